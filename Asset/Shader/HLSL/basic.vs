@@ -1,17 +1,20 @@
 #include "basic.h"
+#include "vertex_packing.h"
 
 cbuffer TransformCB : register(b0)
 {
     row_major float4x4 gWorldMatrix : WORLD;
     row_major float4x4 gViewMatrix : VIEW;
     row_major float4x4 gProjectionView : PROJECTION;
+    float3 gPositionScale : POSITION_SCALE;
+    float3 gPositionOffset : POSITION_OFFSET;
 };
 
 Basic_VertexAttr Basic_VS(Basic_Input input)
 {
     Basic_VertexAttr output = (Basic_VertexAttr)0;
 
-    output.position.xyz = input.Position.xyz;
+    output.position.xyz = DecodePosition(input.Position.xyz, gPositionScale, gPositionOffset);
     output.position.w = 1.0f;
 
     output.position = mul(output.position, gWorldMatrix);
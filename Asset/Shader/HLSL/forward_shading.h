@@ -4,7 +4,7 @@
 struct ForwardShading_Input
 {
     float3 Position : POSITION;
-    float3 Normal : NORMAL;
+    float2 Normal : NORMAL;
     float2 TexCoord : TEXCOORD;
 };
 
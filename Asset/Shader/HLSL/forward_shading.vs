@@ -1,24 +1,27 @@
 #include "forward_shading.h"
+#include "vertex_packing.h"
 
 cbuffer TransformCB : register(b0)
 {
     row_major float4x4 gWorldMatrix : WORLD;
     row_major float4x4 gViewMatrix : VIEW;
     row_major float4x4 gProjectionView : PROJECTION;
+    float3 gPositionScale : POSITION_SCALE;
+    float3 gPositionOffset : POSITION_OFFSET;
 };
 
 ForwardShading_VertexAttr ForwardShading_VS(ForwardShading_Input input)
 {
     ForwardShading_VertexAttr output = (ForwardShading_VertexAttr)0;
 
-    output.position.xyz = input.Position.xyz;
+    output.position.xyz = DecodePosition(input.Position.xyz, gPositionScale, gPositionOffset);
     output.position.w = 1.0f;
     output.position = mul(output.position, gWorldMatrix);
     output.position = mul(output.position, gViewMatrix);
     output.position = mul(output.position, gProjectionView);
 
     output.pos = output.position;
-    output.normal = normalize(mul(input.Normal, (float3x3)gWorldMatrix));
+    output.normal = normalize(mul(DecodeOctahedral(input.Normal), (float3x3)gWorldMatrix));
     output.texcoord = input.TexCoord;
 
     return output;
@@ -4,7 +4,7 @@
 struct ScreenSpaceShadow_Input
 {
     float3 Position : POSITION;
-    float3 Normal : NORMAL;
+    float2 Normal : NORMAL;
 };
 
 struct ScreenSpaceShadow_VertexAttr
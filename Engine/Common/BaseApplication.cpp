@@ -15,6 +15,12 @@ bool BaseApplication::m_bQuit = false;
 
 void BaseApplication::Initialize()
 {
+    auto& assetConfig = gpGlobal->GetConfiguration<AssetConfiguration>();
+    auto& fileSystem = gpGlobal->GetAssetFileSystem();
+    fileSystem.Mount(assetConfig.GetArchivePath(), assetConfig.GetArchivePrefix());
+    if (assetConfig.GetAccessLogPath() != nullptr)
+        fileSystem.StartRecording();
+
     m_pWorld = gpGlobal->GetECSWorld();
 
     if (m_pWorld)
@@ -25,6 +31,10 @@ void BaseApplication::Shutdown()
 {
     if (m_pWorld)
         m_pWorld->Shutdown();
+
+    auto& assetConfig = gpGlobal->GetConfiguration<AssetConfiguration>();
+    if (assetConfig.GetAccessLogPath() != nullptr)
+        gpGlobal->GetAssetFileSystem().SaveAccessOrder(assetConfig.GetAccessLogPath());
 }
 
 void BaseApplication::Tick(float elapsedTime)
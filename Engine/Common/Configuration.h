@@ -45,6 +45,8 @@ public:                                                                 \
         GraphicsConfiguration() = default;
         DECLEAR_CONFIGURATION_ITEM(DeviceType, EConfigurationDeviceType, eDevice_D3D11)
         DECLEAR_CONFIGURATION_ITEM(MSAA, EConfigurationMSAAType, eMSAA_Disable)
+        // Device memory streamed texture mips are kept within, mip tails aside.
+        DECLEAR_CONFIGURATION_ITEM(TexturePoolSize, uint64_t, 512ull << 20)
     };
 
     class DebugConfiguration
@@ -55,6 +57,17 @@ public:                                                                 \
         DECLEAR_CONFIGURATION_ITEM(Height, uint32_t, 200)
     };
 
+    class AssetConfiguration
+    {
+    public:
+        AssetConfiguration() = default;
+        // Mounted at startup when present, loose files are used otherwise.
+        DECLEAR_CONFIGURATION_ITEM(ArchivePath, const char*, "Asset.ntpak")
+        DECLEAR_CONFIGURATION_ITEM(ArchivePrefix, const char*, "Asset/")
+        // When set, the order assets are first read in is written here on shutdown for AssetPacker --order.
+        DECLEAR_CONFIGURATION_ITEM(AccessLogPath, const char*, nullptr)
+    };
+
     class Configuration
     {
     public:
@@ -67,6 +80,7 @@ public:                                                                 \
         AppConfiguration mAppConfig;
         GraphicsConfiguration mGraphicsConfig;
         DebugConfiguration mDebugConfig;
+        AssetConfiguration mAssetConfig;
     };
 
     template<typename T>
@@ -92,4 +106,10 @@ public:                                                                 \
     {
         return mDebugConfig;
     }
+
+    template<>
+    inline AssetConfiguration& Configuration::GetConfiguration<AssetConfiguration>()
+    {
+        return mAssetConfig;
+    }
 }
\ No newline at end of file
@@ -2,6 +2,7 @@
 #include <fstream>
 
 #include "Global.h"
+#include "ISceneSystem.h"
 #include "CameraComponent.h"
 #include "LightComponent.h"
 #include "TransformComponent.h"
@@ -23,7 +24,9 @@ DrawingSystem::DrawingSystem() : m_window(nullptr),
     m_pContext(nullptr),
     m_pEffectPool(nullptr),
     m_pResourceFactory(nullptr),
-    m_pResourceTable(nullptr)
+    m_pResourceTable(nullptr),
+    m_textureStreamer(gpGlobal->GetConfiguration<GraphicsConfiguration>().GetTexturePoolSize()),
+    m_textureLoader(&m_textureStreamer)
 {
 }
 
@@ -43,6 +46,12 @@ void DrawingSystem::Shutdown()
 
 void DrawingSystem::Tick(float elapsedTime)
 {
+    m_textureLoader.Upload(*m_pDevice);
+    m_textureStreamer.Update(*m_pDevice);
+
+    if (gpGlobal->GetSceneSystem() == nullptr)
+        UpdateWorldBounds();
+
     for (auto& pCamera : m_pCameraList)
     {
         auto pFrameGraphComponent = pCamera->GetComponent<FrameGraphComponent>();
@@ -73,6 +82,9 @@ void DrawingSystem::FlushEntity(IEntity* pEntity)
     if (pEntity->HasComponent<MeshFilterComponent>() && pEntity->HasComponent<TransformComponent>())
     {
         m_pMeshList.emplace_back(pEntity);
+        if (pEntity->GetComponent<MeshFilterComponent>()->GetMesh()->GetBounds().IsEmpty())
+            m_pUnboundedMeshList.emplace_back(pEntity);
+
         auto pComponent = pEntity->GetComponent<MeshRendererComponent>();
         auto size = pComponent->GetMaterialSize();
         for (uint32_t i = 0; i < size; i++)
@@ -162,7 +174,7 @@ bool DrawingSystem::CreatePreResource()
 
     m_pResourceFactory->SetEffectPool(m_pEffectPool);
 
-    return true;
+    return CreatePlaceholderTextures();
 }
 
 bool DrawingSystem::RegisterRenderer()
@@ -244,50 +256,56 @@ void DrawingSystem::FlushMaterial(IMaterial* pMaterial)
 
 void DrawingSystem::FlushStandardMaterial(StandardMaterial* pMaterial)
 {
-    auto pAlbedoMap = pMaterial->GetAlbedoMap();
-    if (pAlbedoMap && pAlbedoMap->GetTexture() == nullptr)
-    {
-        auto uri = pAlbedoMap->GetURI();
-        std::shared_ptr<DrawingTexture> pTexture = nullptr;
-        m_pDevice->CreateTextureFromFile(uri, pTexture);
-        pAlbedoMap->SetTexture(pTexture);
-    }
+    FlushTexture(pMaterial->GetAlbedoMap());
+    FlushTexture(pMaterial->GetOcclusionMap());
+    FlushTexture(pMaterial->GetMetallicRoughnessMap());
+    FlushTexture(pMaterial->GetNormalMap());
+    FlushTexture(pMaterial->GetEmissiveMap());
+}
 
-    auto pOcclusionMap = pMaterial->GetOcclusionMap();
-    if (pOcclusionMap && pOcclusionMap->GetTexture() == nullptr)
-    {
-        auto uri = pOcclusionMap->GetURI();
-        std::shared_ptr<DrawingTexture> pTexture = nullptr;
-        m_pDevice->CreateTextureFromFile(uri, pTexture);
-        pOcclusionMap->SetTexture(pTexture);
-    }
+void DrawingSystem::FlushTexture(std::shared_ptr<ITexture> pTexture)
+{
+    // Decoded on the workers and uploaded from Tick, materials draw with placeholders meanwhile.
+    if (pTexture != nullptr)
+        m_textureLoader.Request(pTexture);
+}
 
-    auto pMetallicRoughnessMap = pMaterial->GetMetallicRoughnessMap();
-    if (pMetallicRoughnessMap && pMetallicRoughnessMap->GetTexture() == nullptr)
-    {
-        auto uri = pMetallicRoughnessMap->GetURI();
-        std::shared_ptr<DrawingTexture> pTexture = nullptr;
-        m_pDevice->CreateTextureFromFile(uri, pTexture);
-        pMetallicRoughnessMap->SetTexture(pTexture);
-    }
+bool DrawingSystem::CreatePlaceholderTextures()
+{
+    m_pWhiteTexture = CreatePlaceholderTexture(0xffffffff);
+    m_pBlackTexture = CreatePlaceholderTexture(0xff000000);
+    m_pFlatNormalTexture = CreatePlaceholderTexture(0xffff8080);
 
-    auto pNormalMap = pMaterial->GetNormalMap();
-    if (pNormalMap && pNormalMap->GetTexture() == nullptr)
-    {
-        auto uri = pNormalMap->GetURI();
-        std::shared_ptr<DrawingTexture> pTexture = nullptr;
-        m_pDevice->CreateTextureFromFile(uri, pTexture);
-        pNormalMap->SetTexture(pTexture);
-    }
+    return m_pWhiteTexture != nullptr && m_pBlackTexture != nullptr && m_pFlatNormalTexture != nullptr;
+}
 
-    auto pEmissiveMap = pMaterial->GetEmissiveMap();
-    if (pEmissiveMap && pEmissiveMap->GetTexture() == nullptr)
-    {
-        auto uri = pEmissiveMap->GetURI();
-        std::shared_ptr<DrawingTexture> pTexture = nullptr;
-        m_pDevice->CreateTextureFromFile(uri, pTexture);
-        pEmissiveMap->SetTexture(pTexture);
-    }
+std::shared_ptr<DrawingTexture> DrawingSystem::CreatePlaceholderTexture(uint32_t color)
+{
+    DrawingTextureDesc desc;
+    desc.mType = eTexture_2D;
+    desc.mFormat = eFormat_R8G8B8A8_UNORM;
+    desc.mUsage = eUsage_Immutable;
+    desc.mWidth = 1;
+    desc.mHeight = 1;
+    desc.mBytesPerRow = sizeof(color);
+    desc.mBytesPerSlice = sizeof(color);
+
+    const void* pData[] = { &color };
+    uint32_t size[] = { sizeof(color) };
+
+    std::shared_ptr<DrawingTexture> pTexture;
+    if (!m_pDevice->CreateTexture(desc, pTexture, nullptr, pData, size, 1))
+        return nullptr;
+
+    return pTexture;
+}
+
+std::shared_ptr<DrawingTexture> DrawingSystem::GetBoundTexture(const std::shared_ptr<ITexture>& pTexture, const std::shared_ptr<DrawingTexture>& pPlaceholder)
+{
+    if (pTexture->GetState() != eTextureState_Resident || pTexture->GetTexture() == nullptr)
+        return pPlaceholder;
+
+    return pTexture->GetTexture();
 }
 
 void DrawingSystem::BuildFrameGraph(IEntity* pCamera)
@@ -344,7 +362,9 @@ bool DrawingSystem::BuildForwardFrameGraph(std::shared_ptr<FrameGraph> pFrameGra
         m_pContext->UpdateContext(*m_pResourceTable);
 
         RenderQueueItemListType items;
-        GetVisableRenderable(items);
+        GetVisableRenderable(items, Frustum(Mat::Mul(view, proj)));
+        pRenderer->SetCullingView(Mat::Mul(view, proj), pTransformComponent->GetPosition(),
+                                         float2((float)gpGlobal->GetConfiguration<AppConfiguration>().GetWidth(), (float)gpGlobal->GetConfiguration<AppConfiguration>().GetHeight()));
 
         pRenderer->AddRenderables(items);
         pRenderer->Render(*m_pResourceTable, pDepthPass);
@@ -381,7 +401,8 @@ bool DrawingSystem::BuildForwardFrameGraph(std::shared_ptr<FrameGraph> pFrameGra
         m_pContext->UpdateContext(*m_pResourceTable);
 
         RenderQueueItemListType items;
-        GetVisableRenderable(items);
+        GetVisableRenderable(items, Frustum(Mat::Mul(lightView, lightProj)));
+        pRenderer->ResetCullingView();
 
         pRenderer->UpdateShadowMapAsTarget(*m_pResourceTable);
 
@@ -423,7 +444,9 @@ bool DrawingSystem::BuildForwardFrameGraph(std::shared_ptr<FrameGraph> pFrameGra
         UpdateLightProjMatrix(lightProj);
 
         RenderQueueItemListType items;
-        GetVisableRenderable(items);
+        GetVisableRenderable(items, Frustum(Mat::Mul(view, proj)));
+        pRenderer->SetCullingView(Mat::Mul(view, proj), pTransformComponent->GetPosition(),
+                                         float2((float)gpGlobal->GetConfiguration<AppConfiguration>().GetWidth(), (float)gpGlobal->GetConfiguration<AppConfiguration>().GetHeight()));
 
         pRenderer->UpdateShadowMapAsTexture(*m_pResourceTable);
         pRenderer->UpdateScreenSpaceShadowAsTarget(*m_pResourceTable);
@@ -466,8 +489,16 @@ bool DrawingSystem::BuildForwardFrameGraph(std::shared_ptr<FrameGraph> pFrameGra
         GetLightViewProjectionMatrix(pLightTransformComponent, lightView, lightProj, lightDir);
         UpdateLightDir(lightDir);
 
+        // Only the camera view decides which texture mips are wanted.
+        std::vector<IEntity*> pVisibleList;
+        GetVisibleEntities(pVisibleList, Frustum(Mat::Mul(view, proj)));
+        RequestTextureMips(pVisibleList, pTransformComponent->GetPosition(), proj);
+
         RenderQueueItemListType items;
-        GetVisableRenderable(items);
+        for (auto& pEntity : pVisibleList)
+            AddRenderable(items, pEntity);
+        pRenderer->SetCullingView(Mat::Mul(view, proj), pTransformComponent->GetPosition(),
+                                         float2((float)gpGlobal->GetConfiguration<AppConfiguration>().GetWidth(), (float)gpGlobal->GetConfiguration<AppConfiguration>().GetHeight()));
 
         pRenderer->UpdateScreenSpaceShadowAsTexture(*m_pResourceTable);
 
@@ -540,18 +571,138 @@ bool DrawingSystem::BuildDeferredFrameGraph(std::shared_ptr<FrameGraph> pFrameGr
     return true;
 }
 
-void DrawingSystem::GetVisableRenderable(RenderQueueItemListType& items)
+void DrawingSystem::UpdateWorldBounds()
+{
+    uint32_t count = (uint32_t)m_pMeshList.size();
+    for (uint32_t axis = 0; axis < 3; axis++)
+    {
+        m_boundsCenter[axis].resize(count);
+        m_boundsExtent[axis].resize(count);
+    }
+    m_visible.resize(count);
+
+    gpGlobal->GetJobSystem().ParallelFor(count, 64, [&](uint32_t begin, uint32_t end) {
+        for (uint32_t i = begin; i < end; i++)
+        {
+            auto pTrans = m_pMeshList[i]->GetComponent<TransformComponent>();
+            auto pMeshFilter = m_pMeshList[i]->GetComponent<MeshFilterComponent>();
+
+            auto& bounds = pMeshFilter->GetMesh()->GetBounds();
+            if (bounds.IsEmpty())
+            {
+                // Nothing to cull against, keep it always visible.
+                for (uint32_t axis = 0; axis < 3; axis++)
+                {
+                    m_boundsCenter[axis][i] = 0.0f;
+                    m_boundsExtent[axis][i] = FLT_MAX;
+                }
+                continue;
+            }
+
+            auto worldBounds = bounds.Transform(pTrans->GetWorldMatrix());
+            auto center = worldBounds.Center();
+            auto extent = worldBounds.Extent();
+            for (uint32_t axis = 0; axis < 3; axis++)
+            {
+                m_boundsCenter[axis][i] = center[axis];
+                m_boundsExtent[axis][i] = extent[axis];
+            }
+        }
+    });
+}
+
+void DrawingSystem::GetVisableRenderable(RenderQueueItemListType& items, const Frustum& frustum)
+{
+    std::vector<IEntity*> pVisibleList;
+    GetVisibleEntities(pVisibleList, frustum);
+
+    for (auto& pEntity : pVisibleList)
+        AddRenderable(items, pEntity);
+}
+
+void DrawingSystem::GetVisibleEntities(std::vector<IEntity*>& pVisibleList, const Frustum& frustum)
+{
+    auto pSceneSystem = gpGlobal->GetSceneSystem();
+    if (pSceneSystem != nullptr)
+    {
+        // The scene tree only holds meshes with bounds, the rest are never culled.
+        pVisibleList = m_pUnboundedMeshList;
+        pSceneSystem->QueryFrustum(frustum, pVisibleList);
+        return;
+    }
+
+    if (m_visible.size() != m_pMeshList.size())
+        UpdateWorldBounds();
+
+    uint32_t count = (uint32_t)m_pMeshList.size();
+    gpGlobal->GetJobSystem().ParallelFor(count, 256, [&](uint32_t begin, uint32_t end) {
+        frustum.IntersectBatch(&m_boundsCenter[0][begin], &m_boundsCenter[1][begin], &m_boundsCenter[2][begin],
+                               &m_boundsExtent[0][begin], &m_boundsExtent[1][begin], &m_boundsExtent[2][begin],
+                               end - begin, &m_visible[begin]);
+    });
+
+    for (uint32_t i = 0; i < count; i++)
+    {
+        if (m_visible[i] != 0)
+            pVisibleList.emplace_back(m_pMeshList[i]);
+    }
+}
+
+void DrawingSystem::AddRenderable(RenderQueueItemListType& items, IEntity* pEntity)
 {
-    for (auto& pEntity : m_pMeshList)
+    auto pTrans = pEntity->GetComponent<TransformComponent>();
+    auto pMeshFilter = pEntity->GetComponent<MeshFilterComponent>();
+    auto pMeshRenderer = pEntity->GetComponent<MeshRendererComponent>();
+
+    items.push_back(RenderQueueItem{ dynamic_cast<IRenderable*>(pMeshFilter->GetMesh().get()), pTrans});
+
+    auto pMaterial = pMeshRenderer->GetMaterial(0).get();
+    UpdateMaterial(pMaterial);
+}
+
+void DrawingSystem::RequestTextureMips(const std::vector<IEntity*>& pVisibleList, const float3& cameraPos, const float4x4& proj)
+{
+    // Pixels on screen per unit of size at unit distance.
+    float scale = proj[1][1] * 0.5f * (float)gpGlobal->GetConfiguration<AppConfiguration>().GetHeight();
+
+    for (auto& pEntity : pVisibleList)
     {
         auto pTrans = pEntity->GetComponent<TransformComponent>();
         auto pMeshFilter = pEntity->GetComponent<MeshFilterComponent>();
         auto pMeshRenderer = pEntity->GetComponent<MeshRendererComponent>();
 
-        items.push_back(RenderQueueItem{ dynamic_cast<IRenderable*>(pMeshFilter->GetMesh().get()), pTrans});
+        // Textures are taken to span the mesh once. Meshes without bounds, and the ones the camera
+        // is inside of, want the finest mips.
+        float screenSize = FLT_MAX;
+        auto& bounds = pMeshFilter->GetMesh()->GetBounds();
+        if (!bounds.IsEmpty())
+        {
+            auto worldBounds = bounds.Transform(pTrans->GetWorldMatrix());
+            float radius = worldBounds.Radius();
+            float distance = Vec::Length(worldBounds.Center() - cameraPos) - radius;
+            if (distance > 0.0f)
+                screenSize = 2.0f * radius * scale / distance;
+        }
+
+        auto request = [&](const std::shared_ptr<ITexture>& pTexture) {
+            if (pTexture != nullptr)
+                m_textureStreamer.Request(pTexture, screenSize);
+        };
 
-        auto pMaterial = pMeshRenderer->GetMaterial(0).get();
-        UpdateMaterial(pMaterial);
+        auto size = pMeshRenderer->GetMaterialSize();
+        for (uint32_t i = 0; i < size; i++)
+        {
+            auto pMaterial = pMeshRenderer->GetMaterial(i);
+            if (pMaterial == nullptr || pMaterial->GetMaterialType() != eMaterial_Standard)
+                continue;
+
+            auto pStandardMaterial = std::dynamic_pointer_cast<StandardMaterial>(pMaterial);
+            request(pStandardMaterial->GetAlbedoMap());
+            request(pStandardMaterial->GetOcclusionMap());
+            request(pStandardMaterial->GetMetallicRoughnessMap());
+            request(pStandardMaterial->GetNormalMap());
+            request(pStandardMaterial->GetEmissiveMap());
+        }
     }
 }
 
@@ -578,23 +729,23 @@ void DrawingSystem::UpdateStandardMaterial(StandardMaterial* pMaterial)
 
     auto pTexture = pMaterial->GetAlbedoMap();
     if (pTexture != nullptr)
-        pRenderer->UpdateBaseColorTexture(*m_pResourceTable, pTexture->GetTexture());
+        pRenderer->UpdateBaseColorTexture(*m_pResourceTable, GetBoundTexture(pTexture, m_pWhiteTexture));
 
     pTexture = pMaterial->GetOcclusionMap();
     if (pTexture != nullptr)
-        pRenderer->UpdateOcclusionTexture(*m_pResourceTable, pTexture->GetTexture());
+        pRenderer->UpdateOcclusionTexture(*m_pResourceTable, GetBoundTexture(pTexture, m_pWhiteTexture));
 
     pTexture = pMaterial->GetMetallicRoughnessMap();
     if (pTexture != nullptr)
-        pRenderer->UpdateMetallicRoughnessTexture(*m_pResourceTable, pTexture->GetTexture());
+        pRenderer->UpdateMetallicRoughnessTexture(*m_pResourceTable, GetBoundTexture(pTexture, m_pWhiteTexture));
 
     pTexture = pMaterial->GetNormalMap();
     if (pTexture != nullptr)
-        pRenderer->UpdateNormalTexture(*m_pResourceTable, pTexture->GetTexture());
+        pRenderer->UpdateNormalTexture(*m_pResourceTable, GetBoundTexture(pTexture, m_pFlatNormalTexture));
 
     pTexture = pMaterial->GetEmissiveMap();
     if (pTexture != nullptr)
-        pRenderer->UpdateEmissiveTexture(*m_pResourceTable, pTexture->GetTexture());
+        pRenderer->UpdateEmissiveTexture(*m_pResourceTable, GetBoundTexture(pTexture, m_pBlackTexture));
 }
 
 void DrawingSystem::GetViewMatrix(TransformComponent* pTransform, float4x4& view, float3& dir)
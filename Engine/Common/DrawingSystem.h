@@ -11,11 +11,14 @@
 
 #include "Vector.h"
 #include "Matrix.h"
+#include "Frustum.h"
 #include "DrawingDevice.h"
 #include "DrawingEffectPool.h"
 #include "DrawingResourceTable.h"
 #include "ForwardRenderer.h"
 #include "FrameGraph.h"
+#include "TextureLoader.h"
+#include "TextureStreamer.h"
 
 #include "StandardMaterial.h"
 
@@ -51,12 +54,23 @@ namespace Engine
 
         void FlushMaterial(IMaterial* pMaterial);
         void FlushStandardMaterial(StandardMaterial* pMaterial);
+        void FlushTexture(std::shared_ptr<ITexture> pTexture);
+
+        bool CreatePlaceholderTextures();
+        std::shared_ptr<DrawingTexture> CreatePlaceholderTexture(uint32_t color);
+        // The device texture once resident, the placeholder before.
+        static std::shared_ptr<DrawingTexture> GetBoundTexture(const std::shared_ptr<ITexture>& pTexture, const std::shared_ptr<DrawingTexture>& pPlaceholder);
 
         void BuildFrameGraph(IEntity* pCamera);
         bool BuildForwardFrameGraph(std::shared_ptr<FrameGraph> pFrameGraph, IEntity* pCamera);
         bool BuildDeferredFrameGraph(std::shared_ptr<FrameGraph> pFrameGraph, IEntity* pCamera);
 
-        void GetVisableRenderable(RenderQueueItemListType& items);
+        void UpdateWorldBounds();
+        void GetVisableRenderable(RenderQueueItemListType& items, const Frustum& frustum);
+        void GetVisibleEntities(std::vector<IEntity*>& pVisibleList, const Frustum& frustum);
+        void AddRenderable(RenderQueueItemListType& items, IEntity* pEntity);
+        // Asks for the mips the materials of the visible meshes need at their size on screen.
+        void RequestTextureMips(const std::vector<IEntity*>& pVisibleList, const float3& cameraPos, const float4x4& proj);
 
         void UpdateMaterial(IMaterial* pMaterial);
         void UpdateStandardMaterial(StandardMaterial* pMaterial);
@@ -87,8 +101,22 @@ namespace Engine
         std::shared_ptr<DrawingResourceFactory> m_pResourceFactory;
         std::shared_ptr<DrawingResourceTable> m_pResourceTable;
 
+        TextureStreamer m_textureStreamer;
+        TextureLoader m_textureLoader;
+        // 1x1 stand-ins that leave the material looking untextured: white scales base color, occlusion
+        // and metallic-roughness by their factors, black adds no emission, flat is an unperturbed normal.
+        std::shared_ptr<DrawingTexture> m_pWhiteTexture;
+        std::shared_ptr<DrawingTexture> m_pBlackTexture;
+        std::shared_ptr<DrawingTexture> m_pFlatNormalTexture;
+
         std::vector<IEntity*> m_pCameraList;
         std::vector<IEntity*> m_pLightList;
         std::vector<IEntity*> m_pMeshList;
+        std::vector<IEntity*> m_pUnboundedMeshList;
+
+        // World space bounds of m_pMeshList as center/extent SoA, used when there is no scene system.
+        std::vector<float> m_boundsCenter[3];
+        std::vector<float> m_boundsExtent[3];
+        std::vector<uint8_t> m_visible;
     };
 }
\ No newline at end of file
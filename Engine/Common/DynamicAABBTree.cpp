@@ -0,0 +1,278 @@
+#include <assert.h>
+#include <algorithm>
+
+#include "DynamicAABBTree.h"
+
+using namespace Engine;
+
+DynamicAABBTree::DynamicAABBTree(float margin) : m_root(NullNode), m_freeList(NullNode), m_proxyCount(0), m_margin(margin)
+{
+}
+
+int32_t DynamicAABBTree::CreateProxy(const Box3& box, void* pUserData)
+{
+    int32_t proxyId = AllocateNode();
+
+    Vec3<float> margin(m_margin, m_margin, m_margin);
+    m_nodes[proxyId].box = Box3(box.mMin - margin, box.mMax + margin);
+    m_nodes[proxyId].pUserData = pUserData;
+    m_nodes[proxyId].height = 0;
+
+    InsertLeaf(proxyId);
+    m_proxyCount++;
+
+    return proxyId;
+}
+
+void DynamicAABBTree::DestroyProxy(int32_t proxyId)
+{
+    assert(proxyId >= 0 && proxyId < (int32_t)m_nodes.size());
+    assert(m_nodes[proxyId].IsLeaf());
+
+    RemoveLeaf(proxyId);
+    FreeNode(proxyId);
+    m_proxyCount--;
+}
+
+bool DynamicAABBTree::MoveProxy(int32_t proxyId, const Box3& box)
+{
+    assert(proxyId >= 0 && proxyId < (int32_t)m_nodes.size());
+    assert(m_nodes[proxyId].IsLeaf());
+
+    if (m_nodes[proxyId].box.Contains(box))
+        return false;
+
+    RemoveLeaf(proxyId);
+
+    Vec3<float> margin(m_margin, m_margin, m_margin);
+    m_nodes[proxyId].box = Box3(box.mMin - margin, box.mMax + margin);
+
+    InsertLeaf(proxyId);
+    return true;
+}
+
+void* DynamicAABBTree::GetUserData(int32_t proxyId) const
+{
+    assert(proxyId >= 0 && proxyId < (int32_t)m_nodes.size());
+    return m_nodes[proxyId].pUserData;
+}
+
+const Box3& DynamicAABBTree::GetFatBox(int32_t proxyId) const
+{
+    assert(proxyId >= 0 && proxyId < (int32_t)m_nodes.size());
+    return m_nodes[proxyId].box;
+}
+
+uint32_t DynamicAABBTree::GetProxyCount() const
+{
+    return m_proxyCount;
+}
+
+int32_t DynamicAABBTree::GetHeight() const
+{
+    return m_root == NullNode ? 0 : m_nodes[m_root].height;
+}
+
+int32_t DynamicAABBTree::AllocateNode()
+{
+    int32_t index;
+    if (m_freeList != NullNode)
+    {
+        index = m_freeList;
+        m_freeList = m_nodes[index].parent;
+    }
+    else
+    {
+        index = (int32_t)m_nodes.size();
+        m_nodes.emplace_back();
+    }
+
+    auto& node = m_nodes[index];
+    node.pUserData = nullptr;
+    node.parent = NullNode;
+    node.child1 = NullNode;
+    node.child2 = NullNode;
+    node.height = 0;
+    return index;
+}
+
+void DynamicAABBTree::FreeNode(int32_t index)
+{
+    m_nodes[index].parent = m_freeList;
+    m_nodes[index].height = -1;
+    m_freeList = index;
+}
+
+void DynamicAABBTree::InsertLeaf(int32_t leaf)
+{
+    if (m_root == NullNode)
+    {
+        m_root = leaf;
+        m_nodes[leaf].parent = NullNode;
+        return;
+    }
+
+    // Descend towards the sibling with the lowest surface area cost, like Box2D's b2DynamicTree.
+    auto leafBox = m_nodes[leaf].box;
+    int32_t index = m_root;
+    while (!m_nodes[index].IsLeaf())
+    {
+        auto& node = m_nodes[index];
+        float area = node.box.SurfaceArea();
+        float combinedArea = Box3::Union(node.box, leafBox).SurfaceArea();
+
+        // Cost of making a new parent for this node and the leaf, and the cost pushed down to the children.
+        float cost = 2.0f * combinedArea;
+        float inheritanceCost = 2.0f * (combinedArea - area);
+
+        auto childCost = [&](int32_t child) -> float {
+            auto& childBox = m_nodes[child].box;
+            float newArea = Box3::Union(childBox, leafBox).SurfaceArea();
+            if (m_nodes[child].IsLeaf())
+                return newArea + inheritanceCost;
+            return newArea - childBox.SurfaceArea() + inheritanceCost;
+        };
+
+        float cost1 = childCost(node.child1);
+        float cost2 = childCost(node.child2);
+
+        if (cost < cost1 && cost < cost2)
+            break;
+
+        index = cost1 < cost2 ? node.child1 : node.child2;
+    }
+
+    int32_t sibling = index;
+    int32_t oldParent = m_nodes[sibling].parent;
+    int32_t newParent = AllocateNode();
+
+    m_nodes[newParent].parent = oldParent;
+    m_nodes[newParent].box = Box3::Union(leafBox, m_nodes[sibling].box);
+    m_nodes[newParent].height = m_nodes[sibling].height + 1;
+    m_nodes[newParent].child1 = sibling;
+    m_nodes[newParent].child2 = leaf;
+    m_nodes[sibling].parent = newParent;
+    m_nodes[leaf].parent = newParent;
+
+    if (oldParent != NullNode)
+    {
+        if (m_nodes[oldParent].child1 == sibling)
+            m_nodes[oldParent].child1 = newParent;
+        else
+            m_nodes[oldParent].child2 = newParent;
+    }
+    else
+    {
+        m_root = newParent;
+    }
+
+    Refit(m_nodes[leaf].parent);
+}
+
+void DynamicAABBTree::RemoveLeaf(int32_t leaf)
+{
+    if (leaf == m_root)
+    {
+        m_root = NullNode;
+        return;
+    }
+
+    int32_t parent = m_nodes[leaf].parent;
+    int32_t grandParent = m_nodes[parent].parent;
+    int32_t sibling = m_nodes[parent].child1 == leaf ? m_nodes[parent].child2 : m_nodes[parent].child1;
+
+    if (grandParent != NullNode)
+    {
+        if (m_nodes[grandParent].child1 == parent)
+            m_nodes[grandParent].child1 = sibling;
+        else
+            m_nodes[grandParent].child2 = sibling;
+        m_nodes[sibling].parent = grandParent;
+        FreeNode(parent);
+
+        Refit(grandParent);
+    }
+    else
+    {
+        m_root = sibling;
+        m_nodes[sibling].parent = NullNode;
+        FreeNode(parent);
+    }
+}
+
+void DynamicAABBTree::Refit(int32_t index)
+{
+    while (index != NullNode)
+    {
+        Rotate(index);
+
+        auto& node = m_nodes[index];
+        node.box = Box3::Union(m_nodes[node.child1].box, m_nodes[node.child2].box);
+        node.height = 1 + std::max(m_nodes[node.child1].height, m_nodes[node.child2].height);
+
+        index = node.parent;
+    }
+}
+
+// Swap one child of the node with a grandchild on the other side when that shrinks the surface
+// area of the rebuilt child, following Kensler's tree rotations.
+void DynamicAABBTree::Rotate(int32_t index)
+{
+    auto& node = m_nodes[index];
+    if (node.IsLeaf())
+        return;
+
+    int32_t bestChild = NullNode;
+    int32_t bestGrandChild = NullNode;
+    float bestGain = 0.0f;
+
+    auto evaluate = [&](int32_t child, int32_t other) {
+        auto& otherNode = m_nodes[other];
+        if (otherNode.IsLeaf())
+            return;
+
+        float area = otherNode.box.SurfaceArea();
+        auto& childBox = m_nodes[child].box;
+
+        // Swapping child with otherNode.child1 leaves otherNode holding child and child2.
+        float gain1 = area - Box3::Union(childBox, m_nodes[otherNode.child2].box).SurfaceArea();
+        if (gain1 > bestGain)
+        {
+            bestGain = gain1;
+            bestChild = child;
+            bestGrandChild = otherNode.child1;
+        }
+
+        float gain2 = area - Box3::Union(childBox, m_nodes[otherNode.child1].box).SurfaceArea();
+        if (gain2 > bestGain)
+        {
+            bestGain = gain2;
+            bestChild = child;
+            bestGrandChild = otherNode.child2;
+        }
+    };
+
+    evaluate(node.child1, node.child2);
+    evaluate(node.child2, node.child1);
+
+    if (bestChild == NullNode)
+        return;
+
+    int32_t other = m_nodes[bestGrandChild].parent;
+    auto& otherNode = m_nodes[other];
+
+    if (node.child1 == bestChild)
+        node.child1 = bestGrandChild;
+    else
+        node.child2 = bestGrandChild;
+    m_nodes[bestGrandChild].parent = index;
+
+    if (otherNode.child1 == bestGrandChild)
+        otherNode.child1 = bestChild;
+    else
+        otherNode.child2 = bestChild;
+    m_nodes[bestChild].parent = other;
+
+    otherNode.box = Box3::Union(m_nodes[otherNode.child1].box, m_nodes[otherNode.child2].box);
+    otherNode.height = 1 + std::max(m_nodes[otherNode.child1].height, m_nodes[otherNode.child2].height);
+}
\ No newline at end of file
@@ -0,0 +1,177 @@
+#pragma once
+
+#include <stdint.h>
+#include <vector>
+
+#include "Vector.h"
+#include "Box3.h"
+#include "Sphere.h"
+#include "Frustum.h"
+
+namespace Engine
+{
+    // Incremental bounding volume hierarchy over fattened boxes. Leaves are proxies handed out by
+    // CreateProxy; internal nodes are kept cheap by surface area driven tree rotations.
+    class DynamicAABBTree
+    {
+    public:
+        static const int32_t NullNode = -1;
+
+        explicit DynamicAABBTree(float margin = 0.1f);
+        virtual ~DynamicAABBTree() = default;
+
+        int32_t CreateProxy(const Box3& box, void* pUserData);
+        void DestroyProxy(int32_t proxyId);
+
+        // Returns true when the proxy left its fat box and had to be reinserted.
+        bool MoveProxy(int32_t proxyId, const Box3& box);
+
+        void* GetUserData(int32_t proxyId) const;
+        const Box3& GetFatBox(int32_t proxyId) const;
+
+        uint32_t GetProxyCount() const;
+        int32_t GetHeight() const;
+
+        // The callbacks take the proxy id and return false to stop the query.
+        template<typename Func>
+        void Query(const Box3& box, Func callback) const;
+        template<typename Func>
+        void Query(const Sphere& sphere, Func callback) const;
+        template<typename Func>
+        void Query(const Frustum& frustum, Func callback) const;
+        template<typename Func>
+        void RayCast(const Vec3<float>& origin, const Vec3<float>& dir, float maxDistance, Func callback) const;
+
+    private:
+        struct Node
+        {
+            Box3 box;
+            void* pUserData;
+            int32_t parent;
+            int32_t child1;
+            int32_t child2;
+            int32_t height;
+
+            bool IsLeaf() const
+            {
+                return child1 == NullNode;
+            }
+        };
+
+        int32_t AllocateNode();
+        void FreeNode(int32_t index);
+
+        void InsertLeaf(int32_t leaf);
+        void RemoveLeaf(int32_t leaf);
+
+        void Refit(int32_t index);
+        void Rotate(int32_t index);
+
+        template<typename Test, typename Func>
+        void Traverse(Test test, Func callback) const;
+        template<typename Func>
+        bool ReportSubtree(int32_t index, Func& callback) const;
+
+    private:
+        std::vector<Node> m_nodes;
+        int32_t m_root;
+        int32_t m_freeList;
+        uint32_t m_proxyCount;
+        float m_margin;
+    };
+
+    template<typename Test, typename Func>
+    void DynamicAABBTree::Traverse(Test test, Func callback) const
+    {
+        if (m_root == NullNode)
+            return;
+
+        std::vector<int32_t> stack;
+        stack.reserve(64);
+        stack.push_back(m_root);
+
+        while (!stack.empty())
+        {
+            int32_t index = stack.back();
+            stack.pop_back();
+
+            auto& node = m_nodes[index];
+            if (!test(node.box))
+                continue;
+
+            if (node.IsLeaf())
+            {
+                if (!callback(index))
+                    return;
+            }
+            else
+            {
+                stack.push_back(node.child1);
+                stack.push_back(node.child2);
+            }
+        }
+    }
+
+    template<typename Func>
+    bool DynamicAABBTree::ReportSubtree(int32_t index, Func& callback) const
+    {
+        auto& node = m_nodes[index];
+        if (node.IsLeaf())
+            return callback(index);
+
+        return ReportSubtree(node.child1, callback) && ReportSubtree(node.child2, callback);
+    }
+
+    template<typename Func>
+    void DynamicAABBTree::Query(const Box3& box, Func callback) const
+    {
+        Traverse([&](const Box3& nodeBox) { return nodeBox.Intersect(box); }, callback);
+    }
+
+    template<typename Func>
+    void DynamicAABBTree::Query(const Sphere& sphere, Func callback) const
+    {
+        Traverse([&](const Box3& nodeBox) { return sphere.Intersect(nodeBox); }, callback);
+    }
+
+    template<typename Func>
+    void DynamicAABBTree::Query(const Frustum& frustum, Func callback) const
+    {
+        if (m_root == NullNode)
+            return;
+
+        std::vector<int32_t> stack;
+        stack.reserve(64);
+        stack.push_back(m_root);
+
+        while (!stack.empty())
+        {
+            int32_t index = stack.back();
+            stack.pop_back();
+
+            auto& node = m_nodes[index];
+            if (!frustum.Intersect(node.box))
+                continue;
+
+            // Whole subtrees inside the frustum are reported without testing their children.
+            if (node.IsLeaf() || frustum.Contains(node.box))
+            {
+                if (!ReportSubtree(index, callback))
+                    return;
+            }
+            else
+            {
+                stack.push_back(node.child1);
+                stack.push_back(node.child2);
+            }
+        }
+    }
+
+    template<typename Func>
+    void DynamicAABBTree::RayCast(const Vec3<float>& origin, const Vec3<float>& dir, float maxDistance, Func callback) const
+    {
+        Vec3<float> invDir(1.0f / dir.x, 1.0f / dir.y, 1.0f / dir.z);
+        float distance;
+        Traverse([&](const Box3& nodeBox) { return nodeBox.IntersectRay(origin, invDir, maxDistance, distance); }, callback);
+    }
+}
\ No newline at end of file
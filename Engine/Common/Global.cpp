@@ -98,6 +98,26 @@ FPSCounter& Global::GetFPSCounter()
     return m_fps;
 }
 
+JobSystem& Global::GetJobSystem()
+{
+    return m_jobSystem;
+}
+
+DerivedDataCache& Global::GetDerivedDataCache()
+{
+    return m_derivedDataCache;
+}
+
+AssetFileSystem& Global::GetAssetFileSystem()
+{
+    return m_assetFileSystem;
+}
+
+TextureCache& Global::GetTextureCache()
+{
+    return m_textureCache;
+}
+
 std::shared_ptr<IECSSystem> Global::GetRuntimeModule(ESystemType e)
 {
     auto it = m_pSystems.find(e);
@@ -7,6 +7,10 @@
 
 #include "Vector.h"
 #include "FPS.h"
+#include "JobSystem.h"
+#include "DerivedDataCache.h"
+#include "AssetFileSystem.h"
+#include "TextureCache.h"
 #include "IECSWorld.h"
 #include "ECSWorld.h"
 #include "Configuration.h"
@@ -66,6 +70,10 @@ namespace Engine
         }
 
         FPSCounter& GetFPSCounter();
+        JobSystem& GetJobSystem();
+        DerivedDataCache& GetDerivedDataCache();
+        AssetFileSystem& GetAssetFileSystem();
+        TextureCache& GetTextureCache();
 
         template<typename T>
         void RegisterApp()
@@ -112,6 +120,12 @@ namespace Engine
 
         Configuration m_config;
         FPSCounter m_fps;
+        DerivedDataCache m_derivedDataCache;
+        AssetFileSystem m_assetFileSystem;
+        TextureCache m_textureCache;
+        // Last, so it is destroyed first: its destructor still runs the queued jobs, which use the
+        // members above.
+        JobSystem m_jobSystem;
     };
 
     extern Global* gpGlobal;
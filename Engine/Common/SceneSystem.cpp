@@ -1,4 +1,5 @@
 #include "TransformComponent.h"
+#include "MeshFilterComponent.h"
 
 #include "SceneSystem.h"
 
@@ -10,12 +11,88 @@ void SceneSystem::Initialize()
 
 void SceneSystem::Shutdown()
 {
+    for (auto& proxy : m_proxies)
+        m_tree.DestroyProxy(proxy.proxyId);
+
+    m_proxies.clear();
+    m_proxyIndices.clear();
 }
 
 void SceneSystem::Tick(float elapsedTime)
 {
+    for (auto& proxy : m_proxies)
+    {
+        auto pTransform = proxy.pEntity->GetComponent<TransformComponent>();
+        if (pTransform->GetVersion() == proxy.version)
+            continue;
+
+        Box3 bounds;
+        if (GetWorldBounds(proxy.pEntity, bounds))
+            m_tree.MoveProxy(proxy.proxyId, bounds);
+
+        proxy.version = pTransform->GetVersion();
+    }
 }
 
 void SceneSystem::FlushEntity(IEntity* pEntity)
 {
+    if (m_proxyIndices.find(pEntity) != m_proxyIndices.end())
+        return;
+
+    Box3 bounds;
+    if (!GetWorldBounds(pEntity, bounds))
+        return;
+
+    SceneProxy proxy;
+    proxy.pEntity = pEntity;
+    proxy.proxyId = m_tree.CreateProxy(bounds, pEntity);
+    proxy.version = pEntity->GetComponent<TransformComponent>()->GetVersion();
+
+    m_proxyIndices[pEntity] = (uint32_t)m_proxies.size();
+    m_proxies.emplace_back(proxy);
+}
+
+void SceneSystem::QueryFrustum(const Frustum& frustum, std::vector<IEntity*>& pEntities) const
+{
+    m_tree.Query(frustum, [&](int32_t proxyId) {
+        pEntities.emplace_back(static_cast<IEntity*>(m_tree.GetUserData(proxyId)));
+        return true;
+    });
+}
+
+void SceneSystem::QuerySphere(const Sphere& sphere, std::vector<IEntity*>& pEntities) const
+{
+    m_tree.Query(sphere, [&](int32_t proxyId) {
+        pEntities.emplace_back(static_cast<IEntity*>(m_tree.GetUserData(proxyId)));
+        return true;
+    });
+}
+
+void SceneSystem::QueryBox(const Box3& box, std::vector<IEntity*>& pEntities) const
+{
+    m_tree.Query(box, [&](int32_t proxyId) {
+        pEntities.emplace_back(static_cast<IEntity*>(m_tree.GetUserData(proxyId)));
+        return true;
+    });
+}
+
+void SceneSystem::QueryRay(const float3& origin, const float3& dir, float maxDistance, std::vector<IEntity*>& pEntities) const
+{
+    m_tree.RayCast(origin, dir, maxDistance, [&](int32_t proxyId) {
+        pEntities.emplace_back(static_cast<IEntity*>(m_tree.GetUserData(proxyId)));
+        return true;
+    });
+}
+
+bool SceneSystem::GetWorldBounds(IEntity* pEntity, Box3& bounds) const
+{
+    if (!pEntity->HasComponent<TransformComponent>() || !pEntity->HasComponent<MeshFilterComponent>())
+        return false;
+
+    auto pMesh = pEntity->GetComponent<MeshFilterComponent>()->GetMesh();
+    if (pMesh == nullptr || pMesh->GetBounds().IsEmpty())
+        return false;
+
+    bounds = pMesh->GetBounds().Transform(pEntity->GetComponent<TransformComponent>()->GetWorldMatrix());
+    return true;
 }
\ No newline at end of file
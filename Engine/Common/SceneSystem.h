@@ -1,8 +1,12 @@
 #pragma once
 
+#include <vector>
+#include <unordered_map>
+
 #include "ISceneSystem.h"
 
 #include "ECSSystem.h"
+#include "DynamicAABBTree.h"
 
 namespace Engine
 {
@@ -18,5 +22,25 @@ namespace Engine
         void Tick(float elapsedTime) override;
 
         void FlushEntity(IEntity* pEntity) override;
+
+        void QueryFrustum(const Frustum& frustum, std::vector<IEntity*>& pEntities) const override;
+        void QuerySphere(const Sphere& sphere, std::vector<IEntity*>& pEntities) const override;
+        void QueryBox(const Box3& box, std::vector<IEntity*>& pEntities) const override;
+        void QueryRay(const float3& origin, const float3& dir, float maxDistance, std::vector<IEntity*>& pEntities) const override;
+
+    private:
+        bool GetWorldBounds(IEntity* pEntity, Box3& bounds) const;
+
+    private:
+        struct SceneProxy
+        {
+            IEntity* pEntity;
+            int32_t proxyId;
+            uint32_t version;
+        };
+
+        std::vector<SceneProxy> m_proxies;
+        std::unordered_map<IEntity*, uint32_t> m_proxyIndices;
+        DynamicAABBTree m_tree;
     };
 }
\ No newline at end of file
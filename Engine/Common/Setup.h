@@ -67,6 +67,7 @@
             pWorld->AddECSSystem(gpGlobal->GetLogSystem());
     #ifdef PREDEFINE_APP
             pWorld->AddECSSystem(gpGlobal->GetAnimationSystem());
+            pWorld->AddECSSystem(gpGlobal->GetSceneSystem());
             pWorld->AddECSSystem(gpGlobal->GetDrawingSystem());
 
             gpGlobal->RegisterRenderer<ForwardRenderer>(eRenderer_Forward);
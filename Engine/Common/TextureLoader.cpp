@@ -0,0 +1,108 @@
+#include <algorithm>
+#include <iterator>
+#include <vector>
+
+#include "Global.h"
+#include "TextureCooker.h"
+
+#include "TextureLoader.h"
+
+using namespace Engine;
+
+TextureLoader::TextureLoader(TextureStreamer* pStreamer) : m_pStreamer(pStreamer), m_pQueue(std::make_shared<Queue>())
+{
+}
+
+TextureLoader::~TextureLoader()
+{
+}
+
+void TextureLoader::Request(std::shared_ptr<ITexture> pTexture)
+{
+    if (pTexture == nullptr || pTexture->GetState() != eTextureState_Pending)
+        return;
+
+    pTexture->SetState(eTextureState_Decoding);
+
+    auto pQueue = m_pQueue;
+    {
+        std::lock_guard<std::mutex> lock(pQueue->mutex);
+        pQueue->decodingCount++;
+    }
+
+    bool bStream = m_pStreamer != nullptr;
+    gpGlobal->GetJobSystem().Submit([pQueue, pTexture, bStream]() {
+        auto decoded = Decode(pTexture, bStream);
+
+        std::lock_guard<std::mutex> lock(pQueue->mutex);
+        pQueue->decoded.emplace_back(std::move(decoded));
+        pQueue->decodingCount--;
+    });
+}
+
+void TextureLoader::Upload(DrawingDevice& device, uint32_t maxCount)
+{
+    std::deque<Decoded> batch;
+    {
+        std::lock_guard<std::mutex> lock(m_pQueue->mutex);
+        uint32_t count = std::min(maxCount, (uint32_t)m_pQueue->decoded.size());
+        batch.insert(batch.end(), std::make_move_iterator(m_pQueue->decoded.begin()), std::make_move_iterator(m_pQueue->decoded.begin() + count));
+        m_pQueue->decoded.erase(m_pQueue->decoded.begin(), m_pQueue->decoded.begin() + count);
+    }
+
+    for (auto& decoded : batch)
+    {
+        std::shared_ptr<DrawingTexture> pDrawingTexture = nullptr;
+        if (decoded.pData != nullptr)
+            device.CreateTextureFromMemory(decoded.pData.get(), decoded.size, pDrawingTexture, decoded.maxSize);
+
+        // Streamed textures create their other mips from the source later on.
+        bool bStream = pDrawingTexture != nullptr && decoded.residentMip > 0;
+        decoded.pTexture->SetTexture(pDrawingTexture);
+        decoded.pTexture->SetSourceData(bStream ? decoded.pData : nullptr, bStream ? decoded.size : 0);
+        decoded.pTexture->SetState(eTextureState_Resident);
+
+        if (bStream)
+            m_pStreamer->Add(decoded.pTexture, decoded.residentMip);
+    }
+}
+
+uint32_t TextureLoader::GetDecodingCount() const
+{
+    std::lock_guard<std::mutex> lock(m_pQueue->mutex);
+    return m_pQueue->decodingCount;
+}
+
+TextureLoader::Decoded TextureLoader::Decode(std::shared_ptr<ITexture> pTexture, bool bStream)
+{
+    Decoded decoded = { pTexture, pTexture->GetSourceData(), pTexture->GetSourceSize(), 0, 0 };
+    if (decoded.pData == nullptr)
+    {
+        uint64_t size = 0;
+        decoded.pData = gpGlobal->GetAssetFileSystem().Read(pTexture->GetURI(), size);
+        decoded.size = (uint32_t)size;
+    }
+
+    // Images the cooker can not decode go to the device as they are.
+    if (decoded.pData != nullptr && !TextureCooker::IsCooked(decoded.pData.get(), decoded.size))
+    {
+        uint32_t size = 0;
+        auto pData = TextureCooker::Decode(decoded.pData.get(), decoded.size, pTexture->GetRole(), size);
+        if (pData != nullptr)
+        {
+            decoded.pData = pData;
+            decoded.size = size;
+        }
+    }
+
+    uint32_t width = 0;
+    uint32_t height = 0;
+    uint64_t dataOffset = 0;
+    std::vector<uint64_t> mipSizes;
+    if (!bStream || decoded.pData == nullptr || !TextureCooker::GetMipLayout(decoded.pData.get(), decoded.size, width, height, dataOffset, mipSizes))
+        return decoded;
+
+    decoded.residentMip = TextureStreamer::GetTailMip(width, height, (uint32_t)mipSizes.size());
+    decoded.maxSize = decoded.residentMip > 0 ? TextureStreamer::GetMaxSize(width, height, decoded.residentMip) : 0;
+    return decoded;
+}
\ No newline at end of file
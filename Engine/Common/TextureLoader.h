@@ -0,0 +1,61 @@
+#pragma once
+
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <stdint.h>
+
+#include "DrawingDevice.h"
+#include "ITexture.h"
+#include "TextureStreamer.h"
+
+namespace Engine
+{
+    // Decodes textures on the job system and creates their device textures on the render thread.
+    // Workers fetch the source bytes and turn anything that is not cooked yet into DDS, so the render
+    // thread only uploads ready data, a few textures per frame. With a streamer, cooked 2D textures are
+    // created with their mip tail only, straight from the mapped DDS they keep as source data, and
+    // handed to it.
+    class TextureLoader
+    {
+    public:
+        constexpr static uint32_t MAX_UPLOADS_PER_FRAME = 4;
+
+        explicit TextureLoader(TextureStreamer* pStreamer = nullptr);
+        ~TextureLoader();
+
+        // Moves a pending texture to decoding and queues its decode.
+        void Request(std::shared_ptr<ITexture> pTexture);
+
+        // Render thread only. Creates up to maxCount decoded textures and makes them resident. A
+        // texture that fails to decode becomes resident without a device texture and keeps its placeholder.
+        void Upload(DrawingDevice& device, uint32_t maxCount = MAX_UPLOADS_PER_FRAME);
+
+        uint32_t GetDecodingCount() const;
+
+    private:
+        struct Decoded
+        {
+            std::shared_ptr<ITexture> pTexture;
+            std::shared_ptr<char> pData;
+            uint32_t size;
+            // Non zero when only the mips from residentMip down are created, those no larger than maxSize.
+            uint32_t residentMip;
+            uint32_t maxSize;
+        };
+
+        // Outlives the loader while decodes are still running on the workers.
+        struct Queue
+        {
+            std::mutex mutex;
+            std::deque<Decoded> decoded;
+            uint32_t decodingCount = 0;
+        };
+
+        static Decoded Decode(std::shared_ptr<ITexture> pTexture, bool bStream);
+
+    private:
+        TextureStreamer* m_pStreamer;
+        std::shared_ptr<Queue> m_pQueue;
+    };
+}
\ No newline at end of file
@@ -0,0 +1,250 @@
+#include <algorithm>
+#include <float.h>
+#include <math.h>
+#include <queue>
+
+#include "Global.h"
+#include "TextureCooker.h"
+
+#include "TextureStreamer.h"
+
+using namespace Engine;
+
+constexpr static uint64_t PAGE_SIZE = 4096;
+
+TextureStreamer::TextureStreamer(uint64_t budget) : m_budget(budget), m_residentSize(0), m_frame(0), m_readCount(0), m_pQueue(std::make_shared<Queue>())
+{
+}
+
+TextureStreamer::~TextureStreamer()
+{
+}
+
+uint32_t TextureStreamer::GetTailMip(uint32_t width, uint32_t height, uint32_t mipCount)
+{
+    uint32_t mip = 0;
+    while (mip + 1 < mipCount && (std::max(width >> mip, 1u) > MIP_TAIL_SIZE || std::max(height >> mip, 1u) > MIP_TAIL_SIZE))
+        mip++;
+
+    return std::min(mip, mipCount - 1);
+}
+
+uint32_t TextureStreamer::GetMaxSize(uint32_t width, uint32_t height, uint32_t mip)
+{
+    return std::max(std::max(width, height) >> mip, 1u);
+}
+
+void TextureStreamer::Add(std::shared_ptr<ITexture> pTexture, uint32_t residentMip)
+{
+    auto pSource = pTexture->GetSourceData();
+    if (pSource == nullptr)
+        return;
+
+    Streamed streamed = {};
+    uint64_t dataOffset = 0;
+    std::vector<uint64_t> mipSizes;
+    if (!TextureCooker::GetMipLayout(pSource.get(), pTexture->GetSourceSize(), streamed.width, streamed.height, dataOffset, mipSizes) || residentMip >= mipSizes.size())
+        return;
+
+    streamed.chainSizes.resize(mipSizes.size() + 1, 0);
+    for (uint32_t i = (uint32_t)mipSizes.size(); i-- > 0;)
+        streamed.chainSizes[i] = streamed.chainSizes[i + 1] + mipSizes[i];
+
+    streamed.pTexture = pTexture;
+    streamed.tailMip = GetTailMip(streamed.width, streamed.height, (uint32_t)mipSizes.size());
+    streamed.residentMip = residentMip;
+    streamed.loadingMip = streamed.tailMip + 1;
+    streamed.targetMip = residentMip;
+    streamed.seenFrame = m_frame;
+    streamed.screenSize = 0.0f;
+
+    auto it = m_streamed.find(pTexture.get());
+    if (it != m_streamed.end())
+        m_residentSize -= it->second.chainSizes[it->second.residentMip];
+
+    m_residentSize += streamed.chainSizes[residentMip];
+    m_streamed[pTexture.get()] = std::move(streamed);
+}
+
+void TextureStreamer::Request(const std::shared_ptr<ITexture>& pTexture, float screenSize)
+{
+    auto it = m_streamed.find(pTexture.get());
+    if (it == m_streamed.end())
+    {
+        // Textures that went untracked were down to their tail and kept their source.
+        if (pTexture->GetState() != eTextureState_Resident || pTexture->GetTexture() == nullptr || pTexture->GetSourceData() == nullptr)
+            return;
+
+        uint32_t width = 0;
+        uint32_t height = 0;
+        uint64_t dataOffset = 0;
+        std::vector<uint64_t> mipSizes;
+        if (!TextureCooker::GetMipLayout(pTexture->GetSourceData().get(), pTexture->GetSourceSize(), width, height, dataOffset, mipSizes))
+            return;
+
+        Add(pTexture, GetTailMip(width, height, (uint32_t)mipSizes.size()));
+        it = m_streamed.find(pTexture.get());
+        if (it == m_streamed.end())
+            return;
+    }
+
+    auto& streamed = it->second;
+    if (streamed.seenFrame != m_frame)
+        streamed.screenSize = 0.0f;
+
+    streamed.seenFrame = m_frame;
+    streamed.screenSize = std::max(streamed.screenSize, screenSize);
+}
+
+void TextureStreamer::Update(DrawingDevice& device, uint32_t maxCount)
+{
+    m_frame++;
+
+    Swap(device, maxCount);
+
+    for (auto it = m_streamed.begin(); it != m_streamed.end();)
+    {
+        const auto& streamed = it->second;
+        if (m_frame - streamed.seenFrame > RELEASE_FRAMES && streamed.residentMip == streamed.tailMip && streamed.loadingMip > streamed.tailMip)
+        {
+            m_residentSize -= streamed.chainSizes[streamed.residentMip];
+            it = m_streamed.erase(it);
+        }
+        else
+            ++it;
+    }
+
+    FitBudget();
+    Read();
+}
+
+uint64_t TextureStreamer::GetBudget() const
+{
+    return m_budget;
+}
+
+void TextureStreamer::SetBudget(uint64_t budget)
+{
+    m_budget = budget;
+}
+
+uint64_t TextureStreamer::GetResidentSize() const
+{
+    return m_residentSize;
+}
+
+uint32_t TextureStreamer::GetTextureCount() const
+{
+    return (uint32_t)m_streamed.size();
+}
+
+void TextureStreamer::Swap(DrawingDevice& device, uint32_t maxCount)
+{
+    std::vector<Loaded> batch;
+    {
+        std::lock_guard<std::mutex> lock(m_pQueue->mutex);
+        uint32_t count = std::min(maxCount, (uint32_t)m_pQueue->loaded.size());
+        batch.assign(std::make_move_iterator(m_pQueue->loaded.begin()), std::make_move_iterator(m_pQueue->loaded.begin() + count));
+        m_pQueue->loaded.erase(m_pQueue->loaded.begin(), m_pQueue->loaded.begin() + count);
+    }
+
+    for (auto& loaded : batch)
+    {
+        m_readCount--;
+
+        // Entries are only released with no read in flight, Add may still have replaced this one.
+        auto it = m_streamed.find(loaded.pTexture.get());
+        if (it == m_streamed.end() || it->second.loadingMip != loaded.mip)
+            continue;
+
+        auto& streamed = it->second;
+        streamed.loadingMip = streamed.tailMip + 1;
+
+        // A failed read or creation keeps the mips that are resident.
+        std::shared_ptr<DrawingTexture> pDrawingTexture = nullptr;
+        if (!device.CreateTextureFromMemory(loaded.pData.get(), loaded.size, pDrawingTexture, GetMaxSize(streamed.width, streamed.height, loaded.mip)))
+            continue;
+
+        loaded.pTexture->SetTexture(pDrawingTexture);
+        m_residentSize += streamed.chainSizes[loaded.mip] - streamed.chainSizes[streamed.residentMip];
+        streamed.residentMip = loaded.mip;
+    }
+}
+
+void TextureStreamer::FitBudget()
+{
+    // Tails are always resident, the rest of the budget goes to the largest textures on screen first.
+    std::vector<Streamed*> pOrder;
+    uint64_t tailSize = 0;
+    for (auto& it : m_streamed)
+    {
+        auto& streamed = it.second;
+        if (m_frame - streamed.seenFrame > KEEP_FRAMES)
+            streamed.screenSize = 0.0f;
+
+        streamed.wantedMip = streamed.tailMip;
+        if (streamed.screenSize > 0.0f)
+        {
+            float ratio = (float)std::max(streamed.width, streamed.height) / streamed.screenSize;
+            streamed.wantedMip = ratio > 1.0f ? std::min((uint32_t)log2f(ratio), streamed.tailMip) : 0;
+        }
+
+        tailSize += streamed.chainSizes[streamed.tailMip];
+        pOrder.push_back(&streamed);
+    }
+
+    std::sort(pOrder.begin(), pOrder.end(), [](const Streamed* a, const Streamed* b) { return a->screenSize > b->screenSize; });
+
+    uint64_t remaining = m_budget > tailSize ? m_budget - tailSize : 0;
+    for (auto pStreamed : pOrder)
+    {
+        uint32_t mip = pStreamed->wantedMip;
+        const auto& chainSizes = pStreamed->chainSizes;
+        while (mip < pStreamed->tailMip && chainSizes[mip] - chainSizes[pStreamed->tailMip] > remaining)
+            mip++;
+
+        remaining -= chainSizes[mip] - chainSizes[pStreamed->tailMip];
+        pStreamed->targetMip = mip;
+    }
+}
+
+void TextureStreamer::Read()
+{
+    // Dropping mips comes first as it makes room, then the textures magnified the most.
+    std::priority_queue<std::pair<float, Streamed*>> pending;
+    for (auto& it : m_streamed)
+    {
+        auto& streamed = it.second;
+        if (streamed.targetMip == streamed.residentMip || streamed.loadingMip <= streamed.tailMip)
+            continue;
+
+        float priority = FLT_MAX;
+        if (streamed.targetMip < streamed.residentMip)
+            priority = streamed.screenSize / (float)GetMaxSize(streamed.width, streamed.height, streamed.residentMip);
+
+        pending.emplace(priority, &streamed);
+    }
+
+    auto pQueue = m_pQueue;
+    while (m_readCount < MAX_READS_IN_FLIGHT && !pending.empty())
+    {
+        auto& streamed = *pending.top().second;
+        pending.pop();
+
+        streamed.loadingMip = streamed.targetMip;
+        m_readCount++;
+
+        // The source is the mapped cooked file. The worker faults in the pages of the mips, so the
+        // render thread creates the texture from memory that is already read.
+        Loaded loaded = { streamed.pTexture, streamed.targetMip, streamed.pTexture->GetSourceData(), streamed.pTexture->GetSourceSize() };
+        uint64_t begin = loaded.size - streamed.chainSizes[loaded.mip];
+        gpGlobal->GetJobSystem().Submit([pQueue, loaded, begin]() {
+            volatile char sink = 0;
+            for (uint64_t i = begin; i < loaded.size; i += PAGE_SIZE)
+                sink = sink + loaded.pData.get()[i];
+
+            std::lock_guard<std::mutex> lock(pQueue->mutex);
+            pQueue->loaded.push_back(loaded);
+        });
+    }
+}
\ No newline at end of file
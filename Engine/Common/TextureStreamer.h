@@ -0,0 +1,110 @@
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+#include <stdint.h>
+
+#include "DrawingDevice.h"
+#include "ITexture.h"
+
+namespace Engine
+{
+    // Keeps the mips of cooked textures resident by how large they are on screen. The mip tail is
+    // resident from the first upload on; the mips above it are read from the cooked DDS on the job
+    // system when a draw asks for them and dropped again when the pool runs over its budget, the
+    // least wanted textures first. Device textures hold whole chains, so a change of residency
+    // creates the texture again from the finest resident mip down, straight from the mapped DDS.
+    class TextureStreamer
+    {
+    public:
+        constexpr static uint64_t DEFAULT_BUDGET = 512ull << 20;
+        // Mips no larger than this on either side form the tail.
+        constexpr static uint32_t MIP_TAIL_SIZE = 128;
+        constexpr static uint32_t MAX_READS_IN_FLIGHT = 4;
+        constexpr static uint32_t MAX_UPLOADS_PER_FRAME = 2;
+        // Frames a texture keeps its wanted mips after it was last drawn.
+        constexpr static uint32_t KEEP_FRAMES = 30;
+        // Frames after which a texture that is down to its tail is no longer tracked, which lets the
+        // texture cache release it.
+        constexpr static uint32_t RELEASE_FRAMES = 600;
+
+        explicit TextureStreamer(uint64_t budget = DEFAULT_BUDGET);
+        ~TextureStreamer();
+
+        TextureStreamer(const TextureStreamer&) = delete;
+        TextureStreamer& operator=(const TextureStreamer&) = delete;
+
+        // First mip of the tail of a chain with a top mip of width by height.
+        static uint32_t GetTailMip(uint32_t width, uint32_t height, uint32_t mipCount);
+        // The larger side of mip, which leaves out the mips above it on creation.
+        static uint32_t GetMaxSize(uint32_t width, uint32_t height, uint32_t mip);
+
+        // Render thread only. Tracks a resident texture whose device texture holds the mips from
+        // residentMip down of the cooked DDS kept as its source data.
+        void Add(std::shared_ptr<ITexture> pTexture, uint32_t residentMip);
+
+        // Render thread only. The texture is drawn this frame covering screenSize pixels across,
+        // wanting the mip with about as many texels on its larger side.
+        void Request(const std::shared_ptr<ITexture>& pTexture, float screenSize);
+
+        // Render thread only, once a frame. Creates up to maxCount textures from finished reads,
+        // fits the wanted mips into the budget and queues reads for the ones that are missing.
+        void Update(DrawingDevice& device, uint32_t maxCount = MAX_UPLOADS_PER_FRAME);
+
+        uint64_t GetBudget() const;
+        void SetBudget(uint64_t budget);
+
+        // Device memory of the tracked textures as they are now.
+        uint64_t GetResidentSize() const;
+        uint32_t GetTextureCount() const;
+
+    private:
+        struct Streamed
+        {
+            std::shared_ptr<ITexture> pTexture;
+            uint32_t width;
+            uint32_t height;
+            uint32_t tailMip;
+            uint32_t residentMip;
+            // The mip a read is in flight for, or the tail one past the end when there is none.
+            uint32_t loadingMip;
+            uint32_t wantedMip;
+            uint32_t targetMip;
+            uint32_t seenFrame;
+            float screenSize;
+            // chainSizes[i] is the device memory of the chain from mip i down, and the bytes it takes
+            // at the end of the source.
+            std::vector<uint64_t> chainSizes;
+        };
+
+        struct Loaded
+        {
+            std::shared_ptr<ITexture> pTexture;
+            uint32_t mip;
+            std::shared_ptr<char> pData;
+            uint32_t size;
+        };
+
+        // Outlives the streamer while reads are still running on the workers.
+        struct Queue
+        {
+            std::mutex mutex;
+            std::vector<Loaded> loaded;
+        };
+
+        void Swap(DrawingDevice& device, uint32_t maxCount);
+        void FitBudget();
+        void Read();
+
+    private:
+        uint64_t m_budget;
+        uint64_t m_residentSize;
+        uint32_t m_frame;
+        uint32_t m_readCount;
+
+        std::unordered_map<ITexture*, Streamed> m_streamed;
+        std::shared_ptr<Queue> m_pQueue;
+    };
+}
\ No newline at end of file
@@ -3,7 +3,7 @@
 using namespace Engine;
 
 TransformComponent::TransformComponent() : ComponentBase<TransformComponent>(),
-    m_scale(1.0f, 1.0f, 1.0f), m_quaternion(0.0f, 0.0f, 0.0f, 1.0f)
+    m_scale(1.0f, 1.0f, 1.0f), m_quaternion(), m_version(0)
 {
 }
 
@@ -15,6 +15,7 @@ float3 TransformComponent::GetPosition() const
 void TransformComponent::SetPosition(float3& pos)
 {
     m_position = pos;
+    m_version++;
 }
 
 float3 TransformComponent::GetRotate() const
@@ -25,16 +26,18 @@ float3 TransformComponent::GetRotate() const
 void TransformComponent::SetRotate(float3& rotate)
 {
     m_rotate = rotate;
+    m_version++;
 }
 
-float4 TransformComponent::GetQuaternion() const
+quatf TransformComponent::GetQuaternion() const
 {
     return m_quaternion;
 }
 
-void TransformComponent::SetQuaternion(float4& quaternion)
+void TransformComponent::SetQuaternion(quatf& quaternion)
 {
     m_quaternion = quaternion;
+    m_version++;
 }
 
 float3 TransformComponent::GetScale() const
@@ -45,4 +48,38 @@ float3 TransformComponent::GetScale() const
 void TransformComponent::SetScale(float3& scale)
 {
     m_scale = scale;
+    m_version++;
+}
+
+uint32_t TransformComponent::GetVersion() const
+{
+    return m_version;
+}
+
+float4x4 TransformComponent::GetWorldMatrix() const
+{
+    float3 position = m_position;
+    float3 rotate = m_rotate;
+    float3 scale = m_scale;
+    quatf quaternion = m_quaternion;
+
+    float4x4 posMatrix = {
+        1.f, 0.f, 0.f, 0.f,
+        0.f, 1.f, 0.f, 0.f,
+        0.f, 0.f, 1.f, 0.f,
+        position.x, position.y, position.z, 1.f
+    };
+
+    // The euler rotation is applied after the quaternion, so fold both into one rotation.
+    auto rotQuat = Quaternion::FromEulerLH(rotate.x, rotate.y, rotate.z) * quaternion;
+    float4x4 rotMatrix = Quaternion::ToMatrix4x4(rotQuat);
+
+    float4x4 scaleMatrix = {
+        scale.x, 0.f, 0.f, 0.f,
+        0.f, scale.y, 0.f, 0.f,
+        0.f, 0.f, scale.z, 0.f,
+        0.f, 0.f, 0.f, 1.f
+    };
+
+    return Mat::Mul(scaleMatrix, Mat::Mul(rotMatrix, posMatrix));
 }
\ No newline at end of file
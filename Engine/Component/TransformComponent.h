@@ -1,6 +1,8 @@
 #pragma once
 
 #include "Vector.h"
+#include "Matrix.h"
+#include "Quaternion.h"
 
 #include "Component.h"
 
@@ -18,16 +20,22 @@ namespace Engine
         float3 GetRotate() const;
         void SetRotate(float3& rotate);
 
-        float4 GetQuaternion() const;
-        void SetQuaternion(float4& quaternion);
+        quatf GetQuaternion() const;
+        void SetQuaternion(quatf& quaternion);
 
         float3 GetScale() const;
         void SetScale(float3& scale);
 
+        float4x4 GetWorldMatrix() const;
+
+        // Bumped by every setter so systems can tell when cached world data is stale.
+        uint32_t GetVersion() const;
+
     private:
         float3 m_position;
         float3 m_rotate;
-        float4 m_quaternion;
+        quatf m_quaternion;
         float3 m_scale;
+        uint32_t m_version;
     };
 }
\ No newline at end of file
@@ -8,7 +8,7 @@
 
 using namespace Engine;
 
-GLTF2Loader::GLTF2Loader()
+GLTF2Loader::GLTF2Loader() : m_binaryChunkSize(0)
 {
 }
 
@@ -20,9 +20,19 @@ void GLTF2Loader::Load(std::string filename)
 {
     m_pMeshes.clear();
     m_pMaterials.clear();
+    m_pBinaryChunk = nullptr;
+    m_binaryChunkSize = 0;
 
-    m_asset = gltf2::load(filename);
+    auto separator = filename.find_last_of("/\\");
+    auto directory = separator == std::string::npos ? std::string() : filename.substr(0, separator + 1);
 
+    if (IsBinary(filename))
+        LoadBinary(filename);
+    else
+        LoadText(filename);
+
+    LoadBuffers(directory);
+    LoadTextures(filename, directory);
     LoadMaterials();
     LoadMeshes();
 }
@@ -31,26 +41,25 @@ void GLTF2Loader::ApplyToWorld()
 {
     auto& pWorld = gpGlobal->GetECSWorld();
 
-    auto nodes = m_asset.nodes;
-    auto meshes = m_asset.meshes;
+    const auto& meshes = m_asset.meshes;
+
+    std::for_each(m_asset.nodes.begin(), m_asset.nodes.end(), [&](const gltf2::Node& aNode){
+        if (aNode.mesh < 0)
+            return;
 
-    std::for_each(nodes.begin(), nodes.end(), [&](gltf2::Node& aNode){
-        auto mesh = meshes[aNode.mesh];
+        const auto& mesh = meshes[aNode.mesh];
 
         auto pMaterial = m_pMaterials[mesh.primitives[0].material];
-        auto pMesh = m_pMeshes[aNode.mesh];
+        auto pMesh = m_pMeshes[m_meshOffsets[aNode.mesh]];
 
         TransformComponent transformComp;
         MeshFilterComponent meshFilterComp;
         MeshRendererComponent meshRendererComp;
 
-        float x = aNode.rotation[0];
-        float y = aNode.rotation[1];
-        float z = aNode.rotation[2];
-        float w = aNode.rotation[3];
+        quatf rotation(aNode.rotation);
 
-        transformComp.SetQuaternion(float4(x, y, z, w));
-        meshFilterComp.SetMesh(std::shared_ptr<IMesh>(pMesh));
+        transformComp.SetQuaternion(rotation);
+        meshFilterComp.SetMesh(pMesh);
         meshRendererComp.SetMaterialSize(1);
         meshRendererComp.SetMaterial(std::shared_ptr<IMaterial>(pMaterial));
 
@@ -58,13 +67,373 @@ void GLTF2Loader::ApplyToWorld()
     });
 }
 
+const gltf2::Asset& GLTF2Loader::GetAsset() const
+{
+    return m_asset;
+}
+
+uint32_t GLTF2Loader::GetMeshCount() const
+{
+    return (uint32_t)m_pMeshes.size();
+}
+
+std::shared_ptr<Mesh> GLTF2Loader::GetMesh(uint32_t index) const
+{
+    return m_pMeshes[index];
+}
+
+const GLTF2Loader::CacheStatistics& GLTF2Loader::GetCacheStatistics(uint32_t index) const
+{
+    return m_cacheStatistics[index];
+}
+
+void GLTF2Loader::LoadBinary(const std::string& filename)
+{
+    const uint32_t magic = 0x46546c67;          // "glTF"
+    const uint32_t jsonChunkType = 0x4e4f534a;  // "JSON"
+    const uint32_t binChunkType = 0x004e4942;   // "BIN\0"
+
+    uint64_t size = 0;
+    auto pData = gpGlobal->GetAssetFileSystem().Read(filename, size);
+    if (pData == nullptr)
+        throw gltf2::MisformattedException(filename, "can not be opened");
+
+    // 12 byte header, then chunks of { length, type, data padded to 4 bytes }.
+    uint32_t header[3];
+    if (size < sizeof(header))
+        throw gltf2::MisformattedException(filename, "is not a glTF binary");
+
+    memcpy(header, pData.get(), sizeof(header));
+    if (header[0] != magic || header[1] != 2 || header[2] > size)
+        throw gltf2::MisformattedException(filename, "is not a glTF 2.0 binary");
+
+    char* pJson = nullptr;
+    uint32_t jsonSize = 0;
+    uint64_t offset = sizeof(header);
+    while (offset + 8 <= header[2])
+    {
+        uint32_t chunk[2];
+        memcpy(chunk, pData.get() + offset, sizeof(chunk));
+        offset += sizeof(chunk);
+
+        if (offset + chunk[0] > header[2])
+            throw gltf2::MisformattedException(filename, "has a truncated chunk");
+
+        if (chunk[1] == jsonChunkType && pJson == nullptr)
+        {
+            pJson = pData.get() + offset;
+            jsonSize = chunk[0];
+        }
+        else if (chunk[1] == binChunkType && m_pBinaryChunk == nullptr)
+        {
+            m_pBinaryChunk = std::shared_ptr<char>(pData, pData.get() + offset);
+            m_binaryChunkSize = chunk[0];
+        }
+
+        offset += (chunk[0] + 3) & ~3u;
+    }
+
+    if (pJson == nullptr)
+        throw gltf2::MisformattedException(filename, "has no JSON chunk");
+
+    std::vector<char> copy;
+    JsonDocument document;
+    if (!document.Parse(GetParsableJson(filename, pJson, jsonSize, copy), jsonSize))
+        throw gltf2::MisformattedException(filename, document.GetError());
+
+    auto separator = filename.find_last_of("/\\");
+
+    m_asset = gltf2::Asset();
+    m_asset.dirName = separator == std::string::npos ? std::string() : filename.substr(0, separator);
+    ParseAsset(document.GetRoot(), m_asset);
+}
+
+void GLTF2Loader::LoadText(const std::string& filename)
+{
+    uint64_t size = 0;
+    auto pData = gpGlobal->GetAssetFileSystem().Read(filename, size);
+    if (pData == nullptr)
+        throw gltf2::MisformattedException(filename, "can not be opened");
+
+    std::vector<char> copy;
+    JsonDocument document;
+    if (!document.Parse(GetParsableJson(filename, pData.get(), size, copy), size))
+        throw gltf2::MisformattedException(filename, document.GetError());
+
+    auto separator = filename.find_last_of("/\\");
+
+    m_asset = gltf2::Asset();
+    m_asset.dirName = separator == std::string::npos ? std::string() : filename.substr(0, separator);
+    ParseAsset(document.GetRoot(), m_asset);
+}
+
+void GLTF2Loader::ParseAsset(const JsonDocument::Value& root, gltf2::Asset& asset)
+{
+    typedef JsonDocument::Value Value;
+
+    auto readFloats = [](const Value& value, float* pDst, uint32_t count) {
+        uint32_t i = 0;
+        for (auto element = value.First(); element && i < count; element = element.Next())
+            pDst[i++] = element.GetFloat();
+    };
+
+    auto readTexture = [](const Value& value, gltf2::Material::Texture& texture) {
+        texture.index = value["index"].GetInt(-1);
+        texture.texCoord = value["texCoord"].GetUInt(0);
+    };
+
+    auto readAttributes = [](const Value& value, gltf2::Attributes& attributes) {
+        for (auto member = value.First(); member; member = member.Next())
+            attributes[member.GetKey()] = member.GetUInt();
+    };
+
+    auto metadata = root["asset"];
+    asset.metadata.copyright = metadata["copyright"].GetString();
+    asset.metadata.generator = metadata["generator"].GetString();
+    asset.metadata.version = metadata["version"].GetString();
+    asset.metadata.minVersion = metadata["minVersion"].GetString();
+
+    for (auto value = root["extensionsUsed"].First(); value; value = value.Next())
+        asset.extensionsUsed.push_back(value.GetString());
+    for (auto value = root["extensionsRequired"].First(); value; value = value.Next())
+        asset.extensionRequired.push_back(value.GetString());
+
+    for (auto value = root["accessors"].First(); value; value = value.Next())
+    {
+        static const char* types[] = { "SCALAR", "VEC2", "VEC3", "VEC4", "MAT2", "MAT3", "MAT4" };
+
+        gltf2::Accessor accessor;
+        accessor.name = value["name"].GetString();
+        accessor.bufferView = value["bufferView"].GetInt(-1);
+        accessor.byteOffset = value["byteOffset"].GetUInt(0);
+        accessor.componentType = (gltf2::Accessor::ComponentType)value["componentType"].GetUInt((uint32_t)gltf2::Accessor::ComponentType::Float);
+        accessor.normalized = value["normalized"].GetBool(false);
+        accessor.count = value["count"].GetUInt(0);
+
+        auto type = value["type"].GetCString();
+        auto pType = std::find_if(std::begin(types), std::end(types), [&](const char* name) { return strcmp(name, type) == 0; });
+        accessor.type = pType != std::end(types) ? (gltf2::Accessor::Type)(pType - std::begin(types)) : gltf2::Accessor::Type::Scalar;
+
+        asset.accessors.push_back(accessor);
+    }
+
+    // Data URIs are decoded by LoadBuffers, a .glb keeps its data in the BIN chunk.
+    for (auto value = root["buffers"].First(); value; value = value.Next())
+    {
+        gltf2::Buffer buffer;
+        buffer.name = value["name"].GetString();
+        buffer.uri = value["uri"].GetString();
+        buffer.byteLength = value["byteLength"].GetUInt(0);
+        asset.buffers.push_back(buffer);
+    }
+
+    for (auto value = root["bufferViews"].First(); value; value = value.Next())
+    {
+        gltf2::BufferView bufferView;
+        bufferView.name = value["name"].GetString();
+        bufferView.buffer = value["buffer"].GetUInt(0);
+        bufferView.byteOffset = value["byteOffset"].GetUInt(0);
+        bufferView.byteLength = value["byteLength"].GetUInt(0);
+        bufferView.byteStride = value["byteStride"].GetUInt(0);
+        bufferView.target = (gltf2::BufferView::TargetType)value["target"].GetUInt(0);
+        asset.bufferViews.push_back(bufferView);
+    }
+
+    for (auto value = root["images"].First(); value; value = value.Next())
+    {
+        gltf2::Image image;
+        image.name = value["name"].GetString();
+        image.uri = value["uri"].GetString();
+        image.mimeType = value["mimeType"].GetString();
+        image.bufferView = value["bufferView"].GetInt(-1);
+        asset.images.push_back(image);
+    }
+
+    for (auto value = root["materials"].First(); value; value = value.Next())
+    {
+        gltf2::Material material;
+        material.name = value["name"].GetString();
+
+        auto pbr = value["pbrMetallicRoughness"];
+        readFloats(pbr["baseColorFactor"], material.pbr.baseColorFactor, 4);
+        readTexture(pbr["baseColorTexture"], material.pbr.baseColorTexture);
+        material.pbr.metallicFactor = pbr["metallicFactor"].GetFloat(1.0f);
+        material.pbr.roughnessFactor = pbr["roughnessFactor"].GetFloat(1.0f);
+        readTexture(pbr["metallicRoughnessTexture"], material.pbr.metallicRoughnessTexture);
+
+        readTexture(value["normalTexture"], material.normalTexture);
+        material.normalTexture.scale = value["normalTexture"]["scale"].GetFloat(1.0f);
+        readTexture(value["occlusionTexture"], material.occlusionTexture);
+        material.occlusionTexture.strength = value["occlusionTexture"]["strength"].GetFloat(1.0f);
+        readTexture(value["emissiveTexture"], material.emissiveTexture);
+        readFloats(value["emissiveFactor"], material.emissiveFactor, 3);
+
+        std::string alphaMode = value["alphaMode"].GetString("OPAQUE");
+        if (alphaMode == "MASK")
+            material.alphaMode = gltf2::Material::AlphaMode::Mask;
+        else if (alphaMode == "BLEND")
+            material.alphaMode = gltf2::Material::AlphaMode::Blend;
+
+        material.alphaCutoff = value["alphaCutoff"].GetFloat(0.5f);
+        material.doubleSided = value["doubleSided"].GetBool(false);
+
+        asset.materials.push_back(material);
+    }
+
+    for (auto value = root["meshes"].First(); value; value = value.Next())
+    {
+        gltf2::Mesh mesh;
+        mesh.name = value["name"].GetString();
+
+        for (auto weight = value["weights"].First(); weight; weight = weight.Next())
+            mesh.weights.push_back(weight.GetFloat());
+
+        for (auto element = value["primitives"].First(); element; element = element.Next())
+        {
+            gltf2::Primitive primitive;
+            primitive.indices = element["indices"].GetInt(-1);
+            primitive.material = element["material"].GetInt(-1);
+            primitive.mode = (gltf2::Primitive::Mode)element["mode"].GetUInt((uint32_t)gltf2::Primitive::Mode::Triangles);
+            readAttributes(element["attributes"], primitive.attributes);
+
+            for (auto target = element["targets"].First(); target; target = target.Next())
+            {
+                primitive.targets.emplace_back();
+                readAttributes(target, primitive.targets.back());
+            }
+
+            mesh.primitives.push_back(primitive);
+        }
+
+        asset.meshes.push_back(mesh);
+    }
+
+    for (auto value = root["nodes"].First(); value; value = value.Next())
+    {
+        gltf2::Node node;
+        node.name = value["name"].GetString();
+        node.camera = value["camera"].GetInt(-1);
+        node.mesh = value["mesh"].GetInt(-1);
+        node.skin = value["skin"].GetInt(-1);
+
+        for (auto child = value["children"].First(); child; child = child.Next())
+            node.children.push_back(child.GetInt());
+
+        readFloats(value["matrix"], node.matrix, 16);
+        readFloats(value["rotation"], node.rotation, 4);
+        readFloats(value["scale"], node.scale, 3);
+        readFloats(value["translation"], node.translation, 3);
+
+        for (auto weight = value["weights"].First(); weight; weight = weight.Next())
+            node.weights.push_back(weight.GetFloat());
+
+        asset.nodes.push_back(node);
+    }
+
+    for (auto value = root["samplers"].First(); value; value = value.Next())
+    {
+        gltf2::Sampler sampler;
+        sampler.name = value["name"].GetString();
+        sampler.magFilter = (gltf2::Sampler::MagFilter)value["magFilter"].GetUInt(0);
+        sampler.minFilter = (gltf2::Sampler::MinFilter)value["minFilter"].GetUInt(0);
+        sampler.wrapS = (gltf2::Sampler::WrappingMode)value["wrapS"].GetUInt((uint32_t)gltf2::Sampler::WrappingMode::Repeat);
+        sampler.wrapT = (gltf2::Sampler::WrappingMode)value["wrapT"].GetUInt((uint32_t)gltf2::Sampler::WrappingMode::Repeat);
+        asset.samplers.push_back(sampler);
+    }
+
+    asset.scene = root["scene"].GetInt(-1);
+    for (auto value = root["scenes"].First(); value; value = value.Next())
+    {
+        gltf2::Scene scene;
+        scene.name = value["name"].GetString();
+        for (auto node = value["nodes"].First(); node; node = node.Next())
+            scene.nodes.push_back(node.GetUInt());
+        asset.scenes.push_back(scene);
+    }
+
+    for (auto value = root["textures"].First(); value; value = value.Next())
+    {
+        gltf2::Texture texture;
+        texture.name = value["name"].GetString();
+        texture.sampler = value["sampler"].GetInt(-1);
+        texture.source = value["source"].GetInt(-1);
+        asset.textures.push_back(texture);
+    }
+}
+
+bool GLTF2Loader::IsBinary(const std::string& filename)
+{
+    if (filename.size() < 4)
+        return false;
+
+    std::string extension = filename.substr(filename.size() - 4);
+    std::transform(extension.begin(), extension.end(), extension.begin(), [](char c) { return (char)tolower(c); });
+
+    return extension == ".glb";
+}
+
+char* GLTF2Loader::GetParsableJson(const std::string& filename, char* pJson, uint64_t size, std::vector<char>& copy)
+{
+    // Parsing unescapes in place. A loose file is a copy-on-write mapping of its own, but a stored
+    // archive entry is a view into the mapping every reader of the archive shares.
+    if (!gpGlobal->GetAssetFileSystem().IsArchived(filename))
+        return pJson;
+
+    copy.assign(pJson, pJson + size);
+    return copy.data();
+}
+
+std::shared_ptr<char> GLTF2Loader::DecodeDataURI(const std::string& uri, uint32_t& size)
+{
+    // data:[<mediatype>];base64,<data>, glTF only embeds base64.
+    auto comma = uri.find(',');
+    if (uri.compare(0, 5, "data:") != 0 || comma == std::string::npos || comma < 12 || uri.compare(comma - 7, 7, ";base64") != 0)
+        return nullptr;
+
+    auto decode = [](char c) -> int32_t {
+        if (c >= 'A' && c <= 'Z') return c - 'A';
+        if (c >= 'a' && c <= 'z') return c - 'a' + 26;
+        if (c >= '0' && c <= '9') return c - '0' + 52;
+        if (c == '+' || c == '-') return 62;
+        if (c == '/' || c == '_') return 63;
+        return -1;
+    };
+
+    char* pData = new char[(uri.size() - comma) / 4 * 3 + 3];
+    std::shared_ptr<char> pDecoded(pData, std::default_delete<char[]>());
+
+    uint32_t bits = 0;
+    uint32_t bitCount = 0;
+    size = 0;
+    for (size_t i = comma + 1; i < uri.size() && uri[i] != '='; i++)
+    {
+        int32_t value = decode(uri[i]);
+        if (value < 0)
+            return nullptr;
+
+        bits = (bits << 6) | (uint32_t)value;
+        bitCount += 6;
+        if (bitCount >= 8)
+        {
+            bitCount -= 8;
+            pData[size++] = (char)(bits >> bitCount);
+        }
+    }
+
+    return pDecoded;
+}
+
 void GLTF2Loader::LoadMaterials()
 {
-    auto materials = m_asset.materials;
-    auto textures = m_asset.textures;
-    auto images = m_asset.images;
+    const auto& textures = m_asset.textures;
+
+    auto getTexture = [&](int32_t index) -> std::shared_ptr<ITexture> {
+        if (index < 0 || index >= (int32_t)textures.size())
+            return nullptr;
+        return m_pTextures[index];
+    };
 
-    std::for_each(materials.begin(), materials.end(), [&](gltf2::Material& aMaterial){
+    std::for_each(m_asset.materials.begin(), m_asset.materials.end(), [&](const gltf2::Material& aMaterial){
         auto pMaterial = new StandardMaterial();
 
         float4 baseColor = aMaterial.pbr.baseColorFactor;
@@ -77,92 +446,427 @@ void GLTF2Loader::LoadMaterials()
         pMaterial->SetRoughness(roughness);
         pMaterial->SetEmissive(emissive);
 
-        uint32_t index = -1;
-        if ((index = aMaterial.pbr.baseColorTexture.index) != -1)
+        // Slots referencing the same texture share its handle.
+        pMaterial->SetAlbedoMap(getTexture(aMaterial.pbr.baseColorTexture.index));
+        pMaterial->SetNormalMap(getTexture(aMaterial.normalTexture.index));
+        pMaterial->SetMetallicRoughnessMap(getTexture(aMaterial.pbr.metallicRoughnessTexture.index));
+        pMaterial->SetOcclusionMap(getTexture(aMaterial.occlusionTexture.index));
+        pMaterial->SetEmissiveMap(getTexture(aMaterial.emissiveTexture.index));
+
+        m_pMaterials.push_back(pMaterial);
+    });
+}
+
+void GLTF2Loader::LoadBuffers(const std::string& directory)
+{
+    const auto& buffers = m_asset.buffers;
+
+    m_pBuffers.clear();
+    m_pBuffers.resize(buffers.size());
+
+    gpGlobal->GetJobSystem().ParallelFor((uint32_t)buffers.size(), 1, [&](uint32_t begin, uint32_t end) {
+        for (uint32_t i = begin; i < end; i++)
         {
-            auto baseColorTexture = images[textures[index].source].uri;
-            pMaterial->SetAlbedoMap(std::shared_ptr<ITexture>(new Texture(baseColorTexture)));
+            const auto& aBuffer = buffers[i];
+            std::shared_ptr<char> pBuffer = nullptr;
+
+            // The first buffer of a .glb without a URI is its BIN chunk.
+            if (i == 0 && aBuffer.uri.empty() && m_pBinaryChunk != nullptr && aBuffer.byteLength <= m_binaryChunkSize)
+                pBuffer = m_pBinaryChunk;
+
+            // External .bin files are mapped once and every accessor becomes a view into the mapping.
+            // Embedded data URIs are decoded once into a buffer of their own.
+            if (pBuffer == nullptr && aBuffer.uri.compare(0, 5, "data:") == 0)
+            {
+                uint32_t size = 0;
+                auto pData = DecodeDataURI(aBuffer.uri, size);
+                if (pData != nullptr && size >= aBuffer.byteLength)
+                    pBuffer = pData;
+            }
+            else if (pBuffer == nullptr && !aBuffer.uri.empty())
+            {
+                uint64_t size = 0;
+                auto pFile = gpGlobal->GetAssetFileSystem().Read(directory + aBuffer.uri, size);
+                if (pFile != nullptr && size >= aBuffer.byteLength)
+                    pBuffer = pFile;
+            }
+
+            m_pBuffers[i] = pBuffer;
         }
-        if ((index = aMaterial.normalTexture.index) != -1)
+    });
+}
+
+void GLTF2Loader::LoadTextures(const std::string& filename, const std::string& directory)
+{
+    const auto& textures = m_asset.textures;
+
+    m_pTextures.clear();
+    m_pTextures.resize(textures.size());
+
+    // The material slot a texture is first used in decides how it is cooked.
+    std::vector<ETextureRole> roles(textures.size(), eTextureRole_Albedo);
+    std::vector<bool> bAssigned(textures.size(), false);
+    auto assignRole = [&](int32_t index, ETextureRole role) {
+        if (index >= 0 && index < (int32_t)textures.size() && !bAssigned[index])
         {
-            auto normalTexture = images[textures[index].source].uri;
-            pMaterial->SetNormalMap(std::shared_ptr<ITexture>(new Texture(normalTexture)));
+            roles[index] = role;
+            bAssigned[index] = true;
         }
-        if ((index = aMaterial.pbr.metallicRoughnessTexture.index) != -1)
+    };
+
+    for (const auto& aMaterial : m_asset.materials)
+    {
+        bool bAlphaTested = aMaterial.alphaMode == gltf2::Material::AlphaMode::Mask;
+        assignRole(aMaterial.pbr.baseColorTexture.index, bAlphaTested ? eTextureRole_AlphaTested : eTextureRole_Albedo);
+        assignRole(aMaterial.normalTexture.index, eTextureRole_Normal);
+        assignRole(aMaterial.pbr.metallicRoughnessTexture.index, eTextureRole_MetallicRoughness);
+        assignRole(aMaterial.occlusionTexture.index, eTextureRole_Occlusion);
+        assignRole(aMaterial.emissiveTexture.index, eTextureRole_Emissive);
+    }
+
+    // Textures come from the shared cache, so an image this or another scene already uses is neither
+    // fetched nor cooked again and ends up as a single device texture. Whoever creates a cache entry
+    // fetches and cooks its image on the workers.
+    gpGlobal->GetJobSystem().ParallelFor((uint32_t)textures.size(), 1, [&](uint32_t begin, uint32_t end) {
+        for (uint32_t i = begin; i < end; i++)
         {
-            auto metallicRoughnessTexture = images[textures[index].source].uri;
-            pMaterial->SetMetallicRoughnessMap(std::shared_ptr<ITexture>(new Texture(metallicRoughnessTexture)));
+            const auto& aTexture = textures[i];
+            if (aTexture.source < 0 || aTexture.source >= (int32_t)m_asset.images.size())
+                continue;
+
+            const auto& aImage = m_asset.images[aTexture.source];
+            bool bExternal = !aImage.uri.empty() && aImage.uri.compare(0, 5, "data:") != 0;
+
+            // Embedded images are named after the scene and their index.
+            auto path = bExternal ? directory + aImage.uri : filename + "#" + std::to_string(aTexture.source);
+
+            TextureCache::SamplerDesc sampler;
+            if (aTexture.sampler >= 0 && aTexture.sampler < (int32_t)m_asset.samplers.size())
+            {
+                const auto& aSampler = m_asset.samplers[aTexture.sampler];
+                sampler.magFilter = (uint32_t)aSampler.magFilter;
+                sampler.minFilter = (uint32_t)aSampler.minFilter;
+                sampler.wrapS = (uint32_t)aSampler.wrapS;
+                sampler.wrapT = (uint32_t)aSampler.wrapT;
+            }
+
+            bool bCreated = false;
+            auto pTexture = gpGlobal->GetTextureCache().Acquire(path, sampler, roles[i], bCreated);
+            m_pTextures[i] = pTexture;
+            if (!bCreated)
+                continue;
+
+            if (aImage.bufferView >= 0)
+            {
+                const auto& bufferView = m_asset.bufferViews[aImage.bufferView];
+                const auto& pBuffer = m_pBuffers[bufferView.buffer];
+                if (pBuffer != nullptr)
+                    pTexture->SetSourceData(std::shared_ptr<char>(pBuffer, pBuffer.get() + bufferView.byteOffset), bufferView.byteLength);
+            }
+            else if (bExternal)
+            {
+                // Hashing for the cache reads every page on this worker anyway.
+                uint64_t size = 0;
+                auto pFile = gpGlobal->GetAssetFileSystem().Read(pTexture->GetURI(), size);
+                if (pFile != nullptr)
+                    pTexture->SetSourceData(pFile, (uint32_t)size);
+            }
+            else
+            {
+                uint32_t size = 0;
+                auto pData = DecodeDataURI(aImage.uri, size);
+                if (pData != nullptr)
+                    pTexture->SetSourceData(pData, size);
+            }
+
+            CookTexture(*pTexture);
         }
-        if ((index = aMaterial.occlusionTexture.index) != -1)
+    });
+}
+
+void GLTF2Loader::LoadMeshes()
+{
+    const auto& meshes = m_asset.meshes;
+
+    std::vector<const gltf2::Primitive*> primitives;
+    m_meshOffsets.clear();
+    for (const auto& aMesh : meshes)
+    {
+        m_meshOffsets.push_back((uint32_t)primitives.size());
+        for (const auto& aPrimitive : aMesh.primitives)
+            primitives.push_back(&aPrimitive);
+    }
+
+    // Primitives only read the shared buffers and write their own slot.
+    m_pMeshes.resize(primitives.size());
+    m_cacheStatistics.assign(primitives.size(), CacheStatistics());
+    gpGlobal->GetJobSystem().ParallelFor((uint32_t)primitives.size(), 1, [&](uint32_t begin, uint32_t end) {
+        for (uint32_t i = begin; i < end; i++)
+            m_pMeshes[i] = LoadPrimitive(*primitives[i], m_cacheStatistics[i]);
+    });
+}
+
+std::shared_ptr<Mesh> GLTF2Loader::LoadPrimitive(const gltf2::Primitive& primitive, CacheStatistics& statistics) const
+{
+    struct SemanticDesc
+    {
+        const char* name;
+        Attribute::ESemanticType type;
+        uint32_t components;
+    };
+
+    // Every stream is converted to the layout Mesh expects before quantization, see Mesh::SourceFormat.
+    static const SemanticDesc semantics[] = {
+        { "POSITION", Attribute::ESemanticType::Position, 3 },
+        { "NORMAL", Attribute::ESemanticType::Normal, 3 },
+        { "TANGENT", Attribute::ESemanticType::Tangent, 4 },
+        { "TEXCOORD_0", Attribute::ESemanticType::Texcoord0, 2 },
+        { "TEXCOORD_1", Attribute::ESemanticType::Texcoord1, 2 },
+        { "COLOR_0", Attribute::ESemanticType::Color0, 4 },
+        { "JOINTS_0", Attribute::ESemanticType::Joints0, 4 },
+        { "WEIGHTS_0", Attribute::ESemanticType::Weights0, 4 },
+    };
+
+    // RGB colors get an opaque alpha.
+    static const float fill[4] = { 0.0f, 0.0f, 0.0f, 1.0f };
+
+    const auto& accessors = m_asset.accessors;
+
+    auto pMesh = std::make_shared<Mesh>();
+    for (const auto& aAttribute : primitive.attributes)
+    {
+        const auto& str = aAttribute.first;
+        const auto& accessor = accessors[aAttribute.second];
+
+        auto pSemantic = std::find_if(std::begin(semantics), std::end(semantics), [&](const SemanticDesc& desc) { return str == desc.name; });
+        if (pSemantic == std::end(semantics))
+            continue;
+
+        std::shared_ptr<char> pData = nullptr;
+        uint32_t size = 0;
+        if (pSemantic->type == Attribute::ESemanticType::Joints0)
         {
-            auto occlusionTexture = images[textures[index].source].uri;
-            pMaterial->SetOcclusionMap(std::shared_ptr<ITexture>(new Texture(occlusionTexture)));
+            pData = GetAccessorUInt16(accessor, pSemantic->components);
+            size = accessor.count * pSemantic->components * sizeof(uint16_t);
         }
-        if ((index = aMaterial.emissiveTexture.index) != -1)
+        else
         {
-            auto emissiveTexture = images[textures[index].source].uri;
-            pMaterial->SetEmissiveMap(std::shared_ptr<ITexture>(new Texture(emissiveTexture)));
+            pData = GetAccessorFloats(accessor, pSemantic->components, fill);
+            size = accessor.count * pSemantic->components * sizeof(float);
         }
 
-        m_pMaterials.push_back(pMaterial);
-    });
+        if (pData == nullptr)
+            continue;
+
+        pMesh->AttachVertexData(pData, size, accessor.count, pSemantic->type, str);
+    }
+
+    if (primitive.indices >= 0)
+    {
+        const auto& accessor = accessors[primitive.indices];
+
+        // The renderer takes 16 or 32 bit indices only, 8 bit ones are widened.
+        if (accessor.componentType == gltf2::Accessor::ComponentType::UnsignedInt)
+        {
+            auto pData = GetAccessorData(accessor);
+            if (pData != nullptr)
+                pMesh->AttachIndexData(pData, accessor.count * sizeof(uint32_t), accessor.count);
+        }
+        else
+        {
+            auto pData = GetAccessorUInt16(accessor, 1);
+            if (pData != nullptr)
+                pMesh->AttachIndexData(pData, accessor.count * sizeof(uint16_t), accessor.count);
+        }
+    }
+
+    // The key covers the streams as the pipeline below sees them, so other primitives of a changed
+    // buffer keep their cooked data.
+    Hash64 hash;
+    hash.Update(MESH_COOK_VERSION);
+    hash.Update(MeshFile::VERSION);
+    hash.Update(LOD_COUNT);
+    hash.Update(pMesh->VertexCount());
+    for (const auto& pAttribute : pMesh->GetAttributes())
+    {
+        hash.Update(pAttribute->semanticType);
+        hash.Update(pAttribute->name);
+        hash.Update(pAttribute->size);
+        hash.Update(pAttribute->pData.get(), pAttribute->size);
+    }
+
+    if (pMesh->GetIndexData() != nullptr)
+    {
+        hash.Update(pMesh->IndexCount());
+        hash.Update(pMesh->IndexSize());
+        hash.Update(pMesh->GetIndexData().get(), pMesh->IndexSize());
+    }
+
+    auto& cache = gpGlobal->GetDerivedDataCache();
+    uint64_t key = hash.Final();
+
+    auto path = cache.Find(key);
+    if (!path.empty())
+    {
+        auto pCooked = MeshFile::Load(path);
+        if (pCooked != nullptr)
+            return pCooked;
+    }
+
+    pMesh->Optimize(&statistics.before, &statistics.after);
+    statistics.bOptimized = true;
+    pMesh->GenerateLods(LOD_COUNT);
+    pMesh->GenerateMeshlets();
+    pMesh->GenerateTangents();
+    pMesh->Quantize();
+
+    // Stored uncompressed, a hit then maps straight into the mesh.
+    cache.Store(key, [&](const std::string& path) { return MeshFile::Save(*pMesh, path, false); });
+
+    return pMesh;
 }
 
-void GLTF2Loader::LoadMeshes()
+void GLTF2Loader::CookTexture(ITexture& texture)
 {
-    auto meshes = m_asset.meshes;
-    auto buffers = m_asset.buffers;
-    auto accessors = m_asset.accessors;
-    auto bufferViews = m_asset.bufferViews;
+    auto pSource = texture.GetSourceData();
+    if (pSource == nullptr)
+        return;
+
+    Hash64 hash;
+    hash.Update(TextureCooker::VERSION);
+    hash.Update(texture.GetRole());
+    hash.Update(pSource.get(), texture.GetSourceSize());
+
+    auto& cache = gpGlobal->GetDerivedDataCache();
+    uint64_t key = hash.Final();
+
+    auto path = cache.Find(key);
+    if (path.empty() && cache.Store(key, [&](const std::string& path) { return TextureCooker::Cook(pSource.get(), texture.GetSourceSize(), texture.GetRole(), path); }))
+        path = cache.Find(key);
+
+    // Images the cooker can not decode keep their encoded bytes.
+    auto pFile = path.empty() ? nullptr : MappedFile::Open(path);
+    if (pFile != nullptr)
+        texture.SetSourceData(pFile->GetView(0), (uint32_t)pFile->GetSize());
+}
 
-    std::for_each(meshes.begin(), meshes.end(), [&](gltf2::Mesh& aMesh)
-    {
-        auto primitives = aMesh.primitives;
-        std::for_each(primitives.begin(), primitives.end(), [&](gltf2::Primitive& aPrimitive){
-            auto pMesh = new Mesh();
-            auto attributes = aPrimitive.attributes;
-            std::for_each(attributes.begin(), attributes.end(), [&](gltf2::Attributes::value_type& aAttribute){
-                auto str = aAttribute.first;
-                auto num = aAttribute.second;
+std::shared_ptr<char> GLTF2Loader::GetAccessorElements(const gltf2::Accessor& accessor, uint32_t& stride) const
+{
+    if (accessor.bufferView < 0 || accessor.count == 0)
+        return nullptr;
+
+    const auto& bufferView = m_asset.bufferViews[accessor.bufferView];
+    const auto& pBuffer = m_pBuffers[bufferView.buffer];
+    if (pBuffer == nullptr)
+        return nullptr;
 
-                Attribute::ESemanticType type;
-                if (str ==  "POSITION")
-                    type = Attribute::ESemanticType::Position;
-                else if (str == "NORMAL")
-                    type = Attribute::ESemanticType::Normal;
-                else if (str == "TEXCOORD_0")
-                    type = Attribute::ESemanticType::Texcoord0;
-                else
-                    return;
+    uint32_t elementSize = ElementSize(accessor);
+    stride = bufferView.byteStride != 0 ? bufferView.byteStride : elementSize;
 
-                int bufferView = accessors[num].bufferView;
-                int count = accessors[num].count;
+    // Accessors reaching past their view are rejected instead of reading past the buffer.
+    uint64_t end = accessor.byteOffset + (uint64_t)(accessor.count - 1) * stride + elementSize;
+    if (end > bufferView.byteLength)
+        return nullptr;
 
-                int offset = bufferViews[bufferView].byteOffset;
-                int subsize = bufferViews[bufferView].byteLength;
+    return std::shared_ptr<char>(pBuffer, pBuffer.get() + bufferView.byteOffset + accessor.byteOffset);
+}
+
+std::shared_ptr<char> GLTF2Loader::GetAccessorData(const gltf2::Accessor& accessor) const
+{
+    uint32_t stride = 0;
+    auto pElements = GetAccessorElements(accessor, stride);
+    if (pElements == nullptr)
+        return nullptr;
+
+    // Tightly packed data is shared with the buffer.
+    uint32_t elementSize = ElementSize(accessor);
+    if (stride == elementSize)
+        return pElements;
+
+    // Interleaved streams are gathered once.
+    char* pData = new char[accessor.count * elementSize];
+    for (uint32_t i = 0; i < accessor.count; i++)
+        memcpy(pData + i * elementSize, pElements.get() + i * stride, elementSize);
+
+    return std::shared_ptr<char>(pData, std::default_delete<char[]>());
+}
+
+std::shared_ptr<char> GLTF2Loader::GetAccessorFloats(const gltf2::Accessor& accessor, uint32_t components, const float fill[4]) const
+{
+    uint32_t stride = 0;
+    auto pElements = GetAccessorElements(accessor, stride);
+    if (pElements == nullptr)
+        return nullptr;
 
-                auto pData = buffers[bufferViews[bufferView].buffer].data;
-                char* data = new char[subsize];
-                memcpy(data, pData + offset, subsize);
+    auto type = ComponentType(accessor);
+    auto count = ComponentCount(accessor);
+    if (type == VertexConversion::EComponentType::Float32 && count == components && stride == ElementSize(accessor))
+        return pElements;
 
-                pMesh->AttachVertexData(data, subsize, count, type, str);
-            });
+    char* pData = new char[accessor.count * components * sizeof(float)];
+    VertexConversion::ToFloat(pElements.get(), stride, type, accessor.normalized, count, accessor.count, reinterpret_cast<float*>(pData), components, fill);
 
-            auto indexNum = aPrimitive.indices;
+    return std::shared_ptr<char>(pData, std::default_delete<char[]>());
+}
 
-            int bufferView = accessors[indexNum].bufferView;
-            int count = accessors[indexNum].count;
+std::shared_ptr<char> GLTF2Loader::GetAccessorUInt16(const gltf2::Accessor& accessor, uint32_t components) const
+{
+    uint32_t stride = 0;
+    auto pElements = GetAccessorElements(accessor, stride);
+    if (pElements == nullptr)
+        return nullptr;
 
-            int offset = bufferViews[bufferView].byteOffset;
-            int subsize = bufferViews[bufferView].byteLength;
+    auto type = ComponentType(accessor);
+    auto count = ComponentCount(accessor);
+    if (type == VertexConversion::EComponentType::UInt16 && count == components && stride == ElementSize(accessor))
+        return pElements;
 
-            auto pData = buffers[bufferViews[bufferView].buffer].data;
-            char* data = new char[subsize];
-            memcpy(data, pData + offset, subsize);
+    char* pData = new char[accessor.count * components * sizeof(uint16_t)];
+    VertexConversion::ToUInt16(pElements.get(), stride, type, count, accessor.count, reinterpret_cast<uint16_t*>(pData), components);
 
-            pMesh->AttachIndexData(data, subsize, count);
+    return std::shared_ptr<char>(pData, std::default_delete<char[]>());
+}
 
-            m_pMeshes.push_back(pMesh);
-        });
-    });
+VertexConversion::EComponentType GLTF2Loader::ComponentType(const gltf2::Accessor& accessor)
+{
+    switch (accessor.componentType)
+    {
+    case gltf2::Accessor::ComponentType::Byte:
+        return VertexConversion::EComponentType::Int8;
+    case gltf2::Accessor::ComponentType::UnsignedByte:
+        return VertexConversion::EComponentType::UInt8;
+    case gltf2::Accessor::ComponentType::Short:
+        return VertexConversion::EComponentType::Int16;
+    case gltf2::Accessor::ComponentType::UnsignedShort:
+        return VertexConversion::EComponentType::UInt16;
+    case gltf2::Accessor::ComponentType::UnsignedInt:
+        return VertexConversion::EComponentType::UInt32;
+    default:
+        return VertexConversion::EComponentType::Float32;
+    }
+}
+
+uint32_t GLTF2Loader::ComponentCount(const gltf2::Accessor& accessor)
+{
+    switch (accessor.type)
+    {
+    case gltf2::Accessor::Type::Vec2:
+        return 2;
+    case gltf2::Accessor::Type::Vec3:
+        return 3;
+    case gltf2::Accessor::Type::Vec4:
+    case gltf2::Accessor::Type::Mat2:
+        return 4;
+    case gltf2::Accessor::Type::Mat3:
+        return 9;
+    case gltf2::Accessor::Type::Mat4:
+        return 16;
+    default:
+        return 1;
+    }
+}
+
+uint32_t GLTF2Loader::ElementSize(const gltf2::Accessor& accessor)
+{
+    return VertexConversion::ComponentSize(ComponentType(accessor)) * ComponentCount(accessor);
 }
\ No newline at end of file
@@ -4,30 +4,102 @@
 #include <vector>
 
 #include <glTF2.hpp>
+#include <Exceptions.hpp>
 #include <Global.h>
+#include <Hash64.h>
+#include <JsonDocument.h>
+#include <MappedFile.h>
+#include <VertexConversion.h>
 
 #include <Mesh.h>
+#include <MeshFile.h>
 #include <StandardMaterial.h>
+#include <Texture.h>
+#include <TextureCache.h>
+#include <TextureCooker.h>
 
 namespace Engine
 {
     class GLTF2Loader
     {
     public:
+        // Post-transform cache efficiency of a mesh around Optimize. Meshes found in the derived data
+        // cache were optimized by an earlier run and report bOptimized false.
+        struct CacheStatistics
+        {
+            bool bOptimized = false;
+            VertexCacheStatistics before = {};
+            VertexCacheStatistics after = {};
+        };
+
         GLTF2Loader();
         virtual ~GLTF2Loader();
 
+        // .gltf with sidecar files or self-contained .glb. Throws gltf2::MisformattedException on bad input.
         void Load(std::string filename);
         void ApplyToWorld();
 
+        const gltf2::Asset& GetAsset() const;
+
+        // One mesh per primitive in glTF order.
+        uint32_t GetMeshCount() const;
+        std::shared_ptr<Mesh> GetMesh(uint32_t index) const;
+        const CacheStatistics& GetCacheStatistics(uint32_t index) const;
+
     protected:
+        // A .glb is mapped once. Its JSON chunk is parsed in place and its BIN chunk backs buffer 0,
+        // so embedded images and vertex data are views into the same mapping.
+        void LoadBinary(const std::string& filename);
+        // A .gltf, loose or archived. Only the JSON is read here, buffers and images are mapped or
+        // decoded from their data URIs by the stages below, so no file is read twice.
+        void LoadText(const std::string& filename);
+        static void ParseAsset(const JsonDocument::Value& root, gltf2::Asset& asset);
+        static bool IsBinary(const std::string& filename);
+        // The JSON itself for loose files, a copy of it in copy for archived ones.
+        static char* GetParsableJson(const std::string& filename, char* pJson, uint64_t size, std::vector<char>& copy);
+        // Base64 data URI contents, nullptr for anything else.
+        static std::shared_ptr<char> DecodeDataURI(const std::string& uri, uint32_t& size);
+
+        // Load runs these stages in order. Within a stage buffers, textures and primitives are
+        // independent, so each stage is spread over the job system.
+        void LoadBuffers(const std::string& directory);
+        void LoadTextures(const std::string& filename, const std::string& directory);
         void LoadMaterials();
         void LoadMeshes();
 
+        // Primitives and images are cooked through the derived data cache, keyed by the bytes they
+        // read, so only those whose sources changed are cooked again.
+        std::shared_ptr<Mesh> LoadPrimitive(const gltf2::Primitive& primitive, CacheStatistics& statistics) const;
+        static void CookTexture(ITexture& texture);
+
+        // First element of the accessor and the byte stride between elements, nullptr when the accessor does not fit its view.
+        std::shared_ptr<char> GetAccessorElements(const gltf2::Accessor& accessor, uint32_t& stride) const;
+        // Accessor data as a tightly packed stream in its own encoding, shared with the buffer when possible.
+        std::shared_ptr<char> GetAccessorData(const gltf2::Accessor& accessor) const;
+        // Accessor data converted to count * components floats or uint16s, shared with the buffer when it already is.
+        std::shared_ptr<char> GetAccessorFloats(const gltf2::Accessor& accessor, uint32_t components, const float fill[4]) const;
+        std::shared_ptr<char> GetAccessorUInt16(const gltf2::Accessor& accessor, uint32_t components) const;
+
+        static VertexConversion::EComponentType ComponentType(const gltf2::Accessor& accessor);
+        static uint32_t ComponentCount(const gltf2::Accessor& accessor);
+        static uint32_t ElementSize(const gltf2::Accessor& accessor);
+
+        // Levels of detail per primitive, LOD 0 included.
+        constexpr static uint32_t LOD_COUNT = 4;
+        // Part of the derived data key of every primitive, bump it whenever the mesh pipeline changes.
+        constexpr static uint32_t MESH_COOK_VERSION = 1;
+
     private:
         gltf2::Asset m_asset;
+        std::shared_ptr<char> m_pBinaryChunk;
+        uint32_t m_binaryChunkSize;
+        std::vector<std::shared_ptr<char>> m_pBuffers;
+        std::vector<std::shared_ptr<ITexture>> m_pTextures;
 
-        std::vector<Mesh*> m_pMeshes;
+        // One mesh per primitive, m_meshOffsets[i] is the first primitive of glTF mesh i.
+        std::vector<std::shared_ptr<Mesh>> m_pMeshes;
+        std::vector<uint32_t> m_meshOffsets;
+        std::vector<CacheStatistics> m_cacheStatistics;
         std::vector<StandardMaterial*> m_pMaterials;
     };
 }
\ No newline at end of file
@@ -93,6 +93,8 @@ CubeMesh::CubeMesh()
     AttachVertexData<float3>(position, sizeof(position) / sizeof (float3), Attribute::ESemanticType::Position, "POSITION");
     AttachVertexData<float3>(normal, sizeof(position) / sizeof (float3), Attribute::ESemanticType::Normal, "NORMAL");
     AttachIndexData<short>(indices, sizeof(indices) / sizeof(short));
+
+    Quantize();
 }
 
 CubeMesh::~CubeMesh()
@@ -1,8 +1,15 @@
+#include <algorithm>
+#include <cmath>
+
+#include "Global.h"
 #include "Mesh.h"
+#include "MeshOptimizer.h"
+#include "MeshSimplifier.h"
+#include "VertexPacking.h"
 
 using namespace Engine;
 
-Mesh::Mesh()
+Mesh::Mesh() : m_indexSize(0), m_vertexCount(0), m_indexCount(0), m_bQuantized(false)
 {
 }
 
@@ -47,29 +54,484 @@ const uint32_t Mesh::IndexCount() const
     return m_indexCount;
 }
 
+const Box3& Mesh::GetBounds() const
+{
+    return m_bounds;
+}
+
 void Mesh::AttachVertexData(const char array[], const uint32_t size, const uint32_t count, Attribute::ESemanticType type, std::string name)
 {
     char* pData = new char[size];
 
     memcpy(pData, array, size);
 
+    AttachVertexData(std::shared_ptr<char>(pData, std::default_delete<char[]>()), size, count, type, name);
+}
+
+void Mesh::AttachIndexData(const char array[], const uint32_t size, const uint32_t count)
+{
+    char* pData = new char[size];
+
+    memcpy(pData, array, size);
+
+    AttachIndexData(std::shared_ptr<char>(pData, std::default_delete<char[]>()), size, count);
+}
+
+void Mesh::AttachVertexData(std::shared_ptr<char> pData, const uint32_t size, const uint32_t count, Attribute::ESemanticType type, std::string name)
+{
     auto pAttribute = std::make_shared<Attribute>();
     pAttribute->semanticType = type;
+    pAttribute->format = SourceFormat(type);
     pAttribute->name = name;
-    pAttribute->pData = std::shared_ptr<char>(pData);
+    pAttribute->pData = pData;
     pAttribute->size = size;
 
     m_pAttributes.emplace_back(pAttribute);
     m_vertexCount = count;
+
+    if (type == Attribute::ESemanticType::Position)
+        UpdateBounds(reinterpret_cast<const float3*>(pData.get()), count);
 }
 
-void Mesh::AttachIndexData(const char array[], const uint32_t size, const uint32_t count)
+void Mesh::AttachIndexData(std::shared_ptr<char> pData, const uint32_t size, const uint32_t count)
 {
-    char* pData = new char[size];
-
-    memcpy(pData, array, size);
-
-    m_pIndexData = std::shared_ptr<char>(pData);
+    m_pIndexData = pData;
     m_indexSize = size;
     m_indexCount = count;
+
+    m_lods.clear();
+}
+
+void Mesh::UpdateBounds(const float3 positions[], const uint32_t count)
+{
+    m_bounds.Clear();
+    for (uint32_t i = 0; i < count; i++)
+        m_bounds.Expand(positions[i]);
+}
+
+uint32_t Mesh::GetIndex(const uint32_t i) const
+{
+    if (m_pIndexData == nullptr)
+        return i;
+
+    if (m_indexSize == m_indexCount * sizeof(uint16_t))
+        return reinterpret_cast<const uint16_t*>(m_pIndexData.get())[i];
+
+    return reinterpret_cast<const uint32_t*>(m_pIndexData.get())[i];
+}
+
+void Mesh::GenerateTangents()
+{
+    if (m_bQuantized)
+        return;
+
+    const float3* pPositions = nullptr;
+    const float3* pNormals = nullptr;
+    const float2* pTexcoords = nullptr;
+    for (const auto& pAttribute : m_pAttributes)
+    {
+        switch (pAttribute->semanticType)
+        {
+        case Attribute::ESemanticType::Position:
+            pPositions = reinterpret_cast<const float3*>(pAttribute->pData.get());
+            break;
+        case Attribute::ESemanticType::Normal:
+            pNormals = reinterpret_cast<const float3*>(pAttribute->pData.get());
+            break;
+        case Attribute::ESemanticType::Texcoord0:
+            pTexcoords = reinterpret_cast<const float2*>(pAttribute->pData.get());
+            break;
+        case Attribute::ESemanticType::Tangent:
+            return;
+        default:
+            break;
+        }
+    }
+
+    if (pPositions == nullptr || pNormals == nullptr || pTexcoords == nullptr)
+        return;
+
+    // Per triangle UV gradients accumulated on the vertices, see Lengyel, "Computing Tangent Space Basis Vectors".
+    std::vector<float3> tangents(m_vertexCount, float3(0.0f));
+    std::vector<float3> bitangents(m_vertexCount, float3(0.0f));
+
+    uint32_t count = m_pIndexData != nullptr ? m_indexCount : m_vertexCount;
+    for (uint32_t i = 0; i + 2 < count; i += 3)
+    {
+        uint32_t i0 = GetIndex(i);
+        uint32_t i1 = GetIndex(i + 1);
+        uint32_t i2 = GetIndex(i + 2);
+        if (i0 >= m_vertexCount || i1 >= m_vertexCount || i2 >= m_vertexCount)
+            continue;
+
+        float3 e1 = pPositions[i1] - pPositions[i0];
+        float3 e2 = pPositions[i2] - pPositions[i0];
+        float s1 = pTexcoords[i1].x - pTexcoords[i0].x;
+        float t1 = pTexcoords[i1].y - pTexcoords[i0].y;
+        float s2 = pTexcoords[i2].x - pTexcoords[i0].x;
+        float t2 = pTexcoords[i2].y - pTexcoords[i0].y;
+
+        float det = s1 * t2 - s2 * t1;
+        if (fabsf(det) < 1e-12f)
+            continue;
+
+        float r = 1.0f / det;
+        float3 sdir = (e1 * t2 - e2 * t1) * r;
+        float3 tdir = (e2 * s1 - e1 * s2) * r;
+
+        tangents[i0] += sdir;
+        tangents[i1] += sdir;
+        tangents[i2] += sdir;
+        bitangents[i0] += tdir;
+        bitangents[i1] += tdir;
+        bitangents[i2] += tdir;
+    }
+
+    char* pData = new char[m_vertexCount * sizeof(float4)];
+    float4* pTangents = reinterpret_cast<float4*>(pData);
+    for (uint32_t i = 0; i < m_vertexCount; i++)
+    {
+        const float3& n = pNormals[i];
+
+        // Gram-Schmidt against the normal, falling back to any perpendicular axis for degenerate UVs.
+        float3 t = tangents[i] - n * Vec::Dot(n, tangents[i]);
+        float lengthSquared = Vec::LengthSquared(t);
+        if (lengthSquared < 1e-12f)
+        {
+            t = Vec::Cross(fabsf(n.x) < 0.9f ? float3(1.0f, 0.0f, 0.0f) : float3(0.0f, 1.0f, 0.0f), n);
+            lengthSquared = std::max(Vec::LengthSquared(t), 1e-12f);
+        }
+        t = t / sqrtf(lengthSquared);
+
+        float w = Vec::Dot(Vec::Cross(n, t), bitangents[i]) < 0.0f ? -1.0f : 1.0f;
+        pTangents[i] = float4(t.x, t.y, t.z, w);
+    }
+
+    AttachVertexData(std::shared_ptr<char>(pData, std::default_delete<char[]>()), m_vertexCount * sizeof(float4), m_vertexCount, Attribute::ESemanticType::Tangent, "TANGENT");
+}
+
+void Mesh::Optimize(VertexCacheStatistics* pBefore, VertexCacheStatistics* pAfter)
+{
+    if (m_vertexCount == 0)
+        return;
+
+    uint32_t indexCount = m_pIndexData != nullptr ? m_indexCount : m_vertexCount;
+    indexCount -= indexCount % 3;
+
+    std::vector<uint32_t> indices(indexCount);
+    for (uint32_t i = 0; i < indexCount; i++)
+    {
+        indices[i] = GetIndex(i);
+        if (indices[i] >= m_vertexCount)
+            return;
+    }
+
+    if (pBefore != nullptr)
+        *pBefore = MeshOptimizer::AnalyzeVertexCache(indices.data(), indexCount, m_vertexCount);
+
+    auto remapStreams = [&](const std::vector<uint32_t>& remap, uint32_t vertexCount) {
+        for (auto& pAttribute : m_pAttributes)
+        {
+            uint32_t stride = pAttribute->size / m_vertexCount;
+            char* pData = new char[vertexCount * stride];
+
+            MeshOptimizer::RemapVertices(pAttribute->pData.get(), stride, m_vertexCount, remap, pData);
+
+            pAttribute->pData = std::shared_ptr<char>(pData, std::default_delete<char[]>());
+            pAttribute->size = vertexCount * stride;
+        }
+
+        m_vertexCount = vertexCount;
+    };
+
+    std::vector<MeshOptimizer::VertexStream> streams;
+    for (const auto& pAttribute : m_pAttributes)
+        streams.push_back(MeshOptimizer::VertexStream { pAttribute->pData.get(), pAttribute->size / m_vertexCount });
+
+    std::vector<uint32_t> remap;
+    uint32_t vertexCount = MeshOptimizer::WeldVertices(streams, m_vertexCount, remap);
+    remapStreams(remap, vertexCount);
+    for (auto& index : indices)
+        index = remap[index];
+
+    MeshOptimizer::OptimizeVertexCache(indices.data(), indexCount, m_vertexCount);
+
+    // Quantized positions are left in cache order, the overdraw pass needs the float ones.
+    for (const auto& pAttribute : m_pAttributes)
+    {
+        if (pAttribute->semanticType == Attribute::ESemanticType::Position && pAttribute->format == Attribute::EFormat::Float3)
+            MeshOptimizer::OptimizeOverdraw(indices.data(), indexCount, reinterpret_cast<const float3*>(pAttribute->pData.get()), m_vertexCount);
+    }
+
+    // Also drops vertices no triangle references.
+    vertexCount = MeshOptimizer::OptimizeVertexFetch(indices.data(), indexCount, m_vertexCount, remap);
+    remapStreams(remap, vertexCount);
+
+    if (pAfter != nullptr)
+        *pAfter = MeshOptimizer::AnalyzeVertexCache(indices.data(), indexCount, m_vertexCount);
+
+    if (m_vertexCount < 65536)
+    {
+        char* pData = new char[indexCount * sizeof(uint16_t)];
+        uint16_t* pIndices = reinterpret_cast<uint16_t*>(pData);
+        for (uint32_t i = 0; i < indexCount; i++)
+            pIndices[i] = (uint16_t)indices[i];
+
+        AttachIndexData(std::shared_ptr<char>(pData, std::default_delete<char[]>()), indexCount * sizeof(uint16_t), indexCount);
+    }
+    else
+        AttachIndexData(reinterpret_cast<const char*>(indices.data()), indexCount * sizeof(uint32_t), indexCount);
+}
+
+void Mesh::GenerateLods(uint32_t lodCount)
+{
+    if (m_bQuantized || m_indexCount == 0)
+        return;
+
+    const float3* pPositions = nullptr;
+    const float3* pNormals = nullptr;
+    const float2* pTexcoords = nullptr;
+    for (const auto& pAttribute : m_pAttributes)
+    {
+        if (pAttribute->semanticType == Attribute::ESemanticType::Position && pAttribute->format == Attribute::EFormat::Float3)
+            pPositions = reinterpret_cast<const float3*>(pAttribute->pData.get());
+        else if (pAttribute->semanticType == Attribute::ESemanticType::Normal && pAttribute->format == Attribute::EFormat::Float3)
+            pNormals = reinterpret_cast<const float3*>(pAttribute->pData.get());
+        else if (pAttribute->semanticType == Attribute::ESemanticType::Texcoord0 && pAttribute->format == Attribute::EFormat::Float2)
+            pTexcoords = reinterpret_cast<const float2*>(pAttribute->pData.get());
+    }
+
+    if (pPositions == nullptr)
+        return;
+
+    std::vector<uint32_t> indices(m_indexCount);
+    for (uint32_t i = 0; i < m_indexCount; i++)
+        indices[i] = GetIndex(i);
+
+    uint32_t triangleCount = m_indexCount / 3;
+    uint32_t levelCount = 0;
+    while (levelCount + 1 < lodCount && (triangleCount >> (levelCount + 1)) >= MIN_LOD_TRIANGLES)
+        levelCount++;
+
+    // Every level is simplified from LOD 0, so they build in parallel and errors do not stack up.
+    std::vector<std::vector<uint32_t>> levels(levelCount);
+    std::vector<float> errors(levelCount, 0.0f);
+    gpGlobal->GetJobSystem().ParallelFor(levelCount, 1, [&](uint32_t begin, uint32_t end) {
+        for (uint32_t level = begin; level < end; level++)
+        {
+            auto& lodIndices = levels[level];
+            lodIndices.resize(m_indexCount);
+
+            uint32_t target = (triangleCount >> (level + 1)) * 3;
+            uint32_t count = MeshSimplifier::Simplify(indices.data(), m_indexCount, pPositions, pNormals, pTexcoords, m_vertexCount, target, lodIndices.data(), errors[level]);
+            lodIndices.resize(count);
+
+            MeshOptimizer::OptimizeVertexCache(lodIndices.data(), count, m_vertexCount);
+        }
+    });
+
+    m_lods.clear();
+    m_lods.push_back(MeshLod { 0, m_indexCount, 0.0f });
+
+    // Stop where the simplifier got stuck on locked vertices.
+    uint32_t totalCount = m_indexCount;
+    for (uint32_t level = 0; level < levelCount; level++)
+    {
+        uint32_t count = (uint32_t)levels[level].size();
+        if (count == 0 || count > m_lods.back().indexCount * 9 / 10)
+            break;
+
+        m_lods.push_back(MeshLod { totalCount, count, std::max(errors[level], m_lods.back().error) });
+        totalCount += count;
+    }
+
+    if (m_lods.size() == 1)
+        return;
+
+    // Same index width as LOD 0, the levels follow it in one allocation.
+    uint32_t stride = m_indexSize == m_indexCount * sizeof(uint16_t) ? sizeof(uint16_t) : sizeof(uint32_t);
+    char* pData = new char[totalCount * stride];
+    for (uint32_t l = 0; l < m_lods.size(); l++)
+    {
+        const uint32_t* pSrc = l == 0 ? indices.data() : levels[l - 1].data();
+        for (uint32_t i = 0; i < m_lods[l].indexCount; i++)
+        {
+            uint32_t index = m_lods[l].indexOffset + i;
+            if (stride == sizeof(uint16_t))
+                reinterpret_cast<uint16_t*>(pData)[index] = (uint16_t)pSrc[i];
+            else
+                reinterpret_cast<uint32_t*>(pData)[index] = pSrc[i];
+        }
+    }
+
+    m_pIndexData = std::shared_ptr<char>(pData, std::default_delete<char[]>());
+}
+
+uint32_t Mesh::GetLodCount() const
+{
+    return std::max((uint32_t)m_lods.size(), 1u);
+}
+
+MeshLod Mesh::GetLod(uint32_t lod) const
+{
+    if (lod < m_lods.size())
+        return m_lods[lod];
+
+    return MeshLod { 0, m_indexCount, 0.0f };
+}
+
+uint32_t Mesh::SelectLod(const MeshViewParams& params, float maxPixelError) const
+{
+    if (m_lods.size() <= 1 || params.viewportSize.y <= 0.0f)
+        return 0;
+
+    // Mesh units grow with the largest axis scale of the world matrix.
+    const float4x4& w = params.world;
+    float scale = sqrtf(std::max(std::max(Vec::LengthSquared(float3(w.x00, w.x01, w.x02)), Vec::LengthSquared(float3(w.x10, w.x11, w.x12))),
+                                 Vec::LengthSquared(float3(w.x20, w.x21, w.x22))));
+
+    // Clip w is the view depth, measured to the closest point of the bounding sphere.
+    float3 center = m_bounds.Center();
+    float4 worldCenter = Mat::Mul(float4(center.x, center.y, center.z, 1.0f), w);
+    float distance = Mat::Mul(worldCenter, params.viewProj).w - m_bounds.Radius() * scale;
+    if (distance <= 0.0f)
+        return 0;
+
+    // The view part of viewProj is a rotation, so the second column keeps the projection's y scale.
+    const float4x4& vp = params.viewProj;
+    float projectionScale = Vec::Length(float3(vp.x01, vp.x11, vp.x21));
+    float pixelsPerUnit = projectionScale * params.viewportSize.y * 0.5f / distance;
+
+    uint32_t lod = 0;
+    while (lod + 1 < m_lods.size() && m_lods[lod + 1].error * scale * pixelsPerUnit <= maxPixelError)
+        lod++;
+
+    return lod;
+}
+
+void Mesh::GenerateMeshlets()
+{
+    if (m_bQuantized)
+        return;
+
+    const float3* pPositions = nullptr;
+    for (const auto& pAttribute : m_pAttributes)
+    {
+        if (pAttribute->semanticType == Attribute::ESemanticType::Position && pAttribute->format == Attribute::EFormat::Float3)
+            pPositions = reinterpret_cast<const float3*>(pAttribute->pData.get());
+    }
+
+    if (pPositions == nullptr)
+        return;
+
+    uint32_t indexCount = m_pIndexData != nullptr ? m_indexCount : m_vertexCount;
+    std::vector<uint32_t> indices(indexCount);
+    for (uint32_t i = 0; i < indexCount; i++)
+        indices[i] = GetIndex(i);
+
+    auto pMeshlets = std::make_shared<MeshletSet>();
+    if (pMeshlets->Build(pPositions, m_vertexCount, indices.data(), indexCount))
+        m_pMeshlets = pMeshlets;
+}
+
+bool Mesh::CullMeshlets(const MeshViewParams& params, std::vector<uint32_t>& indices) const
+{
+    if (m_pMeshlets == nullptr)
+        return false;
+
+    indices.clear();
+    m_pMeshlets->Cull(params, indices);
+
+    return true;
+}
+
+void Mesh::Quantize()
+{
+    if (m_bQuantized)
+        return;
+
+    auto repack = [&](std::shared_ptr<Attribute>& pAttribute, Attribute::EFormat format, uint32_t stride) -> char* {
+        uint32_t size = m_vertexCount * stride;
+        char* pData = new char[size];
+
+        pAttribute->format = format;
+        pAttribute->pData = std::shared_ptr<char>(pData, std::default_delete<char[]>());
+        pAttribute->size = size;
+
+        return pData;
+    };
+
+    // Positions first, the tangent handedness is stored in their w.
+    std::vector<PackedPosition> handedness;
+    PackedPosition* pPositions = nullptr;
+    for (auto& pAttribute : m_pAttributes)
+    {
+        if (pAttribute->semanticType != Attribute::ESemanticType::Position || pAttribute->format != Attribute::EFormat::Float3)
+            continue;
+
+        auto pSrc = pAttribute->pData;
+        pPositions = reinterpret_cast<PackedPosition*>(repack(pAttribute, Attribute::EFormat::UNorm16x4, sizeof(PackedPosition)));
+        VertexPacking::PackPositions(reinterpret_cast<const float3*>(pSrc.get()), m_vertexCount, m_bounds, pPositions);
+    }
+
+    if (pPositions == nullptr)
+    {
+        handedness.resize(m_vertexCount);
+        pPositions = handedness.data();
+    }
+
+    for (auto& pAttribute : m_pAttributes)
+    {
+        auto pSrc = pAttribute->pData;
+        switch (pAttribute->semanticType)
+        {
+        case Attribute::ESemanticType::Normal:
+            if (pAttribute->format != Attribute::EFormat::Float3)
+                break;
+            VertexPacking::PackNormals(reinterpret_cast<const float3*>(pSrc.get()), m_vertexCount,
+                                       reinterpret_cast<PackedNormal*>(repack(pAttribute, Attribute::EFormat::SNorm16x2, sizeof(PackedNormal))));
+            break;
+        case Attribute::ESemanticType::Tangent:
+            if (pAttribute->format != Attribute::EFormat::Float4)
+                break;
+            VertexPacking::PackTangents(reinterpret_cast<const float4*>(pSrc.get()), m_vertexCount,
+                                        reinterpret_cast<PackedNormal*>(repack(pAttribute, Attribute::EFormat::SNorm16x2, sizeof(PackedNormal))), pPositions);
+            break;
+        case Attribute::ESemanticType::Texcoord0:
+        case Attribute::ESemanticType::Texcoord1:
+        case Attribute::ESemanticType::Texcoord2:
+            if (pAttribute->format != Attribute::EFormat::Float2)
+                break;
+            VertexPacking::PackTexcoords(reinterpret_cast<const float2*>(pSrc.get()), m_vertexCount,
+                                         reinterpret_cast<PackedTexcoord*>(repack(pAttribute, Attribute::EFormat::Half2, sizeof(PackedTexcoord))));
+            break;
+        default:
+            break;
+        }
+    }
+
+    m_bQuantized = true;
+}
+
+bool Mesh::IsQuantized() const
+{
+    return m_bQuantized;
+}
+
+Attribute::EFormat Mesh::SourceFormat(Attribute::ESemanticType type)
+{
+    switch (type)
+    {
+    case Attribute::ESemanticType::Position:
+    case Attribute::ESemanticType::Normal:
+        return Attribute::EFormat::Float3;
+    case Attribute::ESemanticType::Tangent:
+    case Attribute::ESemanticType::Color0:
+    case Attribute::ESemanticType::Weights0:
+        return Attribute::EFormat::Float4;
+    case Attribute::ESemanticType::Joints0:
+        return Attribute::EFormat::UInt16x4;
+    default:
+        return Attribute::EFormat::Float2;
+    }
 }
\ No newline at end of file
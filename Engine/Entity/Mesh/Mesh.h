@@ -5,11 +5,15 @@
 
 #include "IMesh.h"
 #include "IRenderable.h"
+#include "MeshletSet.h"
 
 namespace Engine
 {
     class Mesh : public IMesh, public IRenderable
     {
+        // Writes and restores the cooked state as is.
+        friend class MeshFile;
+
     public:
         Mesh();
         virtual ~Mesh();
@@ -23,8 +27,27 @@ namespace Engine
         const uint32_t VertexCount() const override;
         const uint32_t IndexCount() const override;
 
+        const Box3& GetBounds() const override;
+
         void AttachVertexData(const char array[], const uint32_t size, const uint32_t count, Attribute::ESemanticType type, std::string name) override;
         void AttachIndexData(const char array[], const uint32_t size, const uint32_t count) override;
+        void AttachVertexData(std::shared_ptr<char> pData, const uint32_t size, const uint32_t count, Attribute::ESemanticType type, std::string name) override;
+        void AttachIndexData(std::shared_ptr<char> pData, const uint32_t size, const uint32_t count) override;
+
+        void GenerateTangents() override;
+
+        void Optimize(VertexCacheStatistics* pBefore = nullptr, VertexCacheStatistics* pAfter = nullptr) override;
+
+        void GenerateLods(uint32_t lodCount) override;
+        uint32_t GetLodCount() const override;
+        MeshLod GetLod(uint32_t lod) const override;
+        uint32_t SelectLod(const MeshViewParams& params, float maxPixelError) const override;
+
+        void GenerateMeshlets() override;
+        bool CullMeshlets(const MeshViewParams& params, std::vector<uint32_t>& indices) const override;
+
+        void Quantize() override;
+        bool IsQuantized() const override;
 
     protected:
         template<typename T>
@@ -32,6 +55,14 @@ namespace Engine
         template<typename T>
         void AttachIndexData(const T array[], const uint32_t count);
 
+        void UpdateBounds(const float3 positions[], const uint32_t count);
+        uint32_t GetIndex(const uint32_t i) const;
+
+        static Attribute::EFormat SourceFormat(Attribute::ESemanticType type);
+
+        // Every level halves the triangles of the previous one down to this.
+        constexpr static uint32_t MIN_LOD_TRIANGLES = 64;
+
     protected:
         std::vector<std::shared_ptr<Attribute>> m_pAttributes;
         std::shared_ptr<char> m_pIndexData;
@@ -39,36 +70,24 @@ namespace Engine
 
         uint32_t m_vertexCount;
         uint32_t m_indexCount;
+
+        Box3 m_bounds;
+        bool m_bQuantized;
+
+        std::shared_ptr<MeshletSet> m_pMeshlets;
+        // Empty until GenerateLods, LOD 0 first.
+        std::vector<MeshLod> m_lods;
     };
 
     template<typename T>
     void Mesh::AttachVertexData(const T array[], const uint32_t count, Attribute::ESemanticType type, std::string name)
     {
-        uint32_t size = count * sizeof(T);
-        char* pData = new char[size];
-
-        memcpy(pData, array, size);
-
-        auto pAttribute = std::make_shared<Attribute>();
-        pAttribute->semanticType = type;
-        pAttribute->name = name;
-        pAttribute->pData = std::shared_ptr<char>(pData);
-        pAttribute->size = size;
-
-        m_pAttributes.emplace_back(pAttribute);
-        m_vertexCount = count;
+        AttachVertexData(reinterpret_cast<const char*>(array), count * sizeof(T), count, type, name);
     }
 
     template<typename T>
     void Mesh::AttachIndexData(const T array[], const uint32_t count)
     {
-        uint32_t size = count * sizeof(T);
-        char* pData = new char[size];
-
-        memcpy(pData, array, size);
-
-        m_pIndexData = std::shared_ptr<char>(pData);
-        m_indexSize = size;
-        m_indexCount = count;
+        AttachIndexData(reinterpret_cast<const char*>(array), count * sizeof(T), count);
     }
-}
+}
\ No newline at end of file
@@ -0,0 +1,667 @@
+#include <assert.h>
+#include <algorithm>
+#include <cfloat>
+#include <cstring>
+#include <mutex>
+
+#include "Global.h"
+#include "MeshBVH.h"
+#include "VertexPacking.h"
+
+using namespace Engine;
+
+namespace
+{
+    const uint32_t BIN_COUNT = 16;
+    const uint32_t PARALLEL_SUBTREE_SIZE = 4096;
+    const uint32_t PARALLEL_RANGE_SIZE = 65536;
+    const uint32_t PARALLEL_GRAIN = 16384;
+
+    struct SplitBins
+    {
+        Box3 box[3][BIN_COUNT];
+        uint32_t count[3][BIN_COUNT];
+
+        SplitBins()
+        {
+            memset(count, 0, sizeof(count));
+        }
+
+        void Merge(const SplitBins& bins)
+        {
+            for (uint32_t axis = 0; axis < 3; axis++)
+            {
+                for (uint32_t i = 0; i < BIN_COUNT; i++)
+                {
+                    box[axis][i].Expand(bins.box[axis][i]);
+                    count[axis][i] += bins.count[axis][i];
+                }
+            }
+        }
+    };
+
+    inline uint32_t GetBin(float centroid, float min, float scale)
+    {
+        return std::min(BIN_COUNT - 1, (uint32_t)std::max(0.0f, (centroid - min) * scale));
+    }
+}
+
+MeshBVH::MeshBVH() : m_buildNodeCount(0)
+{
+}
+
+bool MeshBVH::Build(const IMesh* pMesh)
+{
+    const float3* pPositions = nullptr;
+    std::vector<float3> unpacked;
+    for (auto& pAttribute : pMesh->GetAttributes())
+    {
+        if (pAttribute->semanticType != Attribute::ESemanticType::Position)
+            continue;
+
+        if (pAttribute->format == Attribute::EFormat::UNorm16x4)
+        {
+            unpacked.resize(pMesh->VertexCount());
+            VertexPacking::UnpackPositions(reinterpret_cast<const PackedPosition*>(pAttribute->pData.get()), pMesh->VertexCount(), pMesh->GetBounds(), unpacked.data());
+            pPositions = unpacked.data();
+        }
+        else
+        {
+            pPositions = reinterpret_cast<const float3*>(pAttribute->pData.get());
+        }
+    }
+
+    if (pPositions == nullptr)
+        return false;
+
+    std::vector<uint32_t> indices;
+    auto indexCount = pMesh->IndexCount();
+    if (indexCount == 0)
+    {
+        indices.resize(pMesh->VertexCount());
+        for (uint32_t i = 0; i < indices.size(); i++)
+            indices[i] = i;
+    }
+    else
+    {
+        indices.resize(indexCount);
+        auto pIndexData = pMesh->GetIndexData().get();
+        if (pMesh->IndexSize() / indexCount == sizeof(uint16_t))
+        {
+            auto pIndex16 = reinterpret_cast<const uint16_t*>(pIndexData);
+            for (uint32_t i = 0; i < indexCount; i++)
+                indices[i] = pIndex16[i];
+        }
+        else
+        {
+            memcpy(indices.data(), pIndexData, indexCount * sizeof(uint32_t));
+        }
+    }
+
+    return Build(pPositions, pMesh->VertexCount(), indices.data(), (uint32_t)indices.size());
+}
+
+bool MeshBVH::Build(const float3* pPositions, uint32_t vertexCount, const uint32_t* pIndices, uint32_t indexCount)
+{
+    m_nodes.clear();
+    m_triangles.clear();
+    m_bounds.Clear();
+
+    uint32_t triangleCount = indexCount / 3;
+    if (triangleCount == 0)
+        return false;
+
+    auto& jobSystem = gpGlobal->GetJobSystem();
+
+    m_primBoxes.resize(triangleCount);
+    m_primCentroids.resize(triangleCount);
+    m_primIndices.resize(triangleCount);
+
+    jobSystem.ParallelFor(triangleCount, PARALLEL_GRAIN, [&](uint32_t begin, uint32_t end) {
+        for (uint32_t i = begin; i < end; i++)
+        {
+            auto& box = m_primBoxes[i];
+            box.Clear();
+            for (uint32_t k = 0; k < 3; k++)
+            {
+                assert(pIndices[i * 3 + k] < vertexCount);
+                box.Expand(pPositions[pIndices[i * 3 + k]]);
+            }
+            m_primCentroids[i] = box.Center();
+            m_primIndices[i] = i;
+        }
+    });
+
+    m_buildNodes.resize(triangleCount * 2 - 1);
+    m_buildNodeCount = 1;
+    BuildRecursive(0, 0, triangleCount, 0);
+
+    // Lay the triangles out in leaf order so a leaf reads one contiguous range.
+    m_triangles.resize(triangleCount);
+    jobSystem.ParallelFor(triangleCount, PARALLEL_GRAIN, [&](uint32_t begin, uint32_t end) {
+        for (uint32_t i = begin; i < end; i++)
+        {
+            auto index = m_primIndices[i];
+            auto& triangle = m_triangles[i];
+            triangle.v0 = pPositions[pIndices[index * 3 + 0]];
+            triangle.v1 = pPositions[pIndices[index * 3 + 1]];
+            triangle.v2 = pPositions[pIndices[index * 3 + 2]];
+            triangle.index = index;
+        }
+    });
+
+    m_bounds = m_buildNodes[0].box;
+    m_nodes.reserve(m_buildNodeCount / 2 + 1);
+    Collapse(0);
+
+    m_primBoxes = std::vector<Box3>();
+    m_primCentroids = std::vector<float3>();
+    m_primIndices = std::vector<uint32_t>();
+    m_buildNodes = std::vector<BuildNode>();
+
+    return true;
+}
+
+bool MeshBVH::Intersect(const float3& origin, const float3& dir, float maxDistance, MeshRayHit& hit) const
+{
+    Ray ray;
+    SetupRay(origin, dir, ray);
+    return Traverse<false>(ray, maxDistance, hit);
+}
+
+bool MeshBVH::Occluded(const float3& origin, const float3& dir, float maxDistance) const
+{
+    Ray ray;
+    SetupRay(origin, dir, ray);
+
+    MeshRayHit hit;
+    return Traverse<true>(ray, maxDistance, hit);
+}
+
+const Box3& MeshBVH::GetBounds() const
+{
+    return m_bounds;
+}
+
+uint32_t MeshBVH::GetTriangleCount() const
+{
+    return (uint32_t)m_triangles.size();
+}
+
+uint32_t MeshBVH::GetNodeCount() const
+{
+    return (uint32_t)m_nodes.size();
+}
+
+void MeshBVH::BuildRecursive(uint32_t nodeIndex, uint32_t begin, uint32_t end, uint32_t depth)
+{
+    auto& node = m_buildNodes[nodeIndex];
+
+    Box3 centroidBox;
+    ComputeBounds(begin, end, node.box, centroidBox);
+    node.left = 0;
+    node.first = begin;
+    node.count = end - begin;
+
+    if (node.count == 1 || depth >= MAX_DEPTH)
+        return;
+
+    uint32_t axis, bin;
+    float cost;
+    bool bSplit = FindSplit(begin, end, node.box, centroidBox, axis, bin, cost);
+
+    // SAH cost is in units of one triangle test, so a leaf costs its triangle count.
+    uint32_t mid = begin;
+    if (bSplit && (cost < (float)node.count || node.count > MAX_LEAF_SIZE))
+    {
+        float min = centroidBox.mMin[axis];
+        float scale = (float)BIN_COUNT / (centroidBox.mMax[axis] - min);
+
+        auto it = std::partition(m_primIndices.begin() + begin, m_primIndices.begin() + end, [&](uint32_t index) {
+            return GetBin(m_primCentroids[index][axis], min, scale) < bin;
+        });
+        mid = (uint32_t)(it - m_primIndices.begin());
+    }
+    else if (node.count <= MAX_LEAF_SIZE)
+    {
+        return;
+    }
+
+    if (mid == begin || mid == end)
+    {
+        if (node.count <= MAX_LEAF_SIZE)
+            return;
+
+        // Every centroid landed in one bin, fall back to a median split on the widest axis.
+        auto size = centroidBox.Size();
+        axis = size.x > size.y ? (size.x > size.z ? 0 : 2) : (size.y > size.z ? 1 : 2);
+        mid = begin + node.count / 2;
+        std::nth_element(m_primIndices.begin() + begin, m_primIndices.begin() + mid, m_primIndices.begin() + end, [&](uint32_t a, uint32_t b) {
+            return m_primCentroids[a][axis] < m_primCentroids[b][axis];
+        });
+    }
+
+    uint32_t left = m_buildNodeCount.fetch_add(2);
+    node.left = left;
+    node.count = 0;
+
+    if (end - begin >= PARALLEL_SUBTREE_SIZE)
+    {
+        gpGlobal->GetJobSystem().ParallelFor(2, 1, [&](uint32_t first, uint32_t last) {
+            for (uint32_t child = first; child < last; child++)
+            {
+                if (child == 0)
+                    BuildRecursive(left, begin, mid, depth + 1);
+                else
+                    BuildRecursive(left + 1, mid, end, depth + 1);
+            }
+        });
+    }
+    else
+    {
+        BuildRecursive(left, begin, mid, depth + 1);
+        BuildRecursive(left + 1, mid, end, depth + 1);
+    }
+}
+
+void MeshBVH::ComputeBounds(uint32_t begin, uint32_t end, Box3& box, Box3& centroidBox) const
+{
+    auto computeRange = [&](uint32_t rangeBegin, uint32_t rangeEnd, Box3& rangeBox, Box3& rangeCentroidBox) {
+        for (uint32_t i = rangeBegin; i < rangeEnd; i++)
+        {
+            auto index = m_primIndices[i];
+            rangeBox.Expand(m_primBoxes[index]);
+            rangeCentroidBox.Expand(m_primCentroids[index]);
+        }
+    };
+
+    box.Clear();
+    centroidBox.Clear();
+
+    if (end - begin < PARALLEL_RANGE_SIZE)
+    {
+        computeRange(begin, end, box, centroidBox);
+        return;
+    }
+
+    std::mutex mutex;
+    gpGlobal->GetJobSystem().ParallelFor(end - begin, PARALLEL_GRAIN, [&](uint32_t rangeBegin, uint32_t rangeEnd) {
+        Box3 rangeBox, rangeCentroidBox;
+        computeRange(begin + rangeBegin, begin + rangeEnd, rangeBox, rangeCentroidBox);
+
+        std::lock_guard<std::mutex> lock(mutex);
+        box.Expand(rangeBox);
+        centroidBox.Expand(rangeCentroidBox);
+    });
+}
+
+bool MeshBVH::FindSplit(uint32_t begin, uint32_t end, const Box3& box, const Box3& centroidBox, uint32_t& axis, uint32_t& bin, float& cost) const
+{
+    float min[3], scale[3];
+    for (uint32_t k = 0; k < 3; k++)
+    {
+        min[k] = centroidBox.mMin[k];
+        float extent = centroidBox.mMax[k] - centroidBox.mMin[k];
+        scale[k] = extent > 0.0f ? (float)BIN_COUNT / extent : 0.0f;
+    }
+
+    auto fillBins = [&](uint32_t rangeBegin, uint32_t rangeEnd, SplitBins& bins) {
+        for (uint32_t i = rangeBegin; i < rangeEnd; i++)
+        {
+            auto index = m_primIndices[i];
+            auto& centroid = m_primCentroids[index];
+            for (uint32_t k = 0; k < 3; k++)
+            {
+                auto b = GetBin(centroid[k], min[k], scale[k]);
+                bins.box[k][b].Expand(m_primBoxes[index]);
+                bins.count[k][b]++;
+            }
+        }
+    };
+
+    SplitBins bins;
+    if (end - begin < PARALLEL_RANGE_SIZE)
+    {
+        fillBins(begin, end, bins);
+    }
+    else
+    {
+        std::mutex mutex;
+        gpGlobal->GetJobSystem().ParallelFor(end - begin, PARALLEL_GRAIN, [&](uint32_t rangeBegin, uint32_t rangeEnd) {
+            SplitBins rangeBins;
+            fillBins(begin + rangeBegin, begin + rangeEnd, rangeBins);
+
+            std::lock_guard<std::mutex> lock(mutex);
+            bins.Merge(rangeBins);
+        });
+    }
+
+    float area = box.SurfaceArea();
+    float invArea = area > 0.0f ? 1.0f / area : 0.0f;
+
+    bool bFound = false;
+    cost = FLT_MAX;
+    for (uint32_t k = 0; k < 3; k++)
+    {
+        if (scale[k] == 0.0f)
+            continue;
+
+        // Sweep from the right to get the right hand area and count of every split plane.
+        float rightArea[BIN_COUNT];
+        uint32_t rightCount[BIN_COUNT];
+        Box3 rightBox;
+        uint32_t count = 0;
+        for (uint32_t i = BIN_COUNT - 1; i > 0; i--)
+        {
+            rightBox.Expand(bins.box[k][i]);
+            count += bins.count[k][i];
+            rightArea[i] = rightBox.SurfaceArea();
+            rightCount[i] = count;
+        }
+
+        Box3 leftBox;
+        count = 0;
+        for (uint32_t i = 1; i < BIN_COUNT; i++)
+        {
+            leftBox.Expand(bins.box[k][i - 1]);
+            count += bins.count[k][i - 1];
+            if (count == 0 || rightCount[i] == 0)
+                continue;
+
+            float splitCost = 1.0f + (leftBox.SurfaceArea() * count + rightArea[i] * rightCount[i]) * invArea;
+            if (splitCost < cost)
+            {
+                cost = splitCost;
+                axis = k;
+                bin = i;
+                bFound = true;
+            }
+        }
+    }
+
+    return bFound;
+}
+
+uint32_t MeshBVH::Collapse(uint32_t buildIndex)
+{
+    uint32_t nodeIndex = (uint32_t)m_nodes.size();
+    m_nodes.emplace_back();
+
+    uint32_t children[WIDTH];
+    uint32_t childCount = 0;
+
+    auto& buildNode = m_buildNodes[buildIndex];
+    if (buildNode.count != 0)
+    {
+        children[childCount++] = buildIndex;
+    }
+    else
+    {
+        children[childCount++] = buildNode.left;
+        children[childCount++] = buildNode.left + 1;
+    }
+
+    // Open the inner child with the largest surface area until the node is full.
+    while (childCount < WIDTH)
+    {
+        int32_t best = -1;
+        float bestArea = -1.0f;
+        for (uint32_t i = 0; i < childCount; i++)
+        {
+            auto& child = m_buildNodes[children[i]];
+            if (child.count == 0 && child.box.SurfaceArea() > bestArea)
+            {
+                bestArea = child.box.SurfaceArea();
+                best = (int32_t)i;
+            }
+        }
+
+        if (best < 0)
+            break;
+
+        auto left = m_buildNodes[children[best]].left;
+        children[best] = left;
+        children[childCount++] = left + 1;
+    }
+
+    for (uint32_t i = 0; i < WIDTH; i++)
+    {
+        if (i >= childCount)
+        {
+            auto& node = m_nodes[nodeIndex];
+            for (uint32_t k = 0; k < 3; k++)
+            {
+                node.bounds[k][i] = FLT_MAX;
+                node.bounds[k + 3][i] = -FLT_MAX;
+            }
+            node.child[i] = 0;
+            node.count[i] = INVALID_COUNT;
+            continue;
+        }
+
+        auto& child = m_buildNodes[children[i]];
+        uint32_t childIndex = child.count != 0 ? child.first : Collapse(children[i]);
+
+        // Collapse may grow m_nodes, so only take the reference afterwards.
+        auto& node = m_nodes[nodeIndex];
+        for (uint32_t k = 0; k < 3; k++)
+        {
+            node.bounds[k][i] = child.box.mMin[k];
+            node.bounds[k + 3][i] = child.box.mMax[k];
+        }
+        node.child[i] = childIndex;
+        node.count[i] = child.count;
+    }
+
+    return nodeIndex;
+}
+
+void MeshBVH::SetupRay(const float3& origin, const float3& dir, Ray& ray) const
+{
+    ray.origin = origin;
+    ray.dir = dir;
+    ray.invDir = float3(1.0f / dir.x, 1.0f / dir.y, 1.0f / dir.z);
+
+    ray.nearX = dir.x >= 0.0f ? 0 : 3;
+    ray.nearY = dir.y >= 0.0f ? 1 : 4;
+    ray.nearZ = dir.z >= 0.0f ? 2 : 5;
+
+    // Shear and scale the ray into a space where it runs along +z.
+    float absX = std::abs(dir.x), absY = std::abs(dir.y), absZ = std::abs(dir.z);
+    ray.kz = absX > absY ? (absX > absZ ? 0 : 2) : (absY > absZ ? 1 : 2);
+    ray.kx = (ray.kz + 1) % 3;
+    ray.ky = (ray.kx + 1) % 3;
+    if (dir[ray.kz] < 0.0f)
+        std::swap(ray.kx, ray.ky);
+
+    ray.sx = dir[ray.kx] / dir[ray.kz];
+    ray.sy = dir[ray.ky] / dir[ray.kz];
+    ray.sz = 1.0f / dir[ray.kz];
+}
+
+uint32_t MeshBVH::IntersectNode(const Node& node, const Ray& ray, float maxDistance, float distance[WIDTH]) const
+{
+    int farX = ray.nearX == 0 ? 3 : 0;
+    int farY = ray.nearY == 1 ? 4 : 1;
+    int farZ = ray.nearZ == 2 ? 5 : 2;
+
+    // Operands are ordered so NaNs from 0 * inf drop out of the min/max reductions. The far
+    // distance is padded by 1 + 2 * gamma(3) so rounding can not reject a ray that grazes the box
+    // corner shared by neighbouring triangles (Ize, "Robust BVH Ray Traversal").
+    const float farScale = 1.0000004f;
+#if defined(MATH_SIMD_AVX)
+    __m256 originX = _mm256_set1_ps(ray.origin.x);
+    __m256 originY = _mm256_set1_ps(ray.origin.y);
+    __m256 originZ = _mm256_set1_ps(ray.origin.z);
+    __m256 invDirX = _mm256_set1_ps(ray.invDir.x);
+    __m256 invDirY = _mm256_set1_ps(ray.invDir.y);
+    __m256 invDirZ = _mm256_set1_ps(ray.invDir.z);
+
+    __m256 nearX = _mm256_mul_ps(_mm256_sub_ps(_mm256_load_ps(node.bounds[ray.nearX]), originX), invDirX);
+    __m256 nearY = _mm256_mul_ps(_mm256_sub_ps(_mm256_load_ps(node.bounds[ray.nearY]), originY), invDirY);
+    __m256 nearZ = _mm256_mul_ps(_mm256_sub_ps(_mm256_load_ps(node.bounds[ray.nearZ]), originZ), invDirZ);
+    __m256 farXv = _mm256_mul_ps(_mm256_sub_ps(_mm256_load_ps(node.bounds[farX]), originX), invDirX);
+    __m256 farYv = _mm256_mul_ps(_mm256_sub_ps(_mm256_load_ps(node.bounds[farY]), originY), invDirY);
+    __m256 farZv = _mm256_mul_ps(_mm256_sub_ps(_mm256_load_ps(node.bounds[farZ]), originZ), invDirZ);
+
+    __m256 tmin = _mm256_max_ps(nearX, _mm256_max_ps(nearY, _mm256_max_ps(nearZ, _mm256_setzero_ps())));
+    __m256 tmax = _mm256_min_ps(farXv, _mm256_min_ps(farYv, _mm256_min_ps(farZv, _mm256_set1_ps(maxDistance))));
+    tmax = _mm256_mul_ps(tmax, _mm256_set1_ps(farScale));
+
+    _mm256_storeu_ps(distance, tmin);
+    return (uint32_t)_mm256_movemask_ps(_mm256_cmp_ps(tmin, tmax, _CMP_LE_OQ));
+#elif defined(MATH_SIMD_SSE)
+    __m128 originX = _mm_set1_ps(ray.origin.x);
+    __m128 originY = _mm_set1_ps(ray.origin.y);
+    __m128 originZ = _mm_set1_ps(ray.origin.z);
+    __m128 invDirX = _mm_set1_ps(ray.invDir.x);
+    __m128 invDirY = _mm_set1_ps(ray.invDir.y);
+    __m128 invDirZ = _mm_set1_ps(ray.invDir.z);
+
+    __m128 nearX = _mm_mul_ps(_mm_sub_ps(_mm_load_ps(node.bounds[ray.nearX]), originX), invDirX);
+    __m128 nearY = _mm_mul_ps(_mm_sub_ps(_mm_load_ps(node.bounds[ray.nearY]), originY), invDirY);
+    __m128 nearZ = _mm_mul_ps(_mm_sub_ps(_mm_load_ps(node.bounds[ray.nearZ]), originZ), invDirZ);
+    __m128 farXv = _mm_mul_ps(_mm_sub_ps(_mm_load_ps(node.bounds[farX]), originX), invDirX);
+    __m128 farYv = _mm_mul_ps(_mm_sub_ps(_mm_load_ps(node.bounds[farY]), originY), invDirY);
+    __m128 farZv = _mm_mul_ps(_mm_sub_ps(_mm_load_ps(node.bounds[farZ]), originZ), invDirZ);
+
+    __m128 tmin = _mm_max_ps(nearX, _mm_max_ps(nearY, _mm_max_ps(nearZ, _mm_setzero_ps())));
+    __m128 tmax = _mm_min_ps(farXv, _mm_min_ps(farYv, _mm_min_ps(farZv, _mm_set1_ps(maxDistance))));
+    tmax = _mm_mul_ps(tmax, _mm_set1_ps(farScale));
+
+    _mm_storeu_ps(distance, tmin);
+    return (uint32_t)_mm_movemask_ps(_mm_cmple_ps(tmin, tmax));
+#else
+    uint32_t mask = 0;
+    for (uint32_t i = 0; i < WIDTH; i++)
+    {
+        float tmin = std::max(0.0f, std::max((node.bounds[ray.nearX][i] - ray.origin.x) * ray.invDir.x,
+                                    std::max((node.bounds[ray.nearY][i] - ray.origin.y) * ray.invDir.y,
+                                             (node.bounds[ray.nearZ][i] - ray.origin.z) * ray.invDir.z)));
+        float tmax = std::min(maxDistance, std::min((node.bounds[farX][i] - ray.origin.x) * ray.invDir.x,
+                                           std::min((node.bounds[farY][i] - ray.origin.y) * ray.invDir.y,
+                                                    (node.bounds[farZ][i] - ray.origin.z) * ray.invDir.z)));
+        distance[i] = tmin;
+        if (tmin <= tmax * farScale)
+            mask |= 1 << i;
+    }
+    return mask;
+#endif
+}
+
+// Woop, Benthin and Wald, "Watertight Ray/Triangle Intersection", JCGT 2013.
+bool MeshBVH::IntersectTriangle(const Triangle& triangle, const Ray& ray, float maxDistance, MeshRayHit& hit) const
+{
+    float3 a = triangle.v0 - ray.origin;
+    float3 b = triangle.v1 - ray.origin;
+    float3 c = triangle.v2 - ray.origin;
+
+    float ax = a[ray.kx] - ray.sx * a[ray.kz];
+    float ay = a[ray.ky] - ray.sy * a[ray.kz];
+    float bx = b[ray.kx] - ray.sx * b[ray.kz];
+    float by = b[ray.ky] - ray.sy * b[ray.kz];
+    float cx = c[ray.kx] - ray.sx * c[ray.kz];
+    float cy = c[ray.ky] - ray.sy * c[ray.kz];
+
+    float u = cx * by - cy * bx;
+    float v = ax * cy - ay * cx;
+    float w = bx * ay - by * ax;
+
+    // Edges through the ray need the exact sign, so redo them in double.
+    if (u == 0.0f || v == 0.0f || w == 0.0f)
+    {
+        u = (float)((double)cx * (double)by - (double)cy * (double)bx);
+        v = (float)((double)ax * (double)cy - (double)ay * (double)cx);
+        w = (float)((double)bx * (double)ay - (double)by * (double)ax);
+    }
+
+    if ((u < 0.0f || v < 0.0f || w < 0.0f) && (u > 0.0f || v > 0.0f || w > 0.0f))
+        return false;
+
+    float det = u + v + w;
+    if (det == 0.0f)
+        return false;
+
+    float az = ray.sz * a[ray.kz];
+    float bz = ray.sz * b[ray.kz];
+    float cz = ray.sz * c[ray.kz];
+    float t = u * az + v * bz + w * cz;
+
+    if (det > 0.0f ? (t < 0.0f || t > maxDistance * det) : (t > 0.0f || t < maxDistance * det))
+        return false;
+
+    float invDet = 1.0f / det;
+    hit.distance = t * invDet;
+    hit.u = v * invDet;
+    hit.v = w * invDet;
+    hit.triangle = triangle.index;
+    return true;
+}
+
+template<bool ANY_HIT>
+bool MeshBVH::Traverse(const Ray& ray, float maxDistance, MeshRayHit& hit) const
+{
+    if (m_nodes.empty())
+        return false;
+
+    struct StackEntry
+    {
+        uint32_t child;
+        uint32_t count;
+        float distance;
+    };
+
+    // The build caps the binary depth at MAX_DEPTH, each wide level pushes at most WIDTH entries.
+    StackEntry stack[MAX_DEPTH * WIDTH + 1];
+    uint32_t top = 0;
+    stack[top++] = StackEntry{ 0, 0, 0.0f };
+
+    bool bHit = false;
+    float closest = maxDistance;
+
+    while (top > 0)
+    {
+        auto entry = stack[--top];
+        if (entry.distance > closest)
+            continue;
+
+        if (entry.count != 0)
+        {
+            for (uint32_t i = entry.child; i < entry.child + entry.count; i++)
+            {
+                if (IntersectTriangle(m_triangles[i], ray, closest, hit))
+                {
+                    if (ANY_HIT)
+                        return true;
+
+                    bHit = true;
+                    closest = hit.distance;
+                }
+            }
+            continue;
+        }
+
+        auto& node = m_nodes[entry.child];
+        MATH_SIMD_ALIGN(32) float distance[WIDTH];
+        uint32_t mask = IntersectNode(node, ray, closest, distance);
+
+        // Keep the pushed children sorted so the nearest one is popped first.
+        uint32_t first = top;
+        for (uint32_t i = 0; i < WIDTH; i++)
+        {
+            if ((mask & (1 << i)) == 0 || node.count[i] == INVALID_COUNT)
+                continue;
+
+            StackEntry child{ node.child[i], node.count[i], distance[i] };
+            uint32_t j = top++;
+            while (j > first && stack[j - 1].distance < child.distance)
+            {
+                stack[j] = stack[j - 1];
+                j--;
+            }
+            stack[j] = child;
+        }
+    }
+
+    return bHit;
+}
\ No newline at end of file
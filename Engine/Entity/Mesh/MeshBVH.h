@@ -0,0 +1,115 @@
+#pragma once
+
+#include <atomic>
+#include <vector>
+#include <stdint.h>
+
+#include "Vector.h"
+#include "Box3.h"
+#include "SIMD.h"
+
+#include "IMesh.h"
+
+namespace Engine
+{
+    struct MeshRayHit
+    {
+        float distance;
+        float u, v;
+        uint32_t triangle;
+    };
+
+    // Triangle BVH built with binned SAH and collapsed into WIDTH-ary nodes whose child boxes are
+    // stored as SoA, so one SIMD pass tests a ray against all children of a node.
+    class MeshBVH
+    {
+    public:
+#if defined(MATH_SIMD_AVX)
+        constexpr static uint32_t WIDTH = 8;
+#else
+        constexpr static uint32_t WIDTH = 4;
+#endif
+        constexpr static uint32_t MAX_LEAF_SIZE = 8;
+        constexpr static uint32_t MAX_DEPTH = 64;
+
+        MeshBVH();
+        virtual ~MeshBVH() = default;
+
+        // Uses the position stream and the 16 or 32 bit index data of the mesh.
+        bool Build(const IMesh* pMesh);
+        bool Build(const float3* pPositions, uint32_t vertexCount, const uint32_t* pIndices, uint32_t indexCount);
+
+        // Closest hit along origin + t * dir with t in [0, maxDistance], watertight and double sided.
+        bool Intersect(const float3& origin, const float3& dir, float maxDistance, MeshRayHit& hit) const;
+        // Any hit, for shadow and visibility rays.
+        bool Occluded(const float3& origin, const float3& dir, float maxDistance) const;
+
+        const Box3& GetBounds() const;
+        uint32_t GetTriangleCount() const;
+        uint32_t GetNodeCount() const;
+
+    private:
+        struct Triangle
+        {
+            float3 v0, v1, v2;
+            uint32_t index;
+        };
+
+        struct MATH_SIMD_ALIGN(32) Node
+        {
+            // minX, minY, minZ, maxX, maxY, maxZ of each child.
+            float bounds[6][WIDTH];
+            // Node index for inner children, first triangle for leaves.
+            uint32_t child[WIDTH];
+            // Triangle count for leaves, 0 for inner children, INVALID_COUNT for empty slots.
+            uint32_t count[WIDTH];
+        };
+
+        struct BuildNode
+        {
+            Box3 box;
+            uint32_t left;
+            uint32_t first;
+            uint32_t count;
+        };
+
+        struct Ray
+        {
+            float3 origin;
+            float3 dir;
+            float3 invDir;
+            // Watertight test setup, see Woop et al. "Watertight Ray/Triangle Intersection".
+            int kx, ky, kz;
+            float sx, sy, sz;
+            // Index into Node::bounds of the near plane per axis.
+            int nearX, nearY, nearZ;
+        };
+
+        constexpr static uint32_t INVALID_COUNT = 0xffffffff;
+
+        void BuildRecursive(uint32_t nodeIndex, uint32_t begin, uint32_t end, uint32_t depth);
+        void ComputeBounds(uint32_t begin, uint32_t end, Box3& box, Box3& centroidBox) const;
+        bool FindSplit(uint32_t begin, uint32_t end, const Box3& box, const Box3& centroidBox, uint32_t& axis, uint32_t& bin, float& cost) const;
+
+        uint32_t Collapse(uint32_t buildIndex);
+
+        void SetupRay(const float3& origin, const float3& dir, Ray& ray) const;
+        uint32_t IntersectNode(const Node& node, const Ray& ray, float maxDistance, float distance[WIDTH]) const;
+        bool IntersectTriangle(const Triangle& triangle, const Ray& ray, float maxDistance, MeshRayHit& hit) const;
+
+        template<bool ANY_HIT>
+        bool Traverse(const Ray& ray, float maxDistance, MeshRayHit& hit) const;
+
+    private:
+        std::vector<Node> m_nodes;
+        std::vector<Triangle> m_triangles;
+        Box3 m_bounds;
+
+        // Build time only.
+        std::vector<Box3> m_primBoxes;
+        std::vector<float3> m_primCentroids;
+        std::vector<uint32_t> m_primIndices;
+        std::vector<BuildNode> m_buildNodes;
+        std::atomic<uint32_t> m_buildNodeCount;
+    };
+}
\ No newline at end of file
@@ -0,0 +1,284 @@
+#include <algorithm>
+#include <atomic>
+#include <fstream>
+#include <string.h>
+
+#include "Global.h"
+#include "LZ4.h"
+#include "MappedFile.h"
+#include "MeshFile.h"
+
+using namespace Engine;
+
+bool MeshFile::Save(const Mesh& mesh, const std::string& path, bool bCompress)
+{
+    struct Source
+    {
+        const char* pData;
+        uint32_t size;
+        Block* pBlock;
+    };
+
+    Header header = {};
+    header.magic = MAGIC;
+    header.version = VERSION;
+    memcpy(header.boundsMin, &mesh.m_bounds.mMin, sizeof(header.boundsMin));
+    memcpy(header.boundsMax, &mesh.m_bounds.mMax, sizeof(header.boundsMax));
+    header.flags = mesh.m_bQuantized ? (uint32_t)EFlag::Quantized : 0;
+    header.vertexCount = mesh.m_vertexCount;
+    header.indexCount = mesh.m_pIndexData != nullptr ? mesh.m_indexCount : 0;
+    header.indexStride = header.indexCount > 0 ? mesh.m_indexSize / mesh.m_indexCount : 0;
+    header.streamCount = (uint32_t)mesh.m_pAttributes.size();
+    header.lodCount = (uint32_t)mesh.m_lods.size();
+
+    std::vector<Source> sources;
+
+    std::vector<StreamDesc> streams(header.streamCount);
+    for (uint32_t i = 0; i < header.streamCount; i++)
+    {
+        const auto& pAttribute = mesh.m_pAttributes[i];
+
+        auto& desc = streams[i];
+        memset(&desc, 0, sizeof(desc));
+        desc.semanticType = (uint16_t)pAttribute->semanticType;
+        desc.format = (uint16_t)pAttribute->format;
+        strncpy(desc.name, pAttribute->name.c_str(), sizeof(desc.name) - 1);
+
+        sources.push_back(Source { pAttribute->pData.get(), pAttribute->size, &desc.block });
+    }
+
+    // LODs follow LOD 0 in the same allocation.
+    uint32_t indexTotal = header.indexCount;
+    for (const auto& lod : mesh.m_lods)
+        indexTotal = std::max(indexTotal, lod.indexOffset + lod.indexCount);
+
+    if (header.indexCount > 0)
+        sources.push_back(Source { mesh.m_pIndexData.get(), indexTotal * header.indexStride, &header.blocks[EBlock::Indices] });
+
+    if (mesh.m_pMeshlets != nullptr)
+    {
+        const auto& meshlets = *mesh.m_pMeshlets;
+        header.meshletCount = meshlets.GetMeshletCount();
+        header.meshletStride = sizeof(MeshletSet::Meshlet);
+        header.meshletVertexCount = meshlets.GetVertexCount();
+        header.meshletTriangleCount = meshlets.GetTriangleCount();
+
+        sources.push_back(Source { reinterpret_cast<const char*>(meshlets.GetMeshlets()), header.meshletCount * header.meshletStride, &header.blocks[EBlock::Meshlets] });
+        sources.push_back(Source { reinterpret_cast<const char*>(meshlets.GetVertices()), header.meshletVertexCount * (uint32_t)sizeof(uint32_t), &header.blocks[EBlock::MeshletVertices] });
+        sources.push_back(Source { reinterpret_cast<const char*>(meshlets.GetTriangles()), header.meshletTriangleCount * 3, &header.blocks[EBlock::MeshletTriangles] });
+        sources.push_back(Source { reinterpret_cast<const char*>(meshlets.GetPositions()), meshlets.GetPositionCount() * (uint32_t)sizeof(float3), &header.blocks[EBlock::MeshletPositions] });
+    }
+
+    // Blocks compress independently, an empty result keeps the block as is.
+    std::vector<std::vector<char>> compressed(sources.size());
+    if (bCompress)
+    {
+        gpGlobal->GetJobSystem().ParallelFor((uint32_t)sources.size(), 1, [&](uint32_t begin, uint32_t end) {
+            for (uint32_t i = begin; i < end; i++)
+            {
+                const auto& source = sources[i];
+                std::vector<char> data(LZ4::CompressBound(source.size));
+
+                uint32_t size = LZ4::Compress(source.pData, source.size, data.data(), (uint32_t)data.size());
+                if (size == 0 || size > source.size * MAX_COMPRESSED_RATIO)
+                    continue;
+
+                data.resize(size);
+                compressed[i].swap(data);
+            }
+        });
+    }
+
+    uint64_t offset = Align(sizeof(Header) + streams.size() * sizeof(StreamDesc) + mesh.m_lods.size() * sizeof(MeshLod));
+    for (uint32_t i = 0; i < sources.size(); i++)
+    {
+        uint32_t storedSize = compressed[i].empty() ? sources[i].size : (uint32_t)compressed[i].size();
+        *sources[i].pBlock = Block { offset, sources[i].size, storedSize };
+        offset = Align(offset + storedSize);
+    }
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file)
+        return false;
+
+    uint64_t position = 0;
+    auto write = [&](const void* pData, uint64_t size) {
+        file.write(reinterpret_cast<const char*>(pData), size);
+        position += size;
+    };
+
+    auto pad = [&]() {
+        static const char zeros[ALIGNMENT] = {};
+        write(zeros, Align(position) - position);
+    };
+
+    write(&header, sizeof(header));
+    write(streams.data(), streams.size() * sizeof(StreamDesc));
+    write(mesh.m_lods.data(), mesh.m_lods.size() * sizeof(MeshLod));
+
+    for (uint32_t i = 0; i < sources.size(); i++)
+    {
+        pad();
+        if (compressed[i].empty())
+            write(sources[i].pData, sources[i].size);
+        else
+            write(compressed[i].data(), compressed[i].size());
+    }
+
+    return (bool)file;
+}
+
+std::shared_ptr<Mesh> MeshFile::Load(const std::string& path)
+{
+    auto pFile = MappedFile::Open(path);
+    if (pFile == nullptr || pFile->GetSize() < sizeof(Header))
+        return nullptr;
+
+    Header header;
+    memcpy(&header, pFile->GetData(), sizeof(header));
+    if (header.magic != MAGIC || header.version != VERSION)
+        return nullptr;
+
+    if (header.indexStride != 0 && header.indexStride != sizeof(uint16_t) && header.indexStride != sizeof(uint32_t))
+        return nullptr;
+
+    if (header.meshletCount > 0 && header.meshletStride != sizeof(MeshletSet::Meshlet))
+        return nullptr;
+
+    uint64_t tableSize = sizeof(Header) + (uint64_t)header.streamCount * sizeof(StreamDesc) + (uint64_t)header.lodCount * sizeof(MeshLod);
+    if (tableSize > pFile->GetSize())
+        return nullptr;
+
+    std::vector<StreamDesc> streams(header.streamCount);
+    std::vector<MeshLod> lods(header.lodCount);
+    memcpy(streams.data(), pFile->GetData() + sizeof(Header), streams.size() * sizeof(StreamDesc));
+    memcpy(lods.data(), pFile->GetData() + sizeof(Header) + streams.size() * sizeof(StreamDesc), lods.size() * sizeof(MeshLod));
+
+    uint64_t indexTotal = header.indexCount;
+    for (const auto& lod : lods)
+        indexTotal = std::max(indexTotal, (uint64_t)lod.indexOffset + lod.indexCount);
+
+    // Streams first, then the fixed blocks, each with the size the header implies.
+    std::vector<Block> blocks;
+    std::vector<uint64_t> sizes;
+    for (const auto& desc : streams)
+    {
+        uint32_t formatSize = FormatSize((Attribute::EFormat)desc.format);
+        if (formatSize == 0 || desc.semanticType >= (uint16_t)Attribute::ESemanticType::Count)
+            return nullptr;
+
+        blocks.push_back(desc.block);
+        sizes.push_back((uint64_t)header.vertexCount * formatSize);
+    }
+
+    uint32_t fixedBlock = (uint32_t)blocks.size();
+    uint64_t fixedSizes[BlockCount] = {
+        indexTotal * header.indexStride,
+        (uint64_t)header.meshletCount * header.meshletStride,
+        (uint64_t)header.meshletVertexCount * sizeof(uint32_t),
+        (uint64_t)header.meshletTriangleCount * 3,
+        header.meshletCount > 0 ? (uint64_t)header.vertexCount * sizeof(float3) : 0,
+    };
+
+    for (uint32_t i = 0; i < BlockCount; i++)
+    {
+        blocks.push_back(header.blocks[i]);
+        sizes.push_back(fixedSizes[i]);
+    }
+
+    for (uint32_t i = 0; i < blocks.size(); i++)
+    {
+        const auto& block = blocks[i];
+        if (block.size != sizes[i] || block.storedSize > block.size || block.offset % ALIGNMENT != 0 ||
+            block.offset < tableSize || block.offset + block.storedSize > pFile->GetSize())
+            return nullptr;
+    }
+
+    // Stored blocks are views into the mapping, compressed ones decode on the workers.
+    std::vector<std::shared_ptr<char>> data(blocks.size());
+    std::vector<uint32_t> compressed;
+    for (uint32_t i = 0; i < blocks.size(); i++)
+    {
+        if (blocks[i].storedSize == blocks[i].size)
+            data[i] = pFile->GetView(blocks[i].offset);
+        else
+            compressed.push_back(i);
+    }
+
+    std::atomic<bool> bDecoded(true);
+    gpGlobal->GetJobSystem().ParallelFor((uint32_t)compressed.size(), 1, [&](uint32_t begin, uint32_t end) {
+        for (uint32_t c = begin; c < end; c++)
+        {
+            const auto& block = blocks[compressed[c]];
+            char* pData = new char[block.size];
+            data[compressed[c]] = std::shared_ptr<char>(pData, std::default_delete<char[]>());
+
+            if (!LZ4::Decompress(pFile->GetData() + block.offset, block.storedSize, pData, block.size))
+                bDecoded = false;
+        }
+    });
+
+    if (!bDecoded)
+        return nullptr;
+
+    auto pMesh = std::make_shared<Mesh>();
+    for (uint32_t i = 0; i < streams.size(); i++)
+    {
+        const auto& desc = streams[i];
+
+        auto pAttribute = std::make_shared<Attribute>();
+        pAttribute->semanticType = (Attribute::ESemanticType)desc.semanticType;
+        pAttribute->format = (Attribute::EFormat)desc.format;
+        pAttribute->name = std::string(desc.name, strnlen(desc.name, sizeof(desc.name)));
+        pAttribute->pData = data[i];
+        pAttribute->size = desc.block.size;
+
+        pMesh->m_pAttributes.emplace_back(pAttribute);
+    }
+
+    pMesh->m_vertexCount = header.vertexCount;
+    pMesh->m_pIndexData = header.indexCount > 0 ? data[fixedBlock + EBlock::Indices] : nullptr;
+    pMesh->m_indexSize = header.indexCount * header.indexStride;
+    pMesh->m_indexCount = header.indexCount;
+    pMesh->m_bounds.Set(float3(header.boundsMin[0], header.boundsMin[1], header.boundsMin[2]), float3(header.boundsMax[0], header.boundsMax[1], header.boundsMax[2]));
+    pMesh->m_bQuantized = (header.flags & EFlag::Quantized) != 0;
+    pMesh->m_lods = lods;
+
+    if (header.meshletCount > 0)
+    {
+        auto pMeshlets = std::make_shared<MeshletSet>();
+        if (!pMeshlets->Attach(data[fixedBlock + EBlock::Meshlets], header.meshletCount, data[fixedBlock + EBlock::MeshletVertices], header.meshletVertexCount,
+                               data[fixedBlock + EBlock::MeshletTriangles], header.meshletTriangleCount, data[fixedBlock + EBlock::MeshletPositions], header.vertexCount))
+            return nullptr;
+
+        pMesh->m_pMeshlets = pMeshlets;
+    }
+
+    return pMesh;
+}
+
+uint32_t MeshFile::FormatSize(Attribute::EFormat format)
+{
+    switch (format)
+    {
+    case Attribute::EFormat::Float2:
+        return sizeof(float2);
+    case Attribute::EFormat::Float3:
+        return sizeof(float3);
+    case Attribute::EFormat::Float4:
+        return sizeof(float4);
+    case Attribute::EFormat::UNorm16x4:
+    case Attribute::EFormat::UInt16x4:
+        return 4 * sizeof(uint16_t);
+    case Attribute::EFormat::SNorm16x2:
+    case Attribute::EFormat::Half2:
+        return 2 * sizeof(uint16_t);
+    default:
+        return 0;
+    }
+}
+
+uint64_t MeshFile::Align(uint64_t offset)
+{
+    return (offset + ALIGNMENT - 1) & ~(uint64_t)(ALIGNMENT - 1);
+}
\ No newline at end of file
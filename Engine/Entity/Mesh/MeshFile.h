@@ -0,0 +1,84 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <stdint.h>
+
+#include "Mesh.h"
+
+namespace Engine
+{
+    // Cooked mesh (.ntmesh): a header with the bounds and fixed blocks, the vertex stream
+    // descriptors, the LOD table, then the data blocks. Blocks start 16 byte aligned and are either
+    // stored as is, so loading hands out views into the mapped file without touching a vertex, or
+    // LZ4 compressed when that saves enough to be worth the decode.
+    class MeshFile
+    {
+    public:
+        constexpr static uint32_t MAGIC = 0x48534d4e;   // "NMSH"
+        constexpr static uint32_t VERSION = 1;
+        constexpr static uint32_t ALIGNMENT = 16;
+        // Compressed blocks are only kept when they shrink to this fraction or less.
+        constexpr static float MAX_COMPRESSED_RATIO = 0.875f;
+
+        // Writes the mesh as it is, so cook after Optimize, GenerateLods, GenerateMeshlets and Quantize.
+        static bool Save(const Mesh& mesh, const std::string& path, bool bCompress);
+        // Returns nullptr when the file is missing, damaged or from another version.
+        static std::shared_ptr<Mesh> Load(const std::string& path);
+
+    private:
+        // storedSize < size means the block is LZ4 compressed.
+        struct Block
+        {
+            uint64_t offset;
+            uint32_t size;
+            uint32_t storedSize;
+        };
+
+        enum EBlock
+        {
+            Indices,
+            Meshlets,
+            MeshletVertices,
+            MeshletTriangles,
+            MeshletPositions,
+            BlockCount,
+        };
+
+        enum EFlag : uint32_t
+        {
+            Quantized = 1 << 0,
+        };
+
+        struct Header
+        {
+            uint32_t magic;
+            uint32_t version;
+            float boundsMin[3];
+            float boundsMax[3];
+            uint32_t flags;
+            uint32_t vertexCount;
+            // LOD 0, the other levels follow it in the index block.
+            uint32_t indexCount;
+            uint32_t indexStride;
+            uint32_t streamCount;
+            uint32_t lodCount;
+            uint32_t meshletCount;
+            uint32_t meshletStride;
+            uint32_t meshletVertexCount;
+            uint32_t meshletTriangleCount;
+            Block blocks[BlockCount];
+        };
+
+        struct StreamDesc
+        {
+            uint16_t semanticType;
+            uint16_t format;
+            char name[28];
+            Block block;
+        };
+
+        static uint32_t FormatSize(Attribute::EFormat format);
+        static uint64_t Align(uint64_t offset);
+    };
+}
\ No newline at end of file
@@ -0,0 +1,364 @@
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#include "MeshOptimizer.h"
+
+using namespace Engine;
+
+uint32_t MeshOptimizer::WeldVertices(const std::vector<VertexStream>& streams, uint32_t vertexCount, std::vector<uint32_t>& remap)
+{
+    remap.assign(vertexCount, INVALID_INDEX);
+
+    auto hash = [&](uint32_t vertex) {
+        // FNV-1a over the bytes of every stream.
+        uint32_t h = 2166136261u;
+        for (const auto& stream : streams)
+        {
+            const uint8_t* p = reinterpret_cast<const uint8_t*>(stream.pData) + (size_t)vertex * stream.stride;
+            for (uint32_t i = 0; i < stream.stride; i++)
+                h = (h ^ p[i]) * 16777619u;
+        }
+        return h;
+    };
+
+    auto equal = [&](uint32_t a, uint32_t b) {
+        for (const auto& stream : streams)
+        {
+            if (memcmp(stream.pData + (size_t)a * stream.stride, stream.pData + (size_t)b * stream.stride, stream.stride) != 0)
+                return false;
+        }
+        return true;
+    };
+
+    // Open addressing with linear probing, at most half full.
+    uint32_t tableSize = 1;
+    while (tableSize < vertexCount * 2)
+        tableSize <<= 1;
+
+    std::vector<uint32_t> table(tableSize, INVALID_INDEX);
+    uint32_t uniqueCount = 0;
+
+    for (uint32_t i = 0; i < vertexCount; i++)
+    {
+        uint32_t slot = hash(i) & (tableSize - 1);
+        while (table[slot] != INVALID_INDEX && !equal(table[slot], i))
+            slot = (slot + 1) & (tableSize - 1);
+
+        if (table[slot] == INVALID_INDEX)
+        {
+            table[slot] = i;
+            remap[i] = uniqueCount++;
+        }
+        else
+            remap[i] = remap[table[slot]];
+    }
+
+    return uniqueCount;
+}
+
+void MeshOptimizer::OptimizeVertexCache(uint32_t* pIndices, uint32_t indexCount, uint32_t vertexCount, uint32_t cacheSize)
+{
+    uint32_t triangleCount = indexCount / 3;
+    if (triangleCount == 0)
+        return;
+
+    // Triangles around each vertex, live is the number not emitted yet.
+    std::vector<uint32_t> offsets(vertexCount + 1, 0);
+    for (uint32_t i = 0; i < triangleCount * 3; i++)
+        offsets[pIndices[i] + 1]++;
+    for (uint32_t v = 0; v < vertexCount; v++)
+        offsets[v + 1] += offsets[v];
+
+    std::vector<uint32_t> live(vertexCount);
+    for (uint32_t v = 0; v < vertexCount; v++)
+        live[v] = offsets[v + 1] - offsets[v];
+
+    std::vector<uint32_t> adjacency(triangleCount * 3);
+    std::vector<uint32_t> fill(offsets.begin(), offsets.end() - 1);
+    for (uint32_t i = 0; i < triangleCount * 3; i++)
+        adjacency[fill[pIndices[i]]++] = i / 3;
+
+    std::vector<uint32_t> cacheTime(vertexCount, 0);
+    std::vector<bool> emitted(triangleCount, false);
+    std::vector<uint32_t> deadEnd;
+    std::vector<uint32_t> candidates;
+    std::vector<uint32_t> result;
+    result.reserve(triangleCount * 3);
+
+    uint32_t time = cacheSize + 1;
+    uint32_t cursor = 0;
+    int64_t fan = 0;
+
+    while (fan >= 0)
+    {
+        candidates.clear();
+
+        for (uint32_t a = offsets[fan]; a < offsets[fan + 1]; a++)
+        {
+            uint32_t triangle = adjacency[a];
+            if (emitted[triangle])
+                continue;
+
+            for (uint32_t k = 0; k < 3; k++)
+            {
+                uint32_t v = pIndices[triangle * 3 + k];
+                result.push_back(v);
+                deadEnd.push_back(v);
+                candidates.push_back(v);
+                live[v]--;
+
+                if (time - cacheTime[v] > cacheSize)
+                    cacheTime[v] = time++;
+            }
+            emitted[triangle] = true;
+        }
+
+        // Prefer the oldest candidate that stays in the cache while its remaining triangles are emitted.
+        fan = -1;
+        int64_t bestPriority = -1;
+        for (uint32_t v : candidates)
+        {
+            if (live[v] == 0)
+                continue;
+
+            int64_t priority = 0;
+            if (time - cacheTime[v] + 2 * live[v] <= cacheSize)
+                priority = time - cacheTime[v];
+
+            if (priority > bestPriority)
+            {
+                bestPriority = priority;
+                fan = v;
+            }
+        }
+
+        if (fan >= 0)
+            continue;
+
+        // Dead end, go back to recently used vertices first and scan forward last.
+        while (!deadEnd.empty() && fan < 0)
+        {
+            uint32_t v = deadEnd.back();
+            deadEnd.pop_back();
+            if (live[v] > 0)
+                fan = v;
+        }
+
+        while (cursor < vertexCount && fan < 0)
+        {
+            if (live[cursor] > 0)
+                fan = cursor;
+            cursor++;
+        }
+    }
+
+    std::copy(result.begin(), result.end(), pIndices);
+}
+
+void MeshOptimizer::OptimizeOverdraw(uint32_t* pIndices, uint32_t indexCount, const float3* pPositions, uint32_t vertexCount, float threshold, uint32_t cacheSize)
+{
+    uint32_t triangleCount = indexCount / 3;
+    if (triangleCount == 0)
+        return;
+
+    std::vector<uint32_t> hardBoundaries;
+    std::vector<uint32_t> boundaries;
+    HardBoundaries(pIndices, indexCount, vertexCount, cacheSize, hardBoundaries);
+    SoftBoundaries(pIndices, indexCount, vertexCount, cacheSize, threshold, hardBoundaries, boundaries);
+
+    uint32_t clusterCount = (uint32_t)boundaries.size();
+    boundaries.push_back(triangleCount);
+
+    // Area weighted centroid and normal per cluster, the mesh centroid from all of them.
+    std::vector<float3> centroids(clusterCount, float3(0.0f));
+    std::vector<float3> normals(clusterCount, float3(0.0f));
+    float3 meshCentroid(0.0f);
+    float meshArea = 0.0f;
+
+    for (uint32_t c = 0; c < clusterCount; c++)
+    {
+        float clusterArea = 0.0f;
+        for (uint32_t t = boundaries[c]; t < boundaries[c + 1]; t++)
+        {
+            const float3& p0 = pPositions[pIndices[t * 3 + 0]];
+            const float3& p1 = pPositions[pIndices[t * 3 + 1]];
+            const float3& p2 = pPositions[pIndices[t * 3 + 2]];
+
+            float3 normal = Vec::Cross(p1 - p0, p2 - p0);
+            float area = Vec::Length(normal);
+
+            centroids[c] += (p0 + p1 + p2) * (area / 3.0f);
+            normals[c] += normal;
+            clusterArea += area;
+        }
+
+        meshCentroid += centroids[c];
+        meshArea += clusterArea;
+
+        centroids[c] = clusterArea > 0.0f ? centroids[c] / clusterArea : pPositions[pIndices[boundaries[c] * 3]];
+
+        float length = Vec::Length(normals[c]);
+        normals[c] = length > 0.0f ? normals[c] / length : float3(0.0f);
+    }
+
+    if (meshArea > 0.0f)
+        meshCentroid = meshCentroid / meshArea;
+
+    // Clusters facing away from the center occlude the rest, so they go first.
+    std::vector<float> keys(clusterCount);
+    for (uint32_t c = 0; c < clusterCount; c++)
+        keys[c] = Vec::Dot(centroids[c] - meshCentroid, normals[c]);
+
+    std::vector<uint32_t> order(clusterCount);
+    for (uint32_t c = 0; c < clusterCount; c++)
+        order[c] = c;
+    std::stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) { return keys[a] > keys[b]; });
+
+    std::vector<uint32_t> source(pIndices, pIndices + triangleCount * 3);
+    uint32_t* pDst = pIndices;
+    for (uint32_t c : order)
+    {
+        uint32_t begin = boundaries[c] * 3;
+        uint32_t end = boundaries[c + 1] * 3;
+        pDst = std::copy(source.begin() + begin, source.begin() + end, pDst);
+    }
+}
+
+uint32_t MeshOptimizer::OptimizeVertexFetch(uint32_t* pIndices, uint32_t indexCount, uint32_t vertexCount, std::vector<uint32_t>& remap)
+{
+    remap.assign(vertexCount, INVALID_INDEX);
+
+    uint32_t next = 0;
+    for (uint32_t i = 0; i < indexCount; i++)
+    {
+        uint32_t& index = remap[pIndices[i]];
+        if (index == INVALID_INDEX)
+            index = next++;
+
+        pIndices[i] = index;
+    }
+
+    return next;
+}
+
+VertexCacheStatistics MeshOptimizer::AnalyzeVertexCache(const uint32_t* pIndices, uint32_t indexCount, uint32_t vertexCount, uint32_t cacheSize)
+{
+    std::vector<uint32_t> cacheTime(vertexCount, 0);
+    std::vector<bool> used(vertexCount, false);
+
+    uint32_t time = cacheSize + 1;
+    uint32_t misses = 0;
+    uint32_t usedCount = 0;
+
+    for (uint32_t i = 0; i < indexCount; i++)
+    {
+        uint32_t v = pIndices[i];
+        if (time - cacheTime[v] > cacheSize)
+        {
+            cacheTime[v] = time++;
+            misses++;
+        }
+
+        if (!used[v])
+        {
+            used[v] = true;
+            usedCount++;
+        }
+    }
+
+    VertexCacheStatistics stats;
+    stats.acmr = indexCount >= 3 ? (float)misses / (indexCount / 3) : 0.0f;
+    stats.atvr = usedCount > 0 ? (float)misses / usedCount : 0.0f;
+
+    return stats;
+}
+
+void MeshOptimizer::RemapVertices(const char* pSrc, uint32_t stride, uint32_t vertexCount, const std::vector<uint32_t>& remap, char* pDst)
+{
+    for (uint32_t i = 0; i < vertexCount; i++)
+    {
+        if (remap[i] != INVALID_INDEX)
+            memcpy(pDst + (size_t)remap[i] * stride, pSrc + (size_t)i * stride, stride);
+    }
+}
+
+void MeshOptimizer::HardBoundaries(const uint32_t* pIndices, uint32_t indexCount, uint32_t vertexCount, uint32_t cacheSize, std::vector<uint32_t>& boundaries)
+{
+    // A triangle missing on all three vertices is where the cache order restarted.
+    std::vector<uint32_t> cacheTime(vertexCount, 0);
+    uint32_t time = cacheSize + 1;
+
+    for (uint32_t t = 0; t < indexCount / 3; t++)
+    {
+        uint32_t misses = 0;
+        for (uint32_t k = 0; k < 3; k++)
+        {
+            uint32_t v = pIndices[t * 3 + k];
+            if (time - cacheTime[v] > cacheSize)
+            {
+                cacheTime[v] = time++;
+                misses++;
+            }
+        }
+
+        if (t == 0 || misses == 3)
+            boundaries.push_back(t);
+    }
+}
+
+void MeshOptimizer::SoftBoundaries(const uint32_t* pIndices, uint32_t indexCount, uint32_t vertexCount, uint32_t cacheSize, float threshold,
+                                   const std::vector<uint32_t>& hardBoundaries, std::vector<uint32_t>& boundaries)
+{
+    std::vector<uint32_t> cacheTime(vertexCount, 0);
+    uint32_t time = cacheSize + 1;
+
+    auto simulate = [&](uint32_t t) {
+        uint32_t misses = 0;
+        for (uint32_t k = 0; k < 3; k++)
+        {
+            uint32_t v = pIndices[t * 3 + k];
+            if (time - cacheTime[v] > cacheSize)
+            {
+                cacheTime[v] = time++;
+                misses++;
+            }
+        }
+        return misses;
+    };
+
+    // Moving the clock past the cache size empties it.
+    auto flush = [&]() { time += cacheSize + 1; };
+
+    uint32_t triangleCount = indexCount / 3;
+    for (size_t h = 0; h < hardBoundaries.size(); h++)
+    {
+        uint32_t begin = hardBoundaries[h];
+        uint32_t end = h + 1 < hardBoundaries.size() ? hardBoundaries[h + 1] : triangleCount;
+
+        flush();
+        uint32_t clusterMisses = 0;
+        for (uint32_t t = begin; t < end; t++)
+            clusterMisses += simulate(t);
+        float clusterACMR = (float)clusterMisses / (end - begin);
+
+        // Cut as soon as the piece so far is nearly as cache friendly as the whole cluster.
+        flush();
+        boundaries.push_back(begin);
+
+        uint32_t start = begin;
+        uint32_t misses = 0;
+        for (uint32_t t = begin; t < end; t++)
+        {
+            misses += simulate(t);
+
+            if (t + 1 < end && (float)misses / (t + 1 - start) <= threshold * clusterACMR)
+            {
+                boundaries.push_back(t + 1);
+                start = t + 1;
+                misses = 0;
+                flush();
+            }
+        }
+    }
+}
\ No newline at end of file
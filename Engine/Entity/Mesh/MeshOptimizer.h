@@ -0,0 +1,57 @@
+#pragma once
+
+#include <vector>
+#include <stdint.h>
+
+#include "Vector.h"
+
+#include "IMesh.h"
+
+namespace Engine
+{
+    // Import time reordering of indexed triangle lists. Indices are always 32 bit here, meshes narrow
+    // them afterwards.
+    class MeshOptimizer
+    {
+    public:
+        constexpr static uint32_t CACHE_SIZE = 16;
+        // Cache efficiency the overdraw pass may give up for a better draw order, see Sander et al.
+        // "Fast Triangle Reordering for Vertex Locality and Reduced Overdraw".
+        constexpr static float OVERDRAW_THRESHOLD = 1.05f;
+
+        struct VertexStream
+        {
+            const char* pData;
+            uint32_t stride;
+        };
+
+        // Maps bitwise identical vertices across all streams to one index, first occurrence first.
+        // Returns the welded vertex count.
+        static uint32_t WeldVertices(const std::vector<VertexStream>& streams, uint32_t vertexCount, std::vector<uint32_t>& remap);
+
+        // Tipsify: fans around recently used vertices and only restarts when the fan dies out.
+        static void OptimizeVertexCache(uint32_t* pIndices, uint32_t indexCount, uint32_t vertexCount, uint32_t cacheSize = CACHE_SIZE);
+
+        // Splits the cache ordered list into clusters where that costs little cache efficiency and
+        // draws outward facing clusters first.
+        static void OptimizeOverdraw(uint32_t* pIndices, uint32_t indexCount, const float3* pPositions, uint32_t vertexCount,
+                                     float threshold = OVERDRAW_THRESHOLD, uint32_t cacheSize = CACHE_SIZE);
+
+        // Numbers vertices in order of first use and drops unreferenced ones. Rewrites the indices and
+        // returns the used vertex count, remap[old] is the new index or INVALID_INDEX.
+        static uint32_t OptimizeVertexFetch(uint32_t* pIndices, uint32_t indexCount, uint32_t vertexCount, std::vector<uint32_t>& remap);
+
+        // FIFO cache simulation.
+        static VertexCacheStatistics AnalyzeVertexCache(const uint32_t* pIndices, uint32_t indexCount, uint32_t vertexCount, uint32_t cacheSize = CACHE_SIZE);
+
+        // Gathers dst[remap[i]] = src[i] for every vertex that is kept.
+        static void RemapVertices(const char* pSrc, uint32_t stride, uint32_t vertexCount, const std::vector<uint32_t>& remap, char* pDst);
+
+        constexpr static uint32_t INVALID_INDEX = 0xffffffff;
+
+    private:
+        static void HardBoundaries(const uint32_t* pIndices, uint32_t indexCount, uint32_t vertexCount, uint32_t cacheSize, std::vector<uint32_t>& boundaries);
+        static void SoftBoundaries(const uint32_t* pIndices, uint32_t indexCount, uint32_t vertexCount, uint32_t cacheSize, float threshold,
+                                   const std::vector<uint32_t>& hardBoundaries, std::vector<uint32_t>& boundaries);
+    };
+}
\ No newline at end of file
@@ -0,0 +1,367 @@
+#include <algorithm>
+#include <cmath>
+#include <unordered_set>
+
+#include "Box3.h"
+#include "MeshOptimizer.h"
+#include "MeshSimplifier.h"
+
+using namespace Engine;
+
+uint32_t MeshSimplifier::Simplify(const uint32_t* pIndices, uint32_t indexCount, const float3* pPositions, const float3* pNormals,
+                                  const float2* pTexcoords, uint32_t vertexCount, uint32_t targetIndexCount, uint32_t* pDst, float& error)
+{
+    const uint32_t invalid = MeshOptimizer::INVALID_INDEX;
+
+    indexCount -= indexCount % 3;
+    std::vector<uint32_t> indices(pIndices, pIndices + indexCount);
+    error = 0.0f;
+
+    // A unit sized copy keeps the weights independent of the mesh scale.
+    Box3 box;
+    for (uint32_t v = 0; v < vertexCount; v++)
+        box.Expand(pPositions[v]);
+
+    float3 size = box.Size();
+    float extent = std::max(std::max(size.x, size.y), size.z);
+    float scale = extent > 0.0f ? 1.0f / extent : 1.0f;
+
+    std::vector<float3> positions(vertexCount);
+    for (uint32_t v = 0; v < vertexCount; v++)
+        positions[v] = (pPositions[v] - box.mMin) * scale;
+
+    // Vertices sharing a position form a group, the wedges of an attribute seam.
+    std::vector<uint32_t> group;
+    uint32_t groupCount = MeshOptimizer::WeldVertices({ MeshOptimizer::VertexStream { reinterpret_cast<const char*>(pPositions), sizeof(float3) } }, vertexCount, group);
+
+    std::vector<uint32_t> groupSize(groupCount, 0);
+    std::vector<uint32_t> groupFirst(groupCount, invalid);
+    std::vector<uint32_t> sibling(vertexCount, invalid);
+    for (uint32_t v = 0; v < vertexCount; v++)
+    {
+        uint32_t g = group[v];
+        if (groupSize[g]++ == 0)
+            groupFirst[g] = v;
+        else
+        {
+            sibling[v] = groupFirst[g];
+            sibling[groupFirst[g]] = v;
+        }
+    }
+
+    // Edges without a reverse in vertex space run along borders and both sides of seams.
+    std::unordered_set<uint64_t> edges(indexCount);
+    for (uint32_t i = 0; i < indexCount; i += 3)
+    {
+        for (uint32_t k = 0; k < 3; k++)
+            edges.insert((uint64_t)indices[i + k] << 32 | indices[i + (k + 1) % 3]);
+    }
+
+    std::vector<uint32_t> openOut(vertexCount, invalid);
+    std::vector<uint32_t> openIn(vertexCount, invalid);
+    std::vector<uint32_t> outCount(vertexCount, 0);
+    std::vector<uint32_t> inCount(vertexCount, 0);
+    for (uint32_t i = 0; i < indexCount; i += 3)
+    {
+        for (uint32_t k = 0; k < 3; k++)
+        {
+            uint32_t a = indices[i + k];
+            uint32_t b = indices[i + (k + 1) % 3];
+            if (edges.count((uint64_t)b << 32 | a) == 0)
+            {
+                openOut[a] = b;
+                openIn[b] = a;
+                outCount[a]++;
+                inCount[b]++;
+            }
+        }
+    }
+
+    std::vector<EVertexKind> kind(vertexCount, EVertexKind::Locked);
+    for (uint32_t v = 0; v < vertexCount; v++)
+    {
+        bool single = outCount[v] == 1 && inCount[v] == 1;
+        switch (groupSize[group[v]])
+        {
+        case 1:
+            if (outCount[v] == 0 && inCount[v] == 0)
+                kind[v] = EVertexKind::Manifold;
+            else if (single)
+                kind[v] = EVertexKind::Border;
+            break;
+        case 2:
+        {
+            // The other wedge runs the same open edges the other way round.
+            uint32_t s = sibling[v];
+            if (single && outCount[s] == 1 && inCount[s] == 1 &&
+                openIn[s] == sibling[openOut[v]] && openOut[s] == sibling[openIn[v]] && openIn[s] != invalid && openOut[s] != invalid)
+                kind[v] = EVertexKind::Seam;
+            break;
+        }
+        default:
+            break;
+        }
+    }
+
+    std::vector<Quadric> quadrics(groupCount, Quadric {});
+    for (uint32_t i = 0; i < indexCount; i += 3)
+    {
+        const float3& p0 = positions[indices[i + 0]];
+        const float3& p1 = positions[indices[i + 1]];
+        const float3& p2 = positions[indices[i + 2]];
+
+        float3 normal = Vec::Cross(p1 - p0, p2 - p0);
+        float length = Vec::Length(normal);
+        if (length <= 0.0f)
+            continue;
+
+        normal = normal / length;
+        float d = -Vec::Dot(normal, p0);
+        for (uint32_t k = 0; k < 3; k++)
+            AddPlane(quadrics[group[indices[i + k]]], normal, d, length * 0.5f);
+
+        for (uint32_t k = 0; k < 3; k++)
+        {
+            uint32_t a = indices[i + k];
+            uint32_t b = indices[i + (k + 1) % 3];
+            if (kind[a] != EVertexKind::Border || openOut[a] != b)
+                continue;
+
+            float3 edge = positions[b] - positions[a];
+            float3 edgeNormal = Vec::Cross(edge, normal);
+            float edgeLength = Vec::Length(edgeNormal);
+            if (edgeLength <= 0.0f)
+                continue;
+
+            edgeNormal = edgeNormal / edgeLength;
+            float edgeD = -Vec::Dot(edgeNormal, positions[a]);
+            AddPlane(quadrics[group[a]], edgeNormal, edgeD, BORDER_WEIGHT * Vec::LengthSquared(edge));
+            AddPlane(quadrics[group[b]], edgeNormal, edgeD, BORDER_WEIGHT * Vec::LengthSquared(edge));
+        }
+    }
+
+    auto onOpenEdge = [&](uint32_t s, uint32_t t) { return openOut[s] == t || openIn[s] == t; };
+
+    auto canCollapse = [&](uint32_t s, uint32_t t) {
+        switch (kind[s])
+        {
+        case EVertexKind::Manifold:
+            return true;
+        case EVertexKind::Border:
+            return kind[t] == EVertexKind::Border && onOpenEdge(s, t);
+        case EVertexKind::Seam:
+            return kind[t] == EVertexKind::Seam && onOpenEdge(s, t) && onOpenEdge(sibling[s], sibling[t]);
+        default:
+            return false;
+        }
+    };
+
+    auto attributeCost = [&](uint32_t s, uint32_t t) {
+        float cost = 0.0f;
+        if (pNormals != nullptr)
+            cost += NORMAL_WEIGHT * Vec::LengthSquared(pNormals[s] - pNormals[t]);
+        if (pTexcoords != nullptr)
+            cost += TEXCOORD_WEIGHT * Vec::LengthSquared(pTexcoords[s] - pTexcoords[t]);
+        return cost;
+    };
+
+    std::vector<uint32_t> adjacencyOffsets(vertexCount + 1);
+    std::vector<uint32_t> adjacency;
+
+    // Moving the source wedges onto the target must not turn any remaining triangle around.
+    auto flips = [&](uint32_t s, uint32_t t) {
+        uint32_t wedges[2] = { s, kind[s] == EVertexKind::Seam ? sibling[s] : s };
+        for (uint32_t w = 0; w < 2; w++)
+        {
+            uint32_t v = wedges[w];
+            for (uint32_t a = adjacencyOffsets[v]; a < adjacencyOffsets[v + 1]; a++)
+            {
+                const uint32_t* pTriangle = &indices[adjacency[a] * 3];
+                if (group[pTriangle[0]] == group[t] || group[pTriangle[1]] == group[t] || group[pTriangle[2]] == group[t])
+                    continue;
+
+                float3 p[3];
+                for (uint32_t k = 0; k < 3; k++)
+                    p[k] = group[pTriangle[k]] == group[s] ? positions[t] : positions[pTriangle[k]];
+
+                const float3& p0 = positions[pTriangle[0]];
+                const float3& p1 = positions[pTriangle[1]];
+                const float3& p2 = positions[pTriangle[2]];
+
+                float3 before = Vec::Cross(p1 - p0, p2 - p0);
+                float3 after = Vec::Cross(p[1] - p[0], p[2] - p[0]);
+                if (Vec::Dot(before, after) <= 0.0f)
+                    return true;
+            }
+        }
+        return false;
+    };
+
+    std::vector<Collapse> collapses;
+    std::vector<uint32_t> collapseRemap(vertexCount);
+    std::vector<uint8_t> locked(groupCount);
+    float maxError = 0.0f;
+
+    uint32_t targetTriangleCount = targetIndexCount / 3;
+    for (uint32_t pass = 0; pass < MAX_PASSES && indices.size() / 3 > targetTriangleCount; pass++)
+    {
+        uint32_t triangleCount = (uint32_t)indices.size() / 3;
+
+        collapses.clear();
+        for (uint32_t i = 0; i < triangleCount * 3; i += 3)
+        {
+            for (uint32_t k = 0; k < 3; k++)
+            {
+                uint32_t a = indices[i + k];
+                uint32_t b = indices[i + (k + 1) % 3];
+                uint32_t pair[2][2] = { { a, b }, { b, a } };
+
+                for (auto& edge : pair)
+                {
+                    uint32_t s = edge[0];
+                    uint32_t t = edge[1];
+                    if (group[s] == group[t] || !canCollapse(s, t))
+                        continue;
+
+                    Quadric q = quadrics[group[s]];
+                    AddQuadric(q, quadrics[group[t]]);
+
+                    float positionError = std::max(Evaluate(q, positions[t]), 0.0f);
+                    float attributeError = attributeCost(s, t);
+                    if (kind[s] == EVertexKind::Seam)
+                        attributeError += attributeCost(sibling[s], sibling[t]);
+
+                    float weight = (float)std::max(q.weight, 1e-12);
+                    collapses.push_back(Collapse { positionError + attributeError * weight, positionError / weight, s, t });
+                }
+            }
+        }
+
+        std::sort(collapses.begin(), collapses.end(), [](const Collapse& a, const Collapse& b) { return a.cost < b.cost; });
+
+        std::fill(adjacencyOffsets.begin(), adjacencyOffsets.end(), 0);
+        for (uint32_t i = 0; i < triangleCount * 3; i++)
+            adjacencyOffsets[indices[i] + 1]++;
+        for (uint32_t v = 0; v < vertexCount; v++)
+            adjacencyOffsets[v + 1] += adjacencyOffsets[v];
+
+        adjacency.resize(triangleCount * 3);
+        std::vector<uint32_t> fill(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+        for (uint32_t i = 0; i < triangleCount * 3; i++)
+            adjacency[fill[indices[i]]++] = i / 3;
+
+        for (uint32_t v = 0; v < vertexCount; v++)
+            collapseRemap[v] = v;
+        std::fill(locked.begin(), locked.end(), 0);
+
+        // Each collapse locks both groups for the rest of the pass, so collapses never chain.
+        uint32_t removeCount = triangleCount - targetTriangleCount;
+        uint32_t removed = 0;
+        uint32_t applied = 0;
+        for (const auto& collapse : collapses)
+        {
+            if (removed >= removeCount)
+                break;
+
+            uint32_t s = collapse.source;
+            uint32_t t = collapse.target;
+            if (locked[group[s]] || locked[group[t]] || flips(s, t))
+                continue;
+
+            collapseRemap[s] = t;
+            if (kind[s] == EVertexKind::Seam)
+                collapseRemap[sibling[s]] = sibling[t];
+
+            AddQuadric(quadrics[group[t]], quadrics[group[s]]);
+            locked[group[s]] = 1;
+            locked[group[t]] = 1;
+
+            removed += kind[s] == EVertexKind::Border ? 1 : 2;
+            maxError = std::max(maxError, collapse.error);
+            applied++;
+        }
+
+        if (applied == 0)
+            break;
+
+        uint32_t write = 0;
+        for (uint32_t i = 0; i < triangleCount * 3; i += 3)
+        {
+            uint32_t a = collapseRemap[indices[i + 0]];
+            uint32_t b = collapseRemap[indices[i + 1]];
+            uint32_t c = collapseRemap[indices[i + 2]];
+            if (group[a] == group[b] || group[b] == group[c] || group[c] == group[a])
+                continue;
+
+            indices[write++] = a;
+            indices[write++] = b;
+            indices[write++] = c;
+        }
+        indices.resize(write);
+
+        // An open edge whose far end collapsed into the near end continues past it.
+        for (uint32_t v = 0; v < vertexCount; v++)
+        {
+            if (openOut[v] != invalid)
+            {
+                uint32_t next = openOut[v];
+                openOut[v] = collapseRemap[next] == v ? openOut[next] : collapseRemap[next];
+            }
+            if (openIn[v] != invalid)
+            {
+                uint32_t prev = openIn[v];
+                openIn[v] = collapseRemap[prev] == v ? openIn[prev] : collapseRemap[prev];
+            }
+        }
+    }
+
+    std::copy(indices.begin(), indices.end(), pDst);
+    error = sqrtf(maxError) / scale;
+
+    return (uint32_t)indices.size();
+}
+
+void MeshSimplifier::AddPlane(Quadric& q, const float3& normal, float d, float weight)
+{
+    double w = weight;
+    q.a00 += w * normal.x * normal.x;
+    q.a11 += w * normal.y * normal.y;
+    q.a22 += w * normal.z * normal.z;
+    q.a01 += w * normal.x * normal.y;
+    q.a02 += w * normal.x * normal.z;
+    q.a12 += w * normal.y * normal.z;
+    q.b0 += w * normal.x * d;
+    q.b1 += w * normal.y * d;
+    q.b2 += w * normal.z * d;
+    q.c += w * d * d;
+    q.weight += w;
+}
+
+void MeshSimplifier::AddQuadric(Quadric& q, const Quadric& other)
+{
+    q.a00 += other.a00;
+    q.a11 += other.a11;
+    q.a22 += other.a22;
+    q.a01 += other.a01;
+    q.a02 += other.a02;
+    q.a12 += other.a12;
+    q.b0 += other.b0;
+    q.b1 += other.b1;
+    q.b2 += other.b2;
+    q.c += other.c;
+    q.weight += other.weight;
+}
+
+float MeshSimplifier::Evaluate(const Quadric& q, const float3& p)
+{
+    double x = p.x;
+    double y = p.y;
+    double z = p.z;
+
+    double e = q.a00 * x * x + q.a11 * y * y + q.a22 * z * z
+             + 2.0 * (q.a01 * x * y + q.a02 * x * z + q.a12 * y * z)
+             + 2.0 * (q.b0 * x + q.b1 * y + q.b2 * z)
+             + q.c;
+
+    return (float)e;
+}
\ No newline at end of file
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <vector>
+#include <stdint.h>
+
+#include "Vector.h"
+
+namespace Engine
+{
+    // Edge collapse driven by quadric error, see Garland and Heckbert, "Surface Simplification Using
+    // Quadric Error Metrics". Vertices only collapse onto other vertices, so every level of detail
+    // indexes the original vertex data. Open borders and attribute seams only collapse along
+    // themselves, seam wedges move together.
+    class MeshSimplifier
+    {
+    public:
+        // Attribute differences in the collapse cost, relative to squared distances in a unit sized mesh.
+        constexpr static float NORMAL_WEIGHT = 0.01f;
+        constexpr static float TEXCOORD_WEIGHT = 1.0f;
+        // Planes through open borders, perpendicular to their triangle.
+        constexpr static float BORDER_WEIGHT = 10.0f;
+        constexpr static uint32_t MAX_PASSES = 64;
+
+        // Writes at most indexCount indices to pDst and returns how many. Stops at targetIndexCount or
+        // when every remaining collapse is locked or flips a triangle. error is the largest collapse
+        // error as a distance in mesh units. pNormals and pTexcoords may be nullptr.
+        static uint32_t Simplify(const uint32_t* pIndices, uint32_t indexCount, const float3* pPositions, const float3* pNormals,
+                                 const float2* pTexcoords, uint32_t vertexCount, uint32_t targetIndexCount, uint32_t* pDst, float& error);
+
+    private:
+        enum class EVertexKind : uint8_t
+        {
+            Manifold,
+            Border,
+            Seam,
+            Locked,
+        };
+
+        // E(p) = p'Ap + 2b'p + c with symmetric A, weight is the summed triangle area.
+        struct Quadric
+        {
+            double a00, a11, a22, a01, a02, a12;
+            double b0, b1, b2;
+            double c;
+            double weight;
+        };
+
+        struct Collapse
+        {
+            float cost;
+            // Position part of the cost as a mean squared distance.
+            float error;
+            uint32_t source;
+            uint32_t target;
+        };
+
+        static void AddPlane(Quadric& q, const float3& normal, float d, float weight);
+        static void AddQuadric(Quadric& q, const Quadric& other);
+        static float Evaluate(const Quadric& q, const float3& p);
+    };
+}
\ No newline at end of file
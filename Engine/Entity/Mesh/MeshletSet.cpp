@@ -0,0 +1,319 @@
+#include <algorithm>
+#include <cmath>
+
+#include "MeshletSet.h"
+#include "Frustum.h"
+#include "Matrix.h"
+
+using namespace Engine;
+
+MeshletSet::MeshletSet() : m_meshletCount(0), m_vertexCount(0), m_triangleCount(0), m_positionCount(0)
+{
+}
+
+bool MeshletSet::Build(const float3* pPositions, uint32_t vertexCount, const uint32_t* pIndices, uint32_t indexCount)
+{
+    std::vector<Meshlet> meshlets;
+    std::vector<uint32_t> vertices;
+    std::vector<uint8_t> triangles;
+
+    // Local index of each mesh vertex in the current meshlet, valid while its stamp matches.
+    std::vector<uint8_t> localIndex(vertexCount, 0);
+    std::vector<uint32_t> stamp(vertexCount, 0);
+    uint32_t current = 1;
+
+    Meshlet meshlet = {};
+
+    auto flush = [&]() {
+        if (meshlet.triangleCount == 0)
+            return;
+
+        ComputeBounds(meshlet, &vertices[meshlet.vertexOffset], &triangles[meshlet.triangleOffset * 3], pPositions);
+        meshlets.push_back(meshlet);
+
+        meshlet = {};
+        meshlet.vertexOffset = (uint32_t)vertices.size();
+        meshlet.triangleOffset = (uint32_t)triangles.size() / 3;
+        current++;
+    };
+
+    for (uint32_t i = 0; i + 2 < indexCount; i += 3)
+    {
+        uint32_t newVertices = 0;
+        for (uint32_t k = 0; k < 3; k++)
+        {
+            uint32_t v = pIndices[i + k];
+            if (v >= vertexCount)
+                return false;
+
+            if (stamp[v] != current)
+                newVertices++;
+        }
+
+        if (meshlet.vertexCount + newVertices > MAX_VERTICES || meshlet.triangleCount == MAX_TRIANGLES)
+            flush();
+
+        for (uint32_t k = 0; k < 3; k++)
+        {
+            uint32_t v = pIndices[i + k];
+            if (stamp[v] != current)
+            {
+                stamp[v] = current;
+                localIndex[v] = (uint8_t)meshlet.vertexCount++;
+                vertices.push_back(v);
+            }
+            triangles.push_back(localIndex[v]);
+        }
+        meshlet.triangleCount++;
+    }
+
+    flush();
+
+    if (meshlets.empty())
+        return false;
+
+    m_pMeshlets = Share(meshlets);
+    m_meshletCount = (uint32_t)meshlets.size();
+    m_pVertices = Share(vertices);
+    m_vertexCount = (uint32_t)vertices.size();
+    m_pTriangles = Share(triangles);
+    m_triangleCount = (uint32_t)triangles.size() / 3;
+    m_pPositions = Share(std::vector<float3>(pPositions, pPositions + vertexCount));
+    m_positionCount = vertexCount;
+
+    return true;
+}
+
+bool MeshletSet::Attach(std::shared_ptr<char> pMeshlets, uint32_t meshletCount, std::shared_ptr<char> pVertices, uint32_t vertexCount,
+                        std::shared_ptr<char> pTriangles, uint32_t triangleCount, std::shared_ptr<char> pPositions, uint32_t positionCount)
+{
+    const Meshlet* pSrc = reinterpret_cast<const Meshlet*>(pMeshlets.get());
+    for (uint32_t i = 0; i < meshletCount; i++)
+    {
+        const auto& meshlet = pSrc[i];
+        if (meshlet.vertexCount > MAX_VERTICES || meshlet.triangleCount > MAX_TRIANGLES ||
+            (uint64_t)meshlet.vertexOffset + meshlet.vertexCount > vertexCount ||
+            (uint64_t)meshlet.triangleOffset + meshlet.triangleCount > triangleCount)
+            return false;
+    }
+
+    m_pMeshlets = pMeshlets;
+    m_meshletCount = meshletCount;
+    m_pVertices = pVertices;
+    m_vertexCount = vertexCount;
+    m_pTriangles = pTriangles;
+    m_triangleCount = triangleCount;
+    m_pPositions = pPositions;
+    m_positionCount = positionCount;
+
+    return true;
+}
+
+void MeshletSet::Cull(const MeshViewParams& params, std::vector<uint32_t>& indices) const
+{
+    float4x4 worldViewProj = Mat::Mul(params.world, params.viewProj);
+    Frustum frustum(worldViewProj);
+
+    // Camera in object space by Cramer's rule on the affine part of the row vector world matrix.
+    const float4x4& w = params.world;
+    float3 r0(w.x00, w.x01, w.x02);
+    float3 r1(w.x10, w.x11, w.x12);
+    float3 r2(w.x20, w.x21, w.x22);
+    float3 offset = params.cameraPosition - float3(w.x30, w.x31, w.x32);
+
+    float3 c12 = Vec::Cross(r1, r2);
+    float det = Vec::Dot(r0, c12);
+
+    bool bConeTest = det > 1e-12f;
+    float3 camera(0.0f);
+    if (bConeTest)
+        camera = float3(Vec::Dot(offset, c12), Vec::Dot(offset, Vec::Cross(r2, r0)), Vec::Dot(offset, Vec::Cross(r0, r1))) / det;
+
+    bool bSmallTest = params.viewportSize.x > 0.0f && params.viewportSize.y > 0.0f;
+    float4 clip[MAX_VERTICES];
+
+    const float3* pPositions = GetPositions();
+    for (uint32_t i = 0; i < m_meshletCount; i++)
+    {
+        const auto& meshlet = GetMeshlets()[i];
+
+        if (!frustum.Intersect(meshlet.bounds))
+            continue;
+
+        if (bConeTest && meshlet.coneCutoff <= 1.0f)
+        {
+            float3 view = meshlet.coneApex - camera;
+            if (Vec::Dot(view, meshlet.coneAxis) >= meshlet.coneCutoff * Vec::Length(view))
+                continue;
+        }
+
+        const uint32_t* pVertices = GetVertices() + meshlet.vertexOffset;
+        const uint8_t* pTriangles = GetTriangles() + meshlet.triangleOffset * 3;
+
+        if (bSmallTest)
+        {
+            for (uint32_t v = 0; v < meshlet.vertexCount; v++)
+            {
+                const float3& p = pPositions[pVertices[v]];
+                clip[v] = Mat::Mul(float4(p.x, p.y, p.z, 1.0f), worldViewProj);
+            }
+        }
+
+        for (uint32_t t = 0; t < meshlet.triangleCount; t++)
+        {
+            uint8_t a = pTriangles[t * 3 + 0];
+            uint8_t b = pTriangles[t * 3 + 1];
+            uint8_t c = pTriangles[t * 3 + 2];
+
+            if (bSmallTest && IsSmallTriangle(clip[a], clip[b], clip[c], params.viewportSize))
+                continue;
+
+            indices.push_back(pVertices[a]);
+            indices.push_back(pVertices[b]);
+            indices.push_back(pVertices[c]);
+        }
+    }
+}
+
+uint32_t MeshletSet::GetMeshletCount() const
+{
+    return m_meshletCount;
+}
+
+const MeshletSet::Meshlet& MeshletSet::GetMeshlet(uint32_t index) const
+{
+    return GetMeshlets()[index];
+}
+
+const MeshletSet::Meshlet* MeshletSet::GetMeshlets() const
+{
+    return reinterpret_cast<const Meshlet*>(m_pMeshlets.get());
+}
+
+const uint32_t* MeshletSet::GetVertices() const
+{
+    return reinterpret_cast<const uint32_t*>(m_pVertices.get());
+}
+
+uint32_t MeshletSet::GetVertexCount() const
+{
+    return m_vertexCount;
+}
+
+const uint8_t* MeshletSet::GetTriangles() const
+{
+    return reinterpret_cast<const uint8_t*>(m_pTriangles.get());
+}
+
+uint32_t MeshletSet::GetTriangleCount() const
+{
+    return m_triangleCount;
+}
+
+const float3* MeshletSet::GetPositions() const
+{
+    return reinterpret_cast<const float3*>(m_pPositions.get());
+}
+
+uint32_t MeshletSet::GetPositionCount() const
+{
+    return m_positionCount;
+}
+
+void MeshletSet::ComputeBounds(Meshlet& meshlet, const uint32_t* pVertices, const uint8_t* pTriangles, const float3* pPositions)
+{
+    // The smaller of the box sphere and the incrementally grown one.
+    Box3 box;
+    Sphere sphere;
+    for (uint32_t v = 0; v < meshlet.vertexCount; v++)
+    {
+        box.Expand(pPositions[pVertices[v]]);
+        sphere.Expand(pPositions[pVertices[v]]);
+    }
+
+    Sphere boxSphere(box);
+    meshlet.bounds = boxSphere.mRadius < sphere.mRadius ? boxSphere : sphere;
+
+    float3 normals[MAX_TRIANGLES];
+    float3 axis(0.0f);
+    uint32_t normalCount = 0;
+    for (uint32_t t = 0; t < meshlet.triangleCount; t++)
+    {
+        const float3& p0 = pPositions[pVertices[pTriangles[t * 3 + 0]]];
+        const float3& p1 = pPositions[pVertices[pTriangles[t * 3 + 1]]];
+        const float3& p2 = pPositions[pVertices[pTriangles[t * 3 + 2]]];
+
+        float3 normal = Vec::Cross(p1 - p0, p2 - p0);
+        float length = Vec::Length(normal);
+        if (length <= 0.0f)
+        {
+            normals[t] = float3(0.0f);
+            continue;
+        }
+
+        normals[t] = normal / length;
+        axis += normals[t];
+        normalCount++;
+    }
+
+    meshlet.coneApex = meshlet.bounds.mCenter;
+    meshlet.coneAxis = float3(0.0f, 0.0f, 1.0f);
+    meshlet.coneCutoff = 2.0f;
+
+    float axisLength = Vec::Length(axis);
+    if (normalCount == 0 || axisLength <= 0.0f)
+        return;
+
+    axis = axis / axisLength;
+
+    float minDot = 1.0f;
+    for (uint32_t t = 0; t < meshlet.triangleCount; t++)
+    {
+        if (Vec::LengthSquared(normals[t]) > 0.0f)
+            minDot = std::min(minDot, Vec::Dot(axis, normals[t]));
+    }
+
+    // Nearly hemispherical spreads would put the apex far away and never cull.
+    if (minDot <= 0.1f)
+        return;
+
+    // Move the apex back along the axis until it is behind every triangle plane.
+    float maxT = 0.0f;
+    for (uint32_t t = 0; t < meshlet.triangleCount; t++)
+    {
+        if (Vec::LengthSquared(normals[t]) <= 0.0f)
+            continue;
+
+        const float3& p0 = pPositions[pVertices[pTriangles[t * 3 + 0]]];
+        float dc = Vec::Dot(meshlet.bounds.mCenter - p0, normals[t]);
+        float dn = Vec::Dot(axis, normals[t]);
+        maxT = std::max(maxT, dc / dn);
+    }
+
+    meshlet.coneApex = meshlet.bounds.mCenter - axis * maxT;
+    meshlet.coneAxis = axis;
+    meshlet.coneCutoff = sqrtf(1.0f - minDot * minDot);
+}
+
+bool MeshletSet::IsSmallTriangle(const float4& c0, const float4& c1, const float4& c2, const float2& viewportSize)
+{
+    // Triangles crossing the camera plane are left to the clipper.
+    if (c0.w <= 0.0f || c1.w <= 0.0f || c2.w <= 0.0f)
+        return false;
+
+    float2 s0((c0.x / c0.w * 0.5f + 0.5f) * viewportSize.x, (c0.y / c0.w * 0.5f + 0.5f) * viewportSize.y);
+    float2 s1((c1.x / c1.w * 0.5f + 0.5f) * viewportSize.x, (c1.y / c1.w * 0.5f + 0.5f) * viewportSize.y);
+    float2 s2((c2.x / c2.w * 0.5f + 0.5f) * viewportSize.x, (c2.y / c2.w * 0.5f + 0.5f) * viewportSize.y);
+
+    float area = (s1.x - s0.x) * (s2.y - s0.y) - (s2.x - s0.x) * (s1.y - s0.y);
+    if (area == 0.0f)
+        return true;
+
+    // Sample centers sit at half pixels, rounding both box ends to the same one means none is inside.
+    float minX = std::min(std::min(s0.x, s1.x), s2.x);
+    float maxX = std::max(std::max(s0.x, s1.x), s2.x);
+    float minY = std::min(std::min(s0.y, s1.y), s2.y);
+    float maxY = std::max(std::max(s0.y, s1.y), s2.y);
+
+    return floorf(minX + 0.5f) == floorf(maxX + 0.5f) || floorf(minY + 0.5f) == floorf(maxY + 0.5f);
+}
\ No newline at end of file
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+#include <stdint.h>
+#include <string.h>
+
+#include "Vector.h"
+#include "Sphere.h"
+
+#include "IMesh.h"
+
+namespace Engine
+{
+    // Triangle clusters small enough to cull one by one. Triangles keep their input order, so meshlets
+    // of a cache optimized mesh are spatially coherent.
+    class MeshletSet
+    {
+    public:
+        constexpr static uint32_t MAX_VERTICES = 64;
+        constexpr static uint32_t MAX_TRIANGLES = 124;
+
+        struct Meshlet
+        {
+            Sphere bounds;
+            // Backface cone, see Wihlidal, "Optimizing the Graphics Pipeline with Compute". Every
+            // triangle faces away from the camera when dot(normalize(coneApex - camera), coneAxis)
+            // >= coneCutoff. coneCutoff > 1 means the normals spread too far for a cone.
+            float3 coneApex;
+            float3 coneAxis;
+            float coneCutoff;
+
+            uint32_t vertexOffset;
+            uint32_t triangleOffset;
+            uint32_t vertexCount;
+            uint32_t triangleCount;
+        };
+
+        MeshletSet();
+        virtual ~MeshletSet() = default;
+
+        bool Build(const float3* pPositions, uint32_t vertexCount, const uint32_t* pIndices, uint32_t indexCount);
+
+        // Shares arrays laid out as Build leaves them, e.g. views into a mapped .ntmesh. Only the
+        // meshlet ranges are checked, vertices must index the positions.
+        bool Attach(std::shared_ptr<char> pMeshlets, uint32_t meshletCount, std::shared_ptr<char> pVertices, uint32_t vertexCount,
+                    std::shared_ptr<char> pTriangles, uint32_t triangleCount, std::shared_ptr<char> pPositions, uint32_t positionCount);
+
+        // Appends the mesh indices of the visible triangles. Culling runs in object space, the cone
+        // test is skipped for mirroring world matrices.
+        void Cull(const MeshViewParams& params, std::vector<uint32_t>& indices) const;
+
+        uint32_t GetMeshletCount() const;
+        const Meshlet& GetMeshlet(uint32_t index) const;
+
+        // The arrays Attach takes, triangles count three bytes each.
+        const Meshlet* GetMeshlets() const;
+        const uint32_t* GetVertices() const;
+        uint32_t GetVertexCount() const;
+        const uint8_t* GetTriangles() const;
+        uint32_t GetTriangleCount() const;
+        const float3* GetPositions() const;
+        uint32_t GetPositionCount() const;
+
+    private:
+        static void ComputeBounds(Meshlet& meshlet, const uint32_t* pVertices, const uint8_t* pTriangles, const float3* pPositions);
+
+        template<typename T>
+        static std::shared_ptr<char> Share(const std::vector<T>& array);
+
+        // True when no sample center is covered or the triangle has no area on screen.
+        static bool IsSmallTriangle(const float4& c0, const float4& c1, const float4& c2, const float2& viewportSize);
+
+    private:
+        std::shared_ptr<char> m_pMeshlets;
+        uint32_t m_meshletCount;
+        // Mesh vertex per meshlet vertex, and three meshlet vertices per triangle.
+        std::shared_ptr<char> m_pVertices;
+        uint32_t m_vertexCount;
+        std::shared_ptr<char> m_pTriangles;
+        uint32_t m_triangleCount;
+        // Float positions of the mesh, its own streams are quantized after import.
+        std::shared_ptr<char> m_pPositions;
+        uint32_t m_positionCount;
+    };
+
+    template<typename T>
+    std::shared_ptr<char> MeshletSet::Share(const std::vector<T>& array)
+    {
+        char* pData = new char[array.size() * sizeof(T)];
+        memcpy(pData, array.data(), array.size() * sizeof(T));
+
+        return std::shared_ptr<char>(pData, std::default_delete<char[]>());
+    }
+}
\ No newline at end of file
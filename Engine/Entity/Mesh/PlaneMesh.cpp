@@ -31,6 +31,8 @@ PlaneMesh::PlaneMesh()
     AttachVertexData<float3>(position, sizeof(position) / sizeof (float3), Attribute::ESemanticType::Position, "POSITION");
     AttachVertexData<float3>(normal, sizeof(position) / sizeof (float3), Attribute::ESemanticType::Normal, "NORMAL");
     AttachIndexData<short>(indices, sizeof(indices) / sizeof(short));
+
+    Quantize();
 }
 
 PlaneMesh::~PlaneMesh()
@@ -0,0 +1,659 @@
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+
+#include <algorithm>
+#include <codecvt>
+#include <fstream>
+#include <locale>
+#include <vector>
+#include <math.h>
+#include <string.h>
+
+#include <DirectXTex.h>
+
+#include "Global.h"
+#include "Hash64.h"
+#include "SIMD.h"
+#include "TextureCooker.h"
+
+#include "EnvironmentBaker.h"
+
+using namespace Engine;
+
+constexpr static float PI = 3.14159265358979f;
+// Irradiance is smooth, the harmonics are projected from the first radiance mip no larger than this.
+constexpr static uint32_t SH_FACE_SIZE = 64;
+// Equirect texels averaged per cube texel on either axis at most.
+constexpr static uint32_t MAX_SUPERSAMPLES = 4;
+
+enum EItem
+{
+    eItem_Specular = 0,
+    eItem_Irradiance,
+    eItem_BRDF,
+};
+
+// One level of a float RGBA cube map, the six faces one after another in D3D order.
+struct CubeLevel
+{
+    uint32_t size;
+    std::vector<float> texels;
+};
+
+// GGX samples around +Z in tangent space, structure of arrays in groups of four. Padding has no weight.
+struct Samples
+{
+    std::vector<float> x;
+    std::vector<float> y;
+    std::vector<float> z;
+    std::vector<float> weights;
+    std::vector<float> lods;
+    float normalization;
+};
+
+static uint64_t DeriveKey(uint64_t key, EItem item)
+{
+    Hash64 hash;
+    hash.Update(key);
+    hash.Update(item);
+    return hash.Final();
+}
+
+static float RadicalInverse(uint32_t bits)
+{
+    bits = (bits << 16) | (bits >> 16);
+    bits = ((bits & 0x55555555u) << 1) | ((bits & 0xAAAAAAAAu) >> 1);
+    bits = ((bits & 0x33333333u) << 2) | ((bits & 0xCCCCCCCCu) >> 2);
+    bits = ((bits & 0x0F0F0F0Fu) << 4) | ((bits & 0xF0F0F0F0u) >> 4);
+    bits = ((bits & 0x00FF00FFu) << 8) | ((bits & 0xFF00FF00u) >> 8);
+    return (float)bits * 2.3283064365386963e-10f;
+}
+
+// Half vector of the i-th of count Hammersley points for alpha = roughness^2, around +Z.
+static void SampleGGX(uint32_t i, uint32_t count, float alpha, float& x, float& y, float& z)
+{
+    float phi = 2.0f * PI * ((float)i + 0.5f) / (float)count;
+    float e = RadicalInverse(i);
+    float cosTheta = sqrtf((1.0f - e) / (1.0f + (alpha * alpha - 1.0f) * e));
+    float sinTheta = sqrtf(std::max(1.0f - cosTheta * cosTheta, 0.0f));
+
+    x = sinTheta * cosf(phi);
+    y = sinTheta * sinf(phi);
+    z = cosTheta;
+}
+
+// s and t run from -1 to 1 across and down the face.
+static void FaceDirection(uint32_t face, float s, float t, float* pDirection)
+{
+    float x, y, z;
+    switch (face)
+    {
+        case 0:     x = 1.0f;   y = -t;     z = -s;     break;
+        case 1:     x = -1.0f;  y = -t;     z = s;      break;
+        case 2:     x = s;      y = 1.0f;   z = t;      break;
+        case 3:     x = s;      y = -1.0f;  z = -t;     break;
+        case 4:     x = s;      y = -t;     z = 1.0f;   break;
+        default:    x = -s;     y = -t;     z = -1.0f;  break;
+    }
+
+    float scale = 1.0f / sqrtf(x * x + y * y + z * z);
+    pDirection[0] = x * scale;
+    pDirection[1] = y * scale;
+    pDirection[2] = z * scale;
+}
+
+static __m128 Lerp(__m128 a, __m128 b, float t)
+{
+    return _mm_add_ps(a, _mm_mul_ps(_mm_sub_ps(b, a), _mm_set1_ps(t)));
+}
+
+// Clamped at the edges, wrapping across the seam when bWrap.
+static __m128 SampleBilinear(const float* pTexels, uint32_t width, uint32_t height, float u, float v, bool bWrap)
+{
+    u = u * width - 0.5f;
+    v = std::min(std::max(v * height - 0.5f, 0.0f), (float)(height - 1));
+    if (!bWrap)
+        u = std::min(std::max(u, 0.0f), (float)(width - 1));
+
+    float x = floorf(u);
+    float y = floorf(v);
+    int32_t x0 = (int32_t)x;
+    int32_t x1 = x0 + 1;
+    if (bWrap)
+    {
+        x0 = (x0 % (int32_t)width + (int32_t)width) % (int32_t)width;
+        x1 = (x1 % (int32_t)width + (int32_t)width) % (int32_t)width;
+    }
+    else
+        x1 = std::min(x1, (int32_t)width - 1);
+
+    uint32_t y0 = (uint32_t)y;
+    uint32_t y1 = std::min(y0 + 1, height - 1);
+
+    const float* pRow0 = pTexels + (size_t)y0 * width * 4;
+    const float* pRow1 = pTexels + (size_t)y1 * width * 4;
+    __m128 top = Lerp(_mm_loadu_ps(pRow0 + x0 * 4), _mm_loadu_ps(pRow0 + x1 * 4), u - x);
+    __m128 bottom = Lerp(_mm_loadu_ps(pRow1 + x0 * 4), _mm_loadu_ps(pRow1 + x1 * 4), u - x);
+    return Lerp(top, bottom, v - y);
+}
+
+// Trilinear, without filtering across faces.
+static __m128 SampleCube(const std::vector<CubeLevel>& cube, float x, float y, float z, float lod)
+{
+    float ax = fabsf(x);
+    float ay = fabsf(y);
+    float az = fabsf(z);
+
+    uint32_t face;
+    float s, t, major;
+    if (ax >= ay && ax >= az)
+    {
+        face = x > 0.0f ? 0 : 1;
+        major = ax;
+        s = x > 0.0f ? -z : z;
+        t = -y;
+    }
+    else if (ay >= az)
+    {
+        face = y > 0.0f ? 2 : 3;
+        major = ay;
+        s = x;
+        t = y > 0.0f ? z : -z;
+    }
+    else
+    {
+        face = z > 0.0f ? 4 : 5;
+        major = az;
+        s = z > 0.0f ? x : -x;
+        t = -y;
+    }
+
+    float u = s / major * 0.5f + 0.5f;
+    float v = t / major * 0.5f + 0.5f;
+
+    lod = std::min(std::max(lod, 0.0f), (float)(cube.size() - 1));
+    uint32_t level = (uint32_t)lod;
+    float fraction = lod - level;
+
+    const auto& first = cube[level];
+    __m128 texel = SampleBilinear(first.texels.data() + (size_t)face * first.size * first.size * 4, first.size, first.size, u, v, false);
+    if (fraction > 0.0f && level + 1 < cube.size())
+    {
+        const auto& second = cube[level + 1];
+        texel = Lerp(texel, SampleBilinear(second.texels.data() + (size_t)face * second.size * second.size * 4, second.size, second.size, u, v, false), fraction);
+    }
+
+    return texel;
+}
+
+static bool ReadEnvironment(const void* pSrc, uint32_t size, DirectX::ScratchImage& image)
+{
+    DirectX::TexMetadata metadata;
+    HRESULT hr = E_FAIL;
+    if (TextureCooker::IsCooked(pSrc, size))
+        hr = DirectX::LoadFromDDSMemory(pSrc, size, DirectX::DDS_FLAGS_NONE, &metadata, image);
+    else if (size >= 2 && memcmp(pSrc, "#?", 2) == 0)
+        hr = DirectX::LoadFromHDRMemory(pSrc, size, &metadata, image);
+
+    if (FAILED(hr) || DirectX::IsCompressed(metadata.format) || metadata.dimension != DirectX::TEX_DIMENSION_TEXTURE2D || metadata.IsCubemap())
+        return false;
+
+    if (metadata.format == DXGI_FORMAT_R32G32B32A32_FLOAT)
+        return true;
+
+    DirectX::ScratchImage converted;
+    hr = DirectX::Convert(*image.GetImage(0, 0, 0), DXGI_FORMAT_R32G32B32A32_FLOAT, DirectX::TEX_FILTER_DEFAULT | DirectX::TEX_FILTER_PARALLEL, DirectX::TEX_THRESHOLD_DEFAULT, converted);
+    if (FAILED(hr))
+        return false;
+
+    image = std::move(converted);
+    return true;
+}
+
+// +Y is up, the seam of the equirect is at -X.
+static void FillFromEquirect(const DirectX::Image& equirect, CubeLevel& level)
+{
+    uint32_t size = level.size;
+    uint32_t supersamples = std::min(std::max((uint32_t)equirect.width / (4 * size), 1u), MAX_SUPERSAMPLES);
+    const float* pSrc = reinterpret_cast<const float*>(equirect.pixels);
+    const __m128 scale = _mm_set1_ps(1.0f / (supersamples * supersamples));
+
+    level.texels.resize((size_t)6 * size * size * 4);
+    gpGlobal->GetJobSystem().ParallelFor(6 * size, 4, [&](uint32_t begin, uint32_t end) {
+        for (uint32_t row = begin; row < end; row++)
+        {
+            uint32_t face = row / size;
+            uint32_t y = row % size;
+            float* pDst = level.texels.data() + (size_t)row * size * 4;
+            for (uint32_t x = 0; x < size; x++)
+            {
+                __m128 sum = _mm_setzero_ps();
+                for (uint32_t j = 0; j < supersamples; j++)
+                {
+                    for (uint32_t i = 0; i < supersamples; i++)
+                    {
+                        float direction[3];
+                        float s = (x + (i + 0.5f) / supersamples) / size * 2.0f - 1.0f;
+                        float t = (y + (j + 0.5f) / supersamples) / size * 2.0f - 1.0f;
+                        FaceDirection(face, s, t, direction);
+
+                        float u = atan2f(direction[2], direction[0]) / (2.0f * PI) + 0.5f;
+                        float v = acosf(std::min(std::max(direction[1], -1.0f), 1.0f)) / PI;
+                        sum = _mm_add_ps(sum, SampleBilinear(pSrc, (uint32_t)equirect.width, (uint32_t)equirect.height, u, v, true));
+                    }
+                }
+
+                _mm_storeu_ps(pDst + x * 4, _mm_mul_ps(sum, scale));
+            }
+        }
+    });
+}
+
+static void Downsample(const CubeLevel& src, CubeLevel& dst)
+{
+    dst.size = src.size / 2;
+    dst.texels.resize((size_t)6 * dst.size * dst.size * 4);
+
+    const __m128 quarter = _mm_set1_ps(0.25f);
+    gpGlobal->GetJobSystem().ParallelFor(6 * dst.size, 16, [&](uint32_t begin, uint32_t end) {
+        for (uint32_t row = begin; row < end; row++)
+        {
+            // Rows of the faces follow one another, so row 2r and 2r + 1 of the source stay in the face.
+            const float* pRow0 = src.texels.data() + (size_t)row * 2 * src.size * 4;
+            const float* pRow1 = pRow0 + (size_t)src.size * 4;
+            float* pDst = dst.texels.data() + (size_t)row * dst.size * 4;
+            for (uint32_t x = 0; x < dst.size; x++)
+            {
+                __m128 sum = _mm_add_ps(_mm_add_ps(_mm_loadu_ps(pRow0 + x * 8), _mm_loadu_ps(pRow0 + x * 8 + 4)),
+                    _mm_add_ps(_mm_loadu_ps(pRow1 + x * 8), _mm_loadu_ps(pRow1 + x * 8 + 4)));
+                _mm_storeu_ps(pDst + x * 4, _mm_mul_ps(sum, quarter));
+            }
+        }
+    });
+}
+
+static float AreaElement(float x, float y)
+{
+    return atan2f(x * y, sqrtf(x * x + y * y + 1.0f));
+}
+
+static void ProjectIrradiance(const CubeLevel& level, EnvironmentBaker::Irradiance& irradiance)
+{
+    uint32_t size = level.size;
+    uint32_t rowCount = 6 * size;
+    float texelSize = 2.0f / size;
+
+    // A sum per row, added up in order afterwards so the result does not depend on the scheduling.
+    std::vector<__m128> rowSums((size_t)rowCount * 9, _mm_setzero_ps());
+    gpGlobal->GetJobSystem().ParallelFor(rowCount, 4, [&](uint32_t begin, uint32_t end) {
+        for (uint32_t row = begin; row < end; row++)
+        {
+            uint32_t face = row / size;
+            uint32_t y = row % size;
+            float t = (y + 0.5f) * texelSize - 1.0f;
+            const float* pSrc = level.texels.data() + (size_t)row * size * 4;
+
+            __m128 sums[9];
+            for (uint32_t i = 0; i < 9; i++)
+                sums[i] = _mm_setzero_ps();
+
+            for (uint32_t x = 0; x < size; x++)
+            {
+                float s = (x + 0.5f) * texelSize - 1.0f;
+                float d[3];
+                FaceDirection(face, s, t, d);
+
+                float s0 = s - texelSize * 0.5f;
+                float s1 = s + texelSize * 0.5f;
+                float t0 = t - texelSize * 0.5f;
+                float t1 = t + texelSize * 0.5f;
+                float solidAngle = AreaElement(s0, t0) - AreaElement(s0, t1) - AreaElement(s1, t0) + AreaElement(s1, t1);
+
+                float basis[9] = {
+                    0.282095f,
+                    0.488603f * d[1],
+                    0.488603f * d[2],
+                    0.488603f * d[0],
+                    1.092548f * d[0] * d[1],
+                    1.092548f * d[1] * d[2],
+                    0.315392f * (3.0f * d[2] * d[2] - 1.0f),
+                    1.092548f * d[0] * d[2],
+                    0.546274f * (d[0] * d[0] - d[1] * d[1]),
+                };
+
+                __m128 radiance = _mm_mul_ps(_mm_loadu_ps(pSrc + x * 4), _mm_set1_ps(solidAngle));
+                for (uint32_t i = 0; i < 9; i++)
+                    sums[i] = _mm_add_ps(sums[i], _mm_mul_ps(radiance, _mm_set1_ps(basis[i])));
+            }
+
+            for (uint32_t i = 0; i < 9; i++)
+                rowSums[(size_t)row * 9 + i] = sums[i];
+        }
+    });
+
+    // Convolution with the clamped cosine, per band.
+    const float bands[9] = { PI, 2.0f * PI / 3.0f, 2.0f * PI / 3.0f, 2.0f * PI / 3.0f, PI / 4.0f, PI / 4.0f, PI / 4.0f, PI / 4.0f, PI / 4.0f };
+    for (uint32_t i = 0; i < 9; i++)
+    {
+        __m128 sum = _mm_setzero_ps();
+        for (uint32_t row = 0; row < rowCount; row++)
+            sum = _mm_add_ps(sum, rowSums[(size_t)row * 9 + i]);
+
+        MATH_SIMD_ALIGN(16) float values[4];
+        _mm_store_ps(values, _mm_mul_ps(sum, _mm_set1_ps(bands[i])));
+        for (uint32_t c = 0; c < 3; c++)
+            irradiance.coefficients[i][c] = values[c];
+    }
+}
+
+// Importance sampled with N = V = R. Each sample reads the radiance mip whose texels cover about the
+// solid angle the sample stands for, which keeps few samples free of fireflies.
+static Samples PrepareSamples(float roughness, uint32_t count, uint32_t radianceSize)
+{
+    float alpha = roughness * roughness;
+    float alpha2 = alpha * alpha;
+    float texelSolidAngle = 4.0f * PI / (6.0f * radianceSize * radianceSize);
+
+    Samples samples;
+    float weightSum = 0.0f;
+    for (uint32_t i = 0; i < count; i++)
+    {
+        float hx, hy, hz;
+        SampleGGX(i, count, alpha, hx, hy, hz);
+
+        float lz = 2.0f * hz * hz - 1.0f;
+        if (lz <= 0.0f)
+            continue;
+
+        float denominator = hz * hz * (alpha2 - 1.0f) + 1.0f;
+        float pdf = alpha2 / (PI * denominator * denominator) * 0.25f;
+        float sampleSolidAngle = 1.0f / (count * pdf + 1e-6f);
+
+        samples.x.push_back(2.0f * hz * hx);
+        samples.y.push_back(2.0f * hz * hy);
+        samples.z.push_back(lz);
+        samples.weights.push_back(lz);
+        samples.lods.push_back(roughness == 0.0f ? 0.0f : std::max(0.5f * log2f(sampleSolidAngle / texelSolidAngle) + 1.0f, 0.0f));
+        weightSum += lz;
+    }
+
+    while (samples.x.size() % 4 != 0)
+    {
+        samples.x.push_back(0.0f);
+        samples.y.push_back(0.0f);
+        samples.z.push_back(1.0f);
+        samples.weights.push_back(0.0f);
+        samples.lods.push_back(0.0f);
+    }
+
+    samples.normalization = weightSum > 0.0f ? 1.0f / weightSum : 0.0f;
+    return samples;
+}
+
+static __m128 Prefilter(const std::vector<CubeLevel>& radiance, const Samples& samples, const float* pNormal)
+{
+    float up[3] = { 0.0f, 0.0f, 1.0f };
+    if (fabsf(pNormal[2]) >= 0.999f)
+    {
+        up[0] = 1.0f;
+        up[2] = 0.0f;
+    }
+
+    float tangent[3] = { up[1] * pNormal[2] - up[2] * pNormal[1], up[2] * pNormal[0] - up[0] * pNormal[2], up[0] * pNormal[1] - up[1] * pNormal[0] };
+    float scale = 1.0f / sqrtf(tangent[0] * tangent[0] + tangent[1] * tangent[1] + tangent[2] * tangent[2]);
+    for (uint32_t i = 0; i < 3; i++)
+        tangent[i] *= scale;
+
+    float bitangent[3] = { pNormal[1] * tangent[2] - pNormal[2] * tangent[1], pNormal[2] * tangent[0] - pNormal[0] * tangent[2], pNormal[0] * tangent[1] - pNormal[1] * tangent[0] };
+
+    __m128 frame[3][3];
+    for (uint32_t i = 0; i < 3; i++)
+    {
+        frame[0][i] = _mm_set1_ps(tangent[i]);
+        frame[1][i] = _mm_set1_ps(bitangent[i]);
+        frame[2][i] = _mm_set1_ps(pNormal[i]);
+    }
+
+    // Four samples are turned into world space at once, the fetches are one at a time.
+    __m128 sum = _mm_setzero_ps();
+    for (size_t i = 0; i < samples.x.size(); i += 4)
+    {
+        __m128 x = _mm_loadu_ps(samples.x.data() + i);
+        __m128 y = _mm_loadu_ps(samples.y.data() + i);
+        __m128 z = _mm_loadu_ps(samples.z.data() + i);
+
+        MATH_SIMD_ALIGN(16) float directions[3][4];
+        for (uint32_t c = 0; c < 3; c++)
+            _mm_store_ps(directions[c], _mm_add_ps(_mm_add_ps(_mm_mul_ps(frame[0][c], x), _mm_mul_ps(frame[1][c], y)), _mm_mul_ps(frame[2][c], z)));
+
+        for (uint32_t k = 0; k < 4; k++)
+        {
+            float weight = samples.weights[i + k];
+            if (weight > 0.0f)
+                sum = _mm_add_ps(sum, _mm_mul_ps(SampleCube(radiance, directions[0][k], directions[1][k], directions[2][k], samples.lods[i + k]), _mm_set1_ps(weight)));
+        }
+    }
+
+    return _mm_mul_ps(sum, _mm_set1_ps(samples.normalization));
+}
+
+static bool BakeSpecular(const std::vector<CubeLevel>& radiance, const EnvironmentBaker::Desc& desc, uint32_t mipCount, DirectX::ScratchImage& specular)
+{
+    if (FAILED(specular.InitializeCube(DXGI_FORMAT_R32G32B32A32_FLOAT, desc.faceSize, desc.faceSize, 1, mipCount)))
+        return false;
+
+    // The top mip is the mirror reflection, which is the radiance itself.
+    std::vector<Samples> samples(mipCount);
+    std::vector<uint32_t> firstRows(mipCount + 1, 0);
+    for (uint32_t mip = 0; mip < mipCount; mip++)
+    {
+        if (mip > 0)
+            samples[mip] = PrepareSamples((float)mip / (mipCount - 1), desc.sampleCount, desc.faceSize);
+        firstRows[mip + 1] = firstRows[mip] + 6 * (desc.faceSize >> mip);
+    }
+
+    // The rows of all mips are spread over the workers together, the small mips would leave most of
+    // them idle on their own.
+    gpGlobal->GetJobSystem().ParallelFor(firstRows[mipCount], 1, [&](uint32_t begin, uint32_t end) {
+        for (uint32_t row = begin; row < end; row++)
+        {
+            uint32_t mip = (uint32_t)(std::upper_bound(firstRows.begin(), firstRows.end(), row) - firstRows.begin()) - 1;
+            uint32_t size = desc.faceSize >> mip;
+            uint32_t face = (row - firstRows[mip]) / size;
+            uint32_t y = (row - firstRows[mip]) % size;
+
+            const DirectX::Image* pImage = specular.GetImage(mip, face, 0);
+            float* pDst = reinterpret_cast<float*>(pImage->pixels + y * pImage->rowPitch);
+            if (mip == 0)
+            {
+                memcpy(pDst, radiance[0].texels.data() + ((size_t)face * size + y) * size * 4, (size_t)size * 4 * sizeof(float));
+                continue;
+            }
+
+            for (uint32_t x = 0; x < size; x++)
+            {
+                float normal[3];
+                FaceDirection(face, (x + 0.5f) / size * 2.0f - 1.0f, (y + 0.5f) / size * 2.0f - 1.0f, normal);
+                _mm_storeu_ps(pDst + x * 4, Prefilter(radiance, samples[mip], normal));
+            }
+        }
+    });
+
+    return true;
+}
+
+// Split sum scale and bias, after Karis, Real Shading in Unreal Engine 4. Four samples at a time.
+static bool BakeBRDF(const EnvironmentBaker::Desc& desc, DirectX::ScratchImage& lut)
+{
+    uint32_t size = desc.lutSize;
+    uint32_t count = (desc.lutSampleCount + 3) & ~3u;
+    if (FAILED(lut.Initialize2D(DXGI_FORMAT_R32G32_FLOAT, size, size, 1, 1)))
+        return false;
+
+    const DirectX::Image* pImage = lut.GetImage(0, 0, 0);
+    gpGlobal->GetJobSystem().ParallelFor(size, 1, [&](uint32_t begin, uint32_t end) {
+        std::vector<float> hx(count);
+        std::vector<float> hz(count);
+        for (uint32_t row = begin; row < end; row++)
+        {
+            float roughness = (row + 0.5f) / size;
+            float alpha = roughness * roughness;
+            for (uint32_t i = 0; i < count; i++)
+            {
+                float hy;
+                SampleGGX(i, count, alpha, hx[i], hy, hz[i]);
+            }
+
+            const __m128 zero = _mm_setzero_ps();
+            const __m128 one = _mm_set1_ps(1.0f);
+            const __m128 k = _mm_set1_ps(alpha * 0.5f);
+            const __m128 oneMinusK = _mm_set1_ps(1.0f - alpha * 0.5f);
+
+            float* pDst = reinterpret_cast<float*>(pImage->pixels + row * pImage->rowPitch);
+            for (uint32_t x = 0; x < size; x++)
+            {
+                float nDotV = (x + 0.5f) / size;
+                const __m128 vx = _mm_set1_ps(sqrtf(1.0f - nDotV * nDotV));
+                const __m128 vz = _mm_set1_ps(nDotV);
+                const __m128 visibilityV = _mm_div_ps(vz, _mm_add_ps(_mm_mul_ps(vz, oneMinusK), k));
+
+                __m128 scale = zero;
+                __m128 bias = zero;
+                for (uint32_t i = 0; i < count; i += 4)
+                {
+                    __m128 x4 = _mm_loadu_ps(hx.data() + i);
+                    __m128 z4 = _mm_loadu_ps(hz.data() + i);
+
+                    __m128 vDotH = _mm_max_ps(_mm_add_ps(_mm_mul_ps(vx, x4), _mm_mul_ps(vz, z4)), zero);
+                    __m128 nDotL = _mm_sub_ps(_mm_mul_ps(_mm_add_ps(vDotH, vDotH), z4), vz);
+                    __m128 valid = _mm_cmpgt_ps(nDotL, zero);
+                    nDotL = _mm_max_ps(nDotL, zero);
+
+                    __m128 visibilityL = _mm_div_ps(nDotL, _mm_add_ps(_mm_mul_ps(nDotL, oneMinusK), k));
+                    __m128 g = _mm_div_ps(_mm_mul_ps(_mm_mul_ps(visibilityV, visibilityL), vDotH), _mm_max_ps(_mm_mul_ps(z4, vz), _mm_set1_ps(1e-6f)));
+                    g = _mm_and_ps(valid, g);
+
+                    __m128 f = _mm_sub_ps(one, vDotH);
+                    __m128 f2 = _mm_mul_ps(f, f);
+                    f = _mm_mul_ps(_mm_mul_ps(f2, f2), f);
+
+                    scale = _mm_add_ps(scale, _mm_mul_ps(_mm_sub_ps(one, f), g));
+                    bias = _mm_add_ps(bias, _mm_mul_ps(f, g));
+                }
+
+                MATH_SIMD_ALIGN(16) float scales[4];
+                MATH_SIMD_ALIGN(16) float biases[4];
+                _mm_store_ps(scales, scale);
+                _mm_store_ps(biases, bias);
+                pDst[x * 2] = (scales[0] + scales[1] + scales[2] + scales[3]) / count;
+                pDst[x * 2 + 1] = (biases[0] + biases[1] + biases[2] + biases[3]) / count;
+            }
+        }
+    });
+
+    return true;
+}
+
+static bool SaveHalf(const DirectX::ScratchImage& image, DXGI_FORMAT format, const std::string& path)
+{
+    DirectX::ScratchImage converted;
+    HRESULT hr = DirectX::Convert(image.GetImages(), image.GetImageCount(), image.GetMetadata(), format, DirectX::TEX_FILTER_DEFAULT | DirectX::TEX_FILTER_PARALLEL, DirectX::TEX_THRESHOLD_DEFAULT, converted);
+    if (FAILED(hr))
+        return false;
+
+    std::wstring_convert<std::codecvt_utf8_utf16<wchar_t>> converter;
+    std::wstring widePath = converter.from_bytes(path);
+
+    return SUCCEEDED(DirectX::SaveToDDSFile(converted.GetImages(), converted.GetImageCount(), converted.GetMetadata(), DirectX::DDS_FLAGS_NONE, widePath.c_str()));
+}
+
+static bool WriteIrradiance(const std::string& path, const EnvironmentBaker::Irradiance& irradiance)
+{
+    std::ofstream file(path, std::ios::binary);
+    file.write(reinterpret_cast<const char*>(irradiance.coefficients), sizeof(irradiance.coefficients));
+    return file.good();
+}
+
+static bool ReadIrradiance(const std::string& path, EnvironmentBaker::Irradiance& irradiance)
+{
+    std::ifstream file(path, std::ios::binary);
+    file.read(reinterpret_cast<char*>(irradiance.coefficients), sizeof(irradiance.coefficients));
+    return file.good();
+}
+
+static bool BakeEnvironment(const void* pSrc, uint32_t size, const EnvironmentBaker::Desc& desc, DirectX::ScratchImage& specular, EnvironmentBaker::Irradiance& irradiance)
+{
+    DirectX::ScratchImage equirect;
+    if (!ReadEnvironment(pSrc, size, equirect))
+        return false;
+
+    // The full radiance chain, prefiltering reads the coarse mips for the wide samples.
+    std::vector<CubeLevel> radiance(1);
+    radiance[0].size = desc.faceSize;
+    FillFromEquirect(*equirect.GetImage(0, 0, 0), radiance[0]);
+    while (radiance.back().size > 1)
+    {
+        radiance.emplace_back();
+        Downsample(radiance[radiance.size() - 2], radiance.back());
+    }
+
+    uint32_t shLevel = 0;
+    while (radiance[shLevel].size > SH_FACE_SIZE)
+        shLevel++;
+    ProjectIrradiance(radiance[shLevel], irradiance);
+
+    return BakeSpecular(radiance, desc, std::min(desc.specularMipCount, (uint32_t)radiance.size()), specular);
+}
+
+bool EnvironmentBaker::Bake(const void* pSrc, uint32_t size, const Desc& desc, Result& result)
+{
+    if (desc.faceSize == 0 || (desc.faceSize & (desc.faceSize - 1)) != 0 || desc.specularMipCount == 0 || desc.sampleCount == 0 || desc.lutSize == 0 || desc.lutSampleCount == 0)
+        return false;
+
+    Hash64 hash;
+    hash.Update(VERSION);
+    hash.Update(desc.faceSize);
+    hash.Update(desc.specularMipCount);
+    hash.Update(desc.sampleCount);
+    hash.Update(pSrc, size);
+    uint64_t key = hash.Final();
+
+    auto& cache = gpGlobal->GetDerivedDataCache();
+    uint64_t specularKey = DeriveKey(key, eItem_Specular);
+    uint64_t irradianceKey = DeriveKey(key, eItem_Irradiance);
+
+    // Both come out of one bake, a miss on either bakes both again.
+    result.specularPath = cache.Find(specularKey);
+    auto irradiancePath = cache.Find(irradianceKey);
+    if (result.specularPath.empty() || irradiancePath.empty() || !ReadIrradiance(irradiancePath, result.irradiance))
+    {
+        DirectX::ScratchImage specular;
+        if (!BakeEnvironment(pSrc, size, desc, specular, result.irradiance))
+            return false;
+
+        if (!cache.Store(specularKey, [&](const std::string& path) { return SaveHalf(specular, DXGI_FORMAT_R16G16B16A16_FLOAT, path); }) ||
+            !cache.Store(irradianceKey, [&](const std::string& path) { return WriteIrradiance(path, result.irradiance); }))
+            return false;
+
+        result.specularPath = cache.Find(specularKey);
+    }
+
+    // The lookup table does not depend on the environment, all of them share it.
+    Hash64 brdfHash;
+    brdfHash.Update(VERSION);
+    brdfHash.Update(eItem_BRDF);
+    brdfHash.Update(desc.lutSize);
+    brdfHash.Update(desc.lutSampleCount);
+    uint64_t brdfKey = brdfHash.Final();
+
+    result.brdfPath = cache.Find(brdfKey);
+    if (result.brdfPath.empty())
+    {
+        DirectX::ScratchImage lut;
+        if (BakeBRDF(desc, lut) && cache.Store(brdfKey, [&](const std::string& path) { return SaveHalf(lut, DXGI_FORMAT_R16G16_FLOAT, path); }))
+            result.brdfPath = cache.Find(brdfKey);
+    }
+
+    return !result.specularPath.empty() && !result.brdfPath.empty();
+}
\ No newline at end of file
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <string>
+#include <stdint.h>
+
+namespace Engine
+{
+    // Turns an equirectangular HDR environment into image based lighting: the irradiance as 9 spherical
+    // harmonics coefficients, a cube map prefiltered with GGX for a roughness per mip and the split sum
+    // BRDF lookup table. All three are baked on the job system with SSE and kept in the derived data
+    // cache, so an environment is only ever baked once.
+    class EnvironmentBaker
+    {
+    public:
+        // Part of the derived data keys, bump it whenever the baked output changes.
+        constexpr static uint32_t VERSION = 1;
+
+        struct Desc
+        {
+            // Of the top mip of the prefiltered cube map, a power of two.
+            uint32_t faceSize = 256;
+            // Mip i is prefiltered for a roughness of i / (specularMipCount - 1).
+            uint32_t specularMipCount = 6;
+            uint32_t sampleCount = 256;
+            uint32_t lutSize = 128;
+            uint32_t lutSampleCount = 512;
+        };
+
+        // Irradiance E(n) = sum of coefficients[i] * Y_i(n), with the cosine lobe already convolved
+        // in. The basis is the real one in the order 1, y, z, x, xy, yz, 3z^2 - 1, xz, x^2 - y^2, its
+        // constants are left to the shader.
+        struct Irradiance
+        {
+            float coefficients[9][3];
+        };
+
+        struct Result
+        {
+            // RGBA16F cube map DDS with the full prefiltered mip chain.
+            std::string specularPath;
+            // RG16F DDS, scale and bias to F0 by N.V across and roughness down.
+            std::string brdfPath;
+            Irradiance irradiance;
+        };
+
+        // Reads Radiance HDR or an uncompressed DDS. Only the cache paths are returned, the loaders
+        // map the files from there. False when the image does not decode or a file can not be written.
+        static bool Bake(const void* pSrc, uint32_t size, const Desc& desc, Result& result);
+    };
+}
\ No newline at end of file
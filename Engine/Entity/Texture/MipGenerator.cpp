@@ -0,0 +1,408 @@
+#include <algorithm>
+#include <cmath>
+#include <mutex>
+#include <vector>
+#include <string.h>
+
+#include "Global.h"
+#include "SIMD.h"
+
+#include "MipGenerator.h"
+
+using namespace Engine;
+
+// Output rows per job. A job decodes the source rows its window slides over once, so bands of rows
+// beat single rows.
+constexpr static uint32_t ROWS_PER_JOB = 8;
+
+// Half width of the Kaiser window in destination texels, and its shape.
+constexpr static float KAISER_WIDTH = 2.0f;
+constexpr static float KAISER_ALPHA = 4.0f;
+
+// Weights below this are taken as the zeros of the sinc they are.
+constexpr static float MIN_WEIGHT = 1e-6f;
+
+// Linear to sRGB is a table over the linear range, fine enough to stay within a fraction of an
+// 8-bit step near black where the curve is steepest.
+constexpr static uint32_t SRGB_ENCODE_SIZE = 16384;
+
+struct Tables
+{
+    // Byte to float per channel, 256 entries for each of the four.
+    float linearDecode[4 * 256];
+    float srgbDecode[4 * 256];
+    uint8_t srgbEncode[SRGB_ENCODE_SIZE];
+};
+
+// Per destination texel the source texels it reads, clamped to the edge, and their weights.
+struct Kernel
+{
+    uint32_t taps;
+    std::vector<uint32_t> indices;
+    std::vector<float> weights;
+};
+
+static const Tables& GetTables()
+{
+    static const Tables* pTables = []() {
+        auto pTables = new Tables();
+        for (uint32_t v = 0; v < 256; v++)
+        {
+            float value = v / 255.0f;
+            float linear = value <= 0.04045f ? value / 12.92f : std::pow((value + 0.055f) / 1.055f, 2.4f);
+            for (uint32_t c = 0; c < 4; c++)
+            {
+                pTables->linearDecode[c * 256 + v] = value;
+                pTables->srgbDecode[c * 256 + v] = c == 3 ? value : linear;
+            }
+        }
+
+        for (uint32_t i = 0; i < SRGB_ENCODE_SIZE; i++)
+        {
+            float linear = i / float(SRGB_ENCODE_SIZE - 1);
+            float value = linear <= 0.0031308f ? linear * 12.92f : 1.055f * std::pow(linear, 1.0f / 2.4f) - 0.055f;
+            pTables->srgbEncode[i] = (uint8_t)std::lround(std::min(std::max(value, 0.0f), 1.0f) * 255.0f);
+        }
+
+        return pTables;
+    }();
+
+    return *pTables;
+}
+
+static float BesselI0(float x)
+{
+    // The power series converges quickly for the arguments a Kaiser window passes.
+    float sum = 1.0f;
+    float term = 1.0f;
+    for (int k = 1; k < 32 && term > sum * 1e-8f; k++)
+    {
+        float q = x / (2.0f * k);
+        term *= q * q;
+        sum += term;
+    }
+
+    return sum;
+}
+
+// t is the distance in destination texels.
+static float KaiserSinc(float t)
+{
+    if (std::abs(t) >= KAISER_WIDTH)
+        return 0.0f;
+
+    const float pi = 3.14159265358979f;
+    float ratio = t / KAISER_WIDTH;
+    float window = BesselI0(KAISER_ALPHA * std::sqrt(1.0f - ratio * ratio)) / BesselI0(KAISER_ALPHA);
+    float sinc = std::abs(t) < 1e-5f ? 1.0f : std::sin(pi * t) / (pi * t);
+
+    return sinc * window;
+}
+
+static Kernel BuildKernel(uint32_t srcSize, uint32_t dstSize, MipGenerator::EFilter filter)
+{
+    const float scale = float(srcSize) / float(dstSize);
+    // Source texels a destination texel reaches on each side of its center.
+    const float support = filter == MipGenerator::eFilter_Box ? scale * 0.5f : KAISER_WIDTH * scale;
+    const uint32_t maxTaps = (uint32_t)std::ceil(support * 2.0f) + 1;
+
+    std::vector<int32_t> firsts(dstSize);
+    std::vector<float> weights(dstSize * maxTaps);
+    uint32_t begin = maxTaps;
+    uint32_t end = 0;
+
+    for (uint32_t x = 0; x < dstSize; x++)
+    {
+        // Texel i covers [i, i + 1), so centers sit at half texels.
+        float center = (x + 0.5f) * scale;
+        firsts[x] = (int32_t)std::floor(center - support);
+
+        float sum = 0.0f;
+        float* pWeights = &weights[x * maxTaps];
+        for (uint32_t k = 0; k < maxTaps; k++)
+        {
+            float i = float(firsts[x] + (int32_t)k);
+            float weight = filter == MipGenerator::eFilter_Box ?
+                std::max(0.0f, std::min(i + 1.0f, center + support) - std::max(i, center - support)) :
+                KaiserSinc((i + 0.5f - center) / scale);
+
+            pWeights[k] = std::abs(weight) < MIN_WEIGHT ? 0.0f : weight;
+            sum += pWeights[k];
+        }
+
+        for (uint32_t k = 0; k < maxTaps; k++)
+        {
+            pWeights[k] /= sum;
+            if (pWeights[k] != 0.0f)
+            {
+                begin = std::min(begin, k);
+                end = std::max(end, k + 1);
+            }
+        }
+    }
+
+    // Taps that are zero for every texel, like most of them when the size stays, are dropped.
+    Kernel kernel;
+    kernel.taps = end - begin;
+    kernel.indices.resize(dstSize * kernel.taps);
+    kernel.weights.resize(dstSize * kernel.taps);
+    for (uint32_t x = 0; x < dstSize; x++)
+    {
+        for (uint32_t k = 0; k < kernel.taps; k++)
+        {
+            int32_t i = firsts[x] + (int32_t)(begin + k);
+            kernel.indices[x * kernel.taps + k] = (uint32_t)std::min(std::max(i, 0), (int32_t)srcSize - 1);
+            kernel.weights[x * kernel.taps + k] = weights[x * maxTaps + begin + k];
+        }
+    }
+
+    return kernel;
+}
+
+static void DecodeRow(const uint8_t* pSrc, uint32_t count, const float* pTable, float* pDst)
+{
+    uint32_t i = 0;
+#if defined(MATH_SIMD_AVX2)
+    // Eight channel values per gather, the channel selects its quarter of the table.
+    const __m256i channels = _mm256_setr_epi32(0, 256, 512, 768, 0, 256, 512, 768);
+    for (; i + 8 <= count; i += 8)
+    {
+        __m256i indices = _mm256_add_epi32(_mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(pSrc + i))), channels);
+        _mm256_storeu_ps(pDst + i, _mm256_i32gather_ps(pTable, indices, 4));
+    }
+#endif
+    for (; i < count; i++)
+        pDst[i] = pTable[(i & 3) * 256 + pSrc[i]];
+}
+
+static void Accumulate(float* pDst, const float* pSrc, float weight, uint32_t count)
+{
+    uint32_t i = 0;
+#if defined(MATH_SIMD_AVX)
+    const __m256 weight8 = _mm256_set1_ps(weight);
+    for (; i + 8 <= count; i += 8)
+        _mm256_storeu_ps(pDst + i, _mm256_add_ps(_mm256_loadu_ps(pDst + i), _mm256_mul_ps(_mm256_loadu_ps(pSrc + i), weight8)));
+#endif
+    const __m128 weight4 = _mm_set1_ps(weight);
+    for (; i < count; i += 4)
+        _mm_storeu_ps(pDst + i, _mm_add_ps(_mm_loadu_ps(pDst + i), _mm_mul_ps(_mm_loadu_ps(pSrc + i), weight4)));
+}
+
+// Back to a unit vector, or left alone where the texels cancelled out.
+static __m128 Renormalize(__m128 texel)
+{
+    const __m128 alphaMask = _mm_castsi128_ps(_mm_setr_epi32(0, 0, 0, -1));
+
+    __m128 n = _mm_andnot_ps(alphaMask, _mm_sub_ps(_mm_add_ps(texel, texel), _mm_set1_ps(1.0f)));
+    __m128 squares = _mm_mul_ps(n, n);
+    __m128 length = _mm_add_ps(squares, _mm_shuffle_ps(squares, squares, _MM_SHUFFLE(2, 3, 0, 1)));
+    length = _mm_add_ps(length, _mm_shuffle_ps(length, length, _MM_SHUFFLE(1, 0, 3, 2)));
+
+    __m128 normalized = _mm_add_ps(_mm_mul_ps(_mm_mul_ps(n, SIMDRsqrt(length)), _mm_set1_ps(0.5f)), _mm_set1_ps(0.5f));
+    __m128 valid = _mm_andnot_ps(alphaMask, _mm_cmpgt_ps(length, _mm_set1_ps(1e-8f)));
+
+    return SIMDSelect(valid, texel, normalized);
+}
+
+static void EncodeRow(const float* pSrc, uint32_t width, bool bSRGB, const Tables& tables, uint8_t* pDst)
+{
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 srgbScale = _mm_setr_ps(SRGB_ENCODE_SIZE - 1.0f, SRGB_ENCODE_SIZE - 1.0f, SRGB_ENCODE_SIZE - 1.0f, 255.0f);
+
+    for (uint32_t x = 0; x < width; x++)
+    {
+        __m128 texel = _mm_min_ps(_mm_max_ps(_mm_loadu_ps(pSrc + x * 4), zero), one);
+        uint8_t* pTexel = pDst + x * 4;
+
+        if (bSRGB)
+        {
+            MATH_SIMD_ALIGN(16) int32_t indices[4];
+            _mm_store_si128(reinterpret_cast<__m128i*>(indices), _mm_cvtps_epi32(_mm_mul_ps(texel, srgbScale)));
+            pTexel[0] = tables.srgbEncode[indices[0]];
+            pTexel[1] = tables.srgbEncode[indices[1]];
+            pTexel[2] = tables.srgbEncode[indices[2]];
+            pTexel[3] = (uint8_t)indices[3];
+        }
+        else
+        {
+            __m128i bytes = _mm_cvtps_epi32(_mm_mul_ps(texel, _mm_set1_ps(255.0f)));
+            bytes = _mm_packus_epi16(_mm_packs_epi32(bytes, bytes), bytes);
+            int32_t packed = _mm_cvtsi128_si32(bytes);
+            memcpy(pTexel, &packed, sizeof(packed));
+        }
+    }
+}
+
+static void FilterRows(const MipGenerator::Level& src, const MipGenerator::Level& dst, const Kernel& horizontal, const Kernel& vertical,
+    const MipGenerator::Desc& desc, uint32_t begin, uint32_t end)
+{
+    const Tables& tables = GetTables();
+    const float* pDecode = desc.bSRGB ? tables.srgbDecode : tables.linearDecode;
+    const uint32_t srcCount = src.width * 4;
+
+    // The rows a window covers are consecutive, so a ring as long as the window never evicts a row
+    // the current window still needs.
+    const uint32_t slots = vertical.taps;
+    std::vector<float> decoded((size_t)slots * srcCount);
+    std::vector<int64_t> decodedRows(slots, -1);
+
+    std::vector<float> column(srcCount);
+    std::vector<float> row(dst.width * 4);
+
+    for (uint32_t y = begin; y < end; y++)
+    {
+        std::fill(column.begin(), column.end(), 0.0f);
+        for (uint32_t k = 0; k < vertical.taps; k++)
+        {
+            uint32_t sy = vertical.indices[y * vertical.taps + k];
+            float weight = vertical.weights[y * vertical.taps + k];
+            if (weight == 0.0f)
+                continue;
+
+            uint32_t slot = sy % slots;
+            float* pDecoded = &decoded[(size_t)slot * srcCount];
+            if (decodedRows[slot] != sy)
+            {
+                DecodeRow(src.pTexels + sy * src.rowPitch, srcCount, pDecode, pDecoded);
+                decodedRows[slot] = sy;
+            }
+
+            Accumulate(column.data(), pDecoded, weight, srcCount);
+        }
+
+        for (uint32_t x = 0; x < dst.width; x++)
+        {
+            const uint32_t* pIndices = &horizontal.indices[x * horizontal.taps];
+            const float* pWeights = &horizontal.weights[x * horizontal.taps];
+
+            __m128 sum = _mm_setzero_ps();
+            for (uint32_t k = 0; k < horizontal.taps; k++)
+                sum = _mm_add_ps(sum, _mm_mul_ps(_mm_loadu_ps(&column[pIndices[k] * 4]), _mm_set1_ps(pWeights[k])));
+
+            if (desc.bNormalMap)
+                sum = Renormalize(sum);
+
+            _mm_storeu_ps(&row[x * 4], sum);
+        }
+
+        EncodeRow(row.data(), dst.width, desc.bSRGB, tables, dst.pTexels + y * dst.rowPitch);
+    }
+}
+
+static void GetAlphaHistogram(const MipGenerator::Level& level, uint64_t histogram[256])
+{
+    std::mutex mutex;
+    std::fill(histogram, histogram + 256, 0);
+
+    gpGlobal->GetJobSystem().ParallelFor(level.height, ROWS_PER_JOB * 4, [&](uint32_t begin, uint32_t end) {
+        uint64_t local[256] = {};
+        for (uint32_t y = begin; y < end; y++)
+        {
+            const uint8_t* pRow = level.pTexels + y * level.rowPitch;
+            for (uint32_t x = 0; x < level.width; x++)
+                local[pRow[x * 4 + 3]]++;
+        }
+
+        std::lock_guard<std::mutex> lock(mutex);
+        for (uint32_t i = 0; i < 256; i++)
+            histogram[i] += local[i];
+    });
+}
+
+// Scales alpha so that as close to coverage of the level passes, i.e. has at least threshold
+// alpha, as 8 bits allow. Texels on either side of the new threshold stay there.
+static void PreserveCoverage(const MipGenerator::Level& level, uint32_t threshold, double coverage)
+{
+    uint64_t histogram[256];
+    GetAlphaHistogram(level, histogram);
+
+    const double target = coverage * level.width * level.height;
+
+    // The threshold of the filtered alpha whose passing count is nearest the target.
+    uint32_t best = threshold;
+    double bestError = -1.0;
+    uint64_t passing = 0;
+    for (uint32_t t = 255; t >= 1; t--)
+    {
+        passing += histogram[t];
+        double error = std::abs((double)passing - target);
+        if (bestError < 0.0 || error < bestError)
+        {
+            best = t;
+            bestError = error;
+        }
+    }
+
+    if (best == threshold)
+        return;
+
+    uint8_t remap[256];
+    const float scale = (threshold - 0.5f) / (best - 0.5f);
+    for (uint32_t a = 0; a < 256; a++)
+    {
+        int32_t scaled = std::min((int32_t)std::lround(a * scale), 255);
+        remap[a] = (uint8_t)(a >= best ? std::max(scaled, (int32_t)threshold) : std::min(scaled, (int32_t)threshold - 1));
+    }
+
+    gpGlobal->GetJobSystem().ParallelFor(level.height, ROWS_PER_JOB * 4, [&](uint32_t begin, uint32_t end) {
+        for (uint32_t y = begin; y < end; y++)
+        {
+            uint8_t* pRow = level.pTexels + y * level.rowPitch;
+            for (uint32_t x = 0; x < level.width; x++)
+                pRow[x * 4 + 3] = remap[pRow[x * 4 + 3]];
+        }
+    });
+}
+
+uint32_t MipGenerator::GetLevelCount(uint32_t width, uint32_t height)
+{
+    uint32_t count = 1;
+    while (width > 1 || height > 1)
+    {
+        width = std::max(width / 2, 1u);
+        height = std::max(height / 2, 1u);
+        count++;
+    }
+
+    return count;
+}
+
+void MipGenerator::Generate(const Level* pLevels, uint32_t levelCount, const Desc& desc)
+{
+    // An alpha test passes at or above the cutoff, in bytes the threshold.
+    uint32_t threshold = 0;
+    double coverage = -1.0;
+    if (desc.alphaCutoff >= 0.0f && levelCount > 1)
+    {
+        threshold = std::min(std::max((uint32_t)std::ceil(desc.alphaCutoff * 255.0f), 1u), 255u);
+
+        uint64_t histogram[256];
+        GetAlphaHistogram(pLevels[0], histogram);
+
+        uint64_t passing = 0;
+        for (uint32_t a = threshold; a < 256; a++)
+            passing += histogram[a];
+
+        // Nothing to keep when everything or nothing passes.
+        uint64_t total = (uint64_t)pLevels[0].width * pLevels[0].height;
+        if (passing > 0 && passing < total)
+            coverage = (double)passing / total;
+    }
+
+    for (uint32_t i = 1; i < levelCount; i++)
+    {
+        const Level& src = pLevels[i - 1];
+        const Level& dst = pLevels[i];
+
+        Kernel horizontal = BuildKernel(src.width, dst.width, desc.filter);
+        Kernel vertical = BuildKernel(src.height, dst.height, desc.filter);
+
+        gpGlobal->GetJobSystem().ParallelFor(dst.height, ROWS_PER_JOB, [&](uint32_t begin, uint32_t end) {
+            FilterRows(src, dst, horizontal, vertical, desc, begin, end);
+        });
+
+        if (coverage >= 0.0)
+            PreserveCoverage(dst, threshold, coverage);
+    }
+}
\ No newline at end of file
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace Engine
+{
+    // Builds mip chains of 8-bit four channel images, RGBA or BGRA alike. Filters separably in float,
+    // in linear space for sRGB images, and splits the rows of every level across the job system.
+    // Each level is filtered from the one above it.
+    class MipGenerator
+    {
+    public:
+        enum EFilter
+        {
+            eFilter_Box = 0,
+            // Kaiser windowed sinc, sharper than the box and without its aliasing.
+            eFilter_Kaiser,
+        };
+
+        struct Desc
+        {
+            EFilter filter = eFilter_Kaiser;
+            // Color channels are sRGB encoded, alpha never is.
+            bool bSRGB = false;
+            // The first three channels hold a unit vector as 0.5 * n + 0.5, renormalized per texel.
+            bool bNormalMap = false;
+            // When not negative, the alpha of each level is scaled so the same fraction of texels
+            // passes an alpha test against it as on the top level, which keeps alpha tested
+            // foliage from thinning out in the distance.
+            float alphaCutoff = -1.0f;
+        };
+
+        struct Level
+        {
+            uint32_t width;
+            uint32_t height;
+            size_t rowPitch;
+            uint8_t* pTexels;
+        };
+
+        // Half the size of the previous level, at least 1, down to 1x1.
+        static uint32_t GetLevelCount(uint32_t width, uint32_t height);
+
+        // pLevels[0] is read, the rest are written; their sizes must follow GetLevelCount.
+        static void Generate(const Level* pLevels, uint32_t levelCount, const Desc& desc);
+    };
+}
\ No newline at end of file
@@ -2,15 +2,19 @@
 
 using namespace Engine;
 
-Texture::Texture()
+Texture::Texture() : m_state(eTextureState_Pending), m_role(eTextureRole_Albedo)
 {
     m_pTexture = nullptr;
+    m_pSourceData = nullptr;
+    m_sourceSize = 0;
 }
 
 Texture::Texture(std::string uri) :
-    m_uri(uri)
+    m_uri(uri), m_state(eTextureState_Pending), m_role(eTextureRole_Albedo)
 {
     m_pTexture = nullptr;
+    m_pSourceData = nullptr;
+    m_sourceSize = 0;
 }
 
 Texture::~Texture()
@@ -35,4 +39,40 @@ std::shared_ptr<DrawingTexture> Texture::GetTexture() const
 void Texture::SetTexture(std::shared_ptr<DrawingTexture> pTexture)
 {
     m_pTexture = pTexture;
+}
+
+ETextureState Texture::GetState() const
+{
+    return m_state;
+}
+
+void Texture::SetState(ETextureState state)
+{
+    m_state = state;
+}
+
+ETextureRole Texture::GetRole() const
+{
+    return m_role;
+}
+
+void Texture::SetRole(ETextureRole role)
+{
+    m_role = role;
+}
+
+std::shared_ptr<char> Texture::GetSourceData() const
+{
+    return m_pSourceData;
+}
+
+uint32_t Texture::GetSourceSize() const
+{
+    return m_sourceSize;
+}
+
+void Texture::SetSourceData(std::shared_ptr<char> pData, uint32_t size)
+{
+    m_pSourceData = pData;
+    m_sourceSize = size;
 }
\ No newline at end of file
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <atomic>
 #include <string>
 
 #include "DrawingDevice.h"
@@ -20,8 +21,23 @@ namespace Engine
         std::shared_ptr<DrawingTexture> GetTexture() const override;
         void SetTexture(std::shared_ptr<DrawingTexture> pTexture) override;
 
+        ETextureState GetState() const override;
+        void SetState(ETextureState state) override;
+
+        ETextureRole GetRole() const override;
+        void SetRole(ETextureRole role) override;
+
+        std::shared_ptr<char> GetSourceData() const override;
+        uint32_t GetSourceSize() const override;
+        void SetSourceData(std::shared_ptr<char> pData, uint32_t size) override;
+
     protected:
         std::string m_uri;
         std::shared_ptr<DrawingTexture> m_pTexture;
+        std::atomic<ETextureState> m_state;
+        ETextureRole m_role;
+
+        std::shared_ptr<char> m_pSourceData;
+        uint32_t m_sourceSize;
     };
 }
\ No newline at end of file
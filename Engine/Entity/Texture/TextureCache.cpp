@@ -0,0 +1,91 @@
+#include <filesystem>
+
+#include "AssetFileSystem.h"
+#include "Texture.h"
+#include "TextureCache.h"
+
+using namespace Engine;
+
+TextureCache::TextureCache(uint32_t maxUnreferenced) : m_pState(std::make_shared<State>())
+{
+    m_pState->maxUnreferenced = maxUnreferenced;
+}
+
+TextureCache::~TextureCache()
+{
+}
+
+std::shared_ptr<ITexture> TextureCache::Acquire(const std::string& path, const SamplerDesc& sampler, ETextureRole role, bool& bCreated)
+{
+    auto canonical = Canonicalize(path);
+    auto key = MakeKey(canonical, sampler, role);
+
+    std::lock_guard<std::mutex> lock(m_pState->mutex);
+
+    auto it = m_pState->entries.find(key);
+    bCreated = it == m_pState->entries.end();
+    if (bCreated)
+    {
+        auto pTexture = std::make_shared<Texture>(canonical);
+        pTexture->SetRole(role);
+        it = m_pState->entries.emplace(key, Entry { pTexture, 0, m_pState->unreferenced.end() }).first;
+    }
+
+    auto& entry = it->second;
+    if (entry.refCount++ == 0 && !bCreated)
+        m_pState->unreferenced.erase(entry.lru);
+
+    // The handle keeps the texture alive on its own, its deleter only does the bookkeeping.
+    std::weak_ptr<State> pWeakState = m_pState;
+    auto pTexture = entry.pTexture;
+    return std::shared_ptr<ITexture>(pTexture.get(), [pWeakState, key, pTexture](ITexture*) { Release(pWeakState, key); });
+}
+
+uint32_t TextureCache::GetEntryCount() const
+{
+    std::lock_guard<std::mutex> lock(m_pState->mutex);
+    return (uint32_t)m_pState->entries.size();
+}
+
+uint32_t TextureCache::GetReferencedCount() const
+{
+    std::lock_guard<std::mutex> lock(m_pState->mutex);
+    return (uint32_t)(m_pState->entries.size() - m_pState->unreferenced.size());
+}
+
+std::string TextureCache::Canonicalize(const std::string& path)
+{
+    return std::filesystem::path(AssetFileSystem::Normalize(path)).lexically_normal().generic_string();
+}
+
+std::string TextureCache::MakeKey(const std::string& path, const SamplerDesc& sampler, ETextureRole role)
+{
+    return path + "|" + std::to_string(sampler.magFilter) + "," + std::to_string(sampler.minFilter) + "," +
+        std::to_string(sampler.wrapS) + "," + std::to_string(sampler.wrapT) + "|" + std::to_string(role);
+}
+
+void TextureCache::Release(const std::weak_ptr<State>& pWeakState, const std::string& key)
+{
+    auto pState = pWeakState.lock();
+    if (pState == nullptr)
+        return;
+
+    std::lock_guard<std::mutex> lock(pState->mutex);
+
+    auto it = pState->entries.find(key);
+    if (it == pState->entries.end() || --it->second.refCount > 0)
+        return;
+
+    it->second.lru = pState->unreferenced.insert(pState->unreferenced.end(), key);
+    Evict(*pState);
+}
+
+void TextureCache::Evict(State& state)
+{
+    // Dropping the last reference releases the device texture with it.
+    while (state.unreferenced.size() > state.maxUnreferenced)
+    {
+        state.entries.erase(state.unreferenced.front());
+        state.unreferenced.pop_front();
+    }
+}
\ No newline at end of file
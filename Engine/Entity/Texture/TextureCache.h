@@ -0,0 +1,75 @@
+#pragma once
+
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <stdint.h>
+
+#include "ITexture.h"
+
+namespace Engine
+{
+    // Shares one texture, and so one device texture, between everything that uses the same image with
+    // the same sampling. Acquire hands out handles; an entry is referenced while any of its handles
+    // lives. Unreferenced entries stay cached for a later Acquire and are evicted least recently
+    // released first once there are more than the limit. Safe to use from any thread.
+    class TextureCache
+    {
+    public:
+        constexpr static uint32_t DEFAULT_MAX_UNREFERENCED = 64;
+
+        // glTF sampler values. Part of the key, so images sampled differently stay separate textures.
+        struct SamplerDesc
+        {
+            uint32_t magFilter = 0;
+            uint32_t minFilter = 0;
+            uint32_t wrapS = 10497;     // REPEAT
+            uint32_t wrapT = 10497;
+        };
+
+        explicit TextureCache(uint32_t maxUnreferenced = DEFAULT_MAX_UNREFERENCED);
+        ~TextureCache();
+
+        TextureCache(const TextureCache&) = delete;
+        TextureCache& operator=(const TextureCache&) = delete;
+
+        // Handle to the texture of path, created with that URI and role when not cached. The role is
+        // part of the key as it decides the cooked format. bCreated tells the caller it is the one to
+        // provide the source data.
+        std::shared_ptr<ITexture> Acquire(const std::string& path, const SamplerDesc& sampler, ETextureRole role, bool& bCreated);
+
+        uint32_t GetEntryCount() const;
+        uint32_t GetReferencedCount() const;
+
+        // '/' separated with "." and ".." resolved, so different spellings of a path share an entry.
+        static std::string Canonicalize(const std::string& path);
+
+    private:
+        struct Entry
+        {
+            std::shared_ptr<ITexture> pTexture;
+            uint32_t refCount;
+            // Position in m_unreferenced while refCount is 0.
+            std::list<std::string>::iterator lru;
+        };
+
+        // Handles outliving the cache release into nothing.
+        struct State
+        {
+            mutable std::mutex mutex;
+            std::unordered_map<std::string, Entry> entries;
+            // Least recently released first.
+            std::list<std::string> unreferenced;
+            uint32_t maxUnreferenced;
+        };
+
+        static std::string MakeKey(const std::string& path, const SamplerDesc& sampler, ETextureRole role);
+        static void Release(const std::weak_ptr<State>& pWeakState, const std::string& key);
+        static void Evict(State& state);
+
+    private:
+        std::shared_ptr<State> m_pState;
+    };
+}
\ No newline at end of file
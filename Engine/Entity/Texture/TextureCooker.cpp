@@ -0,0 +1,263 @@
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+
+#include <algorithm>
+#include <codecvt>
+#include <locale>
+#include <vector>
+#include <string.h>
+
+#include <DirectXTex.h>
+#include <DDS.h>
+
+#include "MipGenerator.h"
+#include "TextureCooker.h"
+
+using namespace Engine;
+
+// The glTF default. The cutoff is a material property, textures shared between materials keep the
+// coverage of the default one.
+constexpr static float ALPHA_CUTOFF = 0.5f;
+
+// Block compressed format of each role. The channels kept are the ones forward_shading.ps samples:
+// occlusion reads R, metallic-roughness reads R and G. Emission is added after the tone map, so it
+// stays out of sRGB.
+static DXGI_FORMAT CookedFormat(ETextureRole role)
+{
+    switch (role)
+    {
+        case eTextureRole_Albedo:
+        case eTextureRole_AlphaTested:          return DXGI_FORMAT_BC7_UNORM_SRGB;
+        case eTextureRole_Normal:               return DXGI_FORMAT_BC5_UNORM;
+        case eTextureRole_Occlusion:            return DXGI_FORMAT_BC4_UNORM;
+        case eTextureRole_MetallicRoughness:    return DXGI_FORMAT_BC5_UNORM;
+        case eTextureRole_HDR:                  return DXGI_FORMAT_BC6H_UF16;
+        case eTextureRole_Emissive:
+        default:                                return DXGI_FORMAT_BC7_UNORM;
+    }
+}
+
+// Formats the real-time encoder writes, DXGI_FORMAT_UNKNOWN where a role keeps its decoded format.
+// Albedo and emission drop to BC1 and BC3 from BC7, the channel roles keep their cooked format.
+static DXGI_FORMAT RuntimeFormat(ETextureRole role, bool bOpaque)
+{
+    switch (role)
+    {
+        case eTextureRole_Albedo:
+        case eTextureRole_AlphaTested:          return bOpaque ? DXGI_FORMAT_BC1_UNORM_SRGB : DXGI_FORMAT_BC3_UNORM_SRGB;
+        case eTextureRole_Normal:               return DXGI_FORMAT_BC5_UNORM;
+        case eTextureRole_Occlusion:            return DXGI_FORMAT_BC4_UNORM;
+        case eTextureRole_MetallicRoughness:    return DXGI_FORMAT_BC5_UNORM;
+        case eTextureRole_Emissive:             return DXGI_FORMAT_BC1_UNORM;
+        case eTextureRole_HDR:
+        default:                                return DXGI_FORMAT_UNKNOWN;
+    }
+}
+
+// Albedo is authored in sRGB, filtering and compressing it as such keeps mips from darkening.
+static bool IsSRGB(ETextureRole role)
+{
+    return role == eTextureRole_Albedo || role == eTextureRole_AlphaTested;
+}
+
+static bool Is8BitRGBA(DXGI_FORMAT format)
+{
+    switch (format)
+    {
+        case DXGI_FORMAT_R8G8B8A8_UNORM:
+        case DXGI_FORMAT_R8G8B8A8_UNORM_SRGB:
+        case DXGI_FORMAT_B8G8R8A8_UNORM:
+        case DXGI_FORMAT_B8G8R8A8_UNORM_SRGB:
+            return true;
+        default:
+            return false;
+    }
+}
+
+static bool IsFastEncodable(const DirectX::TexMetadata& metadata)
+{
+    // Block compressed textures need whole blocks on the top level.
+    return Is8BitRGBA(metadata.format) && metadata.width % 4 == 0 && metadata.height % 4 == 0;
+}
+
+static HRESULT ReadImage(const void* pSrc, uint32_t size, DirectX::TexMetadata& metadata, DirectX::ScratchImage& image)
+{
+    if (TextureCooker::IsCooked(pSrc, size))
+        return DirectX::LoadFromDDSMemory(pSrc, size, DirectX::DDS_FLAGS_NONE, &metadata, image);
+
+    if (size >= 2 && memcmp(pSrc, "#?", 2) == 0)
+        return DirectX::LoadFromHDRMemory(pSrc, size, &metadata, image);
+
+    return DirectX::LoadFromWICMemory(pSrc, size, DirectX::WIC_FLAGS_NONE, &metadata, image);
+}
+
+// Kaiser filtered in linear space, normal maps renormalized and alpha tested coverage kept.
+static HRESULT GenerateMips(const DirectX::ScratchImage& image, ETextureRole role, DirectX::ScratchImage& mipChain)
+{
+    const auto& metadata = image.GetMetadata();
+    uint32_t levelCount = MipGenerator::GetLevelCount((uint32_t)metadata.width, (uint32_t)metadata.height);
+    HRESULT hr = mipChain.Initialize2D(metadata.format, metadata.width, metadata.height, 1, levelCount);
+    if (FAILED(hr))
+        return hr;
+
+    std::vector<MipGenerator::Level> levels(levelCount);
+    for (uint32_t i = 0; i < levelCount; i++)
+    {
+        const DirectX::Image* pImage = mipChain.GetImage(i, 0, 0);
+        levels[i] = MipGenerator::Level { (uint32_t)pImage->width, (uint32_t)pImage->height, pImage->rowPitch, pImage->pixels };
+    }
+
+    const DirectX::Image* pTop = image.GetImage(0, 0, 0);
+    for (uint32_t y = 0; y < levels[0].height; y++)
+        memcpy(levels[0].pTexels + y * levels[0].rowPitch, pTop->pixels + y * pTop->rowPitch, levels[0].width * 4);
+
+    MipGenerator::Desc desc;
+    desc.bSRGB = IsSRGB(role);
+    desc.bNormalMap = role == eTextureRole_Normal;
+    if (role == eTextureRole_AlphaTested)
+        desc.alphaCutoff = ALPHA_CUTOFF;
+
+    MipGenerator::Generate(levels.data(), levelCount, desc);
+    return S_OK;
+}
+
+// Where the texels of a cooked 2D texture start and how many bytes each mip takes. The sizes must add
+// up to the rest of the file, which leaves out the legacy formats DirectXTex expands on load.
+static bool ReadMipLayout(const void* pSrc, uint32_t size, DirectX::TexMetadata& metadata, uint64_t& dataOffset, std::vector<uint64_t>& mipSizes)
+{
+    if (!TextureCooker::IsCooked(pSrc, size) || size < sizeof(uint32_t) + sizeof(DirectX::DDS_HEADER))
+        return false;
+
+    if (FAILED(DirectX::GetMetadataFromDDSMemory(pSrc, size, DirectX::DDS_FLAGS_NONE, metadata)))
+        return false;
+
+    if (metadata.dimension != DirectX::TEX_DIMENSION_TEXTURE2D || metadata.arraySize != 1 || metadata.IsCubemap())
+        return false;
+
+    DirectX::DDS_HEADER header;
+    memcpy(&header, static_cast<const char*>(pSrc) + sizeof(uint32_t), sizeof(header));
+    dataOffset = sizeof(uint32_t) + sizeof(DirectX::DDS_HEADER);
+    if ((header.ddspf.flags & DDS_FOURCC) != 0 && header.ddspf.fourCC == MAKEFOURCC('D', 'X', '1', '0'))
+        dataOffset += sizeof(DirectX::DDS_HEADER_DXT10);
+
+    uint64_t end = dataOffset;
+    mipSizes.resize(metadata.mipLevels);
+    for (size_t i = 0; i < metadata.mipLevels; i++)
+    {
+        size_t rowPitch = 0;
+        size_t slicePitch = 0;
+        if (FAILED(DirectX::ComputePitch(metadata.format, std::max<size_t>(metadata.width >> i, 1), std::max<size_t>(metadata.height >> i, 1), rowPitch, slicePitch)))
+            return false;
+
+        mipSizes[i] = slicePitch;
+        end += slicePitch;
+    }
+
+    return end == size;
+}
+
+// Decodes and builds the mip chain, which is left in pResult.
+static HRESULT DecodeImage(const void* pSrc, uint32_t size, ETextureRole role, DirectX::ScratchImage& image, DirectX::ScratchImage& mipChain, const DirectX::ScratchImage*& pResult)
+{
+    DirectX::TexMetadata metadata;
+    HRESULT hr = ReadImage(pSrc, size, metadata, image);
+
+    pResult = &image;
+    if (SUCCEEDED(hr) && metadata.mipLevels == 1 && !DirectX::IsCompressed(metadata.format) && (metadata.width > 1 || metadata.height > 1))
+    {
+        if (Is8BitRGBA(metadata.format) && metadata.dimension == DirectX::TEX_DIMENSION_TEXTURE2D && metadata.arraySize == 1)
+            hr = GenerateMips(image, role, mipChain);
+        else
+            hr = DirectX::GenerateMipMaps(image.GetImages(), image.GetImageCount(), metadata, DirectX::TEX_FILTER_DEFAULT | (IsSRGB(role) ? DirectX::TEX_FILTER_SRGB : 0), 0, mipChain);
+        pResult = &mipChain;
+    }
+
+    return hr;
+}
+
+bool TextureCooker::Cook(const void* pSrc, uint32_t size, ETextureRole role, const std::string& path)
+{
+    // Cooks run on job system workers, which may not have joined COM yet.
+    HRESULT hrCom = CoInitializeEx(nullptr, COINIT_MULTITHREADED);
+
+    bool bSRGB = IsSRGB(role);
+
+    DirectX::ScratchImage image;
+    DirectX::ScratchImage mipChain;
+    const DirectX::ScratchImage* pResult = nullptr;
+    HRESULT hr = DecodeImage(pSrc, size, role, image, mipChain, pResult);
+
+    // Sources that already are block compressed are written as they are.
+    DirectX::ScratchImage compressed;
+    if (SUCCEEDED(hr) && !DirectX::IsCompressed(pResult->GetMetadata().format))
+    {
+        DWORD flags = bSRGB ? DirectX::TEX_COMPRESS_SRGB : 0;
+        hr = DirectX::Compress(pResult->GetImages(), pResult->GetImageCount(), pResult->GetMetadata(), CookedFormat(role), flags, DirectX::TEX_THRESHOLD_DEFAULT, compressed);
+        pResult = &compressed;
+    }
+
+    if (SUCCEEDED(hr))
+    {
+        std::wstring_convert<std::codecvt_utf8_utf16<wchar_t>> converter;
+        std::wstring widePath = converter.from_bytes(path);
+
+        hr = DirectX::SaveToDDSFile(pResult->GetImages(), pResult->GetImageCount(), pResult->GetMetadata(), DirectX::DDS_FLAGS_NONE, widePath.c_str());
+    }
+
+    if (SUCCEEDED(hrCom))
+        CoUninitialize();
+
+    return SUCCEEDED(hr);
+}
+
+std::shared_ptr<char> TextureCooker::Decode(const void* pSrc, uint32_t size, ETextureRole role, uint32_t& decodedSize)
+{
+    HRESULT hrCom = CoInitializeEx(nullptr, COINIT_MULTITHREADED);
+
+    DirectX::ScratchImage image;
+    DirectX::ScratchImage mipChain;
+    const DirectX::ScratchImage* pResult = nullptr;
+    HRESULT hr = DecodeImage(pSrc, size, role, image, mipChain, pResult);
+
+    // Runs on a job system worker next to other decodes, so a single thread per image. The texels
+    // are taken as they are, sRGB or not.
+    DirectX::ScratchImage compressed;
+    DXGI_FORMAT format = SUCCEEDED(hr) ? RuntimeFormat(role, pResult->IsAlphaAllOpaque()) : DXGI_FORMAT_UNKNOWN;
+    if (format != DXGI_FORMAT_UNKNOWN && IsFastEncodable(pResult->GetMetadata()))
+    {
+        DWORD flags = DirectX::TEX_COMPRESS_FAST | DirectX::TEX_COMPRESS_SRGB;
+        if (SUCCEEDED(DirectX::Compress(pResult->GetImages(), pResult->GetImageCount(), pResult->GetMetadata(), format, flags, DirectX::TEX_THRESHOLD_DEFAULT, compressed)))
+            pResult = &compressed;
+    }
+
+    // The blob is handed out as is, the returned pointer keeps it alive.
+    auto pBlob = std::make_shared<DirectX::Blob>();
+    if (SUCCEEDED(hr))
+        hr = DirectX::SaveToDDSMemory(pResult->GetImages(), pResult->GetImageCount(), pResult->GetMetadata(), DirectX::DDS_FLAGS_NONE, *pBlob);
+
+    if (SUCCEEDED(hrCom))
+        CoUninitialize();
+
+    if (FAILED(hr))
+        return nullptr;
+
+    decodedSize = (uint32_t)pBlob->GetBufferSize();
+    return std::shared_ptr<char>(pBlob, static_cast<char*>(pBlob->GetBufferPointer()));
+}
+
+bool TextureCooker::IsCooked(const void* pSrc, uint32_t size)
+{
+    return size >= 4 && memcmp(pSrc, "DDS ", 4) == 0;
+}
+
+bool TextureCooker::GetMipLayout(const void* pSrc, uint32_t size, uint32_t& width, uint32_t& height, uint64_t& dataOffset, std::vector<uint64_t>& mipSizes)
+{
+    DirectX::TexMetadata metadata;
+    if (!ReadMipLayout(pSrc, size, metadata, dataOffset, mipSizes))
+        return false;
+
+    width = (uint32_t)metadata.width;
+    height = (uint32_t)metadata.height;
+    return true;
+}
\ No newline at end of file
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+#include <stdint.h>
+
+#include "ITexture.h"
+
+namespace Engine
+{
+    // Turns encoded images into what the device uploads as is, so decoding, mip generation and block
+    // compression happen once per source image instead of on every start.
+    class TextureCooker
+    {
+    public:
+        // Part of the derived data key, bump it whenever the cooked output changes.
+        constexpr static uint32_t VERSION = 3;
+
+        // Decodes anything WIC reads, plus Radiance HDR and DDS, builds a full mip chain, with
+        // MipGenerator for 8-bit RGBA and BGRA images, block compresses it in the format of role and
+        // writes it to path as DDS. Compression stays on the calling thread: importers cook their images
+        // on the job system side by side, which already keeps every core busy.
+        static bool Cook(const void* pSrc, uint32_t size, ETextureRole role, const std::string& path);
+        // Decode and mips into memory, for images that were not cooked. 8-bit images are block
+        // compressed with the real-time encoder where role has a BC1, BC3, BC4 or BC5 format.
+        // nullptr when the image does not decode.
+        static std::shared_ptr<char> Decode(const void* pSrc, uint32_t size, ETextureRole role, uint32_t& decodedSize);
+
+        // Whether the data already is DDS and needs no decoding.
+        static bool IsCooked(const void* pSrc, uint32_t size);
+
+        // Size of the top mip, where the texels start and bytes of every mip of a cooked 2D texture,
+        // which is what streams a part of its chain at a time. False for anything else, arrays, cube
+        // maps and volumes among them.
+        static bool GetMipLayout(const void* pSrc, uint32_t size, uint32_t& width, uint32_t& height, uint64_t& dataOffset, std::vector<uint64_t>& mipSizes);
+    };
+}
\ No newline at end of file
@@ -258,6 +258,18 @@ bool DrawingDevice_D3D11::CreateTextureFromFile(const std::string uri, std::shar
     return true;
 }
 
+bool DrawingDevice_D3D11::CreateTextureFromMemory(const void* pData, uint32_t size, std::shared_ptr<DrawingTexture>& pRes, uint32_t maxSize)
+{
+    auto pTexture = std::make_shared<DrawingTexture>(shared_from_this());
+
+    std::shared_ptr<DrawingRawTexture> pRawTexture = std::make_shared<DrawingRawTexture2D_D3D11>(std::static_pointer_cast<DrawingDevice_D3D11>(shared_from_this()), pData, size, maxSize);
+    pTexture->SetResource(pRawTexture);
+
+    pRes = pTexture;
+
+    return true;
+}
+
 bool DrawingDevice_D3D11::CreateTarget(const DrawingTargetDesc& desc, std::shared_ptr<DrawingTarget>& pRes)
 {
     std::shared_ptr<DrawingRawTarget> pTargetRaw = nullptr;
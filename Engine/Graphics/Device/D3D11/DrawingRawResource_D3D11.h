@@ -6,10 +6,12 @@
 #include <array>
 #include <string>
 #include <assert.h>
+#include <string.h>
 #include <d3d11.h>
 #include <dxgi.h>
 #include <d3d11shader.h>
 #include <d3dx11effect.h>
+#include <DDSTextureLoader.h>
 #include <WICTextureLoader.h>
 
 #include "DrawingDevice_D3D11.h"
@@ -1079,7 +1081,29 @@ namespace Engine
             std::wstring_convert<std::codecvt_utf8_utf16<wchar_t>> converter;
             std::wstring wideUri = converter.from_bytes(uri);
 
-            HRESULT hr = DirectX::CreateWICTextureFromFile(m_pDevice->GetDevice().get(), m_pDevice->GetDeviceContext().get(), wideUri.c_str(), &pResourceRaw, &pResourceViewRaw);
+            // DDS files are mapped and their mips uploaded from the mapping, without a heap copy.
+            HRESULT hr;
+            if (uri.size() >= 4 && _stricmp(uri.c_str() + uri.size() - 4, ".dds") == 0)
+                hr = DirectX::CreateDDSTextureFromFile(m_pDevice->GetDevice().get(), wideUri.c_str(), &pResourceRaw, &pResourceViewRaw);
+            else
+                hr = DirectX::CreateWICTextureFromFile(m_pDevice->GetDevice().get(), m_pDevice->GetDeviceContext().get(), wideUri.c_str(), &pResourceRaw, &pResourceViewRaw);
+            assert(SUCCEEDED(hr));
+
+            m_pResource = std::shared_ptr<ID3D11Resource>(pResourceRaw, D3D11Releaser<ID3D11Resource>);
+            m_pShaderResourceView = std::shared_ptr<ID3D11ShaderResourceView>(pResourceViewRaw, D3D11Releaser<ID3D11ShaderResourceView>);
+        }
+
+        DrawingRawTexture2D_D3D11(std::shared_ptr<DrawingDevice_D3D11> pDevice, const void* pData, uint32_t size, uint32_t maxSize) : DrawingRawTexture_D3D11(pDevice)
+        {
+            ID3D11Resource* pResourceRaw = nullptr;
+            ID3D11ShaderResourceView* pResourceViewRaw = nullptr;
+
+            // Cooked textures are DDS with their mips, anything else is an encoded image for WIC.
+            HRESULT hr;
+            if (size >= 4 && memcmp(pData, "DDS ", 4) == 0)
+                hr = DirectX::CreateDDSTextureFromMemory(m_pDevice->GetDevice().get(), reinterpret_cast<const uint8_t*>(pData), size, &pResourceRaw, &pResourceViewRaw, maxSize);
+            else
+                hr = DirectX::CreateWICTextureFromMemory(m_pDevice->GetDevice().get(), m_pDevice->GetDeviceContext().get(), reinterpret_cast<const uint8_t*>(pData), size, &pResourceRaw, &pResourceViewRaw);
             assert(SUCCEEDED(hr));
 
             m_pResource = std::shared_ptr<ID3D11Resource>(pResourceRaw, D3D11Releaser<ID3D11Resource>);
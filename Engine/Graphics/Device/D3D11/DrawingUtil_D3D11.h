@@ -56,6 +56,12 @@ namespace Engine
                 return DXGI_FORMAT_R32G32_UINT;
             case eFormat_R32G32_SINT:
                 return DXGI_FORMAT_R32G32_SINT;
+            case eFormat_R16G16_FLOAT:
+                return DXGI_FORMAT_R16G16_FLOAT;
+            case eFormat_R16G16_SNORM:
+                return DXGI_FORMAT_R16G16_SNORM;
+            case eFormat_R16G16B16A16_UNORM:
+                return DXGI_FORMAT_R16G16B16A16_UNORM;
             case eFormat_R8G8B8A8_UNORM:
                 return DXGI_FORMAT_R8G8B8A8_UNORM;
             case eFormat_R8G8B8A8_SNORM:
@@ -315,6 +321,8 @@ namespace Engine
         case eFormat_R32G32_SINT:
             return "int2";
         case eFormat_R32G32_FLOAT:
+        case eFormat_R16G16_FLOAT:
+        case eFormat_R16G16_SNORM:
             return "float2";
         case eFormat_R32G32B32_UINT:
             return "uint3";
@@ -327,6 +335,7 @@ namespace Engine
         case eFormat_R32G32B32A32_SINT:
             return "int4";
         case eFormat_R32G32B32A32_FLOAT:
+        case eFormat_R16G16B16A16_UNORM:
             return "float4";
         }
         return "float4";
@@ -339,10 +348,13 @@ namespace Engine
         case eFormat_R32_UINT:
         case eFormat_R32_SINT:
         case eFormat_R32_FLOAT:
+        case eFormat_R16G16_FLOAT:
+        case eFormat_R16G16_SNORM:
             return 4U;
         case eFormat_R32G32_UINT:
         case eFormat_R32G32_SINT:
         case eFormat_R32G32_FLOAT:
+        case eFormat_R16G16B16A16_UNORM:
             return 8U;
         case eFormat_R32G32B32_UINT:
         case eFormat_R32G32B32_SINT:
@@ -174,6 +174,11 @@ bool DrawingDevice_D3D12::CreateTextureFromFile(const std::string uri, std::shar
     return true;
 }
 
+bool DrawingDevice_D3D12::CreateTextureFromMemory(const void* pData, uint32_t size, std::shared_ptr<DrawingTexture>& pRes, uint32_t maxSize)
+{
+    return true;
+}
+
 bool DrawingDevice_D3D12::CreateTarget(const DrawingTargetDesc& desc, std::shared_ptr<DrawingTarget>& pRes)
 {
     std::shared_ptr<DrawingRawTarget> pTargetRaw = nullptr;
@@ -37,6 +37,7 @@ namespace Engine
         bool CreateIndexBuffer(const DrawingIndexBufferDesc& desc, std::shared_ptr<DrawingIndexBuffer>& pRes, std::shared_ptr<DrawingResource> pRefRes = nullptr, const void* pData = nullptr, uint32_t size = 0) override;
         bool CreateTexture(const DrawingTextureDesc& desc, std::shared_ptr<DrawingTexture>& pRes, std::shared_ptr<DrawingResource> pRefRes = nullptr, const void* pData[] = nullptr, uint32_t size[] = nullptr, uint32_t slices = 0) override;
         bool CreateTextureFromFile(const std::string uri, std::shared_ptr<DrawingTexture>& pRes) override;
+        bool CreateTextureFromMemory(const void* pData, uint32_t size, std::shared_ptr<DrawingTexture>& pRes, uint32_t maxSize) override;
         bool CreateTarget(const DrawingTargetDesc& desc, std::shared_ptr<DrawingTarget>& pRes) override;
         bool CreateDepthBuffer(const DrawingDepthBufferDesc& desc, std::shared_ptr<DrawingDepthBuffer>& pRes) override;
 
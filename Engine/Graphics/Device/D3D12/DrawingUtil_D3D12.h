@@ -54,6 +54,12 @@ namespace Engine
                 return DXGI_FORMAT_R32G32_UINT;
             case eFormat_R32G32_SINT:
                 return DXGI_FORMAT_R32G32_SINT;
+            case eFormat_R16G16_FLOAT:
+                return DXGI_FORMAT_R16G16_FLOAT;
+            case eFormat_R16G16_SNORM:
+                return DXGI_FORMAT_R16G16_SNORM;
+            case eFormat_R16G16B16A16_UNORM:
+                return DXGI_FORMAT_R16G16B16A16_UNORM;
             case eFormat_R8G8B8A8_UNORM:
                 return DXGI_FORMAT_R8G8B8A8_UNORM;
             case eFormat_R8G8B8A8_SNORM:
@@ -194,10 +200,13 @@ namespace Engine
         case eFormat_R32_UINT:
         case eFormat_R32_SINT:
         case eFormat_R32_FLOAT:
+        case eFormat_R16G16_FLOAT:
+        case eFormat_R16G16_SNORM:
             return 4U;
         case eFormat_R32G32_UINT:
         case eFormat_R32G32_SINT:
         case eFormat_R32G32_FLOAT:
+        case eFormat_R16G16B16A16_UNORM:
             return 8U;
         case eFormat_R32G32B32_UINT:
         case eFormat_R32G32B32_SINT:
@@ -88,6 +88,10 @@ namespace Engine
         eFormat_R32G32_UINT,
         eFormat_R32G32_SINT,
 
+        eFormat_R16G16_FLOAT,
+        eFormat_R16G16_SNORM,
+        eFormat_R16G16B16A16_UNORM,
+
         eFormat_R8G8B8A8_UNORM,
         eFormat_R8G8B8A8_SNORM,
         eFormat_R8G8B8A8_UINT,
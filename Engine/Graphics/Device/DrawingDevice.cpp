@@ -463,6 +463,21 @@ void DrawingContext::UpdateTransform(DrawingResourceTable& resTable, float4x4 tr
         pParam->AsFloat4x4(trans);
 }
 
+void DrawingContext::UpdateVertexQuantization(DrawingResourceTable& resTable, float3 scale, float3 offset)
+{
+    auto pEntry = resTable.GetResourceEntry(BaseRenderer::DefaultVertexQuantization());
+    assert(pEntry != nullptr);
+    auto pCB = std::dynamic_pointer_cast<DrawingConstantBuffer>(pEntry->GetResource());
+    if (pCB == nullptr)
+        return;
+    auto pParam = pCB->GetParameter(strPtr("gPositionScale"));
+    if (pParam != nullptr)
+        pParam->AsFloat3(scale);
+    pParam = pCB->GetParameter(strPtr("gPositionOffset"));
+    if (pParam != nullptr)
+        pParam->AsFloat3(offset);
+}
+
 void DrawingContext::UpdateCamera(DrawingResourceTable& resTable, float4x4 proj, float4x4 view)
 {
     auto pEntry = resTable.GetResourceEntry(BaseRenderer::DefaultProjectionMatrix());
@@ -293,6 +293,7 @@ namespace Engine
 
         void UpdateContext(DrawingResourceTable& resTable);
         void UpdateTransform(DrawingResourceTable& resTable, float4x4 trans);
+        void UpdateVertexQuantization(DrawingResourceTable& resTable, float3 scale, float3 offset);
         void UpdateCamera(DrawingResourceTable& resTable, float4x4 proj, float4x4 view);
 
         void UpdateTargets(DrawingResourceTable& resTable);
@@ -326,6 +327,9 @@ namespace Engine
         virtual bool CreateIndexBuffer(const DrawingIndexBufferDesc& desc, std::shared_ptr<DrawingIndexBuffer>& pRes, std::shared_ptr<DrawingResource> pRefRes = nullptr, const void* pData = nullptr, uint32_t size = 0) =  0;
         virtual bool CreateTexture(const DrawingTextureDesc& desc, std::shared_ptr<DrawingTexture>& pRes, std::shared_ptr<DrawingResource> pRefRes = nullptr, const void* pData[] = nullptr, uint32_t size[] = nullptr, uint32_t slices = 0) = 0;
         virtual bool CreateTextureFromFile(const std::string uri, std::shared_ptr<DrawingTexture>& pRes) = 0;
+        // DDS mips larger than maxSize on either side are left out, so part of a chain is created
+        // straight from the mapped file. 0 keeps all of them.
+        virtual bool CreateTextureFromMemory(const void* pData, uint32_t size, std::shared_ptr<DrawingTexture>& pRes, uint32_t maxSize = 0) = 0;
         virtual bool CreateTarget(const DrawingTargetDesc& desc, std::shared_ptr<DrawingTarget>& pRes) = 0;
         virtual bool CreateDepthBuffer(const DrawingDepthBufferDesc& desc, std::shared_ptr<DrawingDepthBuffer>& pRes) = 0;
         virtual bool CreateConstantBuffer(const DrawingConstantBufferDesc& desc, std::shared_ptr<DrawingConstantBuffer>& pRes);
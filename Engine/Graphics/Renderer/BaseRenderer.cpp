@@ -7,7 +7,7 @@ using namespace Engine;
 const uint32_t DrawingLinkedEffectDesc::VERTEX_SHADER_ID;
 const uint32_t DrawingLinkedEffectDesc::PIXEL_SHADER_ID;
 
-BaseRenderer::BaseRenderer()
+BaseRenderer::BaseRenderer() : m_bCullingView(false), m_bClusterIndices(false), m_lod(0)
 {
 }
 
@@ -142,8 +142,27 @@ void BaseRenderer::Render(DrawingResourceTable& resTable, std::shared_ptr<Drawin
             return;
 
         auto trans = UpdateWorldMatrix(item.pTransformComp);
+
+        if (m_bCullingView)
+        {
+            m_viewParams.world = trans;
+
+            // Meshlets cover LOD 0 only, coarser levels are drawn whole.
+            m_lod = pMesh->SelectLod(m_viewParams, MAX_LOD_PIXEL_ERROR);
+            if (m_lod == 0)
+            {
+                m_bClusterIndices = pMesh->CullMeshlets(m_viewParams, m_clusterIndices);
+                if (m_bClusterIndices && m_clusterIndices.empty())
+                    return;
+            }
+        }
+
         m_pDeviceContext->UpdateTransform(resTable, trans);
 
+        // Positions are UNORM16 over the mesh bounds, see AttachMesh.
+        auto& bounds = pMesh->GetBounds();
+        m_pDeviceContext->UpdateVertexQuantization(resTable, bounds.Size(), bounds.mMin);
+
         BeginDrawPass();
         AttachMesh(pMesh);
         FlushData();
@@ -153,6 +172,9 @@ void BaseRenderer::Render(DrawingResourceTable& resTable, std::shared_ptr<Drawin
 
         ResetData();
         EndDrawPass();
+
+        m_bClusterIndices = false;
+        m_lod = 0;
     });
 }
 
@@ -192,21 +214,79 @@ void BaseRenderer::AttachMesh(const IMesh* pMesh)
 
     auto pAttributes = pMesh->GetAttributes();
 
+    // The streams are always packed. Quantized meshes are copied as is, float meshes are packed
+    // straight into the mapped buffer.
     std::for_each(pAttributes.cbegin(), pAttributes.cend(), [&](std::shared_ptr<Attribute> pElem)
     {
         auto type = (uint32_t)pElem->semanticType;
-        
+        auto format = pElem->format;
+
         if (type == (uint32_t)Attribute::ESemanticType::Position)
-            m_pTransientPositionBuffer->FillData(pElem->pData.get(), vertexCount);
+        {
+            if (format == Attribute::EFormat::UNorm16x4)
+                m_pTransientPositionBuffer->FillData(pElem->pData.get(), vertexCount);
+            else
+            {
+                auto pDst = static_cast<PackedPosition*>(m_pTransientPositionBuffer->Map(vertexCount));
+                VertexPacking::PackPositions(reinterpret_cast<const float3*>(pElem->pData.get()), vertexCount, pMesh->GetBounds(), pDst);
+                m_pTransientPositionBuffer->UnMap(nullptr);
+            }
+        }
 
         if (type == (uint32_t)Attribute::ESemanticType::Normal)
-            m_pTransientNormalBuffer->FillData(pElem->pData.get(), vertexCount);
+        {
+            if (format == Attribute::EFormat::SNorm16x2)
+                m_pTransientNormalBuffer->FillData(pElem->pData.get(), vertexCount);
+            else
+            {
+                auto pDst = static_cast<PackedNormal*>(m_pTransientNormalBuffer->Map(vertexCount));
+                VertexPacking::PackNormals(reinterpret_cast<const float3*>(pElem->pData.get()), vertexCount, pDst);
+                m_pTransientNormalBuffer->UnMap(nullptr);
+            }
+        }
 
         if (type == (uint32_t)Attribute::ESemanticType::Texcoord0)
-            m_pTransientTexcoordBuffer->FillData(pElem->pData.get(), vertexCount);
+        {
+            if (format == Attribute::EFormat::Half2)
+                m_pTransientTexcoordBuffer->FillData(pElem->pData.get(), vertexCount);
+            else
+            {
+                auto pDst = static_cast<PackedTexcoord*>(m_pTransientTexcoordBuffer->Map(vertexCount));
+                VertexPacking::PackTexcoords(reinterpret_cast<const float2*>(pElem->pData.get()), vertexCount, pDst);
+                m_pTransientTexcoordBuffer->UnMap(nullptr);
+            }
+        }
     });
 
-    m_pTransientIndexBuffer->FillData(pMesh->GetIndexData().get(), indexCount);
+    if (m_bClusterIndices)
+    {
+        auto count = (uint32_t)m_clusterIndices.size();
+        auto pDst = static_cast<uint16_t*>(m_pTransientIndexBuffer->Map(count));
+        for (uint32_t i = 0; i < count; i++)
+            pDst[i] = (uint16_t)m_clusterIndices[i];
+        m_pTransientIndexBuffer->UnMap(nullptr);
+    }
+    else if (m_lod > 0)
+    {
+        auto lod = pMesh->GetLod(m_lod);
+        auto stride = pMesh->IndexSize() / indexCount;
+        m_pTransientIndexBuffer->FillData(pMesh->GetIndexData().get() + lod.indexOffset * stride, lod.indexCount);
+    }
+    else
+        m_pTransientIndexBuffer->FillData(pMesh->GetIndexData().get(), indexCount);
+}
+
+void BaseRenderer::SetCullingView(const float4x4& viewProj, const float3& cameraPosition, const float2& viewportSize)
+{
+    m_bCullingView = true;
+    m_viewParams.viewProj = viewProj;
+    m_viewParams.cameraPosition = cameraPosition;
+    m_viewParams.viewportSize = viewportSize;
+}
+
+void BaseRenderer::ResetCullingView()
+{
+    m_bCullingView = false;
 }
 
 std::shared_ptr<DrawingPass> BaseRenderer::CreatePass(std::shared_ptr<std::string> pName)
@@ -362,6 +442,7 @@ void BaseRenderer::DefineDefaultResources(DrawingResourceTable& resTable)
     DefineWorldMatrixConstantBuffer(resTable);
     DefineViewMatrixConstantBuffer(resTable);
     DefineProjectionMatrixConstantBuffer(resTable);
+    DefineVertexQuantizationConstantBuffer(resTable);
 
     DefineTarget(DebugLayerTarget(), gpGlobal->GetConfiguration<DebugConfiguration>().GetWidth(), gpGlobal->GetConfiguration<DebugConfiguration>().GetHeight(), resTable);
     DefineShaderResource(resTable);
@@ -448,7 +529,7 @@ void BaseRenderer::DefineVertexFormatP(DrawingResourceTable& resTable)
 
     DrawingVertexFormatDesc::VertexInputElement inputElem;
 
-    inputElem.mFormat = eFormat_R32G32B32_FLOAT;
+    inputElem.mFormat = eFormat_R16G16B16A16_UNORM;
     inputElem.mpName = strPtr("POSITION");
     inputElem.mIndex = 0;
     inputElem.mSlot = 0;
@@ -465,7 +546,7 @@ void BaseRenderer::DefineVertexFormatPN(DrawingResourceTable& resTable)
 
     DrawingVertexFormatDesc::VertexInputElement inputElem;
 
-    inputElem.mFormat = eFormat_R32G32B32_FLOAT;
+    inputElem.mFormat = eFormat_R16G16B16A16_UNORM;
     inputElem.mpName = strPtr("POSITION");
     inputElem.mIndex = 0;
     inputElem.mSlot = 0;
@@ -473,7 +554,7 @@ void BaseRenderer::DefineVertexFormatPN(DrawingResourceTable& resTable)
     inputElem.mInstanceStepRate = 0;
     pDesc->m_inputElements.emplace_back(inputElem);
 
-    inputElem.mFormat = eFormat_R32G32B32_FLOAT;
+    inputElem.mFormat = eFormat_R16G16_SNORM;
     inputElem.mpName = strPtr("NORMAL");
     inputElem.mIndex = 0;
     inputElem.mSlot = 1;
@@ -490,7 +571,7 @@ void BaseRenderer::DefineVertexFormatPNT(DrawingResourceTable& resTable)
 
     DrawingVertexFormatDesc::VertexInputElement inputElem;
 
-    inputElem.mFormat = eFormat_R32G32B32_FLOAT;
+    inputElem.mFormat = eFormat_R16G16B16A16_UNORM;
     inputElem.mpName = strPtr("POSITION");
     inputElem.mIndex = 0;
     inputElem.mSlot = 0;
@@ -498,7 +579,7 @@ void BaseRenderer::DefineVertexFormatPNT(DrawingResourceTable& resTable)
     inputElem.mInstanceStepRate = 0;
     pDesc->m_inputElements.emplace_back(inputElem);
 
-    inputElem.mFormat = eFormat_R32G32B32_FLOAT;
+    inputElem.mFormat = eFormat_R16G16_SNORM;
     inputElem.mpName = strPtr("NORMAL");
     inputElem.mIndex = 0;
     inputElem.mSlot = 1;
@@ -506,7 +587,7 @@ void BaseRenderer::DefineVertexFormatPNT(DrawingResourceTable& resTable)
     inputElem.mInstanceStepRate = 0;
     pDesc->m_inputElements.emplace_back(inputElem);
 
-    inputElem.mFormat = eFormat_R32G32_FLOAT;
+    inputElem.mFormat = eFormat_R16G16_FLOAT;
     inputElem.mpName = strPtr("TEXCOORD");
     inputElem.mIndex = 0;
     inputElem.mSlot = 2;
@@ -621,6 +702,22 @@ void BaseRenderer::DefineProjectionMatrixConstantBuffer(DrawingResourceTable& re
     resTable.AddResourceEntry(DefaultProjectionMatrix(), pDesc);
 }
 
+void BaseRenderer::DefineVertexQuantizationConstantBuffer(DrawingResourceTable& resTable)
+{
+    auto pDesc = std::make_shared<DrawingConstantBufferDesc>();
+
+    DrawingConstantBufferDesc::ParamDesc param;
+    param.mpName = strPtr("gPositionScale");
+    param.mType = EParam_Float3;
+    pDesc->mParameters.emplace_back(param);
+
+    param.mpName = strPtr("gPositionOffset");
+    param.mType = EParam_Float3;
+    pDesc->mParameters.emplace_back(param);
+
+    resTable.AddResourceEntry(DefaultVertexQuantization(), pDesc);
+}
+
 void BaseRenderer::DefineCameraDirVectorConstantBuffer(DrawingResourceTable& resTable)
 {
     auto pDesc = std::make_shared<DrawingConstantBufferDesc>();
@@ -1090,6 +1187,7 @@ void BaseRenderer::BindConstants(DrawingPass& pass)
     AddConstantSlot(pass, DefaultWorldMatrix());
     AddConstantSlot(pass, DefaultViewMatrix());
     AddConstantSlot(pass, DefaultProjectionMatrix());
+    AddConstantSlot(pass, DefaultVertexQuantization());
 }
 
 void BaseRenderer::BindCameraConstants(DrawingPass& pass)
@@ -1318,40 +1416,5 @@ void BaseRenderer::UpdateRectPrimitive(DrawingResourceTable& resTable)
 
 float4x4 BaseRenderer::UpdateWorldMatrix(const TransformComponent* pTransform)
 {
-    float3 position = pTransform->GetPosition();
-    float3 rotate = pTransform->GetRotate();
-    float3 scale = pTransform->GetScale();
-    float4 quaternion = pTransform->GetQuaternion();
-
-    float4x4 posMatrix = {
-        1.f, 0.f, 0.f, 0.f,
-        0.f, 1.f, 0.f, 0.f,
-        0.f, 0.f, 1.f, 0.f,
-        position.x, position.y, position.z, 1.f
-    };
-
-    auto rotMat = Mat::EulerRotateLH(rotate.x, rotate.y, rotate.z);
-    float4x4 rotMatrix = {
-        rotMat.x00, rotMat.x01, rotMat.x02, 0.f,
-        rotMat.x10, rotMat.x11, rotMat.x12, 0.f,
-        rotMat.x20, rotMat.x21, rotMat.x22, 0.f,
-        0.f, 0.f, 0.f, 1.f
-    };
-
-    auto quatMat = Mat::QuatRotateLH(quaternion.x, quaternion.y, quaternion.z, quaternion.w);
-    float4x4 quatMatrix = {
-        quatMat.x00, quatMat.x01, quatMat.x02, 0.f,
-        quatMat.x10, quatMat.x11, quatMat.x12, 0.f,
-        quatMat.x20, quatMat.x21, quatMat.x22, 0.f,
-        0.f, 0.f, 0.f, 1.f
-    };
-
-    float4x4 scaleMatrix = {
-        scale.x, 0.f, 0.f, 0.f,
-        0.f, scale.y, 0.f, 0.f,
-        0.f, 0.f, scale.z, 0.f,
-        0.f, 0.f, 0.f, 1.f
-    };
-
-    return Mat::Mul(scaleMatrix, Mat::Mul(quatMatrix, Mat::Mul(rotMatrix, posMatrix)));
+    return pTransform->GetWorldMatrix();
 }
\ No newline at end of file
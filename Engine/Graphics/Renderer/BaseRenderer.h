@@ -2,12 +2,14 @@
 
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "IRenderer.h"
 #include "DrawingPass.h"
 #include "FrameGraph.h"
 
 #include "RenderQueue.h"
+#include "VertexPacking.h"
 #include "DrawingStreamedResource.h"
 #include "DrawingTextureTarget.h"
 
@@ -51,6 +53,11 @@ namespace Engine
         void UpdateNormalTexture(DrawingResourceTable& resTable, std::shared_ptr<DrawingResource> pTexture);
         void UpdateEmissiveTexture(DrawingResourceTable& resTable, std::shared_ptr<DrawingResource> pTexture);
 
+        // Until reset, meshes draw the level of detail this view needs and meshes with meshlets only
+        // submit the triangles visible from it.
+        void SetCullingView(const float4x4& viewProj, const float3& cameraPosition, const float2& viewportSize);
+        void ResetCullingView();
+
     private:
         virtual void BeginDrawPass() = 0;
         virtual void EndDrawPass() = 0;
@@ -111,6 +118,7 @@ namespace Engine
         FuncResourceName(DefaultWorldMatrix)
         FuncResourceName(DefaultViewMatrix)
         FuncResourceName(DefaultProjectionMatrix)
+        FuncResourceName(DefaultVertexQuantization)
         FuncResourceName(CameraDirVector)
         FuncResourceName(LightDirVector)
         FuncResourceName(LightViewMatrix)
@@ -190,6 +198,7 @@ namespace Engine
         void DefineWorldMatrixConstantBuffer(DrawingResourceTable& resTable);
         void DefineViewMatrixConstantBuffer(DrawingResourceTable& resTable);
         void DefineProjectionMatrixConstantBuffer(DrawingResourceTable& resTable);
+        void DefineVertexQuantizationConstantBuffer(DrawingResourceTable& resTable);
 
         void DefineCameraDirVectorConstantBuffer(DrawingResourceTable& resTable);
         void DefineLightDirVectorConstantBuffer(DrawingResourceTable& resTable);
@@ -271,9 +280,12 @@ namespace Engine
         static const uint32_t MAX_VERTEX_COUNT = 65536 * 4;
         static const uint32_t MAX_INDEX_COUNT = 65536 * 4;
 
-        static const uint32_t PositionOffset = sizeof(float3);
-        static const uint32_t NormalOffset = sizeof(float3);
-        static const uint32_t TexcoordOffset = sizeof(float2);
+        // Screen space error a coarser level of detail may introduce.
+        constexpr static float MAX_LOD_PIXEL_ERROR = 1.0f;
+
+        static const uint32_t PositionOffset = sizeof(PackedPosition);
+        static const uint32_t NormalOffset = sizeof(PackedNormal);
+        static const uint32_t TexcoordOffset = sizeof(PackedTexcoord);
 
         std::shared_ptr<DrawingTransientVertexBuffer> m_pTransientPositionBuffer;
         std::shared_ptr<DrawingTransientVertexBuffer> m_pTransientNormalBuffer;
@@ -292,6 +304,14 @@ namespace Engine
 
         DrawingPassTable m_passTable;
         RenderQueue m_renderQueue;
+
+        bool m_bCullingView;
+        MeshViewParams m_viewParams;
+        // Culled indices of the mesh being attached, valid while m_bClusterIndices is set.
+        std::vector<uint32_t> m_clusterIndices;
+        bool m_bClusterIndices;
+        // Level of detail of the mesh being attached.
+        uint32_t m_lod;
     };
 
     template<typename T>
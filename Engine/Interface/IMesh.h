@@ -3,6 +3,8 @@
 #include <string>
 
 #include "Vector.h"
+#include "Matrix.h"
+#include "Box3.h"
 #include "DrawingConstants.h"
 
 namespace Engine
@@ -17,14 +19,53 @@ namespace Engine
             Texcoord0,
             Texcoord1,
             Texcoord2,
+            Color0,
+            Joints0,
+            Weights0,
             Count,
         } semanticType;
 
+        enum class EFormat : uint16_t
+        {
+            Float2,
+            Float3,
+            Float4,
+            UNorm16x4,
+            SNorm16x2,
+            Half2,
+            UInt16x4,
+        } format;
+
         std::string name;
         std::shared_ptr<char> pData;
         uint32_t size;
     };
 
+    // Post-transform cache efficiency. ACMR is misses per triangle (0.5 is the best a regular grid
+    // gets), ATVR misses per vertex (1 is ideal).
+    struct VertexCacheStatistics
+    {
+        float acmr;
+        float atvr;
+    };
+
+    // Level of detail in the shared index data. error bounds the deviation from LOD 0 in mesh units.
+    struct MeshLod
+    {
+        uint32_t indexOffset;
+        uint32_t indexCount;
+        float error;
+    };
+
+    // Per draw view for IMesh::CullMeshlets and IMesh::SelectLod.
+    struct MeshViewParams
+    {
+        float4x4 world;
+        float4x4 viewProj;
+        float3 cameraPosition;  // World space.
+        float2 viewportSize;    // Zero disables small triangle rejection.
+    };
+
     class IMesh
     {
     public:
@@ -38,7 +79,41 @@ namespace Engine
         virtual const uint32_t VertexCount() const = 0;
         virtual const uint32_t IndexCount() const = 0;
 
+        virtual const Box3& GetBounds() const = 0;
+
         virtual void AttachVertexData(const char array[], const uint32_t size, const uint32_t count, Attribute::ESemanticType type, std::string name) = 0;
         virtual void AttachIndexData(const char array[], const uint32_t size, const uint32_t count) = 0;
+
+        // Share pData instead of copying it, e.g. a tightly packed view into a mapped file.
+        virtual void AttachVertexData(std::shared_ptr<char> pData, const uint32_t size, const uint32_t count, Attribute::ESemanticType type, std::string name) = 0;
+        virtual void AttachIndexData(std::shared_ptr<char> pData, const uint32_t size, const uint32_t count) = 0;
+
+        // Builds a Float4 tangent stream (w = handedness) from the positions, normals, first texcoords
+        // and indices when the mesh has none. Must run before Quantize.
+        virtual void GenerateTangents() = 0;
+
+        // Welds identical vertices, orders triangles for the vertex cache and overdraw and vertices for
+        // fetch locality, then narrows indices to 16 bit when they fit. Indexes non indexed meshes.
+        virtual void Optimize(VertexCacheStatistics* pBefore = nullptr, VertexCacheStatistics* pAfter = nullptr) = 0;
+
+        // Simplifies LOD 0 into up to lodCount - 1 coarser levels appended to the index data, which keeps
+        // IndexSize() and IndexCount() for LOD 0. Must run before Quantize.
+        virtual void GenerateLods(uint32_t lodCount) = 0;
+        virtual uint32_t GetLodCount() const = 0;
+        virtual MeshLod GetLod(uint32_t lod) const = 0;
+        // Coarsest level whose error projects to at most maxPixelError pixels.
+        virtual uint32_t SelectLod(const MeshViewParams& params, float maxPixelError) const = 0;
+
+        // Splits the index data into meshlets with bounds and normal cones. Must run before Quantize,
+        // after Optimize so meshlets follow the cache order.
+        virtual void GenerateMeshlets() = 0;
+        // Fills indices with the triangles of the meshlets that pass the frustum, backface cone and
+        // small triangle tests. Returns false when the mesh has no meshlets.
+        virtual bool CullMeshlets(const MeshViewParams& params, std::vector<uint32_t>& indices) const = 0;
+
+        // Replaces the float streams with the packed layouts of VertexPacking.h. Positions become
+        // relative to GetBounds(), so the bounds must not change afterwards.
+        virtual void Quantize() = 0;
+        virtual bool IsQuantized() const = 0;
     };
 }
\ No newline at end of file
@@ -1,9 +1,16 @@
 #pragma once
 
+#include <vector>
+
 #include "IRuntimeModule.h"
+#include "Vector.h"
+#include "Box3.h"
+#include "Sphere.h"
+#include "Frustum.h"
 
 namespace Engine
 {
+    class IEntity;
     class ISceneSystem : public IRuntimeModule
     {
     public:
@@ -14,5 +21,10 @@ namespace Engine
         virtual void Shutdown() = 0;
 
         virtual void Tick(float elapsedTime) = 0;
+
+        virtual void QueryFrustum(const Frustum& frustum, std::vector<IEntity*>& pEntities) const = 0;
+        virtual void QuerySphere(const Sphere& sphere, std::vector<IEntity*>& pEntities) const = 0;
+        virtual void QueryBox(const Box3& box, std::vector<IEntity*>& pEntities) const = 0;
+        virtual void QueryRay(const float3& origin, const float3& dir, float maxDistance, std::vector<IEntity*>& pEntities) const = 0;
     };
 }
\ No newline at end of file
@@ -7,6 +7,28 @@
 
 namespace Engine
 {
+    // Pending until the drawing system first sees the texture, Decoding while a worker prepares its
+    // data, Resident once the device texture exists. Materials draw with a placeholder until then.
+    enum ETextureState
+    {
+        eTextureState_Pending = 0,
+        eTextureState_Decoding,
+        eTextureState_Resident,
+    };
+
+    // What a texture is sampled as, which decides how it is cooked.
+    enum ETextureRole
+    {
+        eTextureRole_Albedo = 0,
+        eTextureRole_Normal,
+        eTextureRole_Occlusion,
+        eTextureRole_MetallicRoughness,
+        eTextureRole_Emissive,
+        eTextureRole_HDR,
+        // Albedo whose alpha is tested against a cutoff, as glTF MASK materials do.
+        eTextureRole_AlphaTested,
+    };
+
     class ITexture
     {
     public:
@@ -18,5 +40,17 @@ namespace Engine
 
         virtual std::shared_ptr<DrawingTexture> GetTexture() const = 0;
         virtual void SetTexture(std::shared_ptr<DrawingTexture> pTexture) = 0;
+
+        virtual ETextureState GetState() const = 0;
+        virtual void SetState(ETextureState state) = 0;
+
+        virtual ETextureRole GetRole() const = 0;
+        virtual void SetRole(ETextureRole role) = 0;
+
+        // Encoded image bytes fetched ahead of time, e.g. by an importer. Used instead of the URI when set.
+        // Streamed textures keep their cooked DDS here once resident, to read the mips they lack from.
+        virtual std::shared_ptr<char> GetSourceData() const = 0;
+        virtual uint32_t GetSourceSize() const = 0;
+        virtual void SetSourceData(std::shared_ptr<char> pData, uint32_t size) = 0;
     };
 }
\ No newline at end of file
@@ -0,0 +1,157 @@
+#pragma once
+
+#include <algorithm>
+#include <assert.h>
+#include <cfloat>
+
+#include "Vector.h"
+#include "Matrix.h"
+
+namespace Engine
+{
+    class Box3
+    {
+    public:
+        Vec3<float> mMin, mMax;
+
+        Box3()
+        {
+            Clear();
+        }
+
+        Box3(const Vec3<float>& min, const Vec3<float>& max) : mMin(min), mMax(max)
+        {
+        }
+
+        Box3(float minX, float minY, float minZ, float maxX, float maxY, float maxZ) : mMin(minX, minY, minZ), mMax(maxX, maxY, maxZ)
+        {
+        }
+
+        void Set(const Vec3<float>& min, const Vec3<float>& max)
+        {
+            mMin = min;
+            mMax = max;
+        }
+
+        Vec3<float> Size() const
+        {
+            return mMax - mMin;
+        }
+
+        Vec3<float> Center() const
+        {
+            return (mMin + mMax) * 0.5f;
+        }
+
+        Vec3<float> Extent() const
+        {
+            return (mMax - mMin) * 0.5f;
+        }
+
+        float Radius() const
+        {
+            return Vec::Length(Extent());
+        }
+
+        float SurfaceArea() const
+        {
+            auto size = Size();
+            return 2.0f * (size.x * size.y + size.y * size.z + size.z * size.x);
+        }
+
+        bool IsEmpty() const
+        {
+            return mMin.x > mMax.x || mMin.y > mMax.y || mMin.z > mMax.z;
+        }
+
+        void Clear()
+        {
+            mMin = Vec3<float>(FLT_MAX, FLT_MAX, FLT_MAX);
+            mMax = Vec3<float>(-FLT_MAX, -FLT_MAX, -FLT_MAX);
+        }
+
+        void Expand(const Vec3<float>& point)
+        {
+            mMin = Vec3<float>(std::min(mMin.x, point.x), std::min(mMin.y, point.y), std::min(mMin.z, point.z));
+            mMax = Vec3<float>(std::max(mMax.x, point.x), std::max(mMax.y, point.y), std::max(mMax.z, point.z));
+        }
+
+        void Expand(const Box3& box)
+        {
+            if (box.IsEmpty())
+                return;
+
+            Expand(box.mMin);
+            Expand(box.mMax);
+        }
+
+        bool Contains(const Vec3<float>& point) const
+        {
+            return point.x >= mMin.x && point.x <= mMax.x &&
+                   point.y >= mMin.y && point.y <= mMax.y &&
+                   point.z >= mMin.z && point.z <= mMax.z;
+        }
+
+        bool Contains(const Box3& box) const
+        {
+            return box.mMin.x >= mMin.x && box.mMax.x <= mMax.x &&
+                   box.mMin.y >= mMin.y && box.mMax.y <= mMax.y &&
+                   box.mMin.z >= mMin.z && box.mMax.z <= mMax.z;
+        }
+
+        bool Intersect(const Box3& box) const
+        {
+            return mMin.x <= box.mMax.x && mMax.x >= box.mMin.x &&
+                   mMin.y <= box.mMax.y && mMax.y >= box.mMin.y &&
+                   mMin.z <= box.mMax.z && mMax.z >= box.mMin.z;
+        }
+
+        // Slab test, invDir being the component-wise reciprocal of the ray direction.
+        bool IntersectRay(const Vec3<float>& origin, const Vec3<float>& invDir, float maxDistance, float& distance) const
+        {
+            float tmin = 0.0f;
+            float tmax = maxDistance;
+            for (int axis = 0; axis < 3; axis++)
+            {
+                float t0 = (mMin[axis] - origin[axis]) * invDir[axis];
+                float t1 = (mMax[axis] - origin[axis]) * invDir[axis];
+                if (t0 > t1)
+                    std::swap(t0, t1);
+
+                tmin = std::max(tmin, t0);
+                tmax = std::min(tmax, t1);
+                if (tmin > tmax)
+                    return false;
+            }
+
+            distance = tmin;
+            return true;
+        }
+
+        static Box3 Union(const Box3& box1, const Box3& box2)
+        {
+            return Box3(Vec3<float>(std::min(box1.mMin.x, box2.mMin.x), std::min(box1.mMin.y, box2.mMin.y), std::min(box1.mMin.z, box2.mMin.z)),
+                        Vec3<float>(std::max(box1.mMax.x, box2.mMax.x), std::max(box1.mMax.y, box2.mMax.y), std::max(box1.mMax.z, box2.mMax.z)));
+        }
+
+        // Bounds of the box after a row-vector affine transform (Arvo's method).
+        Box3 Transform(const Mat4x4<float>& m) const
+        {
+            if (IsEmpty())
+                return *this;
+
+            auto center = Center();
+            auto extent = Extent();
+
+            Vec3<float> newCenter(center.x * m.x00 + center.y * m.x10 + center.z * m.x20 + m.x30,
+                                  center.x * m.x01 + center.y * m.x11 + center.z * m.x21 + m.x31,
+                                  center.x * m.x02 + center.y * m.x12 + center.z * m.x22 + m.x32);
+
+            Vec3<float> newExtent(extent.x * std::abs(m.x00) + extent.y * std::abs(m.x10) + extent.z * std::abs(m.x20),
+                                  extent.x * std::abs(m.x01) + extent.y * std::abs(m.x11) + extent.z * std::abs(m.x21),
+                                  extent.x * std::abs(m.x02) + extent.y * std::abs(m.x12) + extent.z * std::abs(m.x22));
+
+            return Box3(newCenter - newExtent, newCenter + newExtent);
+        }
+    };
+}
\ No newline at end of file
@@ -0,0 +1,187 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "Vector.h"
+#include "Matrix.h"
+#include "SIMD.h"
+#include "Box3.h"
+#include "Sphere.h"
+
+namespace Engine
+{
+    // Six inward facing planes (a, b, c, d) with a*x + b*y + c*z + d >= 0 inside.
+    class Frustum
+    {
+    public:
+        enum EPlane
+        {
+            ePlane_Left = 0,
+            ePlane_Right,
+            ePlane_Bottom,
+            ePlane_Top,
+            ePlane_Near,
+            ePlane_Far,
+            ePlane_Count,
+        };
+
+        Vec4<float> mPlanes[ePlane_Count];
+
+        Frustum()
+        {
+        }
+
+        explicit Frustum(const Mat4x4<float>& viewProj)
+        {
+            Set(viewProj);
+        }
+
+        // Extract the planes from a row-vector view * projection matrix with D3D style [0, 1] depth.
+        void Set(const Mat4x4<float>& m)
+        {
+            Vec4<float> col0(m.x00, m.x10, m.x20, m.x30);
+            Vec4<float> col1(m.x01, m.x11, m.x21, m.x31);
+            Vec4<float> col2(m.x02, m.x12, m.x22, m.x32);
+            Vec4<float> col3(m.x03, m.x13, m.x23, m.x33);
+
+            mPlanes[ePlane_Left] = col3 + col0;
+            mPlanes[ePlane_Right] = col3 - col0;
+            mPlanes[ePlane_Bottom] = col3 + col1;
+            mPlanes[ePlane_Top] = col3 - col1;
+            mPlanes[ePlane_Near] = col2;
+            mPlanes[ePlane_Far] = col3 - col2;
+
+            for (auto& plane : mPlanes)
+            {
+                auto length = std::sqrt(plane.x * plane.x + plane.y * plane.y + plane.z * plane.z);
+                if (length > 0.0f)
+                    plane = plane / length;
+            }
+        }
+
+        bool Contains(const Vec3<float>& point) const
+        {
+            for (auto& plane : mPlanes)
+            {
+                if (plane.x * point.x + plane.y * point.y + plane.z * point.z + plane.w < 0.0f)
+                    return false;
+            }
+            return true;
+        }
+
+        bool Intersect(const Sphere& sphere) const
+        {
+            for (auto& plane : mPlanes)
+            {
+                if (plane.x * sphere.mCenter.x + plane.y * sphere.mCenter.y + plane.z * sphere.mCenter.z + plane.w < -sphere.mRadius)
+                    return false;
+            }
+            return true;
+        }
+
+        bool Intersect(const Box3& box) const
+        {
+            auto center = box.Center();
+            auto extent = box.Extent();
+            return IntersectCenterExtent(center.x, center.y, center.z, extent.x, extent.y, extent.z);
+        }
+
+        // True when the box is entirely inside, so its contents need no further tests.
+        bool Contains(const Box3& box) const
+        {
+            auto center = box.Center();
+            auto extent = box.Extent();
+            for (auto& plane : mPlanes)
+            {
+                auto distance = plane.x * center.x + plane.y * center.y + plane.z * center.z + plane.w;
+                auto radius = std::abs(plane.x) * extent.x + std::abs(plane.y) * extent.y + std::abs(plane.z) * extent.z;
+                if (distance - radius < 0.0f)
+                    return false;
+            }
+            return true;
+        }
+
+        bool IntersectCenterExtent(float cx, float cy, float cz, float ex, float ey, float ez) const
+        {
+            for (auto& plane : mPlanes)
+            {
+                auto distance = plane.x * cx + plane.y * cy + plane.z * cz + plane.w;
+                auto radius = std::abs(plane.x) * ex + std::abs(plane.y) * ey + std::abs(plane.z) * ez;
+                if (distance + radius < 0.0f)
+                    return false;
+            }
+            return true;
+        }
+
+        // Test count boxes stored as center/extent SoA arrays, writing 1 to pVisible for boxes that
+        // intersect the frustum. Eight boxes per iteration with AVX, four with SSE.
+        void IntersectBatch(const float* pCenterX, const float* pCenterY, const float* pCenterZ,
+                            const float* pExtentX, const float* pExtentY, const float* pExtentZ,
+                            uint32_t count, uint8_t* pVisible) const;
+    };
+
+    inline void Frustum::IntersectBatch(const float* pCenterX, const float* pCenterY, const float* pCenterZ,
+                                        const float* pExtentX, const float* pExtentY, const float* pExtentZ,
+                                        uint32_t count, uint8_t* pVisible) const
+    {
+        uint32_t i = 0;
+
+#if defined(MATH_SIMD_AVX)
+        for (; i + 8 <= count; i += 8)
+        {
+            __m256 cx = _mm256_loadu_ps(pCenterX + i);
+            __m256 cy = _mm256_loadu_ps(pCenterY + i);
+            __m256 cz = _mm256_loadu_ps(pCenterZ + i);
+            __m256 ex = _mm256_loadu_ps(pExtentX + i);
+            __m256 ey = _mm256_loadu_ps(pExtentY + i);
+            __m256 ez = _mm256_loadu_ps(pExtentZ + i);
+
+            __m256 outside = _mm256_setzero_ps();
+            for (auto& plane : mPlanes)
+            {
+                __m256 distance = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(cx, _mm256_set1_ps(plane.x)),
+                                                              _mm256_mul_ps(cy, _mm256_set1_ps(plane.y))),
+                                                _mm256_add_ps(_mm256_mul_ps(cz, _mm256_set1_ps(plane.z)),
+                                                              _mm256_set1_ps(plane.w)));
+                __m256 radius = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(ex, _mm256_set1_ps(std::abs(plane.x))),
+                                                            _mm256_mul_ps(ey, _mm256_set1_ps(std::abs(plane.y)))),
+                                              _mm256_mul_ps(ez, _mm256_set1_ps(std::abs(plane.z))));
+                outside = _mm256_or_ps(outside, _mm256_cmp_ps(_mm256_add_ps(distance, radius), _mm256_setzero_ps(), _CMP_LT_OQ));
+            }
+
+            int mask = _mm256_movemask_ps(outside);
+            for (uint32_t j = 0; j < 8; j++)
+                pVisible[i + j] = ((mask >> j) & 1) ? 0 : 1;
+        }
+#endif
+
+#if defined(MATH_SIMD_SSE)
+        for (; i + 4 <= count; i += 4)
+        {
+            __m128 cx = _mm_loadu_ps(pCenterX + i);
+            __m128 cy = _mm_loadu_ps(pCenterY + i);
+            __m128 cz = _mm_loadu_ps(pCenterZ + i);
+            __m128 ex = _mm_loadu_ps(pExtentX + i);
+            __m128 ey = _mm_loadu_ps(pExtentY + i);
+            __m128 ez = _mm_loadu_ps(pExtentZ + i);
+
+            __m128 outside = _mm_setzero_ps();
+            for (auto& plane : mPlanes)
+            {
+                __m128 distance = _mm_add_ps(_mm_add_ps(_mm_mul_ps(cx, _mm_set1_ps(plane.x)), _mm_mul_ps(cy, _mm_set1_ps(plane.y))),
+                                             _mm_add_ps(_mm_mul_ps(cz, _mm_set1_ps(plane.z)), _mm_set1_ps(plane.w)));
+                __m128 radius = _mm_add_ps(_mm_add_ps(_mm_mul_ps(ex, _mm_set1_ps(std::abs(plane.x))), _mm_mul_ps(ey, _mm_set1_ps(std::abs(plane.y)))),
+                                           _mm_mul_ps(ez, _mm_set1_ps(std::abs(plane.z))));
+                outside = _mm_or_ps(outside, _mm_cmplt_ps(_mm_add_ps(distance, radius), _mm_setzero_ps()));
+            }
+
+            int mask = _mm_movemask_ps(outside);
+            for (uint32_t j = 0; j < 4; j++)
+                pVisible[i + j] = ((mask >> j) & 1) ? 0 : 1;
+        }
+#endif
+
+        for (; i < count; i++)
+            pVisible[i] = IntersectCenterExtent(pCenterX[i], pCenterY[i], pCenterZ[i], pExtentX[i], pExtentY[i], pExtentZ[i]) ? 1 : 0;
+    }
+}
\ No newline at end of file
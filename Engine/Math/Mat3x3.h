@@ -45,7 +45,7 @@ namespace Engine
 
         void Identity();
 
-        const row_type operator[] (size_type index) const;
+        const row_type& operator[] (size_type index) const;
         row_type& operator[](size_type index);
 
         const row_type Row(size_type index) const;
@@ -61,7 +61,7 @@ namespace Engine
     }
 
     template<typename T>
-    const typename Mat3x3<T>::row_type Mat3x3<T>::operator[] (size_type index) const
+    const typename Mat3x3<T>::row_type& Mat3x3<T>::operator[] (size_type index) const
     {
         return mArray[index];
     }
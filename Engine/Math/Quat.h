@@ -0,0 +1,86 @@
+#pragma once
+
+#include <array>
+#include <Quaternion.h>
+
+namespace Engine
+{
+    template<typename T>
+    class Vec3;
+
+    template<typename T>
+    class Vec4;
+
+    // Rotation quaternion stored as (x, y, z, w), w being the scalar part.
+    // Products follow the Hamilton convention: a * b applies b first, then a.
+    template<typename T>
+    class Quat : public Quaternion
+    {
+    public:
+        typedef Quat<T> type;
+        typedef T value_type;
+        typedef size_t size_type;
+
+        constexpr static int DIMS = 4;
+        union
+        {
+            T mData[DIMS];
+            std::array<T, DIMS> mArray;
+            struct{ T x, y, z, w; };
+        };
+
+        Quat();
+        Quat(const Quat& quat);
+        Quat(Quat&& quat);
+        Quat(const T (&val)[4]);
+        Quat(const Vec4<T>& vec);
+        Quat(const T& x, const T& y, const T& z, const T& w);
+
+        size_type Size() const;
+
+        void Identity();
+
+        Vec3<T> Imaginary() const;
+        Vec4<T> AsVec4() const;
+
+        const T& operator[] (size_type index) const;
+        T& operator[](size_type index);
+
+        Quat& operator= (const Quat& quat);
+        template<typename U>
+        Quat& operator= (const Quat<U>& quat);
+
+        Quat& operator+= (const Quat& quat);
+        Quat& operator-= (const Quat& quat);
+        Quat& operator*= (const Quat& quat);
+
+        template<typename U>
+        Quat& operator*= (const U& scalar);
+        template<typename U>
+        Quat& operator/= (const U& scalar);
+    };
+
+    template<typename T>
+    Quat<T> operator+ (const Quat<T>& quat1, const Quat<T>& quat2);
+    template<typename T>
+    Quat<T> operator- (const Quat<T>& quat1, const Quat<T>& quat2);
+    template<typename T>
+    Quat<T> operator* (const Quat<T>& quat1, const Quat<T>& quat2);
+
+    template<typename T>
+    Quat<T> operator* (const Quat<T>& quat, const T& scalar);
+    template<typename T>
+    Quat<T> operator* (const T& scalar, const Quat<T>& quat);
+    template<typename T>
+    Quat<T> operator/ (const Quat<T>& quat, const T& scalar);
+
+    template<typename T>
+    bool operator== (const Quat<T>& quat1, const Quat<T>& quat2);
+    template<typename T>
+    bool operator!= (const Quat<T>& quat1, const Quat<T>& quat2);
+
+    template<typename T>
+    Quat<T> operator- (const Quat<T>& quat);
+}
+
+#include "Quat_imp.h"
\ No newline at end of file
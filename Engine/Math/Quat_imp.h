@@ -0,0 +1,198 @@
+#pragma once
+
+#include "Vec3.h"
+#include "Vec4.h"
+
+namespace Engine
+{
+    template<typename T>
+    Quat<T>::Quat() : mArray{T(), T(), T(), T(1)}
+    {
+    }
+
+    template<typename T>
+    Quat<T>::Quat(const Quat& quat) : mArray{quat[0], quat[1], quat[2], quat[3]}
+    {
+    }
+
+    template<typename T>
+    Quat<T>::Quat(Quat&& quat) : mArray(std::move(quat.mArray))
+    {
+    }
+
+    template<typename T>
+    Quat<T>::Quat(const T (&val)[4]) : mArray{val[0], val[1], val[2], val[3]}
+    {
+    }
+
+    template<typename T>
+    Quat<T>::Quat(const Vec4<T>& vec) : mArray{vec[0], vec[1], vec[2], vec[3]}
+    {
+    }
+
+    template<typename T>
+    Quat<T>::Quat(const T& x, const T& y, const T& z, const T& w) : mArray{x, y, z, w}
+    {
+    }
+
+    template<typename T>
+    typename Quat<T>::size_type Quat<T>::Size() const
+    {
+        return mArray.size();
+    }
+
+    template<typename T>
+    void Quat<T>::Identity()
+    {
+        mArray = { T(), T(), T(), T(1) };
+    }
+
+    template<typename T>
+    Vec3<T> Quat<T>::Imaginary() const
+    {
+        return Vec3<T>(mArray[0], mArray[1], mArray[2]);
+    }
+
+    template<typename T>
+    Vec4<T> Quat<T>::AsVec4() const
+    {
+        return Vec4<T>(mArray[0], mArray[1], mArray[2], mArray[3]);
+    }
+
+    template<typename T>
+    const T& Quat<T>::operator[] (size_type index) const
+    {
+        return mArray[index];
+    }
+
+    template<typename T>
+    T& Quat<T>::operator[](size_type index)
+    {
+        return const_cast<T&>(static_cast<const Quat&>(*this)[index]);
+    }
+
+    template<typename T>
+    Quat<T>& Quat<T>::operator= (const Quat& quat)
+    {
+        mArray = quat.mArray;
+        return *this;
+    }
+
+    template<typename T>
+    template<typename U>
+    Quat<T>& Quat<T>::operator= (const Quat<U>& quat)
+    {
+        mArray[0] = static_cast<T>(quat[0]);
+        mArray[1] = static_cast<T>(quat[1]);
+        mArray[2] = static_cast<T>(quat[2]);
+        mArray[3] = static_cast<T>(quat[3]);
+        return *this;
+    }
+
+    template<typename T>
+    Quat<T>& Quat<T>::operator+= (const Quat& quat)
+    {
+        mArray[0] += quat[0];
+        mArray[1] += quat[1];
+        mArray[2] += quat[2];
+        mArray[3] += quat[3];
+        return *this;
+    }
+
+    template<typename T>
+    Quat<T>& Quat<T>::operator-= (const Quat& quat)
+    {
+        mArray[0] -= quat[0];
+        mArray[1] -= quat[1];
+        mArray[2] -= quat[2];
+        mArray[3] -= quat[3];
+        return *this;
+    }
+
+    template<typename T>
+    Quat<T>& Quat<T>::operator*= (const Quat& quat)
+    {
+        *this = *this * quat;
+        return *this;
+    }
+
+    template<typename T>
+    template<typename U>
+    Quat<T>& Quat<T>::operator*= (const U& scalar)
+    {
+        mArray[0] *= static_cast<T>(scalar);
+        mArray[1] *= static_cast<T>(scalar);
+        mArray[2] *= static_cast<T>(scalar);
+        mArray[3] *= static_cast<T>(scalar);
+        return *this;
+    }
+
+    template<typename T>
+    template<typename U>
+    Quat<T>& Quat<T>::operator/= (const U& scalar)
+    {
+        mArray[0] /= static_cast<T>(scalar);
+        mArray[1] /= static_cast<T>(scalar);
+        mArray[2] /= static_cast<T>(scalar);
+        mArray[3] /= static_cast<T>(scalar);
+        return *this;
+    }
+
+    template<typename T>
+    Quat<T> operator+ (const Quat<T>& quat1, const Quat<T>& quat2)
+    {
+        return Quat<T>(quat1[0] + quat2[0], quat1[1] + quat2[1], quat1[2] + quat2[2], quat1[3] + quat2[3]);
+    }
+
+    template<typename T>
+    Quat<T> operator- (const Quat<T>& quat1, const Quat<T>& quat2)
+    {
+        return Quat<T>(quat1[0] - quat2[0], quat1[1] - quat2[1], quat1[2] - quat2[2], quat1[3] - quat2[3]);
+    }
+
+    template<typename T>
+    Quat<T> operator* (const Quat<T>& quat1, const Quat<T>& quat2)
+    {
+        return Quat<T>(quat1.w * quat2.x + quat1.x * quat2.w + quat1.y * quat2.z - quat1.z * quat2.y,
+                       quat1.w * quat2.y - quat1.x * quat2.z + quat1.y * quat2.w + quat1.z * quat2.x,
+                       quat1.w * quat2.z + quat1.x * quat2.y - quat1.y * quat2.x + quat1.z * quat2.w,
+                       quat1.w * quat2.w - quat1.x * quat2.x - quat1.y * quat2.y - quat1.z * quat2.z);
+    }
+
+    template<typename T>
+    Quat<T> operator* (const Quat<T>& quat, const T& scalar)
+    {
+        return Quat<T>(quat[0] * scalar, quat[1] * scalar, quat[2] * scalar, quat[3] * scalar);
+    }
+
+    template<typename T>
+    Quat<T> operator* (const T& scalar, const Quat<T>& quat)
+    {
+        return Quat<T>(scalar * quat[0], scalar * quat[1], scalar * quat[2], scalar * quat[3]);
+    }
+
+    template<typename T>
+    Quat<T> operator/ (const Quat<T>& quat, const T& scalar)
+    {
+        return Quat<T>(quat[0] / scalar, quat[1] / scalar, quat[2] / scalar, quat[3] / scalar);
+    }
+
+    template<typename T>
+    bool operator== (const Quat<T>& quat1, const Quat<T>& quat2)
+    {
+        return quat1.mArray == quat2.mArray;
+    }
+
+    template<typename T>
+    bool operator!= (const Quat<T>& quat1, const Quat<T>& quat2)
+    {
+        return quat1.mArray != quat2.mArray;
+    }
+
+    template<typename T>
+    Quat<T> operator- (const Quat<T>& quat)
+    {
+        return Quat<T>(-quat[0], -quat[1], -quat[2], -quat[3]);
+    }
+
+}
\ No newline at end of file
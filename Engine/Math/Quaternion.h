@@ -0,0 +1,334 @@
+#pragma once
+
+#include "Vector.h"
+#include "Matrix.h"
+#include "SIMD.h"
+
+#include "Utility.h"
+
+namespace Engine
+{
+    template<typename T>
+    class Quat;
+
+    class Quaternion
+    {
+    public:
+        template<typename T>
+        static inline T Dot(const Quat<T>& quat1, const Quat<T>& quat2)
+        {
+            return quat1.x * quat2.x + quat1.y * quat2.y + quat1.z * quat2.z + quat1.w * quat2.w;
+        }
+
+        template<typename T>
+        static inline T Length(const Quat<T>& quat)
+        {
+            return sqrt(Dot(quat, quat));
+        }
+
+        template<typename T>
+        static inline Quat<T> Normalize(const Quat<T>& quat)
+        {
+            auto length = Length(quat);
+            if (length <= T(0))
+                return Quat<T>();
+            return quat / length;
+        }
+
+        template<typename T>
+        static inline Quat<T> Conjugate(const Quat<T>& quat)
+        {
+            return Quat<T>(-quat.x, -quat.y, -quat.z, quat.w);
+        }
+
+        template<typename T>
+        static inline Quat<T> Inverse(const Quat<T>& quat)
+        {
+            return Conjugate(quat) / Dot(quat, quat);
+        }
+
+        template<typename T>
+        static inline Vec3<T> Rotate(const Quat<T>& quat, const Vec3<T>& vec)
+        {
+            auto u = quat.Imaginary();
+            auto t = Vec::Cross(u, vec) * T(2);
+            return vec + t * quat.w + Vec::Cross(u, t);
+        }
+
+        // Angles are in degrees, matching Mat::EulerRotateLH.
+        template<typename T>
+        static inline Quat<T> FromAxisAngle(const Vec3<T>& axis, T degree)
+        {
+            T s, c;
+            MATH_TYPE_DEGREE_FUN(T, degree / T(2), sin, s)
+            MATH_TYPE_DEGREE_FUN(T, degree / T(2), cos, c)
+
+            auto n = Vec::Normalize(axis) * s;
+            return Quat<T>(n.x, n.y, n.z, c);
+        }
+
+        template<typename T>
+        static inline void ToAxisAngle(const Quat<T>& quat, Vec3<T>& axis, T& degree)
+        {
+            auto q = Normalize(quat);
+            if (q.w < T(0))
+                q = -q;
+
+            auto s = sqrt(std::max(T(0), T(1) - q.w * q.w));
+            degree = static_cast<T>(2.0 * acos(std::min(T(1), q.w)) * 180.0 / PI);
+            if (s < T(1e-6))
+                axis = Vec3<T>(T(1), T(0), T(0));
+            else
+                axis = q.Imaginary() / s;
+        }
+
+        // Same pitch/heading/bank order as Mat::EulerRotateLH: bank first, then pitch, then heading.
+        template<typename T>
+        static inline Quat<T> FromEulerLH(T p, T h, T b)
+        {
+            T sinp, cosp, sinh, cosh, sinb, cosb;
+            MATH_TYPE_DEGREE_FUN(T, p / T(2), sin, sinp)
+            MATH_TYPE_DEGREE_FUN(T, p / T(2), cos, cosp)
+            MATH_TYPE_DEGREE_FUN(T, h / T(2), sin, sinh)
+            MATH_TYPE_DEGREE_FUN(T, h / T(2), cos, cosh)
+            MATH_TYPE_DEGREE_FUN(T, b / T(2), sin, sinb)
+            MATH_TYPE_DEGREE_FUN(T, b / T(2), cos, cosb)
+
+            return Quat<T>(cosh*sinp*cosb + sinh*cosp*sinb,
+                           sinh*cosp*cosb - cosh*sinp*sinb,
+                           cosh*cosp*sinb - sinh*sinp*cosb,
+                           cosh*cosp*cosb + sinh*sinp*sinb);
+        }
+
+        template<typename T>
+        static inline Vec3<T> ToEulerLH(const Quat<T>& quat)
+        {
+            const T toDegree = static_cast<T>(180.0 / PI);
+            auto q = Normalize(quat);
+
+            T p, h, b;
+            T sinp = T(-2) * (q.y * q.z - q.w * q.x);
+            if (std::abs(sinp) > T(0.9999))
+            {
+                p = static_cast<T>(PI / 2.0) * sinp;
+                h = atan2(-q.x * q.z + q.w * q.y, T(0.5) - q.y * q.y - q.z * q.z);
+                b = T(0);
+            }
+            else
+            {
+                p = asin(sinp);
+                h = atan2(q.x * q.z + q.w * q.y, T(0.5) - q.x * q.x - q.y * q.y);
+                b = atan2(q.x * q.y + q.w * q.z, T(0.5) - q.x * q.x - q.z * q.z);
+            }
+            return Vec3<T>(p * toDegree, h * toDegree, b * toDegree);
+        }
+
+        template<typename T>
+        static inline Mat3x3<T> ToMatrix3x3(const Quat<T>& quat)
+        {
+            return Mat::QuatRotateLH(quat.x, quat.y, quat.z, quat.w);
+        }
+
+        template<typename T>
+        static inline Mat4x4<T> ToMatrix4x4(const Quat<T>& quat)
+        {
+            auto m = ToMatrix3x3(quat);
+            return Mat4x4<T>(m.x00, m.x01, m.x02, 0,
+                             m.x10, m.x11, m.x12, 0,
+                             m.x20, m.x21, m.x22, 0,
+                             0,     0,     0,     1);
+        }
+
+        // Expects a pure rotation in the row-vector layout produced by ToMatrix3x3.
+        template<typename T>
+        static inline Quat<T> FromMatrix3x3(const Mat3x3<T>& m)
+        {
+            T trace = m.x00 + m.x11 + m.x22;
+            if (trace > T(0))
+            {
+                T s = sqrt(trace + T(1)) * T(2);
+                return Quat<T>((m.x12 - m.x21) / s, (m.x20 - m.x02) / s, (m.x01 - m.x10) / s, s / T(4));
+            }
+            else if (m.x00 > m.x11 && m.x00 > m.x22)
+            {
+                T s = sqrt(T(1) + m.x00 - m.x11 - m.x22) * T(2);
+                return Quat<T>(s / T(4), (m.x01 + m.x10) / s, (m.x02 + m.x20) / s, (m.x12 - m.x21) / s);
+            }
+            else if (m.x11 > m.x22)
+            {
+                T s = sqrt(T(1) + m.x11 - m.x00 - m.x22) * T(2);
+                return Quat<T>((m.x01 + m.x10) / s, s / T(4), (m.x12 + m.x21) / s, (m.x20 - m.x02) / s);
+            }
+            else
+            {
+                T s = sqrt(T(1) + m.x22 - m.x00 - m.x11) * T(2);
+                return Quat<T>((m.x02 + m.x20) / s, (m.x12 + m.x21) / s, s / T(4), (m.x01 - m.x10) / s);
+            }
+        }
+
+        template<typename T>
+        static inline Quat<T> Nlerp(const Quat<T>& from, const Quat<T>& to, T t)
+        {
+            auto target = Dot(from, to) < T(0) ? -to : to;
+            return Normalize(from + (target - from) * t);
+        }
+
+        template<typename T>
+        static inline Quat<T> Slerp(const Quat<T>& from, const Quat<T>& to, T t)
+        {
+            auto target = to;
+            auto cosTheta = Dot(from, to);
+            if (cosTheta < T(0))
+            {
+                cosTheta = -cosTheta;
+                target = -to;
+            }
+
+            if (cosTheta > T(0.9995))
+                return Normalize(from + (target - from) * t);
+
+            auto theta = acos(cosTheta);
+            auto sinTheta = sin(theta);
+            auto s0 = sin((T(1) - t) * theta) / sinTheta;
+            auto s1 = sin(t * theta) / sinTheta;
+            return from * s0 + target * s1;
+        }
+
+        // Interpolate count quaternion pairs, four per iteration when SSE is available.
+        static inline void NlerpBatch(const Quat<float>* pFrom, const Quat<float>* pTo, const float* pT, Quat<float>* pOut, uint32_t count);
+        static inline void SlerpBatch(const Quat<float>* pFrom, const Quat<float>* pTo, const float* pT, Quat<float>* pOut, uint32_t count);
+
+    protected:
+        Quaternion() = default;
+    };
+}
+
+#include "Quat.h"
+
+namespace Engine
+{
+    typedef Quat<float> quatf;
+    typedef Quat<double> quatd;
+
+    static_assert(sizeof(quatf) == sizeof(float) * 4, "quatf must be tightly packed for the batch kernels");
+
+    inline void Quaternion::NlerpBatch(const Quat<float>* pFrom, const Quat<float>* pTo, const float* pT, Quat<float>* pOut, uint32_t count)
+    {
+        uint32_t i = 0;
+#if defined(MATH_SIMD_SSE)
+        const __m128 signMask = _mm_set1_ps(-0.0f);
+        for (; i + 4 <= count; i += 4)
+        {
+            __m128 ax = _mm_loadu_ps(pFrom[i + 0].mData);
+            __m128 ay = _mm_loadu_ps(pFrom[i + 1].mData);
+            __m128 az = _mm_loadu_ps(pFrom[i + 2].mData);
+            __m128 aw = _mm_loadu_ps(pFrom[i + 3].mData);
+            _MM_TRANSPOSE4_PS(ax, ay, az, aw);
+
+            __m128 bx = _mm_loadu_ps(pTo[i + 0].mData);
+            __m128 by = _mm_loadu_ps(pTo[i + 1].mData);
+            __m128 bz = _mm_loadu_ps(pTo[i + 2].mData);
+            __m128 bw = _mm_loadu_ps(pTo[i + 3].mData);
+            _MM_TRANSPOSE4_PS(bx, by, bz, bw);
+
+            __m128 dot = _mm_add_ps(_mm_add_ps(_mm_mul_ps(ax, bx), _mm_mul_ps(ay, by)), _mm_add_ps(_mm_mul_ps(az, bz), _mm_mul_ps(aw, bw)));
+            __m128 sign = _mm_and_ps(dot, signMask);
+            bx = _mm_xor_ps(bx, sign);
+            by = _mm_xor_ps(by, sign);
+            bz = _mm_xor_ps(bz, sign);
+            bw = _mm_xor_ps(bw, sign);
+
+            __m128 t = _mm_loadu_ps(pT + i);
+            __m128 rx = _mm_add_ps(ax, _mm_mul_ps(_mm_sub_ps(bx, ax), t));
+            __m128 ry = _mm_add_ps(ay, _mm_mul_ps(_mm_sub_ps(by, ay), t));
+            __m128 rz = _mm_add_ps(az, _mm_mul_ps(_mm_sub_ps(bz, az), t));
+            __m128 rw = _mm_add_ps(aw, _mm_mul_ps(_mm_sub_ps(bw, aw), t));
+
+            __m128 len2 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(rx, rx), _mm_mul_ps(ry, ry)), _mm_add_ps(_mm_mul_ps(rz, rz), _mm_mul_ps(rw, rw)));
+            __m128 inv = SIMDRsqrt(len2);
+            rx = _mm_mul_ps(rx, inv);
+            ry = _mm_mul_ps(ry, inv);
+            rz = _mm_mul_ps(rz, inv);
+            rw = _mm_mul_ps(rw, inv);
+
+            _MM_TRANSPOSE4_PS(rx, ry, rz, rw);
+            _mm_storeu_ps(pOut[i + 0].mData, rx);
+            _mm_storeu_ps(pOut[i + 1].mData, ry);
+            _mm_storeu_ps(pOut[i + 2].mData, rz);
+            _mm_storeu_ps(pOut[i + 3].mData, rw);
+        }
+#endif
+        for (; i < count; ++i)
+            pOut[i] = Nlerp(pFrom[i], pTo[i], pT[i]);
+    }
+
+    inline void Quaternion::SlerpBatch(const Quat<float>* pFrom, const Quat<float>* pTo, const float* pT, Quat<float>* pOut, uint32_t count)
+    {
+        uint32_t i = 0;
+#if defined(MATH_SIMD_SSE)
+        // D. Eberly, "A Fast and Accurate Algorithm for Computing SLERP": the slerp weights are
+        // evaluated as a polynomial in (cos - 1), so the kernel needs neither acos nor sin.
+        // The weights stay within 2e-5 of the exact ones over the whole shortest-arc range.
+        const float mu = 1.85298109240830f;
+        const float u[8] = { 1.f / (1 * 3), 1.f / (2 * 5), 1.f / (3 * 7), 1.f / (4 * 9), 1.f / (5 * 11), 1.f / (6 * 13), 1.f / (7 * 15), mu / (8 * 17) };
+        const float v[8] = { 1.f / 3, 2.f / 5, 3.f / 7, 4.f / 9, 5.f / 11, 6.f / 13, 7.f / 15, mu * 8 / 17 };
+
+        const __m128 one = _mm_set1_ps(1.0f);
+        const __m128 signMask = _mm_set1_ps(-0.0f);
+        for (; i + 4 <= count; i += 4)
+        {
+            __m128 ax = _mm_loadu_ps(pFrom[i + 0].mData);
+            __m128 ay = _mm_loadu_ps(pFrom[i + 1].mData);
+            __m128 az = _mm_loadu_ps(pFrom[i + 2].mData);
+            __m128 aw = _mm_loadu_ps(pFrom[i + 3].mData);
+            _MM_TRANSPOSE4_PS(ax, ay, az, aw);
+
+            __m128 bx = _mm_loadu_ps(pTo[i + 0].mData);
+            __m128 by = _mm_loadu_ps(pTo[i + 1].mData);
+            __m128 bz = _mm_loadu_ps(pTo[i + 2].mData);
+            __m128 bw = _mm_loadu_ps(pTo[i + 3].mData);
+            _MM_TRANSPOSE4_PS(bx, by, bz, bw);
+
+            __m128 dot = _mm_add_ps(_mm_add_ps(_mm_mul_ps(ax, bx), _mm_mul_ps(ay, by)), _mm_add_ps(_mm_mul_ps(az, bz), _mm_mul_ps(aw, bw)));
+            __m128 sign = _mm_and_ps(dot, signMask);
+            bx = _mm_xor_ps(bx, sign);
+            by = _mm_xor_ps(by, sign);
+            bz = _mm_xor_ps(bz, sign);
+            bw = _mm_xor_ps(bw, sign);
+
+            __m128 xm1 = _mm_sub_ps(SIMDAbs(dot), one);
+            __m128 t = _mm_loadu_ps(pT + i);
+            __m128 d = _mm_sub_ps(one, t);
+            __m128 sqrT = _mm_mul_ps(t, t);
+            __m128 sqrD = _mm_mul_ps(d, d);
+
+            __m128 fT = one;
+            __m128 fD = one;
+            for (int k = 7; k >= 0; --k)
+            {
+                __m128 uk = _mm_set1_ps(u[k]);
+                __m128 vk = _mm_set1_ps(v[k]);
+                __m128 bT = _mm_mul_ps(_mm_sub_ps(_mm_mul_ps(uk, sqrT), vk), xm1);
+                __m128 bD = _mm_mul_ps(_mm_sub_ps(_mm_mul_ps(uk, sqrD), vk), xm1);
+                fT = _mm_add_ps(one, _mm_mul_ps(bT, fT));
+                fD = _mm_add_ps(one, _mm_mul_ps(bD, fD));
+            }
+            __m128 cT = _mm_mul_ps(t, fT);
+            __m128 cD = _mm_mul_ps(d, fD);
+
+            __m128 rx = _mm_add_ps(_mm_mul_ps(ax, cD), _mm_mul_ps(bx, cT));
+            __m128 ry = _mm_add_ps(_mm_mul_ps(ay, cD), _mm_mul_ps(by, cT));
+            __m128 rz = _mm_add_ps(_mm_mul_ps(az, cD), _mm_mul_ps(bz, cT));
+            __m128 rw = _mm_add_ps(_mm_mul_ps(aw, cD), _mm_mul_ps(bw, cT));
+
+            _MM_TRANSPOSE4_PS(rx, ry, rz, rw);
+            _mm_storeu_ps(pOut[i + 0].mData, rx);
+            _mm_storeu_ps(pOut[i + 1].mData, ry);
+            _mm_storeu_ps(pOut[i + 2].mData, rz);
+            _mm_storeu_ps(pOut[i + 3].mData, rw);
+        }
+#endif
+        for (; i < count; ++i)
+            pOut[i] = Slerp(pFrom[i], pTo[i], pT[i]);
+    }
+}
\ No newline at end of file
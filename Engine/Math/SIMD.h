@@ -0,0 +1,45 @@
+#pragma once
+
+#if defined(_M_X64) || defined(_M_AMD64) || defined(__SSE2__)
+    #define MATH_SIMD_SSE 1
+    #include <emmintrin.h>
+#endif
+
+#if defined(__AVX__)
+    #define MATH_SIMD_AVX 1
+    #include <immintrin.h>
+#endif
+
+#if defined(__AVX2__)
+    #define MATH_SIMD_AVX2 1
+#endif
+
+// MSVC has no switch for F16C, every AVX2 part supports it.
+#if defined(__F16C__) || (defined(_MSC_VER) && defined(__AVX2__))
+    #define MATH_SIMD_F16C 1
+#endif
+
+namespace Engine
+{
+    #define MATH_SIMD_ALIGN(bytes) alignas(bytes)
+
+#if defined(MATH_SIMD_SSE)
+    inline __m128 SIMDAbs(__m128 v)
+    {
+        return _mm_andnot_ps(_mm_set1_ps(-0.0f), v);
+    }
+
+    inline __m128 SIMDSelect(__m128 mask, __m128 a, __m128 b)
+    {
+        return _mm_or_ps(_mm_and_ps(mask, b), _mm_andnot_ps(mask, a));
+    }
+
+    inline __m128 SIMDRsqrt(__m128 v)
+    {
+        // One Newton-Raphson step on top of the 12 bit estimate.
+        __m128 r = _mm_rsqrt_ps(v);
+        __m128 half = _mm_mul_ps(_mm_set1_ps(0.5f), v);
+        return _mm_mul_ps(r, _mm_sub_ps(_mm_set1_ps(1.5f), _mm_mul_ps(half, _mm_mul_ps(r, r))));
+    }
+#endif
+}
\ No newline at end of file
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <algorithm>
+
+#include "Vector.h"
+#include "Box3.h"
+
+namespace Engine
+{
+    class Sphere
+    {
+    public:
+        Vec3<float> mCenter;
+        float mRadius;
+
+        Sphere() : mCenter(0.0f, 0.0f, 0.0f), mRadius(-1.0f)
+        {
+        }
+
+        Sphere(const Vec3<float>& center, float radius) : mCenter(center), mRadius(radius)
+        {
+        }
+
+        explicit Sphere(const Box3& box) : mCenter(box.Center()), mRadius(box.IsEmpty() ? -1.0f : box.Radius())
+        {
+        }
+
+        bool IsEmpty() const
+        {
+            return mRadius < 0.0f;
+        }
+
+        void Expand(const Vec3<float>& point)
+        {
+            if (IsEmpty())
+            {
+                mCenter = point;
+                mRadius = 0.0f;
+                return;
+            }
+
+            auto distance = Vec::Length(point - mCenter);
+            if (distance <= mRadius)
+                return;
+
+            // Grow just enough to keep the old sphere and reach the new point.
+            auto radius = (mRadius + distance) * 0.5f;
+            mCenter = mCenter + (point - mCenter) * ((radius - mRadius) / distance);
+            mRadius = radius;
+        }
+
+        bool Contains(const Vec3<float>& point) const
+        {
+            return Vec::LengthSquared(point - mCenter) <= mRadius * mRadius;
+        }
+
+        bool Intersect(const Sphere& sphere) const
+        {
+            auto radius = mRadius + sphere.mRadius;
+            return Vec::LengthSquared(sphere.mCenter - mCenter) <= radius * radius;
+        }
+
+        bool Intersect(const Box3& box) const
+        {
+            Vec3<float> closest(std::max(box.mMin.x, std::min(mCenter.x, box.mMax.x)),
+                                std::max(box.mMin.y, std::min(mCenter.y, box.mMax.y)),
+                                std::max(box.mMin.z, std::min(mCenter.z, box.mMax.z)));
+            return Contains(closest);
+        }
+    };
+}
\ No newline at end of file
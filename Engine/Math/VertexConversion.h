@@ -0,0 +1,191 @@
+#pragma once
+
+#include <stdint.h>
+#include <string.h>
+#include <algorithm>
+
+#include "SIMD.h"
+
+namespace Engine
+{
+    // Strided source streams of any component encoding, e.g. glTF accessors, converted to the
+    // tightly packed streams meshes are built from.
+    class VertexConversion
+    {
+    public:
+        enum class EComponentType : uint8_t
+        {
+            Int8,
+            UInt8,
+            Int16,
+            UInt16,
+            UInt32,
+            Float32,
+        };
+
+        static inline uint32_t ComponentSize(EComponentType type)
+        {
+            switch (type)
+            {
+            case EComponentType::Int8:
+            case EComponentType::UInt8:
+                return 1;
+            case EComponentType::Int16:
+            case EComponentType::UInt16:
+                return 2;
+            default:
+                return 4;
+            }
+        }
+
+        // Normalized integers map to [0, 1] or [-1, 1] with the glTF rules, other integers keep their
+        // value. Components the source does not have are taken from fill, e.g. alpha 1 for RGB colors.
+        static inline void ToFloat(const void* pSrc, uint32_t stride, EComponentType type, bool normalized, uint32_t srcComponents,
+                                   uint32_t count, float* pDst, uint32_t dstComponents, const float fill[4])
+        {
+            if (count == 0)
+                return;
+
+            const char* pBytes = static_cast<const char*>(pSrc);
+            uint32_t componentSize = ComponentSize(type);
+            uint32_t i = 0;
+
+#if defined(MATH_SIMD_SSE)
+            // Every element is one 16 byte load and one 4 lane store. The load must stay inside the
+            // last element and the store may only spill into slots that are written afterwards.
+            uint64_t srcEnd = (uint64_t)(count - 1) * stride + (uint64_t)srcComponents * componentSize;
+            uint64_t dstEnd = (uint64_t)count * dstComponents;
+            if (stride != 0 && srcEnd >= 16 && dstEnd >= 4 && dstComponents <= 4)
+            {
+                uint32_t loadCount = (uint32_t)std::min<uint64_t>((srcEnd - 16) / stride + 1, count);
+                uint32_t storeCount = (uint32_t)std::min<uint64_t>((dstEnd - 4) / dstComponents + 1, count);
+                uint32_t simdCount = std::min(loadCount, storeCount);
+
+                __m128 fillValue = _mm_loadu_ps(fill);
+                __m128 mask = _mm_castsi128_ps(_mm_cmplt_epi32(_mm_setr_epi32(0, 1, 2, 3), _mm_set1_epi32((int)srcComponents)));
+
+                for (; i < simdCount; i++)
+                {
+                    __m128 value = LoadElementSSE(pBytes + (size_t)i * stride, type, normalized);
+                    _mm_storeu_ps(pDst + (size_t)i * dstComponents, SIMDSelect(mask, fillValue, value));
+                }
+            }
+#endif
+
+            for (; i < count; i++)
+            {
+                const char* pElement = pBytes + (size_t)i * stride;
+                float* pOut = pDst + (size_t)i * dstComponents;
+                for (uint32_t c = 0; c < dstComponents; c++)
+                    pOut[c] = c < srcComponents ? LoadComponent(pElement + c * componentSize, type, normalized) : fill[c];
+            }
+        }
+
+        // Integer streams such as joint indices, narrowed to 16 bit. Missing components are 0.
+        static inline void ToUInt16(const void* pSrc, uint32_t stride, EComponentType type, uint32_t srcComponents,
+                                    uint32_t count, uint16_t* pDst, uint32_t dstComponents)
+        {
+            const char* pBytes = static_cast<const char*>(pSrc);
+            uint32_t componentSize = ComponentSize(type);
+
+            for (uint32_t i = 0; i < count; i++)
+            {
+                const char* pElement = pBytes + (size_t)i * stride;
+                uint16_t* pOut = pDst + (size_t)i * dstComponents;
+                for (uint32_t c = 0; c < dstComponents; c++)
+                    pOut[c] = c < srcComponents ? (uint16_t)LoadInteger(pElement + c * componentSize, type) : 0;
+            }
+        }
+
+    private:
+        template<typename T>
+        static inline T Load(const char* p)
+        {
+            T value;
+            memcpy(&value, p, sizeof(T));
+            return value;
+        }
+
+        static inline float LoadComponent(const char* p, EComponentType type, bool normalized)
+        {
+            switch (type)
+            {
+            case EComponentType::Int8:
+                return normalized ? std::max(Load<int8_t>(p) * (1.0f / 127.0f), -1.0f) : (float)Load<int8_t>(p);
+            case EComponentType::UInt8:
+                return normalized ? Load<uint8_t>(p) * (1.0f / 255.0f) : (float)Load<uint8_t>(p);
+            case EComponentType::Int16:
+                return normalized ? std::max(Load<int16_t>(p) * (1.0f / 32767.0f), -1.0f) : (float)Load<int16_t>(p);
+            case EComponentType::UInt16:
+                return normalized ? Load<uint16_t>(p) * (1.0f / 65535.0f) : (float)Load<uint16_t>(p);
+            case EComponentType::UInt32:
+                return (float)Load<uint32_t>(p);
+            default:
+                return Load<float>(p);
+            }
+        }
+
+        static inline uint32_t LoadInteger(const char* p, EComponentType type)
+        {
+            switch (type)
+            {
+            case EComponentType::Int8:
+                return (uint32_t)std::max<int8_t>(Load<int8_t>(p), 0);
+            case EComponentType::UInt8:
+                return Load<uint8_t>(p);
+            case EComponentType::Int16:
+                return (uint32_t)std::max<int16_t>(Load<int16_t>(p), 0);
+            case EComponentType::UInt16:
+                return Load<uint16_t>(p);
+            case EComponentType::UInt32:
+                return Load<uint32_t>(p);
+            default:
+                return (uint32_t)std::max(Load<float>(p) + 0.5f, 0.0f);
+            }
+        }
+
+#if defined(MATH_SIMD_SSE)
+        // Four components from a 16 byte load, the lanes past the element hold whatever follows it.
+        static inline __m128 LoadElementSSE(const char* p, EComponentType type, bool normalized)
+        {
+            __m128i raw = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+            __m128i zero = _mm_setzero_si128();
+
+            switch (type)
+            {
+            case EComponentType::Int8:
+            {
+                // Move each byte to the top of its lane and shift it back down with sign extension.
+                __m128i bytes = _mm_unpacklo_epi8(raw, raw);
+                __m128 value = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(bytes, bytes), 24));
+                return normalized ? _mm_max_ps(_mm_mul_ps(value, _mm_set1_ps(1.0f / 127.0f)), _mm_set1_ps(-1.0f)) : value;
+            }
+            case EComponentType::UInt8:
+            {
+                __m128 value = _mm_cvtepi32_ps(_mm_unpacklo_epi16(_mm_unpacklo_epi8(raw, zero), zero));
+                return normalized ? _mm_mul_ps(value, _mm_set1_ps(1.0f / 255.0f)) : value;
+            }
+            case EComponentType::Int16:
+            {
+                __m128 value = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(raw, raw), 16));
+                return normalized ? _mm_max_ps(_mm_mul_ps(value, _mm_set1_ps(1.0f / 32767.0f)), _mm_set1_ps(-1.0f)) : value;
+            }
+            case EComponentType::UInt16:
+            {
+                __m128 value = _mm_cvtepi32_ps(_mm_unpacklo_epi16(raw, zero));
+                return normalized ? _mm_mul_ps(value, _mm_set1_ps(1.0f / 65535.0f)) : value;
+            }
+            case EComponentType::UInt32:
+            {
+                // There is no unsigned conversion before AVX-512, so convert the 16 bit halves separately.
+                __m128 high = _mm_cvtepi32_ps(_mm_srli_epi32(raw, 16));
+                __m128 low = _mm_cvtepi32_ps(_mm_and_si128(raw, _mm_set1_epi32(0xffff)));
+                return _mm_add_ps(_mm_mul_ps(high, _mm_set1_ps(65536.0f)), low);
+            }
+            default:
+                return _mm_castsi128_ps(raw);
+            }
+        }
+#endif
+    };
+}
\ No newline at end of file
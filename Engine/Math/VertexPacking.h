@@ -0,0 +1,383 @@
+#pragma once
+
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+#include <algorithm>
+
+#include "Vector.h"
+#include "Box3.h"
+#include "SIMD.h"
+
+namespace Engine
+{
+    // UNORM16 position relative to the mesh bounds. w carries the tangent handedness, 0 for -1 and 65535 for +1.
+    struct PackedPosition
+    {
+        uint16_t x, y, z, w;
+    };
+
+    // SNORM16 octahedral unit vector, used for normals and tangents.
+    struct PackedNormal
+    {
+        int16_t x, y;
+    };
+
+    // IEEE half floats.
+    struct PackedTexcoord
+    {
+        uint16_t u, v;
+    };
+
+    class VertexPacking
+    {
+    public:
+        static inline uint16_t FloatToHalf(float value)
+        {
+            uint32_t bits;
+            memcpy(&bits, &value, sizeof(bits));
+
+            uint32_t sign = (bits >> 16) & 0x8000;
+            uint32_t abs = bits & 0x7fffffff;
+
+            uint16_t half;
+            if (abs >= 0x47800000)
+            {
+                // Overflow goes to infinity, NaN keeps a quiet payload.
+                half = abs > 0x7f800000 ? 0x7e00 : 0x7c00;
+            }
+            else if (abs < 0x38800000)
+            {
+                // Subnormal, let the float adder round the mantissa.
+                float f;
+                memcpy(&f, &abs, sizeof(f));
+                f += 0.5f;
+                uint32_t rounded;
+                memcpy(&rounded, &f, sizeof(rounded));
+                half = (uint16_t)(rounded - 0x3f000000);
+            }
+            else
+            {
+                // Rebias the exponent and round to nearest even.
+                uint32_t odd = (abs >> 13) & 1;
+                half = (uint16_t)((abs + 0xc8000fff + odd) >> 13);
+            }
+
+            return (uint16_t)(half | sign);
+        }
+
+        static inline float HalfToFloat(uint16_t half)
+        {
+            const float magic = 5.192297e+33f; // 2^112, moves the half exponent bias to the float one.
+
+            uint32_t expmant = (uint32_t)(half & 0x7fff) << 13;
+            float f;
+            memcpy(&f, &expmant, sizeof(f));
+            f *= magic;
+
+            uint32_t bits;
+            memcpy(&bits, &f, sizeof(bits));
+            if ((half & 0x7fff) >= 0x7c00)
+                bits |= 0x7f800000;
+            bits |= (uint32_t)(half & 0x8000) << 16;
+
+            memcpy(&f, &bits, sizeof(f));
+            return f;
+        }
+
+        // Cigolle et al. "A Survey of Efficient Representations for Independent Unit Vectors".
+        static inline PackedNormal EncodeOctahedral(const float3& n)
+        {
+            float l1 = std::abs(n.x) + std::abs(n.y) + std::abs(n.z);
+            float x = l1 > 0.0f ? n.x / l1 : 0.0f;
+            float y = l1 > 0.0f ? n.y / l1 : 0.0f;
+
+            if (n.z < 0.0f)
+            {
+                float fx = (1.0f - std::abs(y)) * (x >= 0.0f ? 1.0f : -1.0f);
+                float fy = (1.0f - std::abs(x)) * (y >= 0.0f ? 1.0f : -1.0f);
+                x = fx;
+                y = fy;
+            }
+
+            PackedNormal packed;
+            packed.x = (int16_t)lrintf(std::min(std::max(x, -1.0f), 1.0f) * 32767.0f);
+            packed.y = (int16_t)lrintf(std::min(std::max(y, -1.0f), 1.0f) * 32767.0f);
+            return packed;
+        }
+
+        static inline float3 DecodeOctahedral(const PackedNormal& packed)
+        {
+            float x = std::max(packed.x / 32767.0f, -1.0f);
+            float y = std::max(packed.y / 32767.0f, -1.0f);
+            float z = 1.0f - std::abs(x) - std::abs(y);
+
+            float t = std::max(-z, 0.0f);
+            x += x >= 0.0f ? -t : t;
+            y += y >= 0.0f ? -t : t;
+
+            return Vec::Normalize(float3(x, y, z));
+        }
+
+        static inline void PackPositions(const float3 src[], uint32_t count, const Box3& bounds, PackedPosition dst[])
+        {
+            float3 scale = PositionScale(bounds, 65535.0f);
+            uint32_t i = 0;
+
+#if defined(MATH_SIMD_SSE)
+            __m128 vMin = _mm_setr_ps(bounds.mMin.x, bounds.mMin.y, bounds.mMin.z, 0.0f);
+            __m128 vScale = _mm_setr_ps(scale.x, scale.y, scale.z, 0.0f);
+            __m128 vW = _mm_setr_ps(0.0f, 0.0f, 0.0f, 65535.0f);
+            __m128 vMax = _mm_set1_ps(65535.0f);
+            __m128i vBias = _mm_set1_epi32(32768);
+            __m128i vFlip = _mm_set1_epi16((short)0x8000);
+
+            auto quantize = [&](const float3& p) {
+                __m128 v = _mm_setr_ps(p.x, p.y, p.z, 0.0f);
+                v = _mm_add_ps(_mm_mul_ps(_mm_sub_ps(v, vMin), vScale), vW);
+                v = _mm_min_ps(_mm_max_ps(v, _mm_setzero_ps()), vMax);
+                // SSE2 only has a signed pack, shift into its range and flip the top bit back.
+                return _mm_sub_epi32(_mm_cvtps_epi32(v), vBias);
+            };
+
+            for (; i + 2 <= count; i += 2)
+            {
+                __m128i packed = _mm_packs_epi32(quantize(src[i]), quantize(src[i + 1]));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_xor_si128(packed, vFlip));
+            }
+#endif
+
+            for (; i < count; i++)
+            {
+                auto q = (src[i] - bounds.mMin) * scale;
+                dst[i].x = (uint16_t)lrintf(std::min(std::max(q.x, 0.0f), 65535.0f));
+                dst[i].y = (uint16_t)lrintf(std::min(std::max(q.y, 0.0f), 65535.0f));
+                dst[i].z = (uint16_t)lrintf(std::min(std::max(q.z, 0.0f), 65535.0f));
+                dst[i].w = 65535;
+            }
+        }
+
+        static inline void UnpackPositions(const PackedPosition src[], uint32_t count, const Box3& bounds, float3 dst[])
+        {
+            float3 scale = bounds.Size() / 65535.0f;
+            uint32_t i = 0;
+
+#if defined(MATH_SIMD_SSE)
+            __m128 vMin = _mm_setr_ps(bounds.mMin.x, bounds.mMin.y, bounds.mMin.z, 0.0f);
+            __m128 vScale = _mm_setr_ps(scale.x, scale.y, scale.z, 0.0f);
+
+            // The 4 wide store spills into the next vertex, so the last one goes through the scalar path.
+            for (; i + 1 < count; i++)
+            {
+                __m128i packed = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(src + i));
+                __m128 v = _mm_cvtepi32_ps(_mm_unpacklo_epi16(packed, _mm_setzero_si128()));
+                _mm_storeu_ps(&dst[i].x, _mm_add_ps(_mm_mul_ps(v, vScale), vMin));
+            }
+#endif
+
+            for (; i < count; i++)
+                dst[i] = bounds.mMin + float3(src[i].x, src[i].y, src[i].z) * scale;
+        }
+
+        static inline void PackNormals(const float3 src[], uint32_t count, PackedNormal dst[])
+        {
+            uint32_t i = 0;
+
+#if defined(MATH_SIMD_SSE)
+            const __m128 vOne = _mm_set1_ps(1.0f);
+            const __m128 vSign = _mm_set1_ps(-0.0f);
+
+            for (; i + 4 <= count; i += 4)
+            {
+                __m128 x = _mm_setr_ps(src[i].x, src[i + 1].x, src[i + 2].x, src[i + 3].x);
+                __m128 y = _mm_setr_ps(src[i].y, src[i + 1].y, src[i + 2].y, src[i + 3].y);
+                __m128 z = _mm_setr_ps(src[i].z, src[i + 1].z, src[i + 2].z, src[i + 3].z);
+
+                __m128 l1 = _mm_add_ps(_mm_add_ps(SIMDAbs(x), SIMDAbs(y)), SIMDAbs(z));
+                __m128 valid = _mm_cmpgt_ps(l1, _mm_setzero_ps());
+                __m128 inv = _mm_and_ps(_mm_div_ps(vOne, l1), valid);
+                x = _mm_mul_ps(x, inv);
+                y = _mm_mul_ps(y, inv);
+
+                // Fold the lower hemisphere over the diagonals, keeping the sign of each component.
+                __m128 foldX = _mm_or_ps(_mm_sub_ps(vOne, SIMDAbs(y)), _mm_and_ps(x, vSign));
+                __m128 foldY = _mm_or_ps(_mm_sub_ps(vOne, SIMDAbs(x)), _mm_and_ps(y, vSign));
+                __m128 lower = _mm_cmplt_ps(z, _mm_setzero_ps());
+                x = SIMDSelect(lower, x, foldX);
+                y = SIMDSelect(lower, y, foldY);
+
+                __m128i ix = _mm_cvtps_epi32(_mm_mul_ps(x, _mm_set1_ps(32767.0f)));
+                __m128i iy = _mm_cvtps_epi32(_mm_mul_ps(y, _mm_set1_ps(32767.0f)));
+                __m128i packed = _mm_packs_epi32(ix, iy);
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_unpacklo_epi16(packed, _mm_srli_si128(packed, 8)));
+            }
+#endif
+
+            for (; i < count; i++)
+                dst[i] = EncodeOctahedral(src[i]);
+        }
+
+        static inline void UnpackNormals(const PackedNormal src[], uint32_t count, float3 dst[])
+        {
+            uint32_t i = 0;
+
+#if defined(MATH_SIMD_SSE)
+            const __m128 vSign = _mm_set1_ps(-0.0f);
+            const __m128 vInvScale = _mm_set1_ps(1.0f / 32767.0f);
+
+            for (; i + 4 <= count; i += 4)
+            {
+                __m128i packed = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+                __m128 x = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_slli_epi32(packed, 16), 16));
+                __m128 y = _mm_cvtepi32_ps(_mm_srai_epi32(packed, 16));
+                x = _mm_max_ps(_mm_mul_ps(x, vInvScale), _mm_set1_ps(-1.0f));
+                y = _mm_max_ps(_mm_mul_ps(y, vInvScale), _mm_set1_ps(-1.0f));
+
+                __m128 z = _mm_sub_ps(_mm_sub_ps(_mm_set1_ps(1.0f), SIMDAbs(x)), SIMDAbs(y));
+                __m128 t = _mm_max_ps(_mm_sub_ps(_mm_setzero_ps(), z), _mm_setzero_ps());
+                x = _mm_sub_ps(x, _mm_or_ps(t, _mm_and_ps(x, vSign)));
+                y = _mm_sub_ps(y, _mm_or_ps(t, _mm_and_ps(y, vSign)));
+
+                __m128 inv = SIMDRsqrt(_mm_add_ps(_mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y)), _mm_mul_ps(z, z)));
+
+                MATH_SIMD_ALIGN(16) float fx[4], fy[4], fz[4];
+                _mm_store_ps(fx, _mm_mul_ps(x, inv));
+                _mm_store_ps(fy, _mm_mul_ps(y, inv));
+                _mm_store_ps(fz, _mm_mul_ps(z, inv));
+                for (uint32_t k = 0; k < 4; k++)
+                    dst[i + k] = float3(fx[k], fy[k], fz[k]);
+            }
+#endif
+
+            for (; i < count; i++)
+                dst[i] = DecodeOctahedral(src[i]);
+        }
+
+        // Tangent xyz goes through the octahedral kernel, the handedness in w is written to the packed positions.
+        static inline void PackTangents(const float4 src[], uint32_t count, PackedNormal dst[], PackedPosition positions[])
+        {
+            const uint32_t batch = 256;
+            float3 directions[batch];
+
+            for (uint32_t first = 0; first < count; first += batch)
+            {
+                uint32_t size = std::min(batch, count - first);
+                for (uint32_t i = 0; i < size; i++)
+                {
+                    directions[i] = float3(src[first + i].x, src[first + i].y, src[first + i].z);
+                    positions[first + i].w = src[first + i].w < 0.0f ? 0 : 65535;
+                }
+                PackNormals(directions, size, dst + first);
+            }
+        }
+
+        static inline void UnpackTangents(const PackedNormal src[], const PackedPosition positions[], uint32_t count, float4 dst[])
+        {
+            const uint32_t batch = 256;
+            float3 directions[batch];
+
+            for (uint32_t first = 0; first < count; first += batch)
+            {
+                uint32_t size = std::min(batch, count - first);
+                UnpackNormals(src + first, size, directions);
+                for (uint32_t i = 0; i < size; i++)
+                    dst[first + i] = float4(directions[i].x, directions[i].y, directions[i].z, positions[first + i].w < 32768 ? -1.0f : 1.0f);
+            }
+        }
+
+        static inline void PackTexcoords(const float2 src[], uint32_t count, PackedTexcoord dst[])
+        {
+            const float* pSrc = &src[0].x;
+            uint16_t* pDst = &dst[0].u;
+            uint32_t total = count * 2;
+            uint32_t i = 0;
+
+#if defined(MATH_SIMD_F16C)
+            for (; i + 8 <= total; i += 8)
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(pDst + i), _mm256_cvtps_ph(_mm256_loadu_ps(pSrc + i), _MM_FROUND_TO_NEAREST_INT));
+#elif defined(MATH_SIMD_SSE)
+            for (; i + 4 <= total; i += 4)
+            {
+                __m128i half = FloatToHalfSSE(_mm_loadu_ps(pSrc + i));
+                _mm_storel_epi64(reinterpret_cast<__m128i*>(pDst + i), _mm_packs_epi32(half, half));
+            }
+#endif
+
+            for (; i < total; i++)
+                pDst[i] = FloatToHalf(pSrc[i]);
+        }
+
+        static inline void UnpackTexcoords(const PackedTexcoord src[], uint32_t count, float2 dst[])
+        {
+            const uint16_t* pSrc = &src[0].u;
+            float* pDst = &dst[0].x;
+            uint32_t total = count * 2;
+            uint32_t i = 0;
+
+#if defined(MATH_SIMD_F16C)
+            for (; i + 8 <= total; i += 8)
+                _mm256_storeu_ps(pDst + i, _mm256_cvtph_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pSrc + i))));
+#elif defined(MATH_SIMD_SSE)
+            for (; i + 4 <= total; i += 4)
+            {
+                __m128i half = _mm_unpacklo_epi16(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(pSrc + i)), _mm_setzero_si128());
+                _mm_storeu_ps(pDst + i, HalfToFloatSSE(half));
+            }
+#endif
+
+            for (; i < total; i++)
+                pDst[i] = HalfToFloat(pSrc[i]);
+        }
+
+    private:
+        static inline float3 PositionScale(const Box3& bounds, float range)
+        {
+            auto size = bounds.Size();
+            return float3(size.x > 0.0f ? range / size.x : 0.0f,
+                          size.y > 0.0f ? range / size.y : 0.0f,
+                          size.z > 0.0f ? range / size.z : 0.0f);
+        }
+
+#if defined(MATH_SIMD_SSE)
+        // Same rounding as FloatToHalf, the results are sign extended 32 bit lanes ready for _mm_packs_epi32.
+        static inline __m128i FloatToHalfSSE(__m128 value)
+        {
+            const __m128i vInfinity = _mm_set1_epi32(0x7c00);
+            const __m128i vSubnormalMagic = _mm_set1_epi32(0x3f000000);
+            const __m128i vNormalBias = _mm_set1_epi32((int)0xc8000fff);
+
+            __m128 sign = _mm_and_ps(value, _mm_set1_ps(-0.0f));
+            __m128 absf = _mm_xor_ps(value, sign);
+            __m128i abs = _mm_castps_si128(absf);
+
+            __m128i isNaN = _mm_castps_si128(_mm_cmpunord_ps(absf, absf));
+            __m128i isFinite = _mm_cmpgt_epi32(_mm_set1_epi32(0x47800000), abs);
+            __m128i isSubnormal = _mm_cmpgt_epi32(_mm_set1_epi32(0x38800000), abs);
+            __m128i special = _mm_or_si128(vInfinity, _mm_and_si128(isNaN, _mm_set1_epi32(0x200)));
+
+            __m128i subnormal = _mm_sub_epi32(_mm_castps_si128(_mm_add_ps(absf, _mm_castsi128_ps(vSubnormalMagic))), vSubnormalMagic);
+
+            __m128i odd = _mm_and_si128(_mm_srli_epi32(abs, 13), _mm_set1_epi32(1));
+            __m128i normal = _mm_srli_epi32(_mm_add_epi32(_mm_add_epi32(abs, vNormalBias), odd), 13);
+
+            __m128i finite = _mm_or_si128(_mm_and_si128(isSubnormal, subnormal), _mm_andnot_si128(isSubnormal, normal));
+            __m128i half = _mm_or_si128(_mm_and_si128(isFinite, finite), _mm_andnot_si128(isFinite, special));
+
+            return _mm_or_si128(half, _mm_srai_epi32(_mm_castps_si128(sign), 16));
+        }
+
+        // Takes zero extended halves in 32 bit lanes.
+        static inline __m128 HalfToFloatSSE(__m128i half)
+        {
+            __m128i expmant = _mm_and_si128(half, _mm_set1_epi32(0x7fff));
+            __m128 scaled = _mm_mul_ps(_mm_castsi128_ps(_mm_slli_epi32(expmant, 13)), _mm_set1_ps(5.192297e+33f));
+
+            __m128i isSpecial = _mm_cmpgt_epi32(expmant, _mm_set1_epi32(0x7bff));
+            __m128i exponent = _mm_and_si128(isSpecial, _mm_set1_epi32(0x7f800000));
+            __m128i sign = _mm_slli_epi32(_mm_xor_si128(half, expmant), 16);
+
+            return _mm_or_ps(scaled, _mm_castsi128_ps(_mm_or_si128(sign, exponent)));
+        }
+#endif
+    };
+}
\ No newline at end of file
@@ -0,0 +1,137 @@
+#include <algorithm>
+#include <fstream>
+
+#include "AssetFileSystem.h"
+#include "MappedFile.h"
+
+AssetFileSystem::AssetFileSystem() : m_bRecording(false)
+{
+}
+
+bool AssetFileSystem::Mount(const std::string& archivePath, const std::string& prefix)
+{
+    auto pPak = PakFile::Open(archivePath);
+    if (pPak == nullptr)
+        return false;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_mounted.insert(m_mounted.begin(), Mounted { pPak, Normalize(prefix) });
+
+    return true;
+}
+
+std::shared_ptr<char> AssetFileSystem::Read(const std::string& path, uint64_t& size)
+{
+    auto normalized = Normalize(path);
+
+    std::shared_ptr<PakFile> pPak;
+    std::string name;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        RecordLocked(normalized);
+        Resolve(normalized, pPak, name);
+    }
+
+    // Archives are read only, so reads need no lock once resolved.
+    if (pPak != nullptr)
+        return pPak->Read(name, size);
+
+    auto pFile = MappedFile::Open(path);
+    if (pFile == nullptr)
+        return nullptr;
+
+    size = pFile->GetSize();
+    return pFile->GetView(0);
+}
+
+bool AssetFileSystem::IsArchived(const std::string& path)
+{
+    std::shared_ptr<PakFile> pPak;
+    std::string name;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return Resolve(Normalize(path), pPak, name);
+}
+
+void AssetFileSystem::Record(const std::string& path)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    RecordLocked(Normalize(path));
+}
+
+void AssetFileSystem::StartRecording()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_bRecording = true;
+    m_accessOrder.clear();
+    m_accessed.clear();
+}
+
+bool AssetFileSystem::SaveAccessOrder(const std::string& path)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_bRecording)
+        return false;
+
+    std::ofstream file(path, std::ios::trunc);
+    if (!file)
+        return false;
+
+    for (const auto& accessed : m_accessOrder)
+        file << accessed << "\n";
+
+    return (bool)file;
+}
+
+std::vector<std::string> AssetFileSystem::LoadAccessOrder(const std::string& path)
+{
+    std::vector<std::string> order;
+
+    std::ifstream file(path);
+    std::string line;
+    while (std::getline(file, line))
+    {
+        if (!line.empty() && line.back() == '\r')
+            line.pop_back();
+        if (!line.empty())
+            order.emplace_back(Normalize(line));
+    }
+
+    return order;
+}
+
+std::string AssetFileSystem::Normalize(const std::string& path)
+{
+    std::string normalized = path;
+    std::replace(normalized.begin(), normalized.end(), '\\', '/');
+
+    while (normalized.compare(0, 2, "./") == 0)
+        normalized.erase(0, 2);
+
+    return normalized;
+}
+
+bool AssetFileSystem::Resolve(const std::string& path, std::shared_ptr<PakFile>& pPak, std::string& name)
+{
+    for (const auto& mounted : m_mounted)
+    {
+        if (path.compare(0, mounted.prefix.size(), mounted.prefix) != 0)
+            continue;
+
+        auto entry = path.substr(mounted.prefix.size());
+        if (mounted.pPak->Contains(entry))
+        {
+            pPak = mounted.pPak;
+            name = entry;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void AssetFileSystem::RecordLocked(const std::string& path)
+{
+    if (m_bRecording && m_accessed.insert(path).second)
+        m_accessOrder.emplace_back(path);
+}
\ No newline at end of file
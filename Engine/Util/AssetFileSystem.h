@@ -0,0 +1,60 @@
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_set>
+#include <vector>
+#include <stdint.h>
+
+#include "PakFile.h"
+
+// Resolves asset paths against the mounted archives first and the loose files second, so a packed
+// build and a development tree load through the same calls. While recording, remembers the order in
+// which paths are first read; AssetPacker lays the next archive out in that order so a startup run
+// reads it front to back. Safe to use from any thread.
+class AssetFileSystem
+{
+public:
+    AssetFileSystem();
+
+    AssetFileSystem(const AssetFileSystem&) = delete;
+    AssetFileSystem& operator=(const AssetFileSystem&) = delete;
+
+    // Paths starting with prefix are looked up in the archive without it, e.g. "Asset/" maps
+    // "Asset/Scene/a.bin" to the entry "Scene/a.bin". Later mounts take precedence.
+    bool Mount(const std::string& archivePath, const std::string& prefix);
+
+    // Mapped or decoded contents, nullptr when the path is found nowhere. Read only, copy them to
+    // modify them, e.g. for parsing in place.
+    std::shared_ptr<char> Read(const std::string& path, uint64_t& size);
+    bool IsArchived(const std::string& path);
+
+    // For files read behind the file system's back, e.g. by a third party loader.
+    void Record(const std::string& path);
+
+    void StartRecording();
+    bool SaveAccessOrder(const std::string& path);
+    static std::vector<std::string> LoadAccessOrder(const std::string& path);
+
+    // '/' separators without leading "./", the form used for archive entries and the access order.
+    static std::string Normalize(const std::string& path);
+
+private:
+    struct Mounted
+    {
+        std::shared_ptr<PakFile> pPak;
+        std::string prefix;
+    };
+
+    bool Resolve(const std::string& path, std::shared_ptr<PakFile>& pPak, std::string& name);
+    void RecordLocked(const std::string& path);
+
+private:
+    std::mutex m_mutex;
+    std::vector<Mounted> m_mounted;
+
+    bool m_bRecording;
+    std::vector<std::string> m_accessOrder;
+    std::unordered_set<std::string> m_accessed;
+};
\ No newline at end of file
@@ -0,0 +1,203 @@
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <vector>
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "DerivedDataCache.h"
+
+namespace fs = std::filesystem;
+
+DerivedDataCache::DerivedDataCache(const std::string& directory, uint64_t maxSize) :
+    m_directory(directory), m_maxSize(maxSize), m_bIndexed(false), m_size(0), m_temporaryCount(0)
+{
+}
+
+std::string DerivedDataCache::Find(uint64_t key)
+{
+    auto now = fs::file_time_type::clock::now();
+    std::string path;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        Index();
+
+        auto it = m_entries.find(key);
+        if (it == m_entries.end())
+            return std::string();
+
+        it->second.lastUse = now.time_since_epoch().count();
+        path = GetPath(key);
+    }
+
+    // The write time carries the LRU order over to the next run.
+    std::error_code error;
+    fs::last_write_time(path, now, error);
+    if (error && !fs::exists(path, error))
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto it = m_entries.find(key);
+        if (it != m_entries.end())
+        {
+            m_size -= it->second.size;
+            m_entries.erase(it);
+        }
+        return std::string();
+    }
+
+    return path;
+}
+
+bool DerivedDataCache::Store(uint64_t key, const std::function<bool(const std::string& path)>& write)
+{
+    std::string temporary;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        Index();
+
+        // Unique within this process by the counter and across processes by the start time.
+        auto stamp = std::chrono::steady_clock::now().time_since_epoch().count();
+        temporary = GetPath(key) + "." + std::to_string(stamp) + "_" + std::to_string(m_temporaryCount++) + TEMPORARY_EXTENSION;
+    }
+
+    std::error_code error;
+    if (!write(temporary))
+    {
+        fs::remove(temporary, error);
+        return false;
+    }
+
+    // Replacing fails while another thread or process has the item mapped, which already has the same contents.
+    auto path = GetPath(key);
+    fs::rename(temporary, path, error);
+    if (error)
+    {
+        fs::remove(temporary, error);
+        if (!fs::exists(path, error))
+            return false;
+    }
+
+    uint64_t size = fs::file_size(path, error);
+    if (error)
+        return false;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    auto it = m_entries.find(key);
+    if (it != m_entries.end())
+        m_size -= it->second.size;
+
+    m_entries[key] = Entry { size, fs::file_time_type::clock::now().time_since_epoch().count() };
+    m_size += size;
+
+    if (m_size > m_maxSize)
+        Evict(key);
+
+    return true;
+}
+
+uint64_t DerivedDataCache::GetSize()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    Index();
+
+    return m_size;
+}
+
+uint64_t DerivedDataCache::GetMaxSize() const
+{
+    return m_maxSize;
+}
+
+void DerivedDataCache::Index()
+{
+    if (m_bIndexed)
+        return;
+
+    m_bIndexed = true;
+
+    std::error_code error;
+    fs::create_directories(m_directory, error);
+
+    // Temporaries older than this were left by a crash, younger ones may belong to a running cooker.
+    auto staleTime = fs::file_time_type::clock::now() - std::chrono::hours(1);
+
+    for (const auto& entry : fs::directory_iterator(m_directory, error))
+    {
+        if (!entry.is_regular_file(error))
+            continue;
+
+        auto filename = entry.path().filename().string();
+        auto lastWrite = entry.last_write_time(error);
+        if (error)
+            continue;
+
+        uint64_t key;
+        if (ParseKey(filename, key))
+        {
+            uint64_t size = entry.file_size(error);
+            if (error)
+                continue;
+
+            m_entries[key] = Entry { size, lastWrite.time_since_epoch().count() };
+            m_size += size;
+        }
+        else if (entry.path().extension() == TEMPORARY_EXTENSION && lastWrite < staleTime)
+            fs::remove(entry.path(), error);
+    }
+
+    if (m_size > m_maxSize)
+        Evict(0);
+}
+
+void DerivedDataCache::Evict(uint64_t keep)
+{
+    std::vector<std::pair<int64_t, uint64_t>> order;
+    order.reserve(m_entries.size());
+    for (const auto& entry : m_entries)
+    {
+        if (entry.first != keep)
+            order.emplace_back(entry.second.lastUse, entry.first);
+    }
+
+    std::sort(order.begin(), order.end());
+
+    // Items that are mapped somewhere can not be removed on every platform, they stay for the next eviction.
+    for (const auto& item : order)
+    {
+        if (m_size <= m_maxSize)
+            break;
+
+        std::error_code error;
+        if (!fs::remove(GetPath(item.second), error) && fs::exists(GetPath(item.second), error))
+            continue;
+
+        m_size -= m_entries[item.second].size;
+        m_entries.erase(item.second);
+    }
+}
+
+std::string DerivedDataCache::GetPath(uint64_t key) const
+{
+    char name[17];
+    snprintf(name, sizeof(name), "%016llx", (unsigned long long)key);
+
+    return m_directory + "/" + name + EXTENSION;
+}
+
+bool DerivedDataCache::ParseKey(const std::string& filename, uint64_t& key)
+{
+    std::string extension = EXTENSION;
+    if (filename.size() != 16 + extension.size() || filename.compare(16, std::string::npos, extension) != 0)
+        return false;
+
+    for (uint32_t i = 0; i < 16; i++)
+    {
+        if (!isxdigit((unsigned char)filename[i]))
+            return false;
+    }
+
+    key = strtoull(filename.substr(0, 16).c_str(), nullptr, 16);
+    return true;
+}
\ No newline at end of file
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <functional>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <stdint.h>
+
+// On-disk cache of cooked data, one file per key. Keys are content hashes (see Hash64) of the source
+// bytes, the cooker version and its settings, so a key never needs invalidating: changed inputs
+// simply hash to a new key. The directory is indexed on first use, items are evicted least
+// recently used first once the cache outgrows its size limit. Safe to use from any thread.
+class DerivedDataCache
+{
+public:
+    constexpr static const char* DEFAULT_DIRECTORY = "DerivedDataCache";
+    constexpr static uint64_t DEFAULT_MAX_SIZE = 4ull << 30;
+
+    explicit DerivedDataCache(const std::string& directory = DEFAULT_DIRECTORY, uint64_t maxSize = DEFAULT_MAX_SIZE);
+
+    DerivedDataCache(const DerivedDataCache&) = delete;
+    DerivedDataCache& operator=(const DerivedDataCache&) = delete;
+
+    // Path of the cached item, empty when key is not cached. Marks the item as just used.
+    std::string Find(uint64_t key);
+
+    // Runs write on a temporary path inside the cache and moves the result in place, so readers
+    // never see a partial item and a crash leaves nothing behind. Concurrent stores of one key are
+    // fine, the last move wins with identical contents.
+    bool Store(uint64_t key, const std::function<bool(const std::string& path)>& write);
+
+    uint64_t GetSize();
+    uint64_t GetMaxSize() const;
+
+private:
+    struct Entry
+    {
+        uint64_t size;
+        // Last use in file time ticks, persisted as the file's write time.
+        int64_t lastUse;
+    };
+
+    void Index();
+    void Evict(uint64_t keep);
+    std::string GetPath(uint64_t key) const;
+
+    static bool ParseKey(const std::string& filename, uint64_t& key);
+
+private:
+    constexpr static const char* EXTENSION = ".ddc";
+    constexpr static const char* TEMPORARY_EXTENSION = ".tmp";
+
+    std::string m_directory;
+    uint64_t m_maxSize;
+
+    std::mutex m_mutex;
+    bool m_bIndexed;
+    std::unordered_map<uint64_t, Entry> m_entries;
+    uint64_t m_size;
+    uint64_t m_temporaryCount;
+};
\ No newline at end of file
@@ -0,0 +1,152 @@
+#pragma once
+
+#include <string>
+#include <type_traits>
+#include <stdint.h>
+#include <string.h>
+
+// Streaming XXH64, see https://github.com/Cyan4973/xxHash/blob/dev/doc/xxhash_spec.md. Fast enough
+// to key derived data by the full contents of its sources.
+class Hash64
+{
+public:
+    explicit Hash64(uint64_t seed = 0) : m_totalSize(0), m_bufferSize(0)
+    {
+        m_state[0] = seed + PRIME_1 + PRIME_2;
+        m_state[1] = seed + PRIME_2;
+        m_state[2] = seed;
+        m_state[3] = seed - PRIME_1;
+        m_seed = seed;
+    }
+
+    void Update(const void* pData, size_t size)
+    {
+        const uint8_t* p = static_cast<const uint8_t*>(pData);
+        m_totalSize += size;
+
+        if (m_bufferSize + size < sizeof(m_buffer))
+        {
+            memcpy(m_buffer + m_bufferSize, p, size);
+            m_bufferSize += (uint32_t)size;
+            return;
+        }
+
+        if (m_bufferSize > 0)
+        {
+            size_t fill = sizeof(m_buffer) - m_bufferSize;
+            memcpy(m_buffer + m_bufferSize, p, fill);
+            ConsumeStripe(m_buffer);
+            p += fill;
+            size -= fill;
+            m_bufferSize = 0;
+        }
+
+        for (; size >= sizeof(m_buffer); p += sizeof(m_buffer), size -= sizeof(m_buffer))
+            ConsumeStripe(p);
+
+        memcpy(m_buffer, p, size);
+        m_bufferSize = (uint32_t)size;
+    }
+
+    template<typename T>
+    void Update(const T& value)
+    {
+        static_assert(std::is_trivially_copyable<T>::value, "hash the bytes of plain values only");
+        Update(&value, sizeof(T));
+    }
+
+    // Length first, so consecutive strings can not run into each other.
+    void Update(const std::string& str)
+    {
+        Update((uint64_t)str.size());
+        Update(str.data(), str.size());
+    }
+
+    uint64_t Final() const
+    {
+        uint64_t h;
+        if (m_totalSize >= sizeof(m_buffer))
+        {
+            h = RotateLeft(m_state[0], 1) + RotateLeft(m_state[1], 7) + RotateLeft(m_state[2], 12) + RotateLeft(m_state[3], 18);
+            for (uint32_t i = 0; i < 4; i++)
+                h = (h ^ Round(0, m_state[i])) * PRIME_1 + PRIME_4;
+        }
+        else
+            h = m_seed + PRIME_5;
+
+        h += m_totalSize;
+
+        const uint8_t* p = m_buffer;
+        const uint8_t* pEnd = m_buffer + m_bufferSize;
+        for (; p + 8 <= pEnd; p += 8)
+            h = RotateLeft(h ^ Round(0, Read64(p)), 27) * PRIME_1 + PRIME_4;
+
+        if (p + 4 <= pEnd)
+        {
+            h = RotateLeft(h ^ (Read32(p) * PRIME_1), 23) * PRIME_2 + PRIME_3;
+            p += 4;
+        }
+
+        for (; p < pEnd; p++)
+            h = RotateLeft(h ^ (*p * PRIME_5), 11) * PRIME_1;
+
+        h ^= h >> 33;
+        h *= PRIME_2;
+        h ^= h >> 29;
+        h *= PRIME_3;
+        h ^= h >> 32;
+
+        return h;
+    }
+
+    static uint64_t Compute(const void* pData, size_t size, uint64_t seed = 0)
+    {
+        Hash64 hash(seed);
+        hash.Update(pData, size);
+        return hash.Final();
+    }
+
+private:
+    constexpr static uint64_t PRIME_1 = 0x9E3779B185EBCA87ull;
+    constexpr static uint64_t PRIME_2 = 0xC2B2AE3D27D4EB4Full;
+    constexpr static uint64_t PRIME_3 = 0x165667B19E3779F9ull;
+    constexpr static uint64_t PRIME_4 = 0x85EBCA77C2B2AE63ull;
+    constexpr static uint64_t PRIME_5 = 0x27D4EB2F165667C5ull;
+
+    static uint64_t RotateLeft(uint64_t x, uint32_t r)
+    {
+        return (x << r) | (x >> (64 - r));
+    }
+
+    static uint64_t Round(uint64_t acc, uint64_t input)
+    {
+        return RotateLeft(acc + input * PRIME_2, 31) * PRIME_1;
+    }
+
+    static uint64_t Read64(const uint8_t* p)
+    {
+        uint64_t value;
+        memcpy(&value, p, sizeof(value));
+        return value;
+    }
+
+    static uint64_t Read32(const uint8_t* p)
+    {
+        uint32_t value;
+        memcpy(&value, p, sizeof(value));
+        return value;
+    }
+
+    void ConsumeStripe(const uint8_t* p)
+    {
+        for (uint32_t i = 0; i < 4; i++)
+            m_state[i] = Round(m_state[i], Read64(p + i * 8));
+    }
+
+private:
+    uint64_t m_state[4];
+    uint64_t m_seed;
+    uint64_t m_totalSize;
+    uint8_t m_buffer[32];
+    uint32_t m_bufferSize;
+};
\ No newline at end of file
@@ -0,0 +1,169 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+class JobSystem
+{
+public:
+    typedef std::function<void()> JobType;
+
+    explicit JobSystem(uint32_t workerCount = DefaultWorkerCount());
+    ~JobSystem();
+
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+
+    uint32_t WorkerCount() const;
+
+    void Submit(JobType job);
+
+    // Split [0, count) into batches of at most grain items and call func(begin, end) on the workers
+    // and on the calling thread. Returns once every batch has run.
+    template<typename Func>
+    void ParallelFor(uint32_t count, uint32_t grain, Func func);
+
+    static uint32_t DefaultWorkerCount();
+
+private:
+    bool TryRunJob();
+    void WorkerLoop();
+
+private:
+    std::vector<std::thread> m_workers;
+    std::queue<JobType> m_jobs;
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+    bool m_bStop;
+};
+
+inline JobSystem::JobSystem(uint32_t workerCount) : m_bStop(false)
+{
+    for (uint32_t i = 0; i < workerCount; i++)
+        m_workers.emplace_back(&JobSystem::WorkerLoop, this);
+}
+
+inline JobSystem::~JobSystem()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_bStop = true;
+    }
+    m_condition.notify_all();
+
+    for (auto& worker : m_workers)
+        worker.join();
+}
+
+inline uint32_t JobSystem::WorkerCount() const
+{
+    return (uint32_t)m_workers.size();
+}
+
+inline void JobSystem::Submit(JobType job)
+{
+    if (m_workers.empty())
+    {
+        job();
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_jobs.push(std::move(job));
+    }
+    m_condition.notify_one();
+}
+
+template<typename Func>
+void JobSystem::ParallelFor(uint32_t count, uint32_t grain, Func func)
+{
+    if (count == 0)
+        return;
+
+    grain = std::max(grain, 1u);
+    uint32_t batchCount = (count + grain - 1) / grain;
+    if (batchCount == 1 || m_workers.empty())
+    {
+        func(0, count);
+        return;
+    }
+
+    std::atomic<uint32_t> nextBatch(0);
+    std::atomic<uint32_t> pendingHelpers(std::min(WorkerCount(), batchCount - 1));
+
+    auto runBatches = [&]() {
+        uint32_t batch;
+        while ((batch = nextBatch.fetch_add(1)) < batchCount)
+        {
+            uint32_t begin = batch * grain;
+            func(begin, std::min(begin + grain, count));
+        }
+    };
+
+    uint32_t helperCount = pendingHelpers.load();
+    for (uint32_t i = 0; i < helperCount; i++)
+    {
+        Submit([&]() {
+            runBatches();
+            pendingHelpers.fetch_sub(1);
+        });
+    }
+
+    runBatches();
+
+    // Helpers reference this stack frame, so wait for all of them. Run other queued jobs meanwhile
+    // so a nested ParallelFor issued from a worker can not starve.
+    while (pendingHelpers.load() != 0)
+    {
+        if (!TryRunJob())
+            std::this_thread::yield();
+    }
+}
+
+inline uint32_t JobSystem::DefaultWorkerCount()
+{
+    uint32_t count = std::thread::hardware_concurrency();
+    return count > 1 ? count - 1 : 0;
+}
+
+inline bool JobSystem::TryRunJob()
+{
+    JobType job;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_jobs.empty())
+            return false;
+
+        job = std::move(m_jobs.front());
+        m_jobs.pop();
+    }
+
+    job();
+    return true;
+}
+
+inline void JobSystem::WorkerLoop()
+{
+    while (true)
+    {
+        JobType job;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_condition.wait(lock, [this]() { return m_bStop || !m_jobs.empty(); });
+            if (m_bStop && m_jobs.empty())
+                return;
+
+            job = std::move(m_jobs.front());
+            m_jobs.pop();
+        }
+
+        job();
+    }
+}
\ No newline at end of file
@@ -0,0 +1,466 @@
+#include <math.h>
+#include <string.h>
+
+#include "JsonDocument.h"
+
+JsonDocument::JsonDocument() : m_pBegin(nullptr), m_pCursor(nullptr), m_pEnd(nullptr)
+{
+}
+
+bool JsonDocument::Parse(char* text, size_t size)
+{
+    m_nodes.clear();
+    m_error.clear();
+
+    m_pBegin = text;
+    m_pCursor = text;
+    m_pEnd = text + size;
+
+    // Roughly one value per 16 bytes of typical glTF, saves most of the regrowth.
+    m_nodes.reserve(size / 16 + 1);
+
+    if (!ParseValue(0))
+    {
+        m_nodes.clear();
+        return false;
+    }
+
+    if (SkipWhitespace())
+    {
+        m_nodes.clear();
+        return Fail("trailing characters");
+    }
+
+    return true;
+}
+
+JsonDocument::Value JsonDocument::GetRoot() const
+{
+    return m_nodes.empty() ? Value() : Value(this, 0);
+}
+
+const std::string& JsonDocument::GetError() const
+{
+    return m_error;
+}
+
+bool JsonDocument::ParseValue(uint32_t depth)
+{
+    if (depth > MAX_DEPTH)
+        return Fail("nesting too deep");
+
+    if (!SkipWhitespace())
+        return Fail("unexpected end");
+
+    uint32_t index = (uint32_t)m_nodes.size();
+    m_nodes.emplace_back();
+    m_nodes[index].type = EType::Null;
+    m_nodes[index].count = 0;
+    m_nodes[index].next = 0;
+    m_nodes[index].key = nullptr;
+    m_nodes[index].number = 0.0;
+
+    char c = *m_pCursor;
+    if (c == '{' || c == '[')
+    {
+        bool bObject = c == '{';
+        char close = bObject ? '}' : ']';
+        m_nodes[index].type = bObject ? EType::Object : EType::Array;
+        m_pCursor++;
+
+        if (!SkipWhitespace())
+            return Fail("unexpected end");
+        if (*m_pCursor == close)
+        {
+            m_pCursor++;
+            return true;
+        }
+
+        uint32_t count = 0;
+        uint32_t previous = 0;
+        while (true)
+        {
+            const char* key = nullptr;
+            if (bObject)
+            {
+                if (!SkipWhitespace() || *m_pCursor != '"')
+                    return Fail("expected member name");
+                if (!ParseString(key))
+                    return false;
+                if (!SkipWhitespace() || *m_pCursor != ':')
+                    return Fail("expected ':'");
+                m_pCursor++;
+            }
+
+            uint32_t child = (uint32_t)m_nodes.size();
+            if (!ParseValue(depth + 1))
+                return false;
+
+            m_nodes[child].key = key;
+            if (previous != 0)
+                m_nodes[previous].next = child;
+            previous = child;
+            count++;
+
+            if (!SkipWhitespace())
+                return Fail("unexpected end");
+            if (*m_pCursor == ',')
+            {
+                m_pCursor++;
+                continue;
+            }
+            if (*m_pCursor == close)
+            {
+                m_pCursor++;
+                break;
+            }
+            return Fail(bObject ? "expected ',' or '}'" : "expected ',' or ']'");
+        }
+
+        m_nodes[index].count = count;
+        return true;
+    }
+
+    if (c == '"')
+    {
+        const char* str = nullptr;
+        if (!ParseString(str))
+            return false;
+
+        m_nodes[index].type = EType::String;
+        m_nodes[index].string = str;
+        return true;
+    }
+
+    auto literal = [&](const char* word, size_t length) {
+        if ((size_t)(m_pEnd - m_pCursor) < length || memcmp(m_pCursor, word, length) != 0)
+            return false;
+        m_pCursor += length;
+        return true;
+    };
+
+    if (literal("true", 4))
+    {
+        m_nodes[index].type = EType::Bool;
+        m_nodes[index].boolean = true;
+        return true;
+    }
+
+    if (literal("false", 5))
+    {
+        m_nodes[index].type = EType::Bool;
+        m_nodes[index].boolean = false;
+        return true;
+    }
+
+    if (literal("null", 4))
+        return true;
+
+    double number = 0.0;
+    if (!ParseNumber(number))
+        return false;
+
+    m_nodes[index].type = EType::Number;
+    m_nodes[index].number = number;
+    return true;
+}
+
+bool JsonDocument::ParseString(const char*& str)
+{
+    // Opening quote.
+    m_pCursor++;
+    char* pBegin = m_pCursor;
+
+    // Plain characters stay where they are, only escapes move the tail down.
+    while (m_pCursor < m_pEnd && *m_pCursor != '"' && *m_pCursor != '\\')
+    {
+        if ((unsigned char)*m_pCursor < 0x20)
+            return Fail("control character in string");
+        m_pCursor++;
+    }
+
+    char* pOut = m_pCursor;
+    while (m_pCursor < m_pEnd)
+    {
+        char c = *m_pCursor;
+        if (c == '"')
+        {
+            *pOut = '\0';
+            m_pCursor++;
+            str = pBegin;
+            return true;
+        }
+
+        if ((unsigned char)c < 0x20)
+            return Fail("control character in string");
+
+        if (c != '\\')
+        {
+            *pOut++ = *m_pCursor++;
+            continue;
+        }
+
+        if (m_pEnd - m_pCursor < 2)
+            break;
+
+        char escape = m_pCursor[1];
+        m_pCursor += 2;
+        switch (escape)
+        {
+        case '"': *pOut++ = '"'; break;
+        case '\\': *pOut++ = '\\'; break;
+        case '/': *pOut++ = '/'; break;
+        case 'b': *pOut++ = '\b'; break;
+        case 'f': *pOut++ = '\f'; break;
+        case 'n': *pOut++ = '\n'; break;
+        case 'r': *pOut++ = '\r'; break;
+        case 't': *pOut++ = '\t'; break;
+        case 'u':
+        {
+            auto hex = [&](uint32_t& code) {
+                if (m_pEnd - m_pCursor < 4)
+                    return false;
+                code = 0;
+                for (int i = 0; i < 4; i++)
+                {
+                    char h = *m_pCursor++;
+                    code <<= 4;
+                    if (h >= '0' && h <= '9')
+                        code |= h - '0';
+                    else if (h >= 'a' && h <= 'f')
+                        code |= h - 'a' + 10;
+                    else if (h >= 'A' && h <= 'F')
+                        code |= h - 'A' + 10;
+                    else
+                        return false;
+                }
+                return true;
+            };
+
+            uint32_t code = 0;
+            if (!hex(code))
+                return Fail("invalid \\u escape");
+
+            // Surrogate pair.
+            if (code >= 0xd800 && code <= 0xdbff && m_pEnd - m_pCursor >= 6 && m_pCursor[0] == '\\' && m_pCursor[1] == 'u')
+            {
+                m_pCursor += 2;
+                uint32_t low = 0;
+                if (!hex(low) || low < 0xdc00 || low > 0xdfff)
+                    return Fail("invalid surrogate pair");
+                code = 0x10000 + ((code - 0xd800) << 10) + (low - 0xdc00);
+            }
+
+            // The UTF-8 sequence is never longer than the escape it replaces.
+            if (code < 0x80)
+                *pOut++ = (char)code;
+            else if (code < 0x800)
+            {
+                *pOut++ = (char)(0xc0 | (code >> 6));
+                *pOut++ = (char)(0x80 | (code & 0x3f));
+            }
+            else if (code < 0x10000)
+            {
+                *pOut++ = (char)(0xe0 | (code >> 12));
+                *pOut++ = (char)(0x80 | ((code >> 6) & 0x3f));
+                *pOut++ = (char)(0x80 | (code & 0x3f));
+            }
+            else
+            {
+                *pOut++ = (char)(0xf0 | (code >> 18));
+                *pOut++ = (char)(0x80 | ((code >> 12) & 0x3f));
+                *pOut++ = (char)(0x80 | ((code >> 6) & 0x3f));
+                *pOut++ = (char)(0x80 | (code & 0x3f));
+            }
+            break;
+        }
+        default:
+            return Fail("invalid escape");
+        }
+    }
+
+    return Fail("unterminated string");
+}
+
+bool JsonDocument::ParseNumber(double& number)
+{
+    static const double powers[] = {
+        1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+        1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22,
+    };
+
+    auto isDigit = [&]() { return m_pCursor < m_pEnd && *m_pCursor >= '0' && *m_pCursor <= '9'; };
+
+    bool bNegative = false;
+    if (m_pCursor < m_pEnd && *m_pCursor == '-')
+    {
+        bNegative = true;
+        m_pCursor++;
+    }
+
+    if (!isDigit())
+        return Fail("invalid value");
+
+    // Up to 19 significant digits are exact in the mantissa, the rest only shift the exponent.
+    uint64_t mantissa = 0;
+    int32_t digits = 0;
+    int32_t exponent = 0;
+    for (; isDigit(); m_pCursor++)
+    {
+        if (digits < 19)
+        {
+            mantissa = mantissa * 10 + (*m_pCursor - '0');
+            digits += mantissa != 0 ? 1 : 0;
+        }
+        else
+            exponent++;
+    }
+
+    if (m_pCursor < m_pEnd && *m_pCursor == '.')
+    {
+        m_pCursor++;
+        if (!isDigit())
+            return Fail("invalid number");
+
+        for (; isDigit(); m_pCursor++)
+        {
+            if (digits < 19)
+            {
+                mantissa = mantissa * 10 + (*m_pCursor - '0');
+                digits += mantissa != 0 ? 1 : 0;
+                exponent--;
+            }
+        }
+    }
+
+    if (m_pCursor < m_pEnd && (*m_pCursor == 'e' || *m_pCursor == 'E'))
+    {
+        m_pCursor++;
+        bool bNegativeExponent = false;
+        if (m_pCursor < m_pEnd && (*m_pCursor == '+' || *m_pCursor == '-'))
+            bNegativeExponent = *m_pCursor++ == '-';
+        if (!isDigit())
+            return Fail("invalid number");
+
+        int32_t value = 0;
+        for (; isDigit(); m_pCursor++)
+        {
+            if (value < 10000)
+                value = value * 10 + (*m_pCursor - '0');
+        }
+        exponent += bNegativeExponent ? -value : value;
+    }
+
+    double result = (double)mantissa;
+    if (exponent >= 0 && exponent <= 22)
+        result *= powers[exponent];
+    else if (exponent < 0 && exponent >= -22)
+        result /= powers[-exponent];
+    else if (mantissa != 0)
+        result *= pow(10.0, exponent);
+
+    number = bNegative ? -result : result;
+    return true;
+}
+
+bool JsonDocument::SkipWhitespace()
+{
+    while (m_pCursor < m_pEnd && (*m_pCursor == ' ' || *m_pCursor == '\n' || *m_pCursor == '\r' || *m_pCursor == '\t'))
+        m_pCursor++;
+
+    return m_pCursor < m_pEnd;
+}
+
+bool JsonDocument::Fail(const char* message)
+{
+    m_error = std::string(message) + " at offset " + std::to_string(m_pCursor - m_pBegin);
+    return false;
+}
+
+JsonDocument::EType JsonDocument::Value::GetType() const
+{
+    return m_pDocument->m_nodes[m_index].type;
+}
+
+bool JsonDocument::Value::GetBool(bool defaultValue) const
+{
+    if (!*this || GetType() != EType::Bool)
+        return defaultValue;
+
+    return m_pDocument->m_nodes[m_index].boolean;
+}
+
+double JsonDocument::Value::GetNumber(double defaultValue) const
+{
+    if (!IsNumber())
+        return defaultValue;
+
+    return m_pDocument->m_nodes[m_index].number;
+}
+
+const char* JsonDocument::Value::GetCString(const char* defaultValue) const
+{
+    if (!IsString())
+        return defaultValue;
+
+    return m_pDocument->m_nodes[m_index].string;
+}
+
+uint32_t JsonDocument::Value::Size() const
+{
+    if (!IsArray() && !IsObject())
+        return 0;
+
+    return m_pDocument->m_nodes[m_index].count;
+}
+
+JsonDocument::Value JsonDocument::Value::operator[](const char* key) const
+{
+    if (!IsObject())
+        return Value();
+
+    for (auto member = First(); member; member = member.Next())
+    {
+        if (strcmp(member.GetKey(), key) == 0)
+            return member;
+    }
+
+    return Value();
+}
+
+JsonDocument::Value JsonDocument::Value::operator[](uint32_t index) const
+{
+    if (!IsArray())
+        return Value();
+
+    auto element = First();
+    for (uint32_t i = 0; i < index && element; i++)
+        element = element.Next();
+
+    return element;
+}
+
+JsonDocument::Value JsonDocument::Value::First() const
+{
+    if (Size() == 0)
+        return Value();
+
+    return Value(m_pDocument, m_index + 1);
+}
+
+JsonDocument::Value JsonDocument::Value::Next() const
+{
+    if (!*this)
+        return Value();
+
+    uint32_t next = m_pDocument->m_nodes[m_index].next;
+    return next != 0 ? Value(m_pDocument, next) : Value();
+}
+
+const char* JsonDocument::Value::GetKey() const
+{
+    if (!*this || m_pDocument->m_nodes[m_index].key == nullptr)
+        return "";
+
+    return m_pDocument->m_nodes[m_index].key;
+}
\ No newline at end of file
@@ -0,0 +1,104 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <stdint.h>
+
+// JSON DOM parsed in place. Strings are unescaped and terminated inside the source text, so the
+// text must be writable (a copy-on-write MappedFile view works) and must outlive the document.
+// Values are stored flat in document order and linked to their next sibling.
+class JsonDocument
+{
+public:
+    enum class EType : uint8_t
+    {
+        Null,
+        Bool,
+        Number,
+        String,
+        Array,
+        Object,
+    };
+
+    class Value
+    {
+    public:
+        Value() : m_pDocument(nullptr), m_index(0) {}
+        Value(const JsonDocument* pDocument, uint32_t index) : m_pDocument(pDocument), m_index(index) {}
+
+        explicit operator bool() const { return m_pDocument != nullptr; }
+
+        EType GetType() const;
+        bool IsNumber() const { return *this && GetType() == EType::Number; }
+        bool IsString() const { return *this && GetType() == EType::String; }
+        bool IsArray() const { return *this && GetType() == EType::Array; }
+        bool IsObject() const { return *this && GetType() == EType::Object; }
+
+        bool GetBool(bool defaultValue = false) const;
+        double GetNumber(double defaultValue = 0.0) const;
+        float GetFloat(float defaultValue = 0.0f) const { return (float)GetNumber(defaultValue); }
+        int32_t GetInt(int32_t defaultValue = 0) const { return (int32_t)GetNumber(defaultValue); }
+        uint32_t GetUInt(uint32_t defaultValue = 0) const { return (uint32_t)GetNumber(defaultValue); }
+        const char* GetCString(const char* defaultValue = "") const;
+        std::string GetString(const char* defaultValue = "") const { return GetCString(defaultValue); }
+
+        // Number of elements or members.
+        uint32_t Size() const;
+
+        // Member lookup, an invalid value when missing.
+        Value operator[](const char* key) const;
+        // Element lookup, linear in the index.
+        Value operator[](uint32_t index) const;
+
+        // Iteration over elements or members: for (auto v = a.First(); v; v = v.Next()).
+        Value First() const;
+        Value Next() const;
+        // Member name when iterating an object.
+        const char* GetKey() const;
+
+    private:
+        const JsonDocument* m_pDocument;
+        uint32_t m_index;
+    };
+
+    JsonDocument();
+    ~JsonDocument() = default;
+
+    // Parses text[0, size) in place. Returns false on malformed input, GetError() tells where.
+    bool Parse(char* text, size_t size);
+
+    Value GetRoot() const;
+    const std::string& GetError() const;
+
+private:
+    struct Node
+    {
+        EType type;
+        uint32_t count;     // Elements or members of arrays and objects.
+        uint32_t next;      // Next sibling, 0 for the last one. The first child directly follows its parent.
+        const char* key;    // Member name, nullptr outside objects.
+        union
+        {
+            double number;
+            bool boolean;
+            const char* string;
+        };
+    };
+
+    bool ParseValue(uint32_t depth);
+    bool ParseString(const char*& str);
+    bool ParseNumber(double& number);
+    bool SkipWhitespace();
+    bool Fail(const char* message);
+
+    constexpr static uint32_t MAX_DEPTH = 256;
+
+private:
+    std::vector<Node> m_nodes;
+    std::string m_error;
+
+    // Parse state.
+    char* m_pBegin;
+    char* m_pCursor;
+    char* m_pEnd;
+};
\ No newline at end of file
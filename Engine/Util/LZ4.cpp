@@ -0,0 +1,192 @@
+#include <algorithm>
+#include <string.h>
+
+#include "LZ4.h"
+
+uint32_t LZ4::CompressBound(uint32_t size)
+{
+    return size + size / 255 + 16;
+}
+
+uint32_t LZ4::Compress(const char* pSrc, uint32_t size, char* pDst, uint32_t capacity)
+{
+    const uint8_t* pIn = reinterpret_cast<const uint8_t*>(pSrc);
+    const uint8_t* pEnd = pIn + size;
+    uint8_t* pOut = reinterpret_cast<uint8_t*>(pDst);
+    uint8_t* pOutEnd = pOut + capacity;
+
+    // Positions relative to pIn, stale or colliding entries are caught by comparing the bytes.
+    uint32_t table[1u << HASH_BITS] = {};
+
+    auto fits = [&](uint32_t literalLength, uint32_t matchLength) {
+        size_t worstCase = 1 + literalLength / 255 + 1 + literalLength + 2 + matchLength / 255 + 1;
+        return worstCase <= (size_t)(pOutEnd - pOut);
+    };
+
+    const uint8_t* pAnchor = pIn;
+    const uint8_t* p = pIn;
+    if (size > MATCH_LIMIT)
+    {
+        const uint8_t* pMatchLimit = pEnd - MATCH_LIMIT;
+        const uint8_t* pLiteralLimit = pEnd - LAST_LITERALS;
+        while (p < pMatchLimit)
+        {
+            uint32_t sequence = Read32(p);
+            uint32_t h = Hash(sequence);
+            const uint8_t* pCandidate = pIn + table[h];
+            table[h] = (uint32_t)(p - pIn);
+
+            if (pCandidate >= p || p - pCandidate > MAX_OFFSET || Read32(pCandidate) != sequence)
+            {
+                // Step faster through data that does not compress.
+                p += 1 + ((p - pAnchor) >> 6);
+                continue;
+            }
+
+            const uint8_t* pMatchEnd = p + MIN_MATCH;
+            const uint8_t* pReference = pCandidate + MIN_MATCH;
+            while (pMatchEnd < pLiteralLimit && *pMatchEnd == *pReference)
+            {
+                pMatchEnd++;
+                pReference++;
+            }
+
+            while (p > pAnchor && pCandidate > pIn && p[-1] == pCandidate[-1])
+            {
+                p--;
+                pCandidate--;
+            }
+
+            uint32_t literalLength = (uint32_t)(p - pAnchor);
+            uint32_t matchLength = (uint32_t)(pMatchEnd - p) - MIN_MATCH;
+            if (!fits(literalLength, matchLength))
+                return 0;
+
+            uint8_t* pToken = pOut++;
+            *pToken = (uint8_t)((std::min(literalLength, 15u) << 4) | std::min(matchLength, 15u));
+            if (literalLength >= 15)
+                pOut = WriteLength(pOut, literalLength - 15);
+
+            memcpy(pOut, pAnchor, literalLength);
+            pOut += literalLength;
+
+            uint32_t offset = (uint32_t)(p - pCandidate);
+            *pOut++ = (uint8_t)(offset & 0xff);
+            *pOut++ = (uint8_t)(offset >> 8);
+
+            if (matchLength >= 15)
+                pOut = WriteLength(pOut, matchLength - 15);
+
+            p = pMatchEnd;
+            pAnchor = p;
+        }
+    }
+
+    uint32_t literalLength = (uint32_t)(pEnd - pAnchor);
+    if (!fits(literalLength, 0))
+        return 0;
+
+    *pOut++ = (uint8_t)(std::min(literalLength, 15u) << 4);
+    if (literalLength >= 15)
+        pOut = WriteLength(pOut, literalLength - 15);
+
+    memcpy(pOut, pAnchor, literalLength);
+    pOut += literalLength;
+
+    return (uint32_t)(pOut - reinterpret_cast<uint8_t*>(pDst));
+}
+
+bool LZ4::Decompress(const char* pSrc, uint32_t compressedSize, char* pDst, uint32_t size)
+{
+    const uint8_t* p = reinterpret_cast<const uint8_t*>(pSrc);
+    const uint8_t* pEnd = p + compressedSize;
+    uint8_t* pOut = reinterpret_cast<uint8_t*>(pDst);
+    uint8_t* pOutBegin = pOut;
+    uint8_t* pOutEnd = pOut + size;
+
+    auto readLength = [&](uint32_t& length) {
+        uint8_t byte = 255;
+        while (byte == 255)
+        {
+            if (p >= pEnd || length > size)
+                return false;
+
+            byte = *p++;
+            length += byte;
+        }
+        return true;
+    };
+
+    while (p < pEnd)
+    {
+        uint8_t token = *p++;
+
+        uint32_t literalLength = token >> 4;
+        if (literalLength == 15 && !readLength(literalLength))
+            return false;
+
+        if (literalLength > (size_t)(pEnd - p) || literalLength > (size_t)(pOutEnd - pOut))
+            return false;
+
+        memcpy(pOut, p, literalLength);
+        p += literalLength;
+        pOut += literalLength;
+
+        // The last sequence has no match.
+        if (p == pEnd)
+            break;
+
+        if (pEnd - p < 2)
+            return false;
+
+        uint32_t offset = p[0] | (p[1] << 8);
+        p += 2;
+        if (offset == 0 || offset > (size_t)(pOut - pOutBegin))
+            return false;
+
+        uint32_t matchLength = token & 15;
+        if (matchLength == 15 && !readLength(matchLength))
+            return false;
+
+        matchLength += MIN_MATCH;
+        if (matchLength > (size_t)(pOutEnd - pOut))
+            return false;
+
+        // Overlapping matches repeat the last offset bytes, so they copy forward byte by byte.
+        const uint8_t* pMatch = pOut - offset;
+        if (offset >= matchLength)
+            memcpy(pOut, pMatch, matchLength);
+        else
+        {
+            for (uint32_t i = 0; i < matchLength; i++)
+                pOut[i] = pMatch[i];
+        }
+        pOut += matchLength;
+    }
+
+    return pOut == pOutEnd;
+}
+
+uint32_t LZ4::Hash(uint32_t sequence)
+{
+    return (sequence * 2654435761u) >> (32 - HASH_BITS);
+}
+
+uint32_t LZ4::Read32(const uint8_t* p)
+{
+    uint32_t value;
+    memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+uint8_t* LZ4::WriteLength(uint8_t* p, uint32_t length)
+{
+    while (length >= 255)
+    {
+        *p++ = 255;
+        length -= 255;
+    }
+    *p++ = (uint8_t)length;
+
+    return p;
+}
\ No newline at end of file
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <stdint.h>
+
+// LZ4 block format, see https://github.com/lz4/lz4/blob/dev/doc/lz4_Block_format.md. The
+// compressor is greedy with a single hash table, which is plenty for cooking assets offline.
+// The decoder checks every length against both buffers, so damaged files fail instead of
+// reading or writing out of bounds.
+class LZ4
+{
+public:
+    // Worst case compressed size, for incompressible input.
+    static uint32_t CompressBound(uint32_t size);
+
+    // Returns the compressed size, 0 when it would not fit in capacity.
+    static uint32_t Compress(const char* pSrc, uint32_t size, char* pDst, uint32_t capacity);
+
+    // True when pSrc decodes to exactly size bytes.
+    static bool Decompress(const char* pSrc, uint32_t compressedSize, char* pDst, uint32_t size);
+
+private:
+    constexpr static uint32_t HASH_BITS = 12;
+    constexpr static uint32_t MIN_MATCH = 4;
+    constexpr static uint32_t MAX_OFFSET = 65535;
+    // The format ends with at least 5 literals and no match starts in the last 12 bytes.
+    constexpr static uint32_t LAST_LITERALS = 5;
+    constexpr static uint32_t MATCH_LIMIT = 12;
+
+    static uint32_t Hash(uint32_t sequence);
+    static uint32_t Read32(const uint8_t* p);
+    // Writes the 255 byte extension of a length whose nibble is saturated.
+    static uint8_t* WriteLength(uint8_t* p, uint32_t length);
+};
\ No newline at end of file
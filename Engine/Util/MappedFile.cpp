@@ -0,0 +1,136 @@
+#include <assert.h>
+
+#if defined(_WIN32)
+    #define WIN32_LEAN_AND_MEAN
+    #define NOMINMAX
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+#include "MappedFile.h"
+
+#if defined(_WIN32)
+MappedFile::MappedFile() : m_pData(nullptr), m_size(0), m_hFile(INVALID_HANDLE_VALUE), m_hMapping(nullptr)
+#else
+MappedFile::MappedFile() : m_pData(nullptr), m_size(0)
+#endif
+{
+}
+
+MappedFile::~MappedFile()
+{
+    Unmap();
+}
+
+std::shared_ptr<MappedFile> MappedFile::Open(const std::string& path)
+{
+    std::shared_ptr<MappedFile> pFile(new MappedFile());
+    if (!pFile->Map(path))
+        return nullptr;
+
+    return pFile;
+}
+
+char* MappedFile::GetData() const
+{
+    return m_pData;
+}
+
+uint64_t MappedFile::GetSize() const
+{
+    return m_size;
+}
+
+std::shared_ptr<char> MappedFile::GetView(uint64_t offset)
+{
+    assert(offset <= m_size);
+    return std::shared_ptr<char>(shared_from_this(), m_pData + offset);
+}
+
+void MappedFile::Prefetch(uint64_t offset, uint64_t size) const
+{
+    const uint64_t pageSize = 4096;
+
+    uint64_t end = offset + size < m_size ? offset + size : m_size;
+    volatile char sink = 0;
+    for (uint64_t i = offset; i < end; i += pageSize)
+        sink = sink + m_pData[i];
+}
+
+#if defined(_WIN32)
+bool MappedFile::Map(const std::string& path)
+{
+    HANDLE hFile = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (hFile == INVALID_HANDLE_VALUE)
+        return false;
+    m_hFile = hFile;
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(hFile, &size) || size.QuadPart == 0)
+        return false;
+
+    HANDLE hMapping = CreateFileMappingA(hFile, nullptr, PAGE_WRITECOPY, 0, 0, nullptr);
+    if (hMapping == nullptr)
+        return false;
+    m_hMapping = hMapping;
+
+    m_pData = static_cast<char*>(MapViewOfFile(hMapping, FILE_MAP_COPY, 0, 0, 0));
+    if (m_pData == nullptr)
+        return false;
+
+    m_size = (uint64_t)size.QuadPart;
+    return true;
+}
+
+void MappedFile::Unmap()
+{
+    if (m_pData != nullptr)
+        UnmapViewOfFile(m_pData);
+    if (m_hMapping != nullptr)
+        CloseHandle(m_hMapping);
+    if (m_hFile != INVALID_HANDLE_VALUE)
+        CloseHandle(m_hFile);
+
+    m_pData = nullptr;
+    m_hMapping = nullptr;
+    m_hFile = INVALID_HANDLE_VALUE;
+    m_size = 0;
+}
+#else
+bool MappedFile::Map(const std::string& path)
+{
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+        return false;
+
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size == 0)
+    {
+        close(fd);
+        return false;
+    }
+
+    // The mapping keeps its own reference to the file.
+    void* pData = mmap(nullptr, (size_t)info.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (pData == MAP_FAILED)
+        return false;
+
+    m_pData = static_cast<char*>(pData);
+    m_size = (uint64_t)info.st_size;
+    return true;
+}
+
+void MappedFile::Unmap()
+{
+    if (m_pData != nullptr)
+        munmap(m_pData, (size_t)m_size);
+
+    m_pData = nullptr;
+    m_size = 0;
+}
+#endif
\ No newline at end of file
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <stdint.h>
+
+// Read-only file mapping. Pages are copy-on-write, so views may be handed out as mutable char
+// pointers without ever touching the file on disk.
+class MappedFile : public std::enable_shared_from_this<MappedFile>
+{
+public:
+    // Returns nullptr when the file can not be opened or is empty.
+    static std::shared_ptr<MappedFile> Open(const std::string& path);
+
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    char* GetData() const;
+    uint64_t GetSize() const;
+
+    // Pointer to data + offset sharing ownership of the mapping, which stays alive until the last view is released.
+    std::shared_ptr<char> GetView(uint64_t offset);
+
+    // Faults in the pages of [offset, offset + size) on the calling thread, so a worker pays for the
+    // disk read instead of whoever touches the data first.
+    void Prefetch(uint64_t offset, uint64_t size) const;
+
+private:
+    MappedFile();
+
+    bool Map(const std::string& path);
+    void Unmap();
+
+private:
+    char* m_pData;
+    uint64_t m_size;
+
+#if defined(_WIN32)
+    void* m_hFile;
+    void* m_hMapping;
+#endif
+};
\ No newline at end of file
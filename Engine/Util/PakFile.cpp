@@ -0,0 +1,218 @@
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <string.h>
+
+#include "Hash64.h"
+#include "LZ4.h"
+#include "PakFile.h"
+
+PakFile::PakFile() : m_pNames(nullptr)
+{
+}
+
+bool PakFile::Write(const std::string& path, const std::vector<Source>& sources, bool bCompress)
+{
+    auto align = [](uint64_t offset, uint64_t alignment) { return (offset + alignment - 1) & ~(alignment - 1); };
+
+    std::vector<Entry> entries(sources.size());
+    std::vector<std::shared_ptr<MappedFile>> pFiles(sources.size());
+    std::vector<std::vector<char>> compressed(sources.size());
+    std::string names;
+
+    for (uint32_t i = 0; i < sources.size(); i++)
+    {
+        const auto& source = sources[i];
+
+        // Empty files can not be mapped but are valid entries.
+        std::error_code error;
+        uint64_t size = std::filesystem::file_size(source.path, error);
+        if (error)
+            return false;
+
+        if (size > 0)
+        {
+            pFiles[i] = MappedFile::Open(source.path);
+            if (pFiles[i] == nullptr)
+                return false;
+        }
+
+        entries[i] = Entry { HashName(source.name), 0, size, size, (uint32_t)names.size(), (uint32_t)source.name.size() };
+        names += source.name;
+
+        if (!bCompress || size == 0 || size > UINT32_MAX)
+            continue;
+
+        std::vector<char> data(LZ4::CompressBound((uint32_t)size));
+        uint32_t compressedSize = LZ4::Compress(pFiles[i]->GetData(), (uint32_t)size, data.data(), (uint32_t)data.size());
+        if (compressedSize == 0 || compressedSize > size * MAX_COMPRESSED_RATIO)
+            continue;
+
+        data.resize(compressedSize);
+        compressed[i].swap(data);
+        entries[i].storedSize = compressedSize;
+    }
+
+    // The table is sorted for lookups, the data keeps the order of sources.
+    std::vector<uint32_t> table(entries.size());
+    for (uint32_t i = 0; i < table.size(); i++)
+        table[i] = i;
+
+    std::sort(table.begin(), table.end(), [&](uint32_t a, uint32_t b) {
+        if (entries[a].nameHash != entries[b].nameHash)
+            return entries[a].nameHash < entries[b].nameHash;
+        return sources[a].name < sources[b].name;
+    });
+
+    for (uint32_t i = 1; i < table.size(); i++)
+    {
+        if (sources[table[i - 1]].name == sources[table[i]].name)
+            return false;
+    }
+
+    uint64_t offset = sizeof(Header) + entries.size() * sizeof(Entry) + names.size();
+    for (auto& entry : entries)
+    {
+        offset = align(offset, entry.storedSize < entry.size ? COMPRESSED_ALIGNMENT : PAGE_ALIGNMENT);
+        entry.offset = offset;
+        offset += entry.storedSize;
+    }
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file)
+        return false;
+
+    uint64_t position = 0;
+    auto write = [&](const void* pData, uint64_t size) {
+        file.write(reinterpret_cast<const char*>(pData), size);
+        position += size;
+    };
+
+    Header header = { MAGIC, VERSION, (uint32_t)entries.size(), (uint32_t)names.size() };
+    write(&header, sizeof(header));
+    for (auto i : table)
+        write(&entries[i], sizeof(Entry));
+    write(names.data(), names.size());
+
+    static const char zeros[PAGE_ALIGNMENT] = {};
+    for (uint32_t i = 0; i < entries.size(); i++)
+    {
+        write(zeros, entries[i].offset - position);
+        if (!compressed[i].empty())
+            write(compressed[i].data(), compressed[i].size());
+        else if (pFiles[i] != nullptr)
+            write(pFiles[i]->GetData(), entries[i].size);
+    }
+
+    return (bool)file;
+}
+
+std::shared_ptr<PakFile> PakFile::Open(const std::string& path)
+{
+    auto pFile = MappedFile::Open(path);
+    if (pFile == nullptr || pFile->GetSize() < sizeof(Header))
+        return nullptr;
+
+    Header header;
+    memcpy(&header, pFile->GetData(), sizeof(header));
+    if (header.magic != MAGIC || header.version != VERSION)
+        return nullptr;
+
+    uint64_t namesOffset = sizeof(Header) + (uint64_t)header.entryCount * sizeof(Entry);
+    uint64_t tableEnd = namesOffset + header.namesSize;
+    if (tableEnd > pFile->GetSize())
+        return nullptr;
+
+    std::shared_ptr<PakFile> pPak(new PakFile());
+    pPak->m_entries.resize(header.entryCount);
+    memcpy(pPak->m_entries.data(), pFile->GetData() + sizeof(Header), header.entryCount * sizeof(Entry));
+
+    for (uint32_t i = 0; i < header.entryCount; i++)
+    {
+        const auto& entry = pPak->m_entries[i];
+        if ((uint64_t)entry.nameOffset + entry.nameLength > header.namesSize || entry.storedSize > entry.size ||
+            (entry.storedSize < entry.size && entry.size > UINT32_MAX) ||
+            entry.offset < tableEnd || entry.offset + entry.storedSize > pFile->GetSize() || entry.offset + entry.storedSize < entry.offset)
+            return nullptr;
+
+        if (i > 0 && pPak->m_entries[i - 1].nameHash > entry.nameHash)
+            return nullptr;
+    }
+
+    pPak->m_pFile = pFile;
+    pPak->m_pNames = pFile->GetData() + namesOffset;
+
+    return pPak;
+}
+
+bool PakFile::Contains(const std::string& name) const
+{
+    return Find(name) != nullptr;
+}
+
+bool PakFile::GetSize(const std::string& name, uint64_t& size) const
+{
+    auto pEntry = Find(name);
+    if (pEntry == nullptr)
+        return false;
+
+    size = pEntry->size;
+    return true;
+}
+
+std::shared_ptr<char> PakFile::Read(const std::string& name, uint64_t& size)
+{
+    auto pEntry = Find(name);
+    if (pEntry == nullptr)
+        return nullptr;
+
+    size = pEntry->size;
+    if (pEntry->storedSize == pEntry->size)
+        return m_pFile->GetView(pEntry->offset);
+
+    char* pData = new char[pEntry->size];
+    std::shared_ptr<char> pDecoded(pData, std::default_delete<char[]>());
+    if (!LZ4::Decompress(m_pFile->GetData() + pEntry->offset, (uint32_t)pEntry->storedSize, pData, (uint32_t)pEntry->size))
+        return nullptr;
+
+    return pDecoded;
+}
+
+bool PakFile::Read(const std::string& name, void* pDst, uint64_t size) const
+{
+    auto pEntry = Find(name);
+    if (pEntry == nullptr || pEntry->size != size)
+        return false;
+
+    if (pEntry->storedSize == pEntry->size)
+    {
+        memcpy(pDst, m_pFile->GetData() + pEntry->offset, size);
+        return true;
+    }
+
+    return LZ4::Decompress(m_pFile->GetData() + pEntry->offset, (uint32_t)pEntry->storedSize, static_cast<char*>(pDst), (uint32_t)size);
+}
+
+uint32_t PakFile::GetEntryCount() const
+{
+    return (uint32_t)m_entries.size();
+}
+
+uint64_t PakFile::HashName(const std::string& name)
+{
+    return Hash64::Compute(name.data(), name.size());
+}
+
+const PakFile::Entry* PakFile::Find(const std::string& name) const
+{
+    uint64_t hash = HashName(name);
+    auto it = std::lower_bound(m_entries.begin(), m_entries.end(), hash, [](const Entry& entry, uint64_t value) { return entry.nameHash < value; });
+
+    for (; it != m_entries.end() && it->nameHash == hash; ++it)
+    {
+        if (it->nameLength == name.size() && memcmp(m_pNames + it->nameOffset, name.data(), name.size()) == 0)
+            return &*it;
+    }
+
+    return nullptr;
+}
\ No newline at end of file
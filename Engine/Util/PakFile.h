@@ -0,0 +1,77 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+#include <stdint.h>
+
+#include "MappedFile.h"
+
+// Asset archive (.ntpak): a header, a table of contents sorted by name hash, the names, then the
+// entries in the order they were packed. Stored entries start page aligned, so their views can be
+// handed to an upload as is; entries that LZ4 shrinks enough are stored compressed and decoded on
+// read. The whole archive is mapped once.
+class PakFile
+{
+public:
+    constexpr static uint32_t MAGIC = 0x4b41504e;   // "NPAK"
+    constexpr static uint32_t VERSION = 1;
+    constexpr static uint64_t PAGE_ALIGNMENT = 4096;
+    constexpr static uint64_t COMPRESSED_ALIGNMENT = 16;
+    constexpr static float MAX_COMPRESSED_RATIO = 0.875f;
+
+    struct Source
+    {
+        // Entry name, '/' separated and relative to the archive root.
+        std::string name;
+        std::string path;
+    };
+
+    // Lays entries out in the order of sources, so put the ones read together first.
+    static bool Write(const std::string& path, const std::vector<Source>& sources, bool bCompress);
+
+    // Returns nullptr when the archive is missing or damaged.
+    static std::shared_ptr<PakFile> Open(const std::string& path);
+
+    bool Contains(const std::string& name) const;
+    bool GetSize(const std::string& name, uint64_t& size) const;
+
+    // A view into the mapping for stored entries, a decoded copy for compressed ones. nullptr when
+    // the entry is missing or does not decode. Views are shared by every reader, never write to them.
+    std::shared_ptr<char> Read(const std::string& name, uint64_t& size);
+    // Copies or decodes the entry into pDst, which holds exactly its size, e.g. a mapped upload buffer.
+    bool Read(const std::string& name, void* pDst, uint64_t size) const;
+
+    uint32_t GetEntryCount() const;
+
+    static uint64_t HashName(const std::string& name);
+
+private:
+    struct Header
+    {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t entryCount;
+        uint32_t namesSize;
+    };
+
+    // storedSize < size means the entry is LZ4 compressed.
+    struct Entry
+    {
+        uint64_t nameHash;
+        uint64_t offset;
+        uint64_t size;
+        uint64_t storedSize;
+        uint32_t nameOffset;
+        uint32_t nameLength;
+    };
+
+    PakFile();
+
+    const Entry* Find(const std::string& name) const;
+
+private:
+    std::shared_ptr<MappedFile> m_pFile;
+    std::vector<Entry> m_entries;
+    const char* m_pNames;
+};
\ No newline at end of file
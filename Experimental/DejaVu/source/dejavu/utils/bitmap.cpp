@@ -1,12 +1,441 @@
 #include "utils/bitmap.h"
 #include "utils/strings.h"
 #include <cassert>
+#include <cmath>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <algorithm>
 #include <stb_image.h>
 #include <stb_image_write.h>
 #include <stb_image_resize.h>
 
+#if defined(__x86_64__) || defined(_M_X64)
+#    define DJV_BITMAP_SSE2
+#    include <emmintrin.h>
+#    include <tmmintrin.h>
+// SSE2 is part of x64, SSSE3 is not: its kernels are compiled for it on their own and picked at run time.
+#    if defined(_MSC_VER)
+#        include <intrin.h>
+#    endif
+#    if defined(__GNUC__) || defined(__clang__)
+#        define DJV_BITMAP_TARGET_SSSE3 __attribute__((target("ssse3")))
+#    else
+#        define DJV_BITMAP_TARGET_SSSE3
+#    endif
+#endif
+
 namespace djv
 {
+    namespace
+    {
+        // Output rows resized per stb call, a thread works on one band at a time.
+        constexpr int kResizeBandRows = 64;
+
+        size_t bytes_count(int width, int height, int channels, bool floatdata)
+        {
+            return (size_t)width * height * channels * (floatdata ? sizeof(float) : sizeof(char));
+        }
+
+        bool has_alpha(int channels)
+        {
+            return channels == 2 || channels == 4;
+        }
+
+        template<typename Func>
+        void parallel_for(int count, int threads, Func&& func)
+        {
+            if (count <= 0)
+                return;
+
+            if (threads <= 0)
+                threads = (int)std::thread::hardware_concurrency();
+            threads = std::clamp(threads, 1, count);
+
+            std::atomic<int> next = 0;
+            auto worker = [&]() {
+                for (int i = next++; i < count; i = next++)
+                    func(i);
+            };
+
+            std::vector<std::thread> pool;
+            for (int i = 1; i < threads; i++)
+                pool.emplace_back(worker);
+
+            worker();
+            for (auto& thread : pool)
+                thread.join();
+        }
+
+        float srgb_to_linear(float value)
+        {
+            return value <= 0.04045f ? value / 12.92f : std::pow((value + 0.055f) / 1.055f, 2.4f);
+        }
+
+        float linear_to_srgb(float value)
+        {
+            return value <= 0.0031308f ? value * 12.92f : 1.055f * std::pow(value, 1.0f / 2.4f) - 0.055f;
+        }
+
+        const std::array<float, 256>& srgb_decode_table()
+        {
+            static const std::array<float, 256> table = []() {
+                std::array<float, 256> values;
+                for (int i = 0; i < 256; i++)
+                    values[i] = srgb_to_linear(i / 255.0f);
+                return values;
+            }();
+            return table;
+        }
+
+#if defined(DJV_BITMAP_SSE2)
+        __m128 select_ps(__m128 mask, __m128 a, __m128 b)
+        {
+            return _mm_or_ps(_mm_and_ps(mask, b), _mm_andnot_ps(mask, a));
+        }
+
+        // Lanes of four interleaved floats that hold alpha, rows always start on a pixel.
+        __m128 alpha_lanes(int channels)
+        {
+            if (channels == 4)
+                return _mm_castsi128_ps(_mm_setr_epi32(0, 0, 0, -1));
+            if (channels == 2)
+                return _mm_castsi128_ps(_mm_setr_epi32(0, -1, 0, -1));
+            return _mm_setzero_ps();
+        }
+
+        // For x > 0, log2 of the mantissa from its atanh series.
+        __m128 log2_ps(__m128 x)
+        {
+            const __m128 one = _mm_set1_ps(1.0f);
+            __m128i bits = _mm_castps_si128(_mm_max_ps(x, _mm_set1_ps(1e-30f)));
+            __m128 exponent = _mm_cvtepi32_ps(_mm_sub_epi32(_mm_srli_epi32(bits, 23), _mm_set1_epi32(127)));
+            __m128 mantissa = _mm_castsi128_ps(_mm_or_si128(_mm_and_si128(bits, _mm_set1_epi32(0x007FFFFF)), _mm_set1_epi32(0x3F800000)));
+
+            // Mantissas in [sqrt(0.5), sqrt(2)) keep the series short.
+            __m128 large = _mm_cmpgt_ps(mantissa, _mm_set1_ps(1.41421356f));
+            mantissa = select_ps(large, mantissa, _mm_mul_ps(mantissa, _mm_set1_ps(0.5f)));
+            exponent = _mm_add_ps(exponent, _mm_and_ps(large, one));
+
+            __m128 t = _mm_div_ps(_mm_sub_ps(mantissa, one), _mm_add_ps(mantissa, one));
+            __m128 t2 = _mm_mul_ps(t, t);
+            __m128 p = _mm_set1_ps(1.0f / 9.0f);
+            p = _mm_add_ps(_mm_mul_ps(p, t2), _mm_set1_ps(1.0f / 7.0f));
+            p = _mm_add_ps(_mm_mul_ps(p, t2), _mm_set1_ps(1.0f / 5.0f));
+            p = _mm_add_ps(_mm_mul_ps(p, t2), _mm_set1_ps(1.0f / 3.0f));
+            p = _mm_add_ps(_mm_mul_ps(p, t2), one);
+            return _mm_add_ps(exponent, _mm_mul_ps(_mm_mul_ps(p, t), _mm_set1_ps(2.8853900817779268f)));
+        }
+
+        // 2^n times a Taylor series of 2^f for f in [-0.5, 0.5].
+        __m128 exp2_ps(__m128 x)
+        {
+            x = _mm_min_ps(_mm_max_ps(x, _mm_set1_ps(-126.0f)), _mm_set1_ps(126.0f));
+            __m128i n = _mm_cvtps_epi32(x);
+            __m128 z = _mm_mul_ps(_mm_sub_ps(x, _mm_cvtepi32_ps(n)), _mm_set1_ps(0.6931471805599453f));
+
+            __m128 p = _mm_set1_ps(1.0f / 720.0f);
+            p = _mm_add_ps(_mm_mul_ps(p, z), _mm_set1_ps(1.0f / 120.0f));
+            p = _mm_add_ps(_mm_mul_ps(p, z), _mm_set1_ps(1.0f / 24.0f));
+            p = _mm_add_ps(_mm_mul_ps(p, z), _mm_set1_ps(1.0f / 6.0f));
+            p = _mm_add_ps(_mm_mul_ps(p, z), _mm_set1_ps(0.5f));
+            p = _mm_add_ps(_mm_mul_ps(p, z), _mm_set1_ps(1.0f));
+            p = _mm_add_ps(_mm_mul_ps(p, z), _mm_set1_ps(1.0f));
+            return _mm_mul_ps(p, _mm_castsi128_ps(_mm_slli_epi32(_mm_add_epi32(n, _mm_set1_epi32(127)), 23)));
+        }
+
+        __m128 srgb_to_linear_ps(__m128 x)
+        {
+            __m128 low = _mm_div_ps(x, _mm_set1_ps(12.92f));
+            __m128 base = _mm_div_ps(_mm_add_ps(x, _mm_set1_ps(0.055f)), _mm_set1_ps(1.055f));
+            __m128 high = exp2_ps(_mm_mul_ps(log2_ps(base), _mm_set1_ps(2.4f)));
+            return select_ps(_mm_cmple_ps(x, _mm_set1_ps(0.04045f)), high, low);
+        }
+
+        __m128 linear_to_srgb_ps(__m128 x)
+        {
+            __m128 low = _mm_mul_ps(x, _mm_set1_ps(12.92f));
+            __m128 high = exp2_ps(_mm_mul_ps(log2_ps(x), _mm_set1_ps(1.0f / 2.4f)));
+            high = _mm_sub_ps(_mm_mul_ps(high, _mm_set1_ps(1.055f)), _mm_set1_ps(0.055f));
+            return select_ps(_mm_cmple_ps(x, _mm_set1_ps(0.0031308f)), high, low);
+        }
+#endif
+
+        void u8_to_f32_row(const uint8_t* src, float* dst, int count, int channels, bool srgb)
+        {
+            if (srgb)
+            {
+                const auto& table = srgb_decode_table();
+                const int alpha = has_alpha(channels) ? channels - 1 : channels;
+                for (int i = 0, c = 0; i < count; i++, c = c + 1 == channels ? 0 : c + 1)
+                    dst[i] = c == alpha ? src[i] * (1.0f / 255.0f) : table[src[i]];
+                return;
+            }
+
+            int i = 0;
+#if defined(DJV_BITMAP_SSE2)
+            const __m128 scale = _mm_set1_ps(1.0f / 255.0f);
+            const __m128i zero = _mm_setzero_si128();
+            for (; i + 16 <= count; i += 16)
+            {
+                __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+                __m128i low = _mm_unpacklo_epi8(bytes, zero);
+                __m128i high = _mm_unpackhi_epi8(bytes, zero);
+                _mm_storeu_ps(dst + i, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(low, zero)), scale));
+                _mm_storeu_ps(dst + i + 4, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(low, zero)), scale));
+                _mm_storeu_ps(dst + i + 8, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(high, zero)), scale));
+                _mm_storeu_ps(dst + i + 12, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(high, zero)), scale));
+            }
+#endif
+            for (; i < count; i++)
+                dst[i] = src[i] * (1.0f / 255.0f);
+        }
+
+        void f32_to_u8_row(const float* src, uint8_t* dst, int count, int channels, bool srgb)
+        {
+            int i = 0;
+#if defined(DJV_BITMAP_SSE2)
+            const __m128 alpha = alpha_lanes(channels);
+            const __m128 zero = _mm_setzero_ps();
+            const __m128 one = _mm_set1_ps(1.0f);
+            const __m128 scale = _mm_set1_ps(255.0f);
+            for (; i + 16 <= count; i += 16)
+            {
+                __m128i words[4];
+                for (int k = 0; k < 4; k++)
+                {
+                    __m128 value = _mm_loadu_ps(src + i + k * 4);
+                    if (srgb)
+                        value = select_ps(alpha, linear_to_srgb_ps(value), value);
+                    value = _mm_min_ps(_mm_max_ps(value, zero), one);
+                    words[k] = _mm_cvtps_epi32(_mm_mul_ps(value, scale));
+                }
+
+                __m128i bytes = _mm_packus_epi16(_mm_packs_epi32(words[0], words[1]), _mm_packs_epi32(words[2], words[3]));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), bytes);
+            }
+#endif
+            const int alphaChannel = has_alpha(channels) ? channels - 1 : channels;
+            for (; i < count; i++)
+            {
+                float value = srgb && i % channels != alphaChannel ? linear_to_srgb(src[i]) : src[i];
+                dst[i] = (uint8_t)std::nearbyint(std::clamp(value, 0.0f, 1.0f) * 255.0f);
+            }
+        }
+
+        void transfer_row(float* row, int count, int channels, bool encode)
+        {
+            int i = 0;
+#if defined(DJV_BITMAP_SSE2)
+            const __m128 alpha = alpha_lanes(channels);
+            for (; i + 4 <= count; i += 4)
+            {
+                __m128 value = _mm_loadu_ps(row + i);
+                __m128 converted = encode ? linear_to_srgb_ps(value) : srgb_to_linear_ps(value);
+                _mm_storeu_ps(row + i, select_ps(alpha, converted, value));
+            }
+#endif
+            const int alphaChannel = has_alpha(channels) ? channels - 1 : channels;
+            for (; i < count; i++)
+            {
+                if (i % channels != alphaChannel)
+                    row[i] = encode ? linear_to_srgb(row[i]) : srgb_to_linear(row[i]);
+            }
+        }
+
+        // Rounds c * a / 255 to nearest, exactly.
+        uint8_t multiply_u8(int c, int a)
+        {
+            int x = c * a + 128;
+            return (uint8_t)((x + (x >> 8)) >> 8);
+        }
+
+        void premultiply_u8_row(uint8_t* row, int width, int channels)
+        {
+            int x = 0;
+#if defined(DJV_BITMAP_SSE2)
+            if (channels == 4)
+            {
+                // Alpha is multiplied by 255 and so stays as it is.
+                const __m128i keepAlpha = _mm_setr_epi16(0, 0, 0, 255, 0, 0, 0, 255);
+                const __m128i alphaLanes = _mm_setr_epi16(0, 0, 0, -1, 0, 0, 0, -1);
+                const __m128i bias = _mm_set1_epi16(128);
+                const __m128i zero = _mm_setzero_si128();
+                for (; x + 4 <= width; x += 4)
+                {
+                    __m128i pixels = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row + x * 4));
+                    __m128i halves[2] = { _mm_unpacklo_epi8(pixels, zero), _mm_unpackhi_epi8(pixels, zero) };
+                    for (auto& half : halves)
+                    {
+                        __m128i alpha = _mm_shufflehi_epi16(_mm_shufflelo_epi16(half, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+                        alpha = _mm_or_si128(_mm_andnot_si128(alphaLanes, alpha), keepAlpha);
+                        __m128i product = _mm_add_epi16(_mm_mullo_epi16(half, alpha), bias);
+                        half = _mm_srli_epi16(_mm_add_epi16(product, _mm_srli_epi16(product, 8)), 8);
+                    }
+                    _mm_storeu_si128(reinterpret_cast<__m128i*>(row + x * 4), _mm_packus_epi16(halves[0], halves[1]));
+                }
+            }
+#endif
+            for (; x < width; x++)
+            {
+                uint8_t* pixel = row + x * channels;
+                for (int c = 0; c < channels - 1; c++)
+                    pixel[c] = multiply_u8(pixel[c], pixel[channels - 1]);
+            }
+        }
+
+        void premultiply_f32_row(float* row, int width, int channels)
+        {
+            int x = 0;
+#if defined(DJV_BITMAP_SSE2)
+            if (channels == 4)
+            {
+                const __m128 alphaLane = alpha_lanes(4);
+                for (; x < width; x++)
+                {
+                    __m128 pixel = _mm_loadu_ps(row + x * 4);
+                    __m128 alpha = select_ps(alphaLane, _mm_shuffle_ps(pixel, pixel, _MM_SHUFFLE(3, 3, 3, 3)), _mm_set1_ps(1.0f));
+                    _mm_storeu_ps(row + x * 4, _mm_mul_ps(pixel, alpha));
+                }
+            }
+#endif
+            for (; x < width; x++)
+            {
+                float* pixel = row + x * channels;
+                for (int c = 0; c < channels - 1; c++)
+                    pixel[c] *= pixel[channels - 1];
+            }
+        }
+
+        template<typename T>
+        void swizzle_row(T* row, int width, int channels, const std::array<int, 4>& order)
+        {
+            for (int x = 0; x < width; x++)
+            {
+                T* pixel = row + x * channels;
+                T source[4] = {};
+                std::copy(pixel, pixel + channels, source);
+                for (int c = 0; c < channels; c++)
+                    pixel[c] = source[order[c]];
+            }
+        }
+
+#if defined(DJV_BITMAP_SSE2)
+        bool has_ssse3()
+        {
+            static const bool supported = [] {
+#    if defined(_MSC_VER)
+                int info[4];
+                __cpuid(info, 1);
+                return (info[2] & (1 << 9)) != 0;
+#    else
+                return __builtin_cpu_supports("ssse3") != 0;
+#    endif
+            }();
+            return supported;
+        }
+
+        // Four pixels per pshufb, returns how many pixels it swizzled.
+        DJV_BITMAP_TARGET_SSSE3 int swizzle_rgba8_ssse3(uint8_t* row, int width, const std::array<int, 4>& order)
+        {
+            alignas(16) int8_t indices[16];
+            for (int i = 0; i < 16; i++)
+                indices[i] = (int8_t)(i / 4 * 4 + order[i % 4]);
+
+            const __m128i shuffle = _mm_load_si128(reinterpret_cast<const __m128i*>(indices));
+            int x = 0;
+            for (; x + 4 <= width; x += 4)
+            {
+                __m128i* pixels = reinterpret_cast<__m128i*>(row + x * 4);
+                _mm_storeu_si128(pixels, _mm_shuffle_epi8(_mm_loadu_si128(pixels), shuffle));
+            }
+            return x;
+        }
+#endif
+
+        void swizzle_u8_row(uint8_t* row, int width, int channels, const std::array<int, 4>& order)
+        {
+            int x = 0;
+#if defined(DJV_BITMAP_SSE2)
+            if (channels == 4 && has_ssse3())
+                x = swizzle_rgba8_ssse3(row, width, order);
+#endif
+            swizzle_row(row + x * channels, width - x, channels, order);
+        }
+    }
+
+    BitmapView::BitmapView(void* data, int width, int height, int channels, bool floatdata, std::ptrdiff_t stride)
+        : mData(static_cast<uint8_t*>(data))
+        , mWidth(width)
+        , mHeight(height)
+        , mChannels(channels)
+        , mIsFloatData(floatdata)
+        , mStride(stride != 0 ? stride : (std::ptrdiff_t)width * channels * (floatdata ? sizeof(float) : sizeof(char)))
+    {
+    }
+
+    BitmapView BitmapView::subview(int x, int y, int width, int height) const
+    {
+        x = std::clamp(x, 0, mWidth);
+        y = std::clamp(y, 0, mHeight);
+        width = std::clamp(width, 0, mWidth - x);
+        height = std::clamp(height, 0, mHeight - y);
+
+        return BitmapView(width > 0 && height > 0 ? pixel(x, y) : nullptr, width, height, mChannels, mIsFloatData, mStride);
+    }
+
+    void* BitmapView::data() const
+    {
+        return mData;
+    }
+
+    void* BitmapView::row(int y) const
+    {
+        assert(y >= 0 && y < mHeight);
+        return mData + y * mStride;
+    }
+
+    void* BitmapView::pixel(int x, int y) const
+    {
+        assert(x >= 0 && x < mWidth);
+        return static_cast<uint8_t*>(row(y)) + x * pixelSize();
+    }
+
+    bool BitmapView::isFloat() const
+    {
+        return mIsFloatData;
+    }
+
+    bool BitmapView::empty() const
+    {
+        return mData == nullptr || mWidth <= 0 || mHeight <= 0;
+    }
+
+    int BitmapView::width() const
+    {
+        return mWidth;
+    }
+
+    int BitmapView::height() const
+    {
+        return mHeight;
+    }
+
+    int BitmapView::channels() const
+    {
+        return mChannels;
+    }
+
+    int BitmapView::pixelSize() const
+    {
+        return mChannels * (int)(mIsFloatData ? sizeof(float) : sizeof(char));
+    }
+
+    std::ptrdiff_t BitmapView::stride() const
+    {
+        return mStride;
+    }
+
     Bitmap::Bitmap(const std::string& path, int channels, bool floatdata)
         : mFilePath(path)
         , mChannels(channels)
@@ -17,19 +446,9 @@ namespace djv
 
     Bitmap::Bitmap(int width, int height, int channels, bool floatdata)
         : mFilePath(std::nullopt)
-        , mWidth(width)
-        , mHeight(height)
-        , mChannels(channels)
-        , mIsFloatData(floatdata)
         , mBytes(nullptr)
     {
-        int bytes_count = width * height * channels * (floatdata ? sizeof(float) : sizeof(char));
-        mBytes = std::shared_ptr<uint8_t>(new uint8_t[bytes_count], 
-                                          [&](const uint8_t* data) {
-                                              if (data) {
-                                                  delete[] data;
-                                              }
-                                          });
+        reset(width, height, channels, floatdata);
     }
 
     void Bitmap::setPath(const std::string& path)
@@ -77,30 +496,56 @@ namespace djv
             return false;
 
         uint8_t* bytes = nullptr;
+        // stb reports the channels of the file, the pixels have the ones asked for.
+        int file_channels = 0;
         mChannels = channels;
         mIsFloatData = floatdata;
 
         if (mIsFloatData)
         {
-            bytes = (uint8_t*)stbi_loadf_from_file(file, &mWidth, &mHeight, &mChannels, mChannels);
+            bytes = (uint8_t*)stbi_loadf_from_file(file, &mWidth, &mHeight, &file_channels, mChannels);
         }
         else
         {
-            bytes = (uint8_t*)stbi_load_from_file(file, &mWidth, &mHeight, &mChannels, mChannels);
+            bytes = (uint8_t*)stbi_load_from_file(file, &mWidth, &mHeight, &file_channels, mChannels);
         }
 
+        if (mChannels == 0)
+            mChannels = file_channels;
+
         mBytes = std::shared_ptr<uint8_t>(bytes,
                                           [&](const uint8_t* data) {
                                               if (data) {
                                                   stbi_image_free((void*)data);
                                               }
                                           });
+        mCapacity = bytes != nullptr ? bytes_count(mWidth, mHeight, mChannels, mIsFloatData) : 0;
         fclose(file);
         file = nullptr;
 
         return mBytes != nullptr;
     }
 
+    void Bitmap::reset(int width, int height, int channels, bool floatdata)
+    {
+        size_t size = bytes_count(width, height, channels, floatdata);
+        if (mBytes == nullptr || size > mCapacity)
+        {
+            mBytes = std::shared_ptr<uint8_t>(new uint8_t[size],
+                                              [&](const uint8_t* data) {
+                                                  if (data) {
+                                                      delete[] data;
+                                                  }
+                                              });
+            mCapacity = size;
+        }
+
+        mWidth = width;
+        mHeight = height;
+        mChannels = channels;
+        mIsFloatData = floatdata;
+    }
+
     std::string Bitmap::path() const
     {
         return mFilePath.has_value() ? mFilePath.value() : "";
@@ -116,6 +561,11 @@ namespace djv
         return mBytes.get();
     }
 
+    BitmapView Bitmap::view()
+    {
+        return BitmapView(mBytes.get(), mWidth, mHeight, mChannels, mIsFloatData);
+    }
+
     int Bitmap::width() const
     {
         return mWidth;
@@ -125,7 +575,7 @@ namespace djv
     {
         return mHeight;
     }
-    
+
     int Bitmap::channels() const
     {
         return mChannels;
@@ -135,4 +585,119 @@ namespace djv
     {
         return mIsFloatData;
     }
+
+    bool convert(const BitmapView& src, const BitmapView& dst, bool srgb)
+    {
+        if (src.empty() || dst.empty() || src.isFloat() == dst.isFloat() || src.channels() != dst.channels() ||
+            src.width() != dst.width() || src.height() != dst.height())
+            return false;
+
+        const int count = src.width() * src.channels();
+        for (int y = 0; y < src.height(); y++)
+        {
+            if (src.isFloat())
+                f32_to_u8_row(static_cast<const float*>(src.row(y)), static_cast<uint8_t*>(dst.row(y)), count, src.channels(), srgb);
+            else
+                u8_to_f32_row(static_cast<const uint8_t*>(src.row(y)), static_cast<float*>(dst.row(y)), count, src.channels(), srgb);
+        }
+
+        return true;
+    }
+
+    bool srgb_to_linear_inplace(const BitmapView& view)
+    {
+        if (view.empty() || !view.isFloat())
+            return false;
+
+        for (int y = 0; y < view.height(); y++)
+            transfer_row(static_cast<float*>(view.row(y)), view.width() * view.channels(), view.channels(), false);
+
+        return true;
+    }
+
+    bool linear_to_srgb_inplace(const BitmapView& view)
+    {
+        if (view.empty() || !view.isFloat())
+            return false;
+
+        for (int y = 0; y < view.height(); y++)
+            transfer_row(static_cast<float*>(view.row(y)), view.width() * view.channels(), view.channels(), true);
+
+        return true;
+    }
+
+    bool swizzle_inplace(const BitmapView& view, const std::array<int, 4>& order)
+    {
+        if (view.empty() || view.channels() > 4)
+            return false;
+
+        for (int c = 0; c < view.channels(); c++)
+        {
+            if (order[c] < 0 || order[c] >= view.channels())
+                return false;
+        }
+
+        for (int y = 0; y < view.height(); y++)
+        {
+            if (view.isFloat())
+                swizzle_row(static_cast<float*>(view.row(y)), view.width(), view.channels(), order);
+            else
+                swizzle_u8_row(static_cast<uint8_t*>(view.row(y)), view.width(), view.channels(), order);
+        }
+
+        return true;
+    }
+
+    bool premultiply_inplace(const BitmapView& view)
+    {
+        if (view.empty() || !has_alpha(view.channels()))
+            return false;
+
+        for (int y = 0; y < view.height(); y++)
+        {
+            if (view.isFloat())
+                premultiply_f32_row(static_cast<float*>(view.row(y)), view.width(), view.channels());
+            else
+                premultiply_u8_row(static_cast<uint8_t*>(view.row(y)), view.width(), view.channels());
+        }
+
+        return true;
+    }
+
+    bool resize(const BitmapView& src, const BitmapView& dst, bool srgb, int threads)
+    {
+        if (src.empty() || dst.empty() || src.isFloat() != dst.isFloat() || src.channels() != dst.channels())
+            return false;
+
+        const int channels = src.channels();
+        const int alpha = has_alpha(channels) ? channels - 1 : STBIR_ALPHA_CHANNEL_NONE;
+        const stbir_datatype type = src.isFloat() ? STBIR_TYPE_FLOAT : STBIR_TYPE_UINT8;
+        const stbir_colorspace space = srgb ? STBIR_COLORSPACE_SRGB : STBIR_COLORSPACE_LINEAR;
+        const int bands = (dst.height() + kResizeBandRows - 1) / kResizeBandRows;
+
+        // A band maps to the same rows of the source as a whole resize would, the filter still reads
+        // the source rows around them, so bands join without seams.
+        std::atomic<bool> succeeded = true;
+        parallel_for(bands, threads, [&](int band) {
+            // Handed to stb as its allocation context, see stb_image.cpp.
+            thread_local std::vector<uint8_t> scratch;
+
+            const int y0 = band * kResizeBandRows;
+            const int y1 = std::min(y0 + kResizeBandRows, dst.height());
+            const float t0 = (float)y0 / dst.height();
+            const float t1 = (float)y1 / dst.height();
+
+            int result = stbir_resize_region(src.data(), src.width(), src.height(), (int)src.stride(),
+                                             dst.row(y0), dst.width(), y1 - y0, (int)dst.stride(),
+                                             type, channels, alpha, 0,
+                                             STBIR_EDGE_CLAMP, STBIR_EDGE_CLAMP,
+                                             STBIR_FILTER_DEFAULT, STBIR_FILTER_DEFAULT,
+                                             space, &scratch,
+                                             0.0f, t0, 1.0f, t1);
+            if (result == 0)
+                succeeded = false;
+        });
+
+        return succeeded;
+    }
 }
\ No newline at end of file
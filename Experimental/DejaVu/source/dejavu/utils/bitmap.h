@@ -3,11 +3,48 @@
 #include <string>
 #include <memory>
 #include <optional>
+#include <array>
+#include <cstddef>
+#include <cstdint>
 #include "utils/preprocess.h"
 #include "utils/filesystem.h"
 
 namespace djv
 {
+    /*
+     * Non-owning window into 8-bit or float pixels: a whole bitmap, a sub-rectangle of one or any
+     * buffer with its own row stride. Copying a view never copies pixels, the memory must outlive it.
+    */
+    class DJV_API BitmapView
+    {
+    public:
+        BitmapView() = default;
+        // A stride of 0 means tightly packed rows.
+        BitmapView(void* data, int width, int height, int channels, bool floatdata, std::ptrdiff_t stride = 0);
+
+        // Shares the rows of this view, clipped to it.
+        BitmapView subview(int x, int y, int width, int height) const;
+
+        void* data() const;
+        void* row(int y) const;
+        void* pixel(int x, int y) const;
+        bool isFloat() const;
+        bool empty() const;
+        int width() const;
+        int height() const;
+        int channels() const;
+        int pixelSize() const;
+        std::ptrdiff_t stride() const;
+
+    private:
+        uint8_t* mData = nullptr;
+        int mWidth = 0;
+        int mHeight = 0;
+        int mChannels = 0;
+        bool mIsFloatData = false;
+        std::ptrdiff_t mStride = 0;
+    };
+
     /*
      * Supports: Auto, BMP, HDR, JPG, PNG, TGA.
     */
@@ -21,21 +58,50 @@ namespace djv
         void setData(int offset, int size, const void* data);
         void flush();
         bool load(const std::string& path, int channels, bool floatdata);
+        // Changes the size and format, the buffer is only reallocated when it has to grow.
+        void reset(int width, int height, int channels, bool floatdata);
 
         std::string path() const;
         const void* data() const;
         void* data();
+        BitmapView view();
         bool isFloat() const;
         int width() const;
         int height() const;
         int channels() const;
-        
+
     private:
         int mWidth = 0;
         int mHeight = 0;
         int mChannels = 0;
         bool mIsFloatData = false;
+        size_t mCapacity = 0;
         std::optional<std::string> mFilePath;
         std::shared_ptr<uint8_t> mBytes;
     };
+
+    /*
+     * Pixel operations on views. They work row by row, so sub-rectangles and padded rows need no
+     * copies, and use SSE on x64. The last channel of two and four channel bitmaps is straight alpha,
+     * which is never sRGB encoded. They return false for views they do not apply to.
+    */
+
+    // 8-bit to float or back, both the same size and channel count. With srgb the 8-bit side is sRGB
+    // encoded and the float side linear.
+    bool DJV_API convert(const BitmapView& src, const BitmapView& dst, bool srgb = false);
+
+    // Float views only.
+    bool DJV_API srgb_to_linear_inplace(const BitmapView& view);
+    bool DJV_API linear_to_srgb_inplace(const BitmapView& view);
+
+    // Channel i becomes what channel order[i] was, for the channels the view has.
+    bool DJV_API swizzle_inplace(const BitmapView& view, const std::array<int, 4>& order);
+
+    // Two and four channel views only.
+    bool DJV_API premultiply_inplace(const BitmapView& view);
+
+    // Resamples src into all of dst with stb_image_resize, in bands of rows spread over threads, 0
+    // for one per core. Each thread keeps the scratch memory of stb from band to band. Formats and
+    // channel counts must match.
+    bool DJV_API resize(const BitmapView& src, const BitmapView& dst, bool srgb = false, int threads = 0);
 }
\ No newline at end of file
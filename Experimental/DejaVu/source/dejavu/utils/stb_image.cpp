@@ -4,5 +4,29 @@
 #define STB_IMAGE_WRITE_IMPLEMENTATION
 #include <stb_image_write.h>
 
+#include <cstdlib>
+#include <vector>
+
+// djv::resize hands each band a std::vector<uint8_t> of its thread as the allocation context, which
+// keeps the memory from one band to the next. stb allocates once per call.
+static void* djv_stbir_malloc(size_t size, void* context)
+{
+    if (context == nullptr)
+        return std::malloc(size);
+
+    auto* scratch = static_cast<std::vector<unsigned char>*>(context);
+    if (scratch->size() < size)
+        scratch->resize(size);
+    return scratch->data();
+}
+
+static void djv_stbir_free(void* memory, void* context)
+{
+    if (context == nullptr)
+        std::free(memory);
+}
+
+#define STBIR_MALLOC(size, context) djv_stbir_malloc(size, context)
+#define STBIR_FREE(memory, context) djv_stbir_free(memory, context)
 #define STB_IMAGE_RESIZE_IMPLEMENTATION
 #include <stb_image_resize.h>
\ No newline at end of file
@@ -0,0 +1,224 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include <cstring>
+#include <cstdint>
+#include <vector>
+#include "utils/bitmap.h"
+
+// The reference resizes, compiled into the test so they do not depend on what dejavu-core exports.
+#define STB_IMAGE_RESIZE_STATIC
+#define STB_IMAGE_RESIZE_IMPLEMENTATION
+#include <stb_image_resize.h>
+
+namespace
+{
+    float srgb_to_linear_reference(float value)
+    {
+        return value <= 0.04045f ? value / 12.92f : std::pow((value + 0.055f) / 1.055f, 2.4f);
+    }
+
+    float linear_to_srgb_reference(float value)
+    {
+        return value <= 0.0031308f ? value * 12.92f : 1.055f * std::pow(value, 1.0f / 2.4f) - 0.055f;
+    }
+}
+
+TEST(core_bitmap, subview_test)
+{
+    djv::Bitmap bitmap(37, 21, 4, false);
+    auto view = bitmap.view();
+    static_cast<uint8_t*>(view.pixel(3, 2))[0] = 42;
+
+    auto sub = view.subview(3, 2, 30, 15);
+    EXPECT_EQ(sub.width(), 30);
+    EXPECT_EQ(sub.height(), 15);
+    EXPECT_EQ(sub.stride(), 37 * 4);
+    EXPECT_EQ(static_cast<uint8_t*>(sub.data())[0], 42);
+
+    auto clipped = view.subview(30, 18, 100, 100);
+    EXPECT_EQ(clipped.width(), 7);
+    EXPECT_EQ(clipped.height(), 3);
+
+    EXPECT_TRUE(view.subview(40, 0, 10, 10).empty());
+}
+
+TEST(core_bitmap, convert_test)
+{
+    djv::Bitmap bitmap(37, 21, 4, false);
+    auto view = bitmap.view();
+    for (int y = 0; y < view.height(); y++)
+    {
+        auto row = static_cast<uint8_t*>(view.row(y));
+        for (int i = 0; i < view.width() * 4; i++)
+            row[i] = static_cast<uint8_t>(i * 7 + y * 13);
+    }
+
+    // Odd sub-rectangles run both the SIMD part of the rows and their tails.
+    auto sub = view.subview(3, 2, 29, 15);
+    for (bool srgb : { false, true })
+    {
+        djv::Bitmap linear(sub.width(), sub.height(), 4, true);
+        djv::Bitmap encoded(sub.width(), sub.height(), 4, false);
+        ASSERT_TRUE(djv::convert(sub, linear.view(), srgb));
+        ASSERT_TRUE(djv::convert(linear.view(), encoded.view(), srgb));
+
+        for (int y = 0; y < sub.height(); y++)
+        {
+            for (int i = 0; i < sub.width() * 4; i++)
+            {
+                uint8_t value = static_cast<uint8_t*>(sub.row(y))[i];
+                float expected = srgb && i % 4 != 3 ? srgb_to_linear_reference(value / 255.0f) : value / 255.0f;
+                EXPECT_NEAR(static_cast<float*>(linear.view().row(y))[i], expected, 1e-6f);
+                EXPECT_EQ(static_cast<uint8_t*>(encoded.view().row(y))[i], value);
+            }
+        }
+    }
+
+    djv::Bitmap mismatched(10, 10, 4, true);
+    EXPECT_FALSE(djv::convert(sub, mismatched.view()));
+}
+
+TEST(core_bitmap, srgb_inplace_test)
+{
+    std::vector<float> values;
+    for (int i = 0; i <= 4000; i++)
+        values.push_back(i / 2000.0f - 0.2f);
+    while (values.size() % 4 != 0)
+        values.push_back(0.5f);
+
+    const std::vector<float> original = values;
+    djv::BitmapView view(values.data(), static_cast<int>(values.size() / 4), 1, 4, true);
+
+    ASSERT_TRUE(djv::linear_to_srgb_inplace(view));
+    for (size_t i = 0; i < values.size(); i++)
+    {
+        float expected = i % 4 == 3 ? original[i] : linear_to_srgb_reference(original[i]);
+        EXPECT_NEAR(values[i], expected, 1e-5f * std::max(1.0f, std::fabs(expected)));
+    }
+
+    ASSERT_TRUE(djv::srgb_to_linear_inplace(view));
+    for (size_t i = 0; i < values.size(); i++)
+        EXPECT_NEAR(values[i], original[i], 1e-5f * std::max(1.0f, std::fabs(original[i])));
+
+    uint8_t bytes[4] = {};
+    EXPECT_FALSE(djv::srgb_to_linear_inplace(djv::BitmapView(bytes, 1, 1, 4, false)));
+}
+
+TEST(core_bitmap, swizzle_inplace_test)
+{
+    uint8_t bytes[4 * 9];
+    for (int i = 0; i < 4 * 9; i++)
+        bytes[i] = static_cast<uint8_t>(i);
+
+    ASSERT_TRUE(djv::swizzle_inplace(djv::BitmapView(bytes, 9, 1, 4, false), { 2, 1, 0, 3 }));
+    for (int x = 0; x < 9; x++)
+    {
+        EXPECT_EQ(bytes[x * 4 + 0], x * 4 + 2);
+        EXPECT_EQ(bytes[x * 4 + 1], x * 4 + 1);
+        EXPECT_EQ(bytes[x * 4 + 2], x * 4 + 0);
+        EXPECT_EQ(bytes[x * 4 + 3], x * 4 + 3);
+    }
+
+    float floats[6] = { 1, 2, 3, 4, 5, 6 };
+    ASSERT_TRUE(djv::swizzle_inplace(djv::BitmapView(floats, 2, 1, 3, true), { 2, 0, 1, 0 }));
+    EXPECT_EQ(floats[0], 3);
+    EXPECT_EQ(floats[1], 1);
+    EXPECT_EQ(floats[2], 2);
+    EXPECT_EQ(floats[3], 6);
+
+    EXPECT_FALSE(djv::swizzle_inplace(djv::BitmapView(floats, 2, 1, 3, true), { 3, 0, 1, 0 }));
+}
+
+TEST(core_bitmap, premultiply_inplace_test)
+{
+    std::vector<uint8_t> bytes(13 * 3 * 4);
+    for (size_t i = 0; i < bytes.size(); i++)
+        bytes[i] = static_cast<uint8_t>(i * 37 + 11);
+
+    const std::vector<uint8_t> original = bytes;
+    ASSERT_TRUE(djv::premultiply_inplace(djv::BitmapView(bytes.data(), 13, 3, 4, false)));
+    for (size_t i = 0; i < bytes.size(); i++)
+    {
+        int alpha = original[i / 4 * 4 + 3];
+        int expected = i % 4 == 3 ? alpha : static_cast<int>(std::lround(original[i] * alpha / 255.0));
+        EXPECT_EQ(bytes[i], expected);
+    }
+
+    float floats[8] = { 1.0f, 0.5f, 0.25f, 0.5f, 1.0f, 1.0f, 1.0f, 0.0f };
+    ASSERT_TRUE(djv::premultiply_inplace(djv::BitmapView(floats, 2, 1, 4, true)));
+    EXPECT_EQ(floats[0], 0.5f);
+    EXPECT_EQ(floats[1], 0.25f);
+    EXPECT_EQ(floats[2], 0.125f);
+    EXPECT_EQ(floats[3], 0.5f);
+    EXPECT_EQ(floats[4], 0.0f);
+
+    EXPECT_FALSE(djv::premultiply_inplace(djv::BitmapView(floats, 2, 1, 3, true)));
+}
+
+TEST(core_bitmap, resize_test)
+{
+    // Rows change quickly, so a band that filtered its own rows only would show at its edges.
+    djv::Bitmap source(300, 517, 3, true);
+    auto view = source.view();
+    for (int y = 0; y < view.height(); y++)
+    {
+        auto row = static_cast<float*>(view.row(y));
+        for (int i = 0; i < view.width() * 3; i++)
+            row[i] = std::sin(i * 0.05f) + std::sin(y * 0.3f) + y * 0.01f;
+    }
+
+    // Bands have to add up to one resize of the whole image. The region each band passes to stb only
+    // rounds differently, so they agree to float precision.
+    djv::Bitmap expected(97, 203, 3, true);
+    ASSERT_TRUE(stbir_resize_float(static_cast<const float*>(source.data()), 300, 517, 0,
+                                   static_cast<float*>(expected.data()), 97, 203, 0, 3));
+
+    for (int threads : { 1, 4 })
+    {
+        djv::Bitmap resized(97, 203, 3, true);
+        ASSERT_TRUE(djv::resize(view, resized.view(), false, threads));
+
+        auto values = static_cast<const float*>(resized.data());
+        auto expectedValues = static_cast<const float*>(expected.data());
+        for (int i = 0; i < 97 * 203 * 3; i++)
+            ASSERT_NEAR(values[i], expectedValues[i], 1e-4f) << "row " << i / (97 * 3) << " with " << threads << " threads";
+    }
+
+    // 8-bit sRGB with alpha takes the other paths through stb.
+    djv::Bitmap bytes(300, 517, 4, false);
+    auto byteView = bytes.view();
+    for (int y = 0; y < byteView.height(); y++)
+    {
+        auto row = static_cast<uint8_t*>(byteView.row(y));
+        for (int i = 0; i < byteView.width() * 4; i++)
+            row[i] = static_cast<uint8_t>(127.5f + 127.5f * std::sin(i * 0.05f + y * 0.3f));
+    }
+
+    djv::Bitmap expectedBytes(97, 203, 4, false);
+    ASSERT_TRUE(stbir_resize_uint8_srgb(static_cast<const uint8_t*>(bytes.data()), 300, 517, 0,
+                                        static_cast<uint8_t*>(expectedBytes.data()), 97, 203, 0, 4, 3, 0));
+
+    djv::Bitmap resizedBytes(97, 203, 4, false);
+    ASSERT_TRUE(djv::resize(byteView, resizedBytes.view(), true, 4));
+    for (int i = 0; i < 97 * 203 * 4; i++)
+    {
+        int difference = static_cast<const uint8_t*>(resizedBytes.data())[i] - static_cast<const uint8_t*>(expectedBytes.data())[i];
+        ASSERT_LE(std::abs(difference), 1) << "row " << i / (97 * 4);
+    }
+
+    EXPECT_FALSE(djv::resize(view, resizedBytes.view()));
+}
+
+TEST(core_bitmap, reset_test)
+{
+    djv::Bitmap bitmap(64, 64, 4, true);
+    const void* data = bitmap.data();
+
+    bitmap.reset(32, 32, 3, true);
+    EXPECT_EQ(bitmap.data(), data);
+    EXPECT_EQ(bitmap.width(), 32);
+    EXPECT_EQ(bitmap.channels(), 3);
+
+    bitmap.reset(128, 128, 4, true);
+    EXPECT_NE(bitmap.data(), data);
+}
\ No newline at end of file
@@ -0,0 +1,104 @@
+#include <chrono>
+#include <random>
+#include <vector>
+#include <iostream>
+
+#include "Global.h"
+#include "MeshBVH.h"
+
+using namespace Engine;
+
+typedef std::chrono::high_resolution_clock Clock;
+
+// Wavy terrain grid with floating debris, roughly what the picking and shadow queries see in a level.
+static void BuildTestMesh(uint32_t gridSize, uint32_t debrisCount, std::vector<float3>& positions, std::vector<uint32_t>& indices)
+{
+    std::mt19937 rng(5);
+    std::uniform_real_distribution<float> random(-1.0f, 1.0f);
+
+    for (uint32_t y = 0; y <= gridSize; y++)
+    {
+        for (uint32_t x = 0; x <= gridSize; x++)
+        {
+            float fx = (float)x / gridSize * 10.0f - 5.0f;
+            float fz = (float)y / gridSize * 10.0f - 5.0f;
+            positions.push_back(float3(fx, 0.3f * sinf(x * 0.1f) * cosf(y * 0.13f), fz));
+        }
+    }
+
+    for (uint32_t y = 0; y < gridSize; y++)
+    {
+        for (uint32_t x = 0; x < gridSize; x++)
+        {
+            uint32_t a = y * (gridSize + 1) + x;
+            uint32_t b = a + 1;
+            uint32_t c = a + gridSize + 1;
+            uint32_t d = c + 1;
+            indices.insert(indices.end(), { a, c, b, b, c, d });
+        }
+    }
+
+    for (uint32_t i = 0; i < debrisCount; i++)
+    {
+        float3 center(random(rng) * 5.0f, random(rng) * 2.0f + 1.0f, random(rng) * 5.0f);
+        uint32_t base = (uint32_t)positions.size();
+        for (uint32_t k = 0; k < 3; k++)
+            positions.push_back(center + float3(random(rng), random(rng), random(rng)) * 0.2f);
+        indices.insert(indices.end(), { base, base + 1, base + 2 });
+    }
+}
+
+int main()
+{
+    if (gpGlobal == nullptr)
+        gpGlobal = new Global();
+
+    std::vector<float3> positions;
+    std::vector<uint32_t> indices;
+    BuildTestMesh(512, 50000, positions, indices);
+
+    MeshBVH bvh;
+    auto buildStart = Clock::now();
+    bvh.Build(positions.data(), (uint32_t)positions.size(), indices.data(), (uint32_t)indices.size());
+    auto buildEnd = Clock::now();
+
+    std::cout << "triangles: " << bvh.GetTriangleCount() << ", nodes: " << bvh.GetNodeCount() << ", width: " << MeshBVH::WIDTH << std::endl;
+    std::cout << "build: " << std::chrono::duration<double, std::milli>(buildEnd - buildStart).count() << " ms" << std::endl;
+
+    const uint32_t rayCount = 1000000;
+    std::vector<float3> origins(rayCount);
+    std::vector<float3> dirs(rayCount);
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<float> random(-1.0f, 1.0f);
+    for (uint32_t i = 0; i < rayCount; i++)
+    {
+        origins[i] = float3(random(rng) * 6.0f, 3.0f, random(rng) * 6.0f);
+        dirs[i] = Vec::Normalize(float3(random(rng) * 0.5f, -1.0f, random(rng) * 0.5f));
+    }
+
+    uint32_t hitCount = 0;
+    auto closestStart = Clock::now();
+    for (uint32_t i = 0; i < rayCount; i++)
+    {
+        MeshRayHit hit;
+        if (bvh.Intersect(origins[i], dirs[i], 100.0f, hit))
+            hitCount++;
+    }
+    auto closestEnd = Clock::now();
+
+    uint32_t occludedCount = 0;
+    auto anyStart = Clock::now();
+    for (uint32_t i = 0; i < rayCount; i++)
+    {
+        if (bvh.Occluded(origins[i], dirs[i], 100.0f))
+            occludedCount++;
+    }
+    auto anyEnd = Clock::now();
+
+    double closestSeconds = std::chrono::duration<double>(closestEnd - closestStart).count();
+    double anySeconds = std::chrono::duration<double>(anyEnd - anyStart).count();
+    std::cout << "closest hit: " << rayCount / closestSeconds * 1e-6 << " Mrays/s (" << hitCount << " hits)" << std::endl;
+    std::cout << "any hit: " << rayCount / anySeconds * 1e-6 << " Mrays/s (" << occludedCount << " hits)" << std::endl;
+
+    return 0;
+}
\ No newline at end of file
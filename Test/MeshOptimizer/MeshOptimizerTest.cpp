@@ -0,0 +1,79 @@
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+#include <iostream>
+
+#include "Global.h"
+#include "Mesh.h"
+
+using namespace Engine;
+
+// UV sphere with its triangles in random order, about what an exporter that sorts by material or
+// smoothing group hands the importer.
+static void BuildShuffledSphere(uint32_t rings, uint32_t segments, std::vector<float3>& positions, std::vector<uint32_t>& indices)
+{
+    const float pi = 3.14159265f;
+    for (uint32_t r = 0; r <= rings; r++)
+    {
+        float theta = (float)r / rings * pi;
+        for (uint32_t s = 0; s <= segments; s++)
+        {
+            float phi = (float)s / segments * 2.0f * pi;
+            positions.push_back(float3(sinf(theta) * cosf(phi), cosf(theta), sinf(theta) * sinf(phi)));
+        }
+    }
+
+    std::vector<uint32_t> triangles;
+    for (uint32_t r = 0; r < rings; r++)
+    {
+        for (uint32_t s = 0; s < segments; s++)
+        {
+            uint32_t a = r * (segments + 1) + s;
+            uint32_t b = a + 1;
+            uint32_t c = a + segments + 1;
+            uint32_t d = c + 1;
+            triangles.insert(triangles.end(), { a, c, b, b, c, d });
+        }
+    }
+
+    std::vector<uint32_t> order(triangles.size() / 3);
+    for (uint32_t i = 0; i < order.size(); i++)
+        order[i] = i;
+    std::shuffle(order.begin(), order.end(), std::mt19937(11));
+
+    for (auto triangle : order)
+        indices.insert(indices.end(), triangles.begin() + triangle * 3, triangles.begin() + triangle * 3 + 3);
+}
+
+int main()
+{
+    if (gpGlobal == nullptr)
+        gpGlobal = new Global();
+
+    std::vector<float3> positions;
+    std::vector<uint32_t> indices;
+    BuildShuffledSphere(200, 200, positions, indices);
+
+    Mesh mesh;
+    mesh.AttachVertexData(reinterpret_cast<const char*>(positions.data()), (uint32_t)(positions.size() * sizeof(float3)), (uint32_t)positions.size(), Attribute::ESemanticType::Position, "POSITION");
+    mesh.AttachIndexData(reinterpret_cast<const char*>(indices.data()), (uint32_t)(indices.size() * sizeof(uint32_t)), (uint32_t)indices.size());
+
+    VertexCacheStatistics before;
+    VertexCacheStatistics after;
+    mesh.Optimize(&before, &after);
+
+    std::cout << "triangles: " << indices.size() / 3 << ", vertices: " << positions.size() << " -> " << mesh.VertexCount() << std::endl;
+    std::cout << "ACMR: " << before.acmr << " -> " << after.acmr << std::endl;
+    std::cout << "ATVR: " << before.atvr << " -> " << after.atvr << std::endl;
+
+    // A shuffled list misses the cache on nearly every vertex, a cache ordered one on little more than
+    // one in two triangles.
+    if (after.acmr >= before.acmr || after.acmr > 1.0f)
+    {
+        std::cout << "Optimize did not improve the vertex cache" << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
\ No newline at end of file
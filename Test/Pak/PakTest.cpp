@@ -0,0 +1,176 @@
+#include <stdint.h>
+#include <string.h>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "Global.h"
+#include "AssetFileSystem.h"
+#include "PakFile.h"
+#include "GLTF2Loader.h"
+
+using namespace Engine;
+
+static bool WriteFile(const std::string& path, const std::vector<char>& data)
+{
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file.write(data.data(), data.size());
+    return (bool)file;
+}
+
+static bool SameBytes(const std::shared_ptr<char>& pData, uint64_t size, const std::vector<char>& expected)
+{
+    return size == expected.size() && (size == 0 || (pData != nullptr && memcmp(pData.get(), expected.data(), size) == 0));
+}
+
+// Exposes parsing alone, the rest of Load needs a device for the textures.
+class ParsingLoader : public GLTF2Loader
+{
+public:
+    using GLTF2Loader::LoadText;
+};
+
+// A compressible, an incompressible and an empty entry, which covers both ways entries are stored.
+static bool TestRoundTrip()
+{
+    std::vector<char> text;
+    while (text.size() < 64 * 1024)
+    {
+        const char line[] = "Compressible text repeats itself line after line.\n";
+        text.insert(text.end(), line, line + sizeof(line) - 1);
+    }
+
+    std::mt19937 rng(3);
+    std::vector<char> noise(5000);
+    for (auto& value : noise)
+        value = (char)rng();
+
+    WriteFile("PakTest/text.txt", text);
+    WriteFile("PakTest/noise.bin", noise);
+    WriteFile("PakTest/empty.bin", std::vector<char>());
+
+    std::vector<PakFile::Source> sources = {
+        { "Data/text.txt", "PakTest/text.txt" },
+        { "Data/noise.bin", "PakTest/noise.bin" },
+        { "Data/empty.bin", "PakTest/empty.bin" },
+    };
+    auto pPak = PakFile::Write("PakTest/RoundTrip.ntpak", sources, true) ? PakFile::Open("PakTest/RoundTrip.ntpak") : nullptr;
+    if (pPak == nullptr || pPak->GetEntryCount() != 3)
+    {
+        std::cout << "round trip: the archive does not open" << std::endl;
+        return false;
+    }
+
+    uint64_t textSize = 0;
+    uint64_t noiseSize = 0;
+    uint64_t emptySize = 1;
+    auto pText = pPak->Read("Data/text.txt", textSize);
+    auto pNoise = pPak->Read("Data/noise.bin", noiseSize);
+    std::vector<char> copy(text.size());
+
+    bool bCompressed = SameBytes(pText, textSize, text) && pPak->Read("Data/text.txt", copy.data(), copy.size()) && copy == text;
+    bool bStored = SameBytes(pNoise, noiseSize, noise);
+    bool bAligned = pNoise != nullptr && (uintptr_t)pNoise.get() % PakFile::PAGE_ALIGNMENT == 0;
+    bool bEmpty = pPak->GetSize("Data/empty.bin", emptySize) && emptySize == 0 && !pPak->Contains("Data/missing.bin");
+
+    sources.push_back({ "Data/text.txt", "PakTest/noise.bin" });
+    bool bDuplicateRejected = !PakFile::Write("PakTest/Duplicate.ntpak", sources, false);
+
+    std::vector<char> archive(std::filesystem::file_size("PakTest/RoundTrip.ntpak"));
+    std::ifstream("PakTest/RoundTrip.ntpak", std::ios::binary).read(archive.data(), archive.size());
+    archive.resize(archive.size() - 1);
+    WriteFile("PakTest/Truncated.ntpak", archive);
+    bool bTruncatedRejected = PakFile::Open("PakTest/Truncated.ntpak") == nullptr;
+
+    std::cout << "round trip: compressed " << bCompressed << ", stored " << bStored << ", page aligned " << bAligned << ", empty " << bEmpty << std::endl;
+    std::cout << "rejected: duplicate names " << bDuplicateRejected << ", truncated archive " << bTruncatedRejected << std::endl;
+
+    return bCompressed && bStored && bAligned && bEmpty && bDuplicateRejected && bTruncatedRejected;
+}
+
+// Every spelling of a path is recorded once, in the order of first use.
+static bool TestAccessOrder()
+{
+    AssetFileSystem fileSystem;
+    if (!fileSystem.Mount("PakTest/RoundTrip.ntpak", "Asset/"))
+    {
+        std::cout << "access order: the archive does not mount" << std::endl;
+        return false;
+    }
+
+    uint64_t size = 0;
+    fileSystem.StartRecording();
+    fileSystem.Read("Asset/Data/noise.bin", size);
+    fileSystem.Read("./Asset/Data/text.txt", size);
+    fileSystem.Read("Asset\\Data\\noise.bin", size);
+
+    std::vector<std::string> order;
+    if (fileSystem.SaveAccessOrder("PakTest/AccessOrder.txt"))
+        order = AssetFileSystem::LoadAccessOrder("PakTest/AccessOrder.txt");
+
+    std::cout << "access order:";
+    for (const auto& path : order)
+        std::cout << " " << path;
+    std::cout << std::endl;
+
+    return order == std::vector<std::string>({ "Asset/Data/noise.bin", "Asset/Data/text.txt" });
+}
+
+// Parsing unescapes strings in place, which must not reach the mapping the archive shares with every
+// other reader of the same entry, so the same entry has to parse twice.
+static bool TestArchivedGLTF()
+{
+    const std::string path = "Test/Suzanne/Suzanne.gltf";
+    if (!PakFile::Write("PakTest/Suzanne.ntpak", { { "Suzanne/Suzanne.gltf", path } }, false) ||
+        !gpGlobal->GetAssetFileSystem().Mount("PakTest/Suzanne.ntpak", "Archive/"))
+    {
+        std::cout << "archived glTF: " << path << " can not be packed" << std::endl;
+        return false;
+    }
+
+    auto reference = gltf2::load(path);
+
+    bool bPassed = true;
+    for (uint32_t i = 0; i < 2; i++)
+    {
+        ParsingLoader loader;
+        try
+        {
+            loader.LoadText("Archive/Suzanne/Suzanne.gltf");
+        }
+        catch (const std::exception& e)
+        {
+            std::cout << e.what() << std::endl;
+        }
+
+        const auto& asset = loader.GetAsset();
+        bool bSame = asset.metadata.generator == reference.metadata.generator && asset.metadata.version == reference.metadata.version &&
+            asset.accessors.size() == reference.accessors.size() && asset.meshes.size() == reference.meshes.size() &&
+            asset.buffers.size() == reference.buffers.size() && !asset.buffers.empty() && asset.buffers[0].uri == reference.buffers[0].uri &&
+            asset.images.size() == reference.images.size() && !asset.images.empty() && asset.images[0].uri == reference.images[0].uri;
+
+        std::cout << "archived glTF, load " << i + 1 << ": " << asset.accessors.size() << " accessors, " << asset.meshes.size() << " meshes, "
+                  << (bSame ? "same as" : "differs from") << " the loose file" << std::endl;
+        bPassed = bPassed && bSame;
+    }
+
+    return bPassed;
+}
+
+int main()
+{
+    if (gpGlobal == nullptr)
+        gpGlobal = new Global();
+
+    std::filesystem::create_directories("PakTest");
+    std::cout << std::boolalpha;
+
+    bool bPassed = TestRoundTrip();
+    bPassed = TestAccessOrder() && bPassed;
+    bPassed = TestArchivedGLTF() && bPassed;
+
+    return bPassed ? 0 : 1;
+}
\ No newline at end of file
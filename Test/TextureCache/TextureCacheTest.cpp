@@ -0,0 +1,121 @@
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "TextureCache.h"
+
+using namespace Engine;
+
+// Spellings of a path share an entry, samplers and roles split it.
+static bool TestKeys()
+{
+    TextureCache cache;
+    TextureCache::SamplerDesc sampler;
+    TextureCache::SamplerDesc clamped;
+    clamped.wrapS = 33071;
+
+    bool bCreated = false;
+    bool bDotCreated = true;
+    bool bBackslashCreated = true;
+    bool bClampedCreated = false;
+    bool bNormalCreated = false;
+    auto pTexture = cache.Acquire("Asset/Scene/a.png", sampler, eTextureRole_Albedo, bCreated);
+    auto pDot = cache.Acquire("./Asset/Scene/../Scene/a.png", sampler, eTextureRole_Albedo, bDotCreated);
+    auto pBackslash = cache.Acquire("Asset\\Scene\\a.png", sampler, eTextureRole_Albedo, bBackslashCreated);
+    auto pClamped = cache.Acquire("Asset/Scene/a.png", clamped, eTextureRole_Albedo, bClampedCreated);
+    auto pNormal = cache.Acquire("Asset/Scene/a.png", sampler, eTextureRole_Normal, bNormalCreated);
+
+    bool bShared = bCreated && !bDotCreated && !bBackslashCreated && pDot.get() == pTexture.get() && pBackslash.get() == pTexture.get();
+    bool bSplit = bClampedCreated && bNormalCreated && pClamped.get() != pTexture.get() && pNormal->GetRole() == eTextureRole_Normal;
+
+    std::cout << "keys: " << cache.GetEntryCount() << " entries, spellings shared " << bShared << ", samplers and roles split " << bSplit << std::endl;
+    return bShared && bSplit && cache.GetEntryCount() == 3 && cache.GetReferencedCount() == 3;
+}
+
+// Entries stay while referenced, then wait in the LRU list until more than the limit are unreferenced.
+static bool TestReferences()
+{
+    TextureCache cache(2);
+    TextureCache::SamplerDesc sampler;
+    bool bCreated = false;
+
+    auto pA = cache.Acquire("a.png", sampler, eTextureRole_Albedo, bCreated);
+    auto pA2 = cache.Acquire("a.png", sampler, eTextureRole_Albedo, bCreated);
+    auto pB = cache.Acquire("b.png", sampler, eTextureRole_Albedo, bCreated);
+    auto pC = cache.Acquire("c.png", sampler, eTextureRole_Albedo, bCreated);
+
+    pA = nullptr;
+    bool bReferenced = cache.GetReferencedCount() == 3;
+    pA2 = nullptr;
+    bool bCached = cache.GetReferencedCount() == 2 && cache.GetEntryCount() == 3;
+    pB = nullptr;
+    pC = nullptr;
+    bool bEvicted = cache.GetReferencedCount() == 0 && cache.GetEntryCount() == 2;
+
+    bool bKeptCreated = true;
+    bool bEvictedCreated = false;
+    cache.Acquire("b.png", sampler, eTextureRole_Albedo, bKeptCreated);
+    cache.Acquire("a.png", sampler, eTextureRole_Albedo, bEvictedCreated);
+    bool bLeastRecentFirst = !bKeptCreated && bEvictedCreated;
+
+    std::cout << "references: held " << bReferenced << ", cached " << bCached << ", evicted " << bEvicted << ", least recent first " << bLeastRecentFirst << std::endl;
+    return bReferenced && bCached && bEvicted && bLeastRecentFirst;
+}
+
+static bool TestConcurrency()
+{
+    TextureCache cache(4);
+    TextureCache::SamplerDesc sampler;
+
+    std::vector<std::thread> threads;
+    for (uint32_t t = 0; t < 8; t++)
+    {
+        threads.emplace_back([&cache, sampler, t]() {
+            std::vector<std::shared_ptr<ITexture>> pHeld;
+            for (uint32_t i = 0; i < 2000; i++)
+            {
+                bool bCreated = false;
+                pHeld.push_back(cache.Acquire(std::to_string((i * 7 + t) % 16) + ".png", sampler, eTextureRole_Albedo, bCreated));
+                if (pHeld.size() > 3)
+                    pHeld.erase(pHeld.begin());
+            }
+        });
+    }
+
+    for (auto& thread : threads)
+        thread.join();
+
+    std::cout << "concurrency: " << cache.GetReferencedCount() << " referenced, " << cache.GetEntryCount() << " cached" << std::endl;
+    return cache.GetReferencedCount() == 0 && cache.GetEntryCount() <= 4;
+}
+
+// A handle keeps its texture after the cache is gone and releases into nothing.
+static bool TestOutlivingHandles()
+{
+    std::shared_ptr<ITexture> pTexture;
+    {
+        TextureCache cache;
+        bool bCreated = false;
+        pTexture = cache.Acquire("a.png", TextureCache::SamplerDesc(), eTextureRole_Albedo, bCreated);
+    }
+
+    bool bAlive = pTexture->GetURI() == "a.png";
+    pTexture = nullptr;
+
+    std::cout << "outliving handles: texture alive " << bAlive << std::endl;
+    return bAlive;
+}
+
+int main()
+{
+    std::cout << std::boolalpha;
+
+    bool bPassed = TestKeys();
+    bPassed = TestReferences() && bPassed;
+    bPassed = TestConcurrency() && bPassed;
+    bPassed = TestOutlivingHandles() && bPassed;
+
+    return bPassed ? 0 : 1;
+}
\ No newline at end of file
@@ -123,6 +123,10 @@ namespace
 
     inline HANDLE safe_handle( HANDLE h ) { return (h == INVALID_HANDLE_VALUE) ? nullptr : h; }
 
+    struct view_unmapper { void operator()(const uint8_t* p) { if (p) UnmapViewOfFile(p); } };
+
+    typedef std::unique_ptr<const uint8_t, view_unmapper> ScopedView;
+
     template<UINT TNameLength>
     inline void SetDebugObjectName(_In_ ID3D11DeviceChild* resource, _In_ const char (&name)[TNameLength])
     {
@@ -200,9 +204,11 @@ namespace
 
 
     //--------------------------------------------------------------------------------------
+    // The file is mapped rather than read, so the subresources point straight into the page cache
+    // and no heap copy of the whole file is made.
     HRESULT LoadTextureDataFromFile(
         _In_z_ const wchar_t* fileName,
-        std::unique_ptr<uint8_t[]>& ddsData,
+        ScopedView& ddsData,
         const DDS_HEADER** header,
         const uint8_t** bitData,
         size_t* bitSize)
@@ -253,28 +259,17 @@ namespace
             return E_FAIL;
         }
 
-        // create enough space for the file data
-        ddsData.reset(new (std::nothrow) uint8_t[fileInfo.EndOfFile.LowPart]);
-        if (!ddsData)
-        {
-            return E_OUTOFMEMORY;
-        }
-
-        // read the data in
-        DWORD BytesRead = 0;
-        if (!ReadFile(hFile.get(),
-            ddsData.get(),
-            fileInfo.EndOfFile.LowPart,
-            &BytesRead,
-            nullptr
-        ))
+        // map the file, the view keeps the mapping alive once the handles are closed
+        ScopedHandle hMapping(CreateFileMappingW(hFile.get(), nullptr, PAGE_READONLY, 0, 0, nullptr));
+        if (!hMapping)
         {
             return HRESULT_FROM_WIN32(GetLastError());
         }
 
-        if (BytesRead < fileInfo.EndOfFile.LowPart)
+        ddsData.reset(static_cast<const uint8_t*>(MapViewOfFile(hMapping.get(), FILE_MAP_READ, 0, 0, 0)));
+        if (!ddsData)
         {
-            return E_FAIL;
+            return HRESULT_FROM_WIN32(GetLastError());
         }
 
         // DDS files always start with the same magic number ("DDS ")
@@ -1924,7 +1919,7 @@ HRESULT DirectX::CreateDDSTextureFromFileEx(
     const uint8_t* bitData = nullptr;
     size_t bitSize = 0;
 
-    std::unique_ptr<uint8_t[]> ddsData;
+    ScopedView ddsData;
     HRESULT hr = LoadTextureDataFromFile(fileName,
         ddsData,
         &header,
@@ -223,7 +223,7 @@ namespace
     //--------------------------------------------------------------------------------------
     HRESULT LoadTextureDataFromFile(
         _In_z_ const wchar_t* fileName,
-        std::unique_ptr<uint8_t[]>& ddsData,
+        DDSMappedData& ddsData,
         const DDS_HEADER** header,
         const uint8_t** bitData,
         size_t* bitSize)
@@ -264,28 +264,17 @@ namespace
             return E_FAIL;
         }
 
-        // create enough space for the file data
-        ddsData.reset(new (std::nothrow) uint8_t[fileInfo.EndOfFile.LowPart]);
-        if (!ddsData)
-        {
-            return E_OUTOFMEMORY;
-        }
-
-        // read the data in
-        DWORD BytesRead = 0;
-        if (!ReadFile(hFile.get(),
-            ddsData.get(),
-            fileInfo.EndOfFile.LowPart,
-            &BytesRead,
-            nullptr
-        ))
+        // map the file, the view keeps the mapping alive once the handles are closed
+        ScopedHandle hMapping(CreateFileMappingW(hFile.get(), nullptr, PAGE_READONLY, 0, 0, nullptr));
+        if (!hMapping)
         {
             return HRESULT_FROM_WIN32(GetLastError());
         }
 
-        if (BytesRead < fileInfo.EndOfFile.LowPart)
+        ddsData.reset(static_cast<const uint8_t*>(MapViewOfFile(hMapping.get(), FILE_MAP_READ, 0, 0, 0)));
+        if (!ddsData)
         {
-            return E_FAIL;
+            return HRESULT_FROM_WIN32(GetLastError());
         }
 
         // DDS files always start with the same magic number ("DDS ")
@@ -1542,13 +1531,23 @@ HRESULT DirectX::LoadDDSTextureFromMemoryEx(
 }
 
 
+//--------------------------------------------------------------------------------------
+_Use_decl_annotations_
+void DirectX::DDSMappedDataDeleter::operator()(const uint8_t* ddsData) const noexcept
+{
+    if (ddsData)
+    {
+        UnmapViewOfFile(ddsData);
+    }
+}
+
 //--------------------------------------------------------------------------------------
 _Use_decl_annotations_
 HRESULT DirectX::LoadDDSTextureFromFile(
     ID3D12Device* d3dDevice,
     const wchar_t* fileName,
     ID3D12Resource** texture,
-    std::unique_ptr<uint8_t[]>& ddsData,
+    DDSMappedData& ddsData,
     std::vector<D3D12_SUBRESOURCE_DATA>& subresources,
     size_t maxsize,
     DDS_ALPHA_MODE* alphaMode,
@@ -1575,7 +1574,7 @@ HRESULT DirectX::LoadDDSTextureFromFileEx(
     D3D12_RESOURCE_FLAGS resFlags,
     unsigned int loadFlags,
     ID3D12Resource** texture,
-    std::unique_ptr<uint8_t[]>& ddsData,
+    DDSMappedData& ddsData,
     std::vector<D3D12_SUBRESOURCE_DATA>& subresources,
     DDS_ALPHA_MODE* alphaMode,
     bool* isCubeMap)
@@ -41,6 +41,12 @@ namespace DirectX
         DDS_LOADER_MIP_RESERVE = 0x8,
     };
 
+    // Read-only mapping of a DDS file. The subresources LoadDDSTextureFromFile returns point into it
+    // rather than into a heap copy, so it must live until their upload has been recorded.
+    struct DDSMappedDataDeleter { void __cdecl operator()(_In_opt_ const uint8_t* ddsData) const noexcept; };
+
+    typedef std::unique_ptr<const uint8_t, DDSMappedDataDeleter> DDSMappedData;
+
     // Standard version
     HRESULT __cdecl LoadDDSTextureFromMemory(
         _In_ ID3D12Device* d3dDevice,
@@ -56,7 +62,7 @@ namespace DirectX
         _In_ ID3D12Device* d3dDevice,
         _In_z_ const wchar_t* szFileName,
         _Outptr_ ID3D12Resource** texture,
-        std::unique_ptr<uint8_t[]>& ddsData,
+        DDSMappedData& ddsData,
         std::vector<D3D12_SUBRESOURCE_DATA>& subresources,
         size_t maxsize = 0,
         _Out_opt_ DDS_ALPHA_MODE* alphaMode = nullptr,
@@ -82,7 +88,7 @@ namespace DirectX
         D3D12_RESOURCE_FLAGS resFlags,
         unsigned int loadFlags,
         _Outptr_ ID3D12Resource** texture,
-        std::unique_ptr<uint8_t[]>& ddsData,
+        DDSMappedData& ddsData,
         std::vector<D3D12_SUBRESOURCE_DATA>& subresources,
         _Out_opt_ DDS_ALPHA_MODE* alphaMode = nullptr,
         _Out_opt_ bool* isCubeMap = nullptr);
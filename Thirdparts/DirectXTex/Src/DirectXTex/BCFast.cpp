@@ -0,0 +1,417 @@
+//-------------------------------------------------------------------------------------
+// BCFast.cpp
+//  
+// Real-time BC1, BC3, BC4 and BC5 encoders for TEX_COMPRESS_FAST
+//
+// Licensed under the MIT License.
+//-------------------------------------------------------------------------------------
+
+#include <algorithm>
+#include <stdlib.h>
+#include <string.h>
+
+#include <smmintrin.h>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+
+#include "BCFast.h"
+
+using namespace DirectX;
+
+namespace
+{
+    // Insetting the bounding box by 1/16 of the color range and 1/32 of the alpha range moves the
+    // endpoints toward the texels, which lowers the error of the palette on average.
+    const int INSET_COLOR_SHIFT = 4;
+    const int INSET_ALPHA_SHIFT = 5;
+
+    // Axes longer than this are halved or quartered. Rounding keeps the weights within 64, and
+    // 2 * 255 * 64 still fits the signed 16-bit sums of _mm_maddubs_epi16.
+    const int MAX_AXIS_WEIGHT = 63;
+
+    inline void LoadBlock(const uint8_t* pSrc, size_t srcPitch, __m128i rows[4])
+    {
+        for (size_t i = 0; i < 4; ++i)
+            rows[i] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pSrc + srcPitch * i));
+    }
+
+    // Loads the four texels of a row, reading no further than they reach.
+    inline __m128i LoadRow(const uint8_t* pSrc, size_t pixelSize)
+    {
+        if (pixelSize == 4)
+            return _mm_loadu_si128(reinterpret_cast<const __m128i*>(pSrc));
+        if (pixelSize == 2)
+            return _mm_loadl_epi64(reinterpret_cast<const __m128i*>(pSrc));
+
+        int32_t row;
+        memcpy(&row, pSrc, sizeof(row));
+        return _mm_cvtsi32_si128(row);
+    }
+
+    // Shuffle moving byte channel of the four texels of a row into the low dword.
+    inline __m128i ChannelSelect(size_t pixelSize, size_t channel)
+    {
+        const char c = char(channel), s = char(pixelSize);
+        return _mm_setr_epi8(c, char(c + s), char(c + s * 2), char(c + s * 3), -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1);
+    }
+
+    // The 16 values of a channel in texel order.
+    inline __m128i GatherChannel(const __m128i rows[4], __m128i select)
+    {
+        __m128i r01 = _mm_unpacklo_epi32(_mm_shuffle_epi8(rows[0], select), _mm_shuffle_epi8(rows[1], select));
+        __m128i r23 = _mm_unpacklo_epi32(_mm_shuffle_epi8(rows[2], select), _mm_shuffle_epi8(rows[3], select));
+        return _mm_unpacklo_epi64(r01, r23);
+    }
+
+    // Ramp positions below 4 as the 32 bits of a BC1 index word, texel 0 lowest.
+    inline uint32_t PackIndices2(__m128i indices)
+    {
+        __m128i pairs = _mm_maddubs_epi16(indices, _mm_set1_epi16(0x0401));
+        __m128i quads = _mm_madd_epi16(pairs, _mm_set1_epi32(0x00100001));
+        __m128i packed = _mm_packus_epi16(_mm_packus_epi32(quads, quads), _mm_setzero_si128());
+        return uint32_t(_mm_cvtsi128_si32(packed));
+    }
+
+    // Ramp positions below 8 as the 48 bits of a BC4 index block, texel 0 lowest.
+    inline uint64_t PackIndices3(__m128i indices)
+    {
+        __m128i pairs = _mm_maddubs_epi16(indices, _mm_set1_epi16(0x0801));
+        __m128i quads = _mm_madd_epi16(pairs, _mm_set1_epi32(0x00400001));
+        __m128i low = _mm_and_si128(quads, _mm_set_epi32(0, -1, 0, -1));
+        __m128i words = _mm_or_si128(low, _mm_slli_epi64(_mm_srli_epi64(quads, 32), 12));
+        return uint64_t(uint32_t(_mm_cvtsi128_si32(words))) | (uint64_t(uint32_t(_mm_extract_epi32(words, 2))) << 24);
+    }
+
+    // Four floats scaled and rounded to the nearest ramp position.
+    inline __m128i RampPositions(__m128i values, __m128i offset, __m128 scale)
+    {
+        return _mm_cvtps_epi32(_mm_mul_ps(_mm_cvtepi32_ps(_mm_sub_epi32(values, offset)), scale));
+    }
+
+    // x / 255 for the x the 565 rounding produces, which stay below 255 * 64.
+    inline __m128i Divide255(__m128i x)
+    {
+        return _mm_srli_epi32(_mm_add_epi32(_mm_add_epi32(x, _mm_set1_epi32(1)), _mm_srli_epi32(x, 8)), 8);
+    }
+
+    inline __m128i Quantize(__m128i channel, int maximum)
+    {
+        return Divide255(_mm_add_epi32(_mm_mullo_epi32(channel, _mm_set1_epi32(maximum)), _mm_set1_epi32(127)));
+    }
+
+    // Lane 0 of each of the four vectors, in one vector.
+    inline __m128i Transpose(__m128i v0, __m128i v1, __m128i v2, __m128i v3)
+    {
+        return _mm_unpacklo_epi64(_mm_unpacklo_epi32(v0, v1), _mm_unpacklo_epi32(v2, v3));
+    }
+
+    inline __m128i Broadcast(__m128i v, int lane)
+    {
+        switch (lane)
+        {
+        case 0:  return _mm_shuffle_epi32(v, _MM_SHUFFLE(0, 0, 0, 0));
+        case 1:  return _mm_shuffle_epi32(v, _MM_SHUFFLE(1, 1, 1, 1));
+        case 2:  return _mm_shuffle_epi32(v, _MM_SHUFFLE(2, 2, 2, 2));
+        default: return _mm_shuffle_epi32(v, _MM_SHUFFLE(3, 3, 3, 3));
+        }
+    }
+
+    inline __m128i Channel(__m128i texels, int channel)
+    {
+        return _mm_and_si128(_mm_srli_epi32(texels, channel * 8), _mm_set1_epi32(0xff));
+    }
+
+    inline __m128i Select(__m128i mask, __m128i a, __m128i b)
+    {
+        return _mm_blendv_epi8(b, a, mask);
+    }
+
+    //-------------------------------------------------------------------------------------
+    // Color blocks of BC1 and BC3, four at a time and always in four color mode. The passes over
+    // the texels run once per block; everything between them works on all four blocks, one per
+    // lane, so no decision is a branch. Colors stay in texel byte order except when packed to 565.
+    void EncodeColorBlocks(uint8_t* pDest, size_t destStride, const __m128i blocks[4][4], bool bBGR)
+    {
+        __m128i minima[4], maxima[4];
+        for (int b = 0; b < 4; ++b)
+        {
+            const __m128i* rows = blocks[b];
+            __m128i minimum = _mm_min_epu8(_mm_min_epu8(rows[0], rows[1]), _mm_min_epu8(rows[2], rows[3]));
+            __m128i maximum = _mm_max_epu8(_mm_max_epu8(rows[0], rows[1]), _mm_max_epu8(rows[2], rows[3]));
+            minimum = _mm_min_epu8(minimum, _mm_shuffle_epi32(minimum, _MM_SHUFFLE(1, 0, 3, 2)));
+            maximum = _mm_max_epu8(maximum, _mm_shuffle_epi32(maximum, _MM_SHUFFLE(1, 0, 3, 2)));
+            minima[b] = _mm_min_epu8(minimum, _mm_shuffle_epi32(minimum, _MM_SHUFFLE(2, 3, 0, 1)));
+            maxima[b] = _mm_max_epu8(maximum, _mm_shuffle_epi32(maximum, _MM_SHUFFLE(2, 3, 0, 1)));
+        }
+
+        const __m128i low = Transpose(minima[0], minima[1], minima[2], minima[3]);
+        const __m128i high = Transpose(maxima[0], maxima[1], maxima[2], maxima[3]);
+
+        __m128i color0[3], color1[3];
+        for (int i = 0; i < 3; ++i)
+        {
+            __m128i lo = Channel(low, i);
+            __m128i hi = Channel(high, i);
+            __m128i inset = _mm_srli_epi32(_mm_sub_epi32(hi, lo), INSET_COLOR_SHIFT);
+            color0[i] = _mm_sub_epi32(hi, inset);
+            color1[i] = _mm_add_epi32(lo, inset);
+        }
+
+        // The box has four diagonals. The sign of the covariance of the first and third channel
+        // with green picks the one along which the texels spread. Multiplying the deltas by green
+        // in the first and third lane and zero in the others leaves exactly those two sums.
+        const __m128i center = _mm_avg_epu8(low, high);
+        const __m128i green = _mm_setr_epi8(2, 3, -1, -1, 2, 3, -1, -1, 10, 11, -1, -1, 10, 11, -1, -1);
+        __m128i covariances[4];
+        for (int b = 0; b < 4; ++b)
+        {
+            const __m128i centered = _mm_cvtepu8_epi16(Broadcast(center, b));
+            __m128i covariance = _mm_setzero_si128();
+            for (int i = 0; i < 4; ++i)
+            {
+                __m128i delta0 = _mm_sub_epi16(_mm_cvtepu8_epi16(blocks[b][i]), centered);
+                __m128i delta1 = _mm_sub_epi16(_mm_cvtepu8_epi16(_mm_srli_si128(blocks[b][i], 8)), centered);
+                covariance = _mm_add_epi32(covariance, _mm_madd_epi16(delta0, _mm_shuffle_epi8(delta0, green)));
+                covariance = _mm_add_epi32(covariance, _mm_madd_epi16(delta1, _mm_shuffle_epi8(delta1, green)));
+            }
+            covariances[b] = _mm_add_epi32(covariance, _mm_shuffle_epi32(covariance, _MM_SHUFFLE(1, 0, 3, 2)));
+        }
+
+        const __m128i first = Transpose(covariances[0], covariances[1], covariances[2], covariances[3]);
+        const __m128i third = Transpose(_mm_srli_si128(covariances[0], 4), _mm_srli_si128(covariances[1], 4), _mm_srli_si128(covariances[2], 4), _mm_srli_si128(covariances[3], 4));
+        for (int i = 0; i < 3; i += 2)
+        {
+            __m128i flip = _mm_cmplt_epi32(i == 0 ? first : third, _mm_setzero_si128());
+            __m128i c0 = Select(flip, color1[i], color0[i]);
+            color1[i] = Select(flip, color0[i], color1[i]);
+            color0[i] = c0;
+        }
+
+        // 565 wants red first.
+        const int red = bBGR ? 2 : 0, blue = bBGR ? 0 : 2;
+        __m128i endpoint0 = _mm_or_si128(_mm_or_si128(_mm_slli_epi32(Quantize(color0[red], 31), 11), _mm_slli_epi32(Quantize(color0[1], 63), 5)), Quantize(color0[blue], 31));
+        __m128i endpoint1 = _mm_or_si128(_mm_or_si128(_mm_slli_epi32(Quantize(color1[red], 31), 11), _mm_slli_epi32(Quantize(color1[1], 63), 5)), Quantize(color1[blue], 31));
+
+        // What the decoder expands the endpoints to.
+        for (int e = 0; e < 2; ++e)
+        {
+            __m128i endpoint = e == 0 ? endpoint0 : endpoint1;
+            __m128i* color = e == 0 ? color0 : color1;
+            __m128i r = _mm_srli_epi32(endpoint, 11);
+            __m128i g = _mm_and_si128(_mm_srli_epi32(endpoint, 5), _mm_set1_epi32(63));
+            __m128i b = _mm_and_si128(endpoint, _mm_set1_epi32(31));
+            color[red] = _mm_or_si128(_mm_slli_epi32(r, 3), _mm_srli_epi32(r, 2));
+            color[1] = _mm_or_si128(_mm_slli_epi32(g, 2), _mm_srli_epi32(g, 4));
+            color[blue] = _mm_or_si128(_mm_slli_epi32(b, 3), _mm_srli_epi32(b, 2));
+        }
+
+        // The axis is scaled down to signed bytes small enough that two products summed by
+        // maddubs can not saturate, which lets the projection run on the 8-bit texels. The
+        // multiplier is 4, 2 or 1 followed by a shift by 2, a per lane shift by 0, 1 or 2.
+        __m128i axis[3], extent = _mm_setzero_si128();
+        for (int i = 0; i < 3; ++i)
+        {
+            axis[i] = _mm_sub_epi32(color0[i], color1[i]);
+            extent = _mm_max_epi32(extent, _mm_abs_epi32(axis[i]));
+        }
+
+        const __m128i multiplier = _mm_add_epi32(_mm_set1_epi32(4),
+            _mm_add_epi32(_mm_add_epi32(_mm_cmpgt_epi32(extent, _mm_set1_epi32(MAX_AXIS_WEIGHT)), _mm_cmpgt_epi32(extent, _mm_set1_epi32(MAX_AXIS_WEIGHT))),
+                _mm_cmpgt_epi32(extent, _mm_set1_epi32(MAX_AXIS_WEIGHT * 2 + 1))));
+
+        __m128i length = _mm_setzero_si128(), origin = _mm_setzero_si128(), weights = _mm_setzero_si128();
+        for (int i = 0; i < 3; ++i)
+        {
+            __m128i weight = _mm_srai_epi32(_mm_add_epi32(_mm_mullo_epi32(axis[i], multiplier), _mm_set1_epi32(2)), 2);
+            length = _mm_add_epi32(length, _mm_mullo_epi32(axis[i], weight));
+            origin = _mm_add_epi32(origin, _mm_mullo_epi32(color1[i], weight));
+            weights = _mm_or_si128(weights, _mm_slli_epi32(_mm_and_si128(weight, _mm_set1_epi32(0xff)), i * 8));
+        }
+
+        // Equal endpoints have no axis; a zero scale sends every texel to endpoint 1.
+        const __m128 lengths = _mm_cvtepi32_ps(length);
+        const __m128 scales = _mm_and_ps(_mm_div_ps(_mm_set1_ps(3.0f), lengths), _mm_cmpneq_ps(lengths, _mm_setzero_ps()));
+
+        // Endpoint 0 must be the larger one for four color mode; swapping them swaps 0 with 1 and
+        // 2 with 3.
+        const __m128i swap = _mm_and_si128(_mm_cmplt_epi32(endpoint0, endpoint1), _mm_set1_epi32(0x01010101));
+        alignas(16) uint32_t endpoints[4];
+        _mm_store_si128(reinterpret_cast<__m128i*>(endpoints), _mm_or_si128(_mm_max_epi32(endpoint0, endpoint1), _mm_slli_epi32(_mm_min_epi32(endpoint0, endpoint1), 16)));
+
+        // Ramp positions run from endpoint 1 to endpoint 0, the palette is 0, 1, 2/3, 1/3.
+        const __m128i palette = _mm_setr_epi8(1, 3, 2, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0);
+
+        for (int b = 0; b < 4; ++b)
+        {
+            const __m128i direction = Broadcast(weights, b);
+            const __m128i offset = Broadcast(origin, b);
+            const __m128 scale = _mm_castsi128_ps(Broadcast(_mm_castps_si128(scales), b));
+
+            __m128i positions[4];
+            for (int i = 0; i < 4; ++i)
+            {
+                __m128i dots = _mm_madd_epi16(_mm_maddubs_epi16(blocks[b][i], direction), _mm_set1_epi16(1));
+                positions[i] = RampPositions(dots, offset, scale);
+            }
+
+            __m128i packed = _mm_packs_epi16(_mm_packs_epi32(positions[0], positions[1]), _mm_packs_epi32(positions[2], positions[3]));
+            packed = _mm_min_epi8(_mm_max_epi8(packed, _mm_setzero_si128()), _mm_set1_epi8(3));
+            packed = _mm_xor_si128(_mm_shuffle_epi8(palette, packed), Broadcast(swap, b));
+
+            const uint32_t block[2] = { endpoints[b], PackIndices2(packed) };
+            memcpy(pDest + destStride * b, block, sizeof(block));
+        }
+    }
+
+    //-------------------------------------------------------------------------------------
+    // BC4 block, and the alpha block of BC3, from the 16 values of a channel. Always written in
+    // eight value mode.
+    void EncodeChannelBlock(uint8_t* pDest, __m128i values)
+    {
+        __m128i minimum = _mm_min_epu8(values, _mm_srli_si128(values, 8));
+        __m128i maximum = _mm_max_epu8(values, _mm_srli_si128(values, 8));
+        minimum = _mm_min_epu8(minimum, _mm_srli_si128(minimum, 4));
+        maximum = _mm_max_epu8(maximum, _mm_srli_si128(maximum, 4));
+        minimum = _mm_min_epu8(minimum, _mm_srli_si128(minimum, 2));
+        maximum = _mm_max_epu8(maximum, _mm_srli_si128(maximum, 2));
+        minimum = _mm_min_epu8(minimum, _mm_srli_si128(minimum, 1));
+        maximum = _mm_max_epu8(maximum, _mm_srli_si128(maximum, 1));
+
+        const int lo = _mm_cvtsi128_si32(minimum) & 0xff;
+        const int hi = _mm_cvtsi128_si32(maximum) & 0xff;
+        const int inset = (hi - lo) >> INSET_ALPHA_SHIFT;
+        const int endpoint0 = hi - inset;
+        const int endpoint1 = lo + inset;
+
+        uint64_t indices = 0;
+        if (endpoint0 > endpoint1)
+        {
+            const __m128i offset = _mm_set1_epi32(endpoint1);
+            const __m128 scale = _mm_set1_ps(7.0f / float(endpoint0 - endpoint1));
+
+            __m128i positions[4];
+            positions[0] = RampPositions(_mm_cvtepu8_epi32(values), offset, scale);
+            positions[1] = RampPositions(_mm_cvtepu8_epi32(_mm_srli_si128(values, 4)), offset, scale);
+            positions[2] = RampPositions(_mm_cvtepu8_epi32(_mm_srli_si128(values, 8)), offset, scale);
+            positions[3] = RampPositions(_mm_cvtepu8_epi32(_mm_srli_si128(values, 12)), offset, scale);
+
+            __m128i packed = _mm_packs_epi16(_mm_packs_epi32(positions[0], positions[1]), _mm_packs_epi32(positions[2], positions[3]));
+            packed = _mm_min_epi8(_mm_max_epi8(packed, _mm_setzero_si128()), _mm_set1_epi8(7));
+
+            // Ramp positions run from endpoint 1 to endpoint 0, the palette is 0, 1, 6/7, ..., 1/7.
+            packed = _mm_shuffle_epi8(_mm_setr_epi8(1, 7, 6, 5, 4, 3, 2, 0, 0, 0, 0, 0, 0, 0, 0, 0), packed);
+            indices = PackIndices3(packed);
+        }
+
+        pDest[0] = uint8_t(endpoint0);
+        pDest[1] = uint8_t(endpoint1);
+        memcpy(pDest + 2, &indices, 6);
+    }
+}
+
+//-------------------------------------------------------------------------------------
+bool DirectX::FastEncoderSupported() noexcept
+{
+    static const bool bSupported = []()
+    {
+        unsigned int ecx = 0;
+#ifdef _MSC_VER
+        int info[4] = {};
+        __cpuid(info, 1);
+        ecx = unsigned(info[2]);
+#else
+        unsigned int eax, ebx, edx;
+        if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx))
+            return false;
+#endif
+        const unsigned int SSSE3 = 1u << 9, SSE41 = 1u << 19;
+        return (ecx & (SSSE3 | SSE41)) == (SSSE3 | SSE41);
+    }();
+
+    return bSupported;
+}
+
+void DirectX::FastEncodeBC1(uint8_t* pDest, const uint8_t* pSrc, size_t srcPitch, size_t count, bool bBGR) noexcept
+{
+    __m128i blocks[4][4];
+    for (size_t i = 0; i < count; i += 4, pSrc += 64, pDest += 32)
+    {
+        const size_t blockCount = std::min<size_t>(4, count - i);
+        for (size_t b = 0; b < 4; ++b)
+            LoadBlock(pSrc + 16 * std::min(b, blockCount - 1), srcPitch, blocks[b]);
+
+        if (blockCount == 4)
+        {
+            EncodeColorBlocks(pDest, 8, blocks, bBGR);
+        }
+        else
+        {
+            // The last block stands in for the missing ones.
+            uint8_t temp[32];
+            EncodeColorBlocks(temp, 8, blocks, bBGR);
+            memcpy(pDest, temp, blockCount * 8);
+        }
+    }
+}
+
+void DirectX::FastEncodeBC3(uint8_t* pDest, const uint8_t* pSrc, size_t srcPitch, size_t count, bool bBGR) noexcept
+{
+    const __m128i alpha = ChannelSelect(4, 3);
+
+    __m128i blocks[4][4];
+    for (size_t i = 0; i < count; i += 4, pSrc += 64, pDest += 64)
+    {
+        const size_t blockCount = std::min<size_t>(4, count - i);
+        for (size_t b = 0; b < 4; ++b)
+            LoadBlock(pSrc + 16 * std::min(b, blockCount - 1), srcPitch, blocks[b]);
+
+        for (size_t b = 0; b < blockCount; ++b)
+            EncodeChannelBlock(pDest + 16 * b, GatherChannel(blocks[b], alpha));
+
+        if (blockCount == 4)
+        {
+            EncodeColorBlocks(pDest + 8, 16, blocks, bBGR);
+        }
+        else
+        {
+            uint8_t temp[64];
+            EncodeColorBlocks(temp, 16, blocks, bBGR);
+            for (size_t b = 0; b < blockCount; ++b)
+                memcpy(pDest + 16 * b + 8, temp + 16 * b, 8);
+        }
+    }
+}
+
+void DirectX::FastEncodeBC4(uint8_t* pDest, const uint8_t* pSrc, size_t srcPitch, size_t count, size_t pixelSize, size_t channel) noexcept
+{
+    const __m128i select = ChannelSelect(pixelSize, channel);
+
+    __m128i rows[4];
+    for (size_t i = 0; i < count; ++i, pSrc += pixelSize * 4, pDest += 8)
+    {
+        for (size_t j = 0; j < 4; ++j)
+            rows[j] = LoadRow(pSrc + srcPitch * j, pixelSize);
+
+        EncodeChannelBlock(pDest, GatherChannel(rows, select));
+    }
+}
+
+void DirectX::FastEncodeBC5(uint8_t* pDest, const uint8_t* pSrc, size_t srcPitch, size_t count, size_t pixelSize, size_t channelR, size_t channelG) noexcept
+{
+    const __m128i selectR = ChannelSelect(pixelSize, channelR);
+    const __m128i selectG = ChannelSelect(pixelSize, channelG);
+
+    __m128i rows[4];
+    for (size_t i = 0; i < count; ++i, pSrc += pixelSize * 4, pDest += 16)
+    {
+        for (size_t j = 0; j < 4; ++j)
+            rows[j] = LoadRow(pSrc + srcPitch * j, pixelSize);
+
+        EncodeChannelBlock(pDest, GatherChannel(rows, selectR));
+        EncodeChannelBlock(pDest + 8, GatherChannel(rows, selectG));
+    }
+}
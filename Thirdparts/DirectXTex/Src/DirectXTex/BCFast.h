@@ -0,0 +1,34 @@
+//-------------------------------------------------------------------------------------
+// BCFast.h
+//  
+// Real-time BC1, BC3, BC4 and BC5 encoders for TEX_COMPRESS_FAST
+//
+// Licensed under the MIT License.
+//-------------------------------------------------------------------------------------
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace DirectX
+{
+    // Bounding box endpoints inset by a fraction of the range, indices by projecting each texel on
+    // the endpoint line. Works on 8-bit texels with SSE4.1; color blocks go four at a time with the
+    // endpoint math running one block per lane. One to two orders of magnitude faster than the
+    // cluster fit encoders, at a visibly lower quality.
+    //
+    // Each call encodes count horizontally adjacent 4x4 blocks. pSrc points at the top left texel of
+    // the first one; all four rows of every block must be readable, partial blocks are replicated
+    // by the caller. pixelSize is the byte size of a texel, channel offsets are bytes within it.
+
+    // SSSE3 and SSE4.1, checked once.
+    bool FastEncoderSupported() noexcept;
+
+    // BC1 is always written in four color mode, alpha is ignored. bBGR selects B8G8R8A8 texels.
+    void FastEncodeBC1(uint8_t* pDest, const uint8_t* pSrc, size_t srcPitch, size_t count, bool bBGR) noexcept;
+    void FastEncodeBC3(uint8_t* pDest, const uint8_t* pSrc, size_t srcPitch, size_t count, bool bBGR) noexcept;
+
+    void FastEncodeBC4(uint8_t* pDest, const uint8_t* pSrc, size_t srcPitch, size_t count, size_t pixelSize, size_t channel) noexcept;
+    void FastEncodeBC5(uint8_t* pDest, const uint8_t* pSrc, size_t srcPitch, size_t count, size_t pixelSize, size_t channelR, size_t channelG) noexcept;
+}
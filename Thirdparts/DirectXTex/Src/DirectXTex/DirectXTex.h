@@ -486,6 +486,10 @@ namespace DirectX
 
         TEX_FILTER_FORCE_WIC        = 0x20000000,
             // Forces use of the WIC path even when logic would have picked a non-WIC path when both are an option
+
+        TEX_FILTER_PARALLEL         = 0x40000000,
+            // Convert and Resize split the image into tiles of rows processed on all cores, which implies the non-WIC path
+            // unless TEX_FILTER_FORCE_WIC is given. Error diffusion dithering and triangle filtering stay on one thread
     };
 
     HRESULT __cdecl Resize(
@@ -591,6 +595,10 @@ namespace DirectX
 
         TEX_COMPRESS_PARALLEL           = 0x10000000,
             // Compress is free to use multithreading to improve performance (by default it does not use multithreading)
+
+        TEX_COMPRESS_FAST               = 0x20000000,
+            // Real-time bounding box encoder for BC1, BC3, BC4 and BC5 UNORM from 8-bit RGBA, BGRA, RG or R sources that need no
+            // sRGB conversion; anything else uses the default encoders. Threshold and dithering are ignored, BC1 is always opaque
     };
 
     HRESULT __cdecl Compress(
@@ -11,12 +11,8 @@
 
 #include "DirectXTexP.h"
 
-#ifdef _OPENMP
-#include <omp.h>
-#pragma warning(disable : 4616 6993)
-#endif
-
 #include "BC.h"
+#include "BCFast.h"
 
 using namespace DirectX;
 
@@ -195,7 +191,15 @@ namespace
 
 
     //-------------------------------------------------------------------------------------
-#ifdef _OPENMP
+    // Calls encodeRow for every block row until one fails, a block row per tile.
+    template<typename F>
+    bool ForEachBlockRow(size_t nbHeight, bool bParallel, F encodeRow)
+    {
+        return _ForEachRowTile(nbHeight, 1, bParallel, [&](size_t by, size_t) { return encodeRow(by); });
+    }
+
+
+    //-------------------------------------------------------------------------------------
     HRESULT CompressBC_Parallel(
         const Image& image,
         const Image& result,
@@ -232,100 +236,219 @@ namespace
         if (!DetermineEncoderSettings(result.format, pfEncode, blocksize, cflags))
             return HRESULT_FROM_WIN32(ERROR_NOT_SUPPORTED);
 
-        // Refactored version of loop to support parallel independance
-        const size_t nBlocks = std::max<size_t>(1, (image.width + 3) / 4) * std::max<size_t>(1, (image.height + 3) / 4);
+        const size_t nbWidth = std::max<size_t>(1, (image.width + 3) / 4);
+        const size_t nbHeight = std::max<size_t>(1, (image.height + 3) / 4);
 
-        bool fail = false;
-
-#pragma omp parallel for
-        for (int nb = 0; nb < static_cast<int>(nBlocks); ++nb)
+        auto encodeRow = [&](size_t by)
         {
-            int nbWidth = std::max<int>(1, int((image.width + 3) / 4));
-
-            int y = nb / nbWidth;
-            int x = (nb - (y*nbWidth)) * 4;
-            y *= 4;
-
-            assert((x >= 0) && (x < int(image.width)));
-            assert((y >= 0) && (y < int(image.height)));
-
+            size_t y = by * 4;
             size_t rowPitch = image.rowPitch;
-            const uint8_t *pSrc = image.pixels + (y*rowPitch) + (x*sbpp);
+            size_t ph = std::min<size_t>(4, image.height - y);
 
-            uint8_t *pDest = result.pixels + (nb*blocksize);
+            for (size_t bx = 0; bx < nbWidth; ++bx)
+            {
+                size_t x = bx * 4;
 
-            size_t ph = std::min<size_t>(4, image.height - y);
-            size_t pw = std::min<size_t>(4, image.width - x);
-            assert(pw > 0 && ph > 0);
+                assert(x < image.width);
+                assert(y < image.height);
 
-            ptrdiff_t bytesLeft = pEnd - pSrc;
-            assert(bytesLeft > 0);
-            size_t bytesToRead = std::min<size_t>(rowPitch, size_t(bytesLeft));
+                const uint8_t *pSrc = image.pixels + (y*rowPitch) + (x*sbpp);
+                uint8_t *pDest = result.pixels + (by*result.rowPitch) + (bx*blocksize);
 
-            __declspec(align(16)) XMVECTOR temp[16];
-            if (!_LoadScanline(&temp[0], pw, pSrc, bytesToRead, format))
-                fail = true;
+                size_t pw = std::min<size_t>(4, image.width - x);
+                assert(pw > 0 && ph > 0);
 
-            if (ph > 1)
-            {
-                bytesToRead = std::min<size_t>(rowPitch, size_t(bytesLeft - rowPitch));
-                if (!_LoadScanline(&temp[4], pw, pSrc + rowPitch, bytesToRead, format))
-                    fail = true;
+                ptrdiff_t bytesLeft = pEnd - pSrc;
+                assert(bytesLeft > 0);
+                size_t bytesToRead = std::min<size_t>(rowPitch, size_t(bytesLeft));
+
+                alignas(16) XMVECTOR temp[16];
+                if (!_LoadScanline(&temp[0], pw, pSrc, bytesToRead, format))
+                    return false;
 
-                if (ph > 2)
+                if (ph > 1)
                 {
-                    bytesToRead = std::min<size_t>(rowPitch, size_t(bytesLeft - rowPitch * 2));
-                    if (!_LoadScanline(&temp[8], pw, pSrc + rowPitch * 2, bytesToRead, format))
-                        fail = true;
+                    bytesToRead = std::min<size_t>(rowPitch, size_t(bytesLeft - rowPitch));
+                    if (!_LoadScanline(&temp[4], pw, pSrc + rowPitch, bytesToRead, format))
+                        return false;
 
-                    if (ph > 3)
+                    if (ph > 2)
                     {
-                        bytesToRead = std::min<size_t>(rowPitch, size_t(bytesLeft - rowPitch * 3));
-                        if (!_LoadScanline(&temp[12], pw, pSrc + rowPitch * 3, bytesToRead, format))
-                            fail = true;
+                        bytesToRead = std::min<size_t>(rowPitch, size_t(bytesLeft - rowPitch * 2));
+                        if (!_LoadScanline(&temp[8], pw, pSrc + rowPitch * 2, bytesToRead, format))
+                            return false;
+
+                        if (ph > 3)
+                        {
+                            bytesToRead = std::min<size_t>(rowPitch, size_t(bytesLeft - rowPitch * 3));
+                            if (!_LoadScanline(&temp[12], pw, pSrc + rowPitch * 3, bytesToRead, format))
+                                return false;
+                        }
                     }
                 }
-            }
 
-            if (pw != 4 || ph != 4)
-            {
-                // Replicate pixels for partial block
-                static const size_t uSrc[] = { 0, 0, 0, 1 };
-
-                if (pw < 4)
+                if (pw != 4 || ph != 4)
                 {
-                    for (size_t t = 0; t < ph && t < 4; ++t)
+                    // Replicate pixels for partial block
+                    static const size_t uSrc[] = { 0, 0, 0, 1 };
+
+                    if (pw < 4)
                     {
-                        for (size_t s = pw; s < 4; ++s)
+                        for (size_t t = 0; t < ph && t < 4; ++t)
                         {
-                            temp[(t << 2) | s] = temp[(t << 2) | uSrc[s]];
+                            for (size_t s = pw; s < 4; ++s)
+                            {
+                                temp[(t << 2) | s] = temp[(t << 2) | uSrc[s]];
+                            }
                         }
                     }
-                }
 
-                if (ph < 4)
-                {
-                    for (size_t t = ph; t < 4; ++t)
+                    if (ph < 4)
                     {
-                        for (size_t s = 0; s < 4; ++s)
+                        for (size_t t = ph; t < 4; ++t)
                         {
-                            temp[(t << 2) | s] = temp[(uSrc[t] << 2) | s];
+                            for (size_t s = 0; s < 4; ++s)
+                            {
+                                temp[(t << 2) | s] = temp[(uSrc[t] << 2) | s];
+                            }
                         }
                     }
                 }
+
+                _ConvertScanline(temp, 16, result.format, format, cflags | srgb);
+
+                if (pfEncode)
+                    pfEncode(pDest, temp, bcflags);
+                else
+                    D3DXEncodeBC1(pDest, temp, threshold, bcflags);
             }
 
-            _ConvertScanline(temp, 16, result.format, format, cflags | srgb);
+            return true;
+        };
 
-            if (pfEncode)
-                pfEncode(pDest, temp, bcflags);
-            else
-                D3DXEncodeBC1(pDest, temp, threshold, bcflags);
+        return ForEachBlockRow(nbHeight, true, encodeRow) ? S_OK : E_FAIL;
+    }
+
+
+    //-------------------------------------------------------------------------------------
+    // TEX_COMPRESS_FAST reads the 8-bit texels as they are, so it only takes sources that need no
+    // conversion on the way to the target.
+    bool DetermineFastEncoderSettings(_In_ DXGI_FORMAT source, _In_ DXGI_FORMAT target, _In_ DWORD srgb, _Out_ size_t& pixelSize, _Out_ bool& bgr)
+    {
+        pixelSize = 0;
+        bgr = false;
+
+        if (!FastEncoderSupported())
+            return false;
+
+        const bool srgbIn = IsSRGB(source) || (srgb & TEX_COMPRESS_SRGB_IN) != 0;
+        const bool srgbOut = IsSRGB(target) || (srgb & TEX_COMPRESS_SRGB_OUT) != 0;
+        if (srgbIn != srgbOut)
+            return false;
+
+        switch (source)
+        {
+        case DXGI_FORMAT_R8G8B8A8_UNORM:
+        case DXGI_FORMAT_R8G8B8A8_UNORM_SRGB:   pixelSize = 4; break;
+        case DXGI_FORMAT_B8G8R8A8_UNORM:
+        case DXGI_FORMAT_B8G8R8A8_UNORM_SRGB:   pixelSize = 4; bgr = true; break;
+        case DXGI_FORMAT_R8G8_UNORM:            pixelSize = 2; break;
+        case DXGI_FORMAT_R8_UNORM:              pixelSize = 1; break;
+        default:                                return false;
         }
 
-        return (fail) ? E_FAIL : S_OK;
+        switch (target)
+        {
+        case DXGI_FORMAT_BC1_UNORM:
+        case DXGI_FORMAT_BC1_UNORM_SRGB:
+        case DXGI_FORMAT_BC3_UNORM:
+        case DXGI_FORMAT_BC3_UNORM_SRGB:        return pixelSize == 4;
+        case DXGI_FORMAT_BC4_UNORM:             return true;
+        case DXGI_FORMAT_BC5_UNORM:             return pixelSize >= 2;
+        default:                                return false;
+        }
+    }
+
+
+    //-------------------------------------------------------------------------------------
+    HRESULT CompressBC_Fast(
+        const Image& image,
+        const Image& result,
+        size_t pixelSize,
+        bool bgr,
+        bool parallel)
+    {
+        if (!image.pixels || !result.pixels)
+            return E_POINTER;
+
+        assert(image.width == result.width);
+        assert(image.height == result.height);
+
+        const size_t blocksize = (result.format == DXGI_FORMAT_BC3_UNORM || result.format == DXGI_FORMAT_BC3_UNORM_SRGB || result.format == DXGI_FORMAT_BC5_UNORM) ? 16 : 8;
+        const size_t red = bgr ? 2 : 0;
+
+        auto encode = [&](uint8_t* pDest, const uint8_t* pSrc, size_t srcPitch, size_t count)
+        {
+            switch (result.format)
+            {
+            case DXGI_FORMAT_BC1_UNORM:
+            case DXGI_FORMAT_BC1_UNORM_SRGB:    FastEncodeBC1(pDest, pSrc, srcPitch, count, bgr); break;
+            case DXGI_FORMAT_BC3_UNORM:
+            case DXGI_FORMAT_BC3_UNORM_SRGB:    FastEncodeBC3(pDest, pSrc, srcPitch, count, bgr); break;
+            case DXGI_FORMAT_BC4_UNORM:         FastEncodeBC4(pDest, pSrc, srcPitch, count, pixelSize, red); break;
+            default:                            FastEncodeBC5(pDest, pSrc, srcPitch, count, pixelSize, red, 1); break;
+            }
+        };
+
+        const size_t nbWidth = std::max<size_t>(1, (image.width + 3) / 4);
+        const size_t nbHeight = std::max<size_t>(1, (image.height + 3) / 4);
+
+        auto encodeRow = [&](size_t by)
+        {
+            const size_t y = by * 4;
+            const size_t ph = std::min<size_t>(4, image.height - y);
+            const uint8_t *pSrc = image.pixels + (y*image.rowPitch);
+            uint8_t *pDest = result.pixels + (by*result.rowPitch);
+
+            // Whole blocks are read in place, a row of them per call
+            const size_t nbFull = (ph == 4) ? image.width / 4 : 0;
+            if (nbFull > 0)
+                encode(pDest, pSrc, image.rowPitch, nbFull);
+
+            // Replicate pixels for partial blocks, the same way the default path does
+            static const size_t uSrc[] = { 0, 0, 0, 1 };
+            for (size_t bx = nbFull; bx < nbWidth; ++bx)
+            {
+                const size_t x = bx * 4;
+                const size_t pw = std::min<size_t>(4, image.width - x);
+                assert(pw > 0 && ph > 0);
+
+                uint8_t temp[16 * 4];
+                for (size_t t = 0; t < 4; ++t)
+                {
+                    size_t sy = t;
+                    while (sy >= ph)
+                        sy = uSrc[sy];
+
+                    for (size_t s = 0; s < 4; ++s)
+                    {
+                        size_t sx = s;
+                        while (sx >= pw)
+                            sx = uSrc[sx];
+
+                        memcpy(temp + ((t << 2) | s) * pixelSize, pSrc + (sy*image.rowPitch) + (x + sx) * pixelSize, pixelSize);
+                    }
+                }
+
+                encode(pDest + (bx*blocksize), temp, pixelSize * 4, 1);
+            }
+
+            return true;
+        };
+
+        ForEachBlockRow(nbHeight, parallel, encodeRow);
+        return S_OK;
     }
-#endif // _OPENMP
 
 
     //-------------------------------------------------------------------------------------
@@ -617,13 +740,15 @@ HRESULT DirectX::Compress(
     }
 
     // Compress single image
-    if (compress & TEX_COMPRESS_PARALLEL)
+    size_t pixelSize = 0;
+    bool bgr = false;
+    if ((compress & TEX_COMPRESS_FAST) && DetermineFastEncoderSettings(srcImage.format, format, GetSRGBFlags(compress), pixelSize, bgr))
+    {
+        hr = CompressBC_Fast(srcImage, *img, pixelSize, bgr, (compress & TEX_COMPRESS_PARALLEL) != 0);
+    }
+    else if (compress & TEX_COMPRESS_PARALLEL)
     {
-#ifndef _OPENMP
-        return E_NOTIMPL;
-#else
         hr = CompressBC_Parallel(srcImage, *img, GetBCFlags(compress), GetSRGBFlags(compress), threshold);
-#endif // _OPENMP
     }
     else
     {
@@ -677,6 +802,10 @@ HRESULT DirectX::Compress(
         return E_POINTER;
     }
 
+    size_t pixelSize = 0;
+    bool bgr = false;
+    const bool fast = (compress & TEX_COMPRESS_FAST) && DetermineFastEncoderSettings(metadata.format, format, GetSRGBFlags(compress), pixelSize, bgr);
+
     for (size_t index = 0; index < nimages; ++index)
     {
         assert(dest[index].format == format);
@@ -689,21 +818,23 @@ HRESULT DirectX::Compress(
             return E_FAIL;
         }
 
-        if ((compress & TEX_COMPRESS_PARALLEL))
+        if (fast)
         {
-#ifndef _OPENMP
-            return E_NOTIMPL;
-#else
-            if (compress & TEX_COMPRESS_PARALLEL)
+            hr = CompressBC_Fast(src, dest[index], pixelSize, bgr, (compress & TEX_COMPRESS_PARALLEL) != 0);
+            if (FAILED(hr))
             {
-                hr = CompressBC_Parallel(src, dest[index], GetBCFlags(compress), GetSRGBFlags(compress), threshold);
-                if (FAILED(hr))
-                {
-                    cImages.Release();
-                    return  hr;
-                }
+                cImages.Release();
+                return hr;
+            }
+        }
+        else if ((compress & TEX_COMPRESS_PARALLEL))
+        {
+            hr = CompressBC_Parallel(src, dest[index], GetBCFlags(compress), GetSRGBFlags(compress), threshold);
+            if (FAILED(hr))
+            {
+                cImages.Release();
+                return  hr;
             }
-#endif // _OPENMP
         }
         else
         {
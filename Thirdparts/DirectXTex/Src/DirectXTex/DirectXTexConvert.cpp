@@ -772,6 +772,9 @@ _Use_decl_annotations_ bool DirectX::_LoadScanline(
 
     const XMVECTOR* ePtr = pDestination + count;
 
+    if (_LoadScanlineFast(pDestination, count, pSource, size, format, false))
+        return true;
+
     switch (static_cast<int>(format))
     {
     case DXGI_FORMAT_R32G32B32A32_FLOAT:
@@ -1621,6 +1624,9 @@ bool DirectX::_StoreScanline(
 
     const XMVECTOR* ePtr = pSource + count;
 
+    if (_StoreScanlineFast(pDestination, size, format, pSource, count, false))
+        return true;
+
     switch (static_cast<int>(format))
     {
     case DXGI_FORMAT_R32G32B32A32_FLOAT:
@@ -2718,6 +2724,303 @@ HRESULT DirectX::_ConvertFromR16G16B16A16(const Image& srcImage, const Image& de
 }
 
 
+//-------------------------------------------------------------------------------------
+// Whole scanline load/store of the common four channel formats
+//
+// 8-bit rows convert four texels per step and decode sRGB through a table. sRGB is encoded by
+// finding the byte whose rounding interval holds the linear value, so the bytes match those of
+// XMColorRGBToSRGB followed by the store. Half rows use F16C when the build has it.
+//-------------------------------------------------------------------------------------
+namespace
+{
+    enum FAST_FORMAT
+    {
+        FAST_NONE = 0,
+        FAST_RGBA8,
+        FAST_BGRA8,
+        FAST_RGBA16F,
+        FAST_RGBA32F,
+    };
+
+    FAST_FORMAT GetFastFormat(_In_ DXGI_FORMAT format)
+    {
+        switch (format)
+        {
+        case DXGI_FORMAT_R8G8B8A8_UNORM:
+        case DXGI_FORMAT_R8G8B8A8_UNORM_SRGB:   return FAST_RGBA8;
+        case DXGI_FORMAT_B8G8R8A8_UNORM:
+        case DXGI_FORMAT_B8G8R8A8_UNORM_SRGB:   return FAST_BGRA8;
+        case DXGI_FORMAT_R16G16B16A16_FLOAT:    return FAST_RGBA16F;
+        case DXGI_FORMAT_R32G32B32A32_FLOAT:    return FAST_RGBA32F;
+        default:                                return FAST_NONE;
+        }
+    }
+
+    inline size_t GetFastPixelSize(_In_ FAST_FORMAT format)
+    {
+        return (format == FAST_RGBA32F) ? 16 : (format == FAST_RGBA16F) ? 8 : 4;
+    }
+
+    const size_t SRGB_ENCODE_STEPS = 4096;
+
+    struct SRGBTables
+    {
+        float decode[256];
+        // Smallest linear value that encodes to each byte, the last one past the range.
+        float thresholds[257];
+        // Byte at the start of each step of the linear range. A step is narrower than a byte
+        // anywhere on the curve, so the thresholds correct it by at most one.
+        uint8_t encode[SRGB_ENCODE_STEPS];
+    };
+
+    // XMColorRGBToSRGB of one channel followed by the 8-bit store.
+    uint32_t EncodeSRGB(float linear)
+    {
+        float value = (linear < 0.0031308f) ? linear * 12.92f : 1.055f * powf(linear, 1.0f / 2.4f) - 0.055f;
+        long byte = lrintf(value * 255.0f);
+        return static_cast<uint32_t>((byte < 0) ? 0 : (byte > 255) ? 255 : byte);
+    }
+
+    SRGBTables CreateSRGBTables()
+    {
+        SRGBTables tables = {};
+
+        // XMColorSRGBToRGB of one channel
+        for (uint32_t i = 0; i < 256; ++i)
+        {
+            float value = float(i) / 255.0f;
+            tables.decode[i] = (value > 0.04045f) ? powf(value * (1.0f / 1.055f) + (0.055f / 1.055f), 2.4f) : value * (1.0f / 12.92f);
+        }
+
+        // Encoding rises with the linear value, and positive floats order like their bits.
+        for (uint32_t byte = 1; byte < 256; ++byte)
+        {
+            uint32_t lo = 0;
+            uint32_t hi = 0x3F800000;
+            while (lo < hi)
+            {
+                uint32_t mid = lo + (hi - lo) / 2;
+                float linear;
+                memcpy(&linear, &mid, sizeof(float));
+                if (EncodeSRGB(linear) >= byte)
+                    hi = mid;
+                else
+                    lo = mid + 1;
+            }
+            memcpy(&tables.thresholds[byte], &lo, sizeof(float));
+        }
+        tables.thresholds[256] = 2.0f;
+
+        for (size_t i = 0; i < SRGB_ENCODE_STEPS; ++i)
+            tables.encode[i] = static_cast<uint8_t>(EncodeSRGB(float(i) / float(SRGB_ENCODE_STEPS - 1)));
+
+        return tables;
+    }
+
+    const SRGBTables& GetSRGBTables()
+    {
+        static const SRGBTables s_tables = CreateSRGBTables();
+        return s_tables;
+    }
+
+    inline uint8_t EncodeSRGBByte(const SRGBTables& tables, float linear)
+    {
+        // Saturate, NaN to zero as XMVectorSaturate does
+        float value = (linear > 0.0f) ? std::min(linear, 1.0f) : 0.0f;
+
+        uint32_t byte = tables.encode[static_cast<size_t>(value * float(SRGB_ENCODE_STEPS - 1))];
+        if (value < tables.thresholds[byte])
+            --byte;
+        else if (value >= tables.thresholds[byte + 1])
+            ++byte;
+
+        return static_cast<uint8_t>(byte);
+    }
+
+    void LoadRGBA8(
+        _Out_writes_(count) XMVECTOR* pDestination, size_t count,
+        _In_reads_(count * 4) const uint8_t* pSource, bool bgr, bool srgb)
+    {
+        if (srgb)
+        {
+            // Color through the table, alpha stays linear
+            const float* decode = GetSRGBTables().decode;
+            for (size_t i = 0; i < count; ++i)
+            {
+                const uint8_t* p = pSource + i * 4;
+                pDestination[i] = XMVectorSet(decode[p[bgr ? 2 : 0]], decode[p[1]], decode[p[bgr ? 0 : 2]], float(p[3]) * (1.0f / 255.0f));
+            }
+            return;
+        }
+
+        size_t i = 0;
+#if defined(_XM_SSE_INTRINSICS_)
+        const __m128i zero = _mm_setzero_si128();
+        const __m128 scale = _mm_set1_ps(1.0f / 255.0f);
+        for (; i + 4 <= count; i += 4)
+        {
+            __m128i texels = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pSource + i * 4));
+            __m128i lo = _mm_unpacklo_epi8(texels, zero);
+            __m128i hi = _mm_unpackhi_epi8(texels, zero);
+
+            __m128i t[4] = { _mm_unpacklo_epi16(lo, zero), _mm_unpackhi_epi16(lo, zero), _mm_unpacklo_epi16(hi, zero), _mm_unpackhi_epi16(hi, zero) };
+            for (size_t j = 0; j < 4; ++j)
+            {
+                __m128i v = bgr ? _mm_shuffle_epi32(t[j], _MM_SHUFFLE(3, 0, 1, 2)) : t[j];
+                pDestination[i + j] = _mm_mul_ps(_mm_cvtepi32_ps(v), scale);
+            }
+        }
+#endif
+        for (; i < count; ++i)
+        {
+            XMVECTOR v = XMLoadUByteN4(reinterpret_cast<const XMUBYTEN4*>(pSource + i * 4));
+            pDestination[i] = bgr ? XMVectorSwizzle<2, 1, 0, 3>(v) : v;
+        }
+    }
+
+    void StoreRGBA8(
+        _Out_writes_(count * 4) uint8_t* pDestination,
+        _In_reads_(count) const XMVECTOR* pSource, size_t count, bool bgr, bool srgb)
+    {
+        if (srgb)
+        {
+            const SRGBTables& tables = GetSRGBTables();
+            for (size_t i = 0; i < count; ++i)
+            {
+                XMFLOAT4A v;
+                XMStoreFloat4A(&v, pSource[i]);
+
+                uint8_t* p = pDestination + i * 4;
+                p[bgr ? 2 : 0] = EncodeSRGBByte(tables, v.x);
+                p[1] = EncodeSRGBByte(tables, v.y);
+                p[bgr ? 0 : 2] = EncodeSRGBByte(tables, v.z);
+                p[3] = static_cast<uint8_t>(lrintf(((v.w > 0.0f) ? std::min(v.w, 1.0f) : 0.0f) * 255.0f));
+            }
+            return;
+        }
+
+        size_t i = 0;
+#if defined(_XM_SSE_INTRINSICS_)
+        const __m128 zero = _mm_setzero_ps();
+        const __m128 one = _mm_set1_ps(1.0f);
+        const __m128 scale = _mm_set1_ps(255.0f);
+        for (; i + 4 <= count; i += 4)
+        {
+            __m128i t[4];
+            for (size_t j = 0; j < 4; ++j)
+            {
+                // Saturate, round to nearest even as XMVectorRound does
+                __m128i v = _mm_cvtps_epi32(_mm_mul_ps(_mm_min_ps(_mm_max_ps(pSource[i + j], zero), one), scale));
+                t[j] = bgr ? _mm_shuffle_epi32(v, _MM_SHUFFLE(3, 0, 1, 2)) : v;
+            }
+
+            __m128i texels = _mm_packus_epi16(_mm_packs_epi32(t[0], t[1]), _mm_packs_epi32(t[2], t[3]));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(pDestination + i * 4), texels);
+        }
+#endif
+        for (; i < count; ++i)
+        {
+            XMVECTOR v = bgr ? XMVectorSwizzle<2, 1, 0, 3>(pSource[i]) : pSource[i];
+            XMStoreUByteN4(reinterpret_cast<XMUBYTEN4*>(pDestination + i * 4), v);
+        }
+    }
+}
+
+_Use_decl_annotations_
+bool DirectX::_IsFastScanlineFormat(DXGI_FORMAT format)
+{
+    return GetFastFormat(format) != FAST_NONE;
+}
+
+_Use_decl_annotations_
+bool DirectX::_LoadScanlineFast(
+    XMVECTOR* pDestination,
+    size_t count,
+    const void* pSource,
+    size_t size,
+    DXGI_FORMAT format,
+    bool srgb)
+{
+    assert(pDestination && count > 0 && ((reinterpret_cast<uintptr_t>(pDestination) & 0xF) == 0));
+    assert(pSource && size > 0);
+
+    FAST_FORMAT fast = GetFastFormat(format);
+    if (fast == FAST_NONE || (srgb && fast != FAST_RGBA8 && fast != FAST_BGRA8))
+        return false;
+
+    size_t pixelSize = GetFastPixelSize(fast);
+    if (size < pixelSize)
+        return false;
+
+    size_t n = std::min(count, size / pixelSize);
+    switch (fast)
+    {
+    case FAST_RGBA32F:
+        memcpy(pDestination, pSource, n * sizeof(XMVECTOR));
+        break;
+
+    case FAST_RGBA16F:
+#if defined(_XM_F16C_INTRINSICS_)
+        for (size_t i = 0; i < n; ++i)
+            pDestination[i] = _mm_cvtph_ps(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(static_cast<const uint8_t*>(pSource) + i * 8)));
+#else
+        XMConvertHalfToFloatStream(reinterpret_cast<float*>(pDestination), sizeof(float), static_cast<const HALF*>(pSource), sizeof(HALF), n * 4);
+#endif
+        break;
+
+    default:
+        LoadRGBA8(pDestination, n, static_cast<const uint8_t*>(pSource), fast == FAST_BGRA8, srgb);
+        break;
+    }
+
+    return true;
+}
+
+_Use_decl_annotations_
+bool DirectX::_StoreScanlineFast(
+    void* pDestination,
+    size_t size,
+    DXGI_FORMAT format,
+    const XMVECTOR* pSource,
+    size_t count,
+    bool srgb)
+{
+    assert(pDestination && size > 0);
+    assert(pSource && count > 0 && ((reinterpret_cast<uintptr_t>(pSource) & 0xF) == 0));
+
+    FAST_FORMAT fast = GetFastFormat(format);
+    if (fast == FAST_NONE || (srgb && fast != FAST_RGBA8 && fast != FAST_BGRA8))
+        return false;
+
+    size_t pixelSize = GetFastPixelSize(fast);
+    if (size < pixelSize)
+        return false;
+
+    size_t n = std::min(count, size / pixelSize);
+    switch (fast)
+    {
+    case FAST_RGBA32F:
+        memcpy(pDestination, pSource, n * sizeof(XMVECTOR));
+        break;
+
+    case FAST_RGBA16F:
+#if defined(_XM_F16C_INTRINSICS_)
+        for (size_t i = 0; i < n; ++i)
+            _mm_storel_epi64(reinterpret_cast<__m128i*>(static_cast<uint8_t*>(pDestination) + i * 8), _mm_cvtps_ph(pSource[i], _MM_FROUND_TO_NEAREST_INT));
+#else
+        XMConvertFloatToHalfStream(static_cast<HALF*>(pDestination), sizeof(HALF), reinterpret_cast<const float*>(pSource), sizeof(float), n * 4);
+#endif
+        break;
+
+    default:
+        StoreRGBA8(static_cast<uint8_t*>(pDestination), pSource, n, fast == FAST_BGRA8, srgb);
+        break;
+    }
+
+    return true;
+}
+
+
 //-------------------------------------------------------------------------------------
 // Convert from Linear RGB to sRGB
 //
@@ -2778,6 +3081,9 @@ bool DirectX::_StoreScanlineLinear(
         break;
     }
 
+    if ((flags & TEX_FILTER_SRGB_OUT) && _StoreScanlineFast(pDestination, size, format, pSource, count, true))
+        return true;
+
     // sRGB output processing (Linear RGB -> sRGB)
     if (flags & TEX_FILTER_SRGB_OUT)
     {
@@ -2853,6 +3159,9 @@ bool DirectX::_LoadScanlineLinear(
         break;
     }
 
+    if ((flags & TEX_FILTER_SRGB_IN) && _LoadScanlineFast(pDestination, count, pSource, size, format, true))
+        return true;
+
     if (_LoadScanline(pDestination, count, pSource, size, format))
     {
         // sRGB input processing (sRGB -> Linear RGB)
@@ -4394,6 +4703,12 @@ namespace
             return true;
         }
 
+        if (filter & TEX_FILTER_PARALLEL)
+        {
+            // WIC converts on the calling thread only
+            return false;
+        }
+
         if (filter & TEX_FILTER_SEPARATE_ALPHA)
         {
             // Alpha is not premultiplied, so use non-WIC code paths
@@ -4574,6 +4889,36 @@ namespace
     }
 
 
+    //-------------------------------------------------------------------------------------
+    // Pairs of the whole scanline formats that need nothing from _ConvertScanline but sRGB on
+    // an 8-bit side go straight from load to store. Sets which side converts sRGB.
+    //-------------------------------------------------------------------------------------
+    bool UseFastConversion(
+        _In_ DXGI_FORMAT sformat,
+        _In_ DXGI_FORMAT tformat,
+        _In_ DWORD filter,
+        _Out_ bool& srgbIn,
+        _Out_ bool& srgbOut)
+    {
+        srgbIn = false;
+        srgbOut = false;
+
+        if (!_IsFastScanlineFormat(sformat) || !_IsFastScanlineFormat(tformat))
+            return false;
+
+        if (filter & (TEX_FILTER_FLOAT_X2BIAS | TEX_FILTER_DITHER | TEX_FILTER_DITHER_DIFFUSION))
+            return false;
+
+        // As _ConvertScanline resolves the sRGB flags
+        bool in = IsSRGB(sformat) || (filter & TEX_FILTER_SRGB_IN) != 0;
+        bool out = IsSRGB(tformat) || (filter & TEX_FILTER_SRGB_OUT) != 0;
+        srgbIn = in && !out;
+        srgbOut = out && !in;
+
+        return (!srgbIn || BitsPerColor(sformat) == 8) && (!srgbOut || BitsPerColor(tformat) == 8);
+    }
+
+
     //-------------------------------------------------------------------------------------
     // Convert the source image (not using WIC)
     //-------------------------------------------------------------------------------------
@@ -4620,44 +4965,57 @@ namespace
         }
         else
         {
-            ScopedAlignedArrayXMVECTOR scanline(static_cast<XMVECTOR*>(_aligned_malloc((sizeof(XMVECTOR)*width), 16)));
-            if (!scanline)
-                return E_OUTOFMEMORY;
+            // Rows are independent without error diffusion, so they are converted in tiles
+            bool srgbIn = false;
+            bool srgbOut = false;
+            bool fast = UseFastConversion(srcImage.format, destImage.format, filter, srgbIn, srgbOut);
 
-            if (filter & TEX_FILTER_DITHER)
+            std::atomic<bool> outOfMemory(false);
+            auto convertRows = [&](size_t begin, size_t end) -> bool
             {
-                // Ordered dithering
-                for (size_t h = 0; h < srcImage.height; ++h)
+                ScopedAlignedArrayXMVECTOR scanline(static_cast<XMVECTOR*>(_aligned_malloc((sizeof(XMVECTOR)*width), 16)));
+                if (!scanline)
                 {
-                    if (!_LoadScanline(scanline.get(), width, pSrc, srcImage.rowPitch, srcImage.format))
-                        return E_FAIL;
-
-                    _ConvertScanline(scanline.get(), width, destImage.format, srcImage.format, filter);
-
-                    if (!_StoreScanlineDither(pDest, destImage.rowPitch, destImage.format, scanline.get(), width, threshold, h, z, nullptr))
-                        return E_FAIL;
-
-                    pSrc += srcImage.rowPitch;
-                    pDest += destImage.rowPitch;
+                    outOfMemory = true;
+                    return false;
                 }
-            }
-            else
-            {
-                // No dithering
-                for (size_t h = 0; h < srcImage.height; ++h)
+
+                const uint8_t* pSrcRow = pSrc + begin * srcImage.rowPitch;
+                uint8_t* pDestRow = pDest + begin * destImage.rowPitch;
+                for (size_t h = begin; h < end; ++h)
                 {
-                    if (!_LoadScanline(scanline.get(), width, pSrc, srcImage.rowPitch, srcImage.format))
-                        return E_FAIL;
+                    if (fast)
+                    {
+                        if (!_LoadScanlineFast(scanline.get(), width, pSrcRow, srcImage.rowPitch, srcImage.format, srgbIn)
+                            || !_StoreScanlineFast(pDestRow, destImage.rowPitch, destImage.format, scanline.get(), width, srgbOut))
+                            return false;
+                    }
+                    else
+                    {
+                        if (!_LoadScanline(scanline.get(), width, pSrcRow, srcImage.rowPitch, srcImage.format))
+                            return false;
 
-                    _ConvertScanline(scanline.get(), width, destImage.format, srcImage.format, filter);
+                        _ConvertScanline(scanline.get(), width, destImage.format, srcImage.format, filter);
 
-                    if (!_StoreScanline(pDest, destImage.rowPitch, destImage.format, scanline.get(), width, threshold))
-                        return E_FAIL;
+                        if (filter & TEX_FILTER_DITHER)
+                        {
+                            // Ordered dithering
+                            if (!_StoreScanlineDither(pDestRow, destImage.rowPitch, destImage.format, scanline.get(), width, threshold, h, z, nullptr))
+                                return false;
+                        }
+                        else if (!_StoreScanline(pDestRow, destImage.rowPitch, destImage.format, scanline.get(), width, threshold))
+                            return false;
+                    }
 
-                    pSrc += srcImage.rowPitch;
-                    pDest += destImage.rowPitch;
+                    pSrcRow += srcImage.rowPitch;
+                    pDestRow += destImage.rowPitch;
                 }
-            }
+
+                return true;
+            };
+
+            if (!_ForEachRowTile(srcImage.height, _RowTileHeight(width), (filter & TEX_FILTER_PARALLEL) != 0, convertRows))
+                return outOfMemory ? E_OUTOFMEMORY : E_FAIL;
         }
 
         return S_OK;
@@ -108,6 +108,9 @@
 #include <malloc.h>
 #include <memory>
 
+#include <algorithm>
+#include <atomic>
+#include <thread>
 #include <vector>
 
 #include <stdlib.h>
@@ -300,6 +303,66 @@ namespace DirectX
         _Inout_updates_all_(count) XMVECTOR* pBuffer, _In_ size_t count,
         _In_ DXGI_FORMAT outFormat, _In_ DXGI_FORMAT inFormat, _In_ DWORD flags);
 
+    //---------------------------------------------------------------------------------
+    // Whole scanline load/store for 8-bit RGBA/BGRA, 16-bit and 32-bit float RGBA. sRGB is only
+    // converted on the 8-bit formats; these return false for anything else so callers can fall
+    // back to the per-texel functions above.
+    bool __cdecl _IsFastScanlineFormat(_In_ DXGI_FORMAT format);
+
+    _Success_(return != false) bool __cdecl _LoadScanlineFast(
+        _Out_writes_(count) XMVECTOR* pDestination, _In_ size_t count,
+        _In_reads_bytes_(size) const void* pSource, _In_ size_t size, _In_ DXGI_FORMAT format, _In_ bool srgb);
+
+    _Success_(return != false) bool __cdecl _StoreScanlineFast(
+        _Out_writes_bytes_(size) void* pDestination, _In_ size_t size, _In_ DXGI_FORMAT format,
+        _In_reads_(count) const XMVECTOR* pSource, _In_ size_t count, _In_ bool srgb);
+
+    //---------------------------------------------------------------------------------
+    // Calls processRows(begin, end) on tiles of tileHeight rows until one fails. Tiles are
+    // independent, so worker threads take them off a shared counter. Plain std::thread instead
+    // of OpenMP keeps the parallel paths available on every toolchain.
+    template<typename F>
+    bool _ForEachRowTile(size_t height, size_t tileHeight, bool parallel, F processRows)
+    {
+        tileHeight = std::max<size_t>(tileHeight, 1);
+        const size_t tileCount = (height + tileHeight - 1) / tileHeight;
+
+        std::atomic<size_t> nextTile(0);
+        std::atomic<bool> fail(false);
+
+        auto processTiles = [&]()
+        {
+            for (size_t tile = nextTile++; tile < tileCount && !fail; tile = nextTile++)
+            {
+                size_t begin = tile * tileHeight;
+                if (!processRows(begin, std::min(begin + tileHeight, height)))
+                    fail = true;
+            }
+        };
+
+        size_t threadCount = parallel ? std::min<size_t>(std::max(1u, std::thread::hardware_concurrency()), tileCount) : 1;
+
+        // The calling thread takes tiles too.
+        std::vector<std::thread> threads;
+        if (threadCount > 1)
+            threads.reserve(threadCount - 1);
+        for (size_t i = 1; i < threadCount; ++i)
+            threads.emplace_back(processTiles);
+
+        processTiles();
+
+        for (auto& thread : threads)
+            thread.join();
+
+        return !fail;
+    }
+
+    // Rows per tile so a tile holds about 64K texels.
+    inline size_t __cdecl _RowTileHeight(_In_ size_t width)
+    {
+        return std::max<size_t>(65536 / std::max<size_t>(width, 1), 1);
+    }
+
     //---------------------------------------------------------------------------------
     // DDS helper functions
     HRESULT __cdecl _EncodeDDSHeader(
@@ -184,6 +184,12 @@ namespace
             return true;
         }
 
+        if (filter & TEX_FILTER_PARALLEL)
+        {
+            // WIC scales on the calling thread only
+            return false;
+        }
+
         if (IsSRGB(format) || (filter & TEX_FILTER_SRGB))
         {
             // Use non-WIC code paths for sRGB correct filtering
@@ -244,61 +250,83 @@ namespace
     // Resize custom filters
     //-------------------------------------------------------------------------------------
 
+    // The separable filters compute every destination row from the source alone, so rows are
+    // resized in tiles, on all cores with TEX_FILTER_PARALLEL. A tile that can not allocate its
+    // scanlines sets outOfMemory before failing.
+    template<typename F>
+    HRESULT ForEachRowTile(const Image& destImage, DWORD filter, const std::atomic<bool>& outOfMemory, F resizeRows)
+    {
+        if (!_ForEachRowTile(destImage.height, _RowTileHeight(destImage.width), (filter & TEX_FILTER_PARALLEL) != 0, resizeRows))
+            return outOfMemory ? E_OUTOFMEMORY : E_FAIL;
+
+        return S_OK;
+    }
+
     //--- Point Filter ---
-    HRESULT ResizePointFilter(const Image& srcImage, const Image& destImage)
+    HRESULT ResizePointFilter(const Image& srcImage, DWORD filter, const Image& destImage)
     {
         assert(srcImage.pixels && destImage.pixels);
         assert(srcImage.format == destImage.format);
 
-        // Allocate temporary space (2 scanlines)
-        ScopedAlignedArrayXMVECTOR scanline(static_cast<XMVECTOR*>(_aligned_malloc(
-            (sizeof(XMVECTOR) * (srcImage.width + destImage.width)), 16)));
-        if (!scanline)
-            return E_OUTOFMEMORY;
-
-        XMVECTOR* target = scanline.get();
-
-        XMVECTOR* row = target + destImage.width;
-
-#ifdef _DEBUG
-        memset(row, 0xCD, sizeof(XMVECTOR)*srcImage.width);
-#endif
-
         const uint8_t* pSrc = srcImage.pixels;
-        uint8_t* pDest = destImage.pixels;
 
         size_t rowPitch = srcImage.rowPitch;
 
         size_t xinc = (srcImage.width << 16) / destImage.width;
         size_t yinc = (srcImage.height << 16) / destImage.height;
 
-        size_t lasty = size_t(-1);
-
-        size_t sy = 0;
-        for (size_t y = 0; y < destImage.height; ++y)
+        std::atomic<bool> outOfMemory(false);
+        auto resizeRows = [&](size_t begin, size_t end) -> bool
         {
-            if ((lasty ^ sy) >> 16)
+            // Allocate temporary space (2 scanlines)
+            ScopedAlignedArrayXMVECTOR scanline(static_cast<XMVECTOR*>(_aligned_malloc(
+                (sizeof(XMVECTOR) * (srcImage.width + destImage.width)), 16)));
+            if (!scanline)
             {
-                if (!_LoadScanline(row, srcImage.width, pSrc + (rowPitch * (sy >> 16)), rowPitch, srcImage.format))
-                    return E_FAIL;
-                lasty = sy;
+                outOfMemory = true;
+                return false;
             }
 
-            size_t sx = 0;
-            for (size_t x = 0; x < destImage.width; ++x)
+            XMVECTOR* target = scanline.get();
+
+            XMVECTOR* row = target + destImage.width;
+
+#ifdef _DEBUG
+            memset(row, 0xCD, sizeof(XMVECTOR)*srcImage.width);
+#endif
+
+            uint8_t* pDest = destImage.pixels + destImage.rowPitch * begin;
+
+            size_t lasty = size_t(-1);
+
+            size_t sy = yinc * begin;
+            for (size_t y = begin; y < end; ++y)
             {
-                target[x] = row[sx >> 16];
-                sx += xinc;
-            }
+                if ((lasty ^ sy) >> 16)
+                {
+                    if (!_LoadScanline(row, srcImage.width, pSrc + (rowPitch * (sy >> 16)), rowPitch, srcImage.format))
+                        return false;
+                    lasty = sy;
+                }
 
-            if (!_StoreScanline(pDest, destImage.rowPitch, destImage.format, target, destImage.width))
-                return E_FAIL;
-            pDest += destImage.rowPitch;
+                size_t sx = 0;
+                for (size_t x = 0; x < destImage.width; ++x)
+                {
+                    target[x] = row[sx >> 16];
+                    sx += xinc;
+                }
 
-            sy += yinc;
-        }
+                if (!_StoreScanline(pDest, destImage.rowPitch, destImage.format, target, destImage.width))
+                    return false;
+                pDest += destImage.rowPitch;
 
-        return S_OK;
+                sy += yinc;
+            }
+
+            return true;
+        };
+
+        return ForEachRowTile(destImage, filter, outOfMemory, resizeRows);
     }
 
 
@@ -311,56 +339,65 @@ namespace
         if (((destImage.width << 1) != srcImage.width) || ((destImage.height << 1) != srcImage.height))
             return E_FAIL;
 
-        // Allocate temporary space (3 scanlines)
-        ScopedAlignedArrayXMVECTOR scanline(static_cast<XMVECTOR*>(_aligned_malloc(
-            (sizeof(XMVECTOR) * (srcImage.width * 2 + destImage.width)), 16)));
-        if (!scanline)
-            return E_OUTOFMEMORY;
+        size_t rowPitch = srcImage.rowPitch;
+
+        std::atomic<bool> outOfMemory(false);
+        auto resizeRows = [&](size_t begin, size_t end) -> bool
+        {
+            // Allocate temporary space (3 scanlines)
+            ScopedAlignedArrayXMVECTOR scanline(static_cast<XMVECTOR*>(_aligned_malloc(
+                (sizeof(XMVECTOR) * (srcImage.width * 2 + destImage.width)), 16)));
+            if (!scanline)
+            {
+                outOfMemory = true;
+                return false;
+            }
 
-        XMVECTOR* target = scanline.get();
+            XMVECTOR* target = scanline.get();
 
-        XMVECTOR* urow0 = target + destImage.width;
-        XMVECTOR* urow1 = urow0 + srcImage.width;
+            XMVECTOR* urow0 = target + destImage.width;
+            XMVECTOR* urow1 = urow0 + srcImage.width;
 
 #ifdef _DEBUG
-        memset(urow0, 0xCD, sizeof(XMVECTOR)*srcImage.width);
-        memset(urow1, 0xDD, sizeof(XMVECTOR)*srcImage.width);
+            memset(urow0, 0xCD, sizeof(XMVECTOR)*srcImage.width);
+            memset(urow1, 0xDD, sizeof(XMVECTOR)*srcImage.width);
 #endif
 
-        const XMVECTOR* urow2 = urow0 + 1;
-        const XMVECTOR* urow3 = urow1 + 1;
-
-        const uint8_t* pSrc = srcImage.pixels;
-        uint8_t* pDest = destImage.pixels;
-
-        size_t rowPitch = srcImage.rowPitch;
+            const XMVECTOR* urow2 = urow0 + 1;
+            const XMVECTOR* urow3 = urow1 + 1;
 
-        for (size_t y = 0; y < destImage.height; ++y)
-        {
-            if (!_LoadScanlineLinear(urow0, srcImage.width, pSrc, rowPitch, srcImage.format, filter))
-                return E_FAIL;
-            pSrc += rowPitch;
+            const uint8_t* pSrc = srcImage.pixels + rowPitch * 2 * begin;
+            uint8_t* pDest = destImage.pixels + destImage.rowPitch * begin;
 
-            if (urow0 != urow1)
+            for (size_t y = begin; y < end; ++y)
             {
-                if (!_LoadScanlineLinear(urow1, srcImage.width, pSrc, rowPitch, srcImage.format, filter))
-                    return E_FAIL;
+                if (!_LoadScanlineLinear(urow0, srcImage.width, pSrc, rowPitch, srcImage.format, filter))
+                    return false;
                 pSrc += rowPitch;
-            }
 
-            for (size_t x = 0; x < destImage.width; ++x)
-            {
-                size_t x2 = x << 1;
+                if (urow0 != urow1)
+                {
+                    if (!_LoadScanlineLinear(urow1, srcImage.width, pSrc, rowPitch, srcImage.format, filter))
+                        return false;
+                    pSrc += rowPitch;
+                }
 
-                AVERAGE4(target[x], urow0[x2], urow1[x2], urow2[x2], urow3[x2])
+                for (size_t x = 0; x < destImage.width; ++x)
+                {
+                    size_t x2 = x << 1;
+
+                    AVERAGE4(target[x], urow0[x2], urow1[x2], urow2[x2], urow3[x2])
+                }
+
+                if (!_StoreScanlineLinear(pDest, destImage.rowPitch, destImage.format, target, destImage.width, filter))
+                    return false;
+                pDest += destImage.rowPitch;
             }
 
-            if (!_StoreScanlineLinear(pDest, destImage.rowPitch, destImage.format, target, destImage.width, filter))
-                return E_FAIL;
-            pDest += destImage.rowPitch;
-        }
+            return true;
+        };
 
-        return S_OK;
+        return ForEachRowTile(destImage, filter, outOfMemory, resizeRows);
     }
 
 
@@ -370,12 +407,6 @@ namespace
         assert(srcImage.pixels && destImage.pixels);
         assert(srcImage.format == destImage.format);
 
-        // Allocate temporary space (3 scanlines, plus X and Y filters)
-        ScopedAlignedArrayXMVECTOR scanline(static_cast<XMVECTOR*>(_aligned_malloc(
-            (sizeof(XMVECTOR) * (srcImage.width * 2 + destImage.width)), 16)));
-        if (!scanline)
-            return E_OUTOFMEMORY;
-
         std::unique_ptr<LinearFilter[]> lf(new (std::nothrow) LinearFilter[destImage.width + destImage.height]);
         if (!lf)
             return E_OUTOFMEMORY;
@@ -386,67 +417,83 @@ namespace
         _CreateLinearFilter(srcImage.width, destImage.width, (filter & TEX_FILTER_WRAP_U) != 0, lfX);
         _CreateLinearFilter(srcImage.height, destImage.height, (filter & TEX_FILTER_WRAP_V) != 0, lfY);
 
-        XMVECTOR* target = scanline.get();
+        const uint8_t* pSrc = srcImage.pixels;
 
-        XMVECTOR* row0 = target + destImage.width;
-        XMVECTOR* row1 = row0 + srcImage.width;
+        size_t rowPitch = srcImage.rowPitch;
 
-#ifdef _DEBUG
-        memset(row0, 0xCD, sizeof(XMVECTOR)*srcImage.width);
-        memset(row1, 0xDD, sizeof(XMVECTOR)*srcImage.width);
-#endif
+        std::atomic<bool> outOfMemory(false);
+        auto resizeRows = [&](size_t begin, size_t end) -> bool
+        {
+            // Allocate temporary space (3 scanlines)
+            ScopedAlignedArrayXMVECTOR scanline(static_cast<XMVECTOR*>(_aligned_malloc(
+                (sizeof(XMVECTOR) * (srcImage.width * 2 + destImage.width)), 16)));
+            if (!scanline)
+            {
+                outOfMemory = true;
+                return false;
+            }
 
-        const uint8_t* pSrc = srcImage.pixels;
-        uint8_t* pDest = destImage.pixels;
+            XMVECTOR* target = scanline.get();
 
-        size_t rowPitch = srcImage.rowPitch;
+            XMVECTOR* row0 = target + destImage.width;
+            XMVECTOR* row1 = row0 + srcImage.width;
 
-        size_t u0 = size_t(-1);
-        size_t u1 = size_t(-1);
+#ifdef _DEBUG
+            memset(row0, 0xCD, sizeof(XMVECTOR)*srcImage.width);
+            memset(row1, 0xDD, sizeof(XMVECTOR)*srcImage.width);
+#endif
 
-        for (size_t y = 0; y < destImage.height; ++y)
-        {
-            auto& toY = lfY[y];
+            uint8_t* pDest = destImage.pixels + destImage.rowPitch * begin;
 
-            if (toY.u0 != u0)
+            size_t u0 = size_t(-1);
+            size_t u1 = size_t(-1);
+
+            for (size_t y = begin; y < end; ++y)
             {
-                if (toY.u0 != u1)
+                auto& toY = lfY[y];
+
+                if (toY.u0 != u0)
                 {
-                    u0 = toY.u0;
+                    if (toY.u0 != u1)
+                    {
+                        u0 = toY.u0;
 
-                    if (!_LoadScanlineLinear(row0, srcImage.width, pSrc + (rowPitch * u0), rowPitch, srcImage.format, filter))
-                        return E_FAIL;
+                        if (!_LoadScanlineLinear(row0, srcImage.width, pSrc + (rowPitch * u0), rowPitch, srcImage.format, filter))
+                            return false;
+                    }
+                    else
+                    {
+                        u0 = u1;
+                        u1 = size_t(-1);
+
+                        std::swap(row0, row1);
+                    }
                 }
-                else
+
+                if (toY.u1 != u1)
                 {
-                    u0 = u1;
-                    u1 = size_t(-1);
+                    u1 = toY.u1;
 
-                    std::swap(row0, row1);
+                    if (!_LoadScanlineLinear(row1, srcImage.width, pSrc + (rowPitch * u1), rowPitch, srcImage.format, filter))
+                        return false;
                 }
-            }
 
-            if (toY.u1 != u1)
-            {
-                u1 = toY.u1;
-
-                if (!_LoadScanlineLinear(row1, srcImage.width, pSrc + (rowPitch * u1), rowPitch, srcImage.format, filter))
-                    return E_FAIL;
-            }
+                for (size_t x = 0; x < destImage.width; ++x)
+                {
+                    auto& toX = lfX[x];
 
-            for (size_t x = 0; x < destImage.width; ++x)
-            {
-                auto& toX = lfX[x];
+                    BILINEAR_INTERPOLATE(target[x], toX, toY, row0, row1)
+                }
 
-                BILINEAR_INTERPOLATE(target[x], toX, toY, row0, row1)
+                if (!_StoreScanlineLinear(pDest, destImage.rowPitch, destImage.format, target, destImage.width, filter))
+                    return false;
+                pDest += destImage.rowPitch;
             }
 
-            if (!_StoreScanlineLinear(pDest, destImage.rowPitch, destImage.format, target, destImage.width, filter))
-                return E_FAIL;
-            pDest += destImage.rowPitch;
-        }
+            return true;
+        };
 
-        return S_OK;
+        return ForEachRowTile(destImage, filter, outOfMemory, resizeRows);
     }
 
 
@@ -456,12 +503,6 @@ namespace
         assert(srcImage.pixels && destImage.pixels);
         assert(srcImage.format == destImage.format);
 
-        // Allocate temporary space (5 scanlines, plus X and Y filters)
-        ScopedAlignedArrayXMVECTOR scanline(static_cast<XMVECTOR*>(_aligned_malloc(
-            (sizeof(XMVECTOR) * (srcImage.width * 4 + destImage.width)), 16)));
-        if (!scanline)
-            return E_OUTOFMEMORY;
-
         std::unique_ptr<CubicFilter[]> cf(new (std::nothrow) CubicFilter[destImage.width + destImage.height]);
         if (!cf)
             return E_OUTOFMEMORY;
@@ -472,141 +513,157 @@ namespace
         _CreateCubicFilter(srcImage.width, destImage.width, (filter & TEX_FILTER_WRAP_U) != 0, (filter & TEX_FILTER_MIRROR_U) != 0, cfX);
         _CreateCubicFilter(srcImage.height, destImage.height, (filter & TEX_FILTER_WRAP_V) != 0, (filter & TEX_FILTER_MIRROR_V) != 0, cfY);
 
-        XMVECTOR* target = scanline.get();
+        const uint8_t* pSrc = srcImage.pixels;
 
-        XMVECTOR* row0 = target + destImage.width;
-        XMVECTOR* row1 = row0 + srcImage.width;
-        XMVECTOR* row2 = row0 + srcImage.width * 2;
-        XMVECTOR* row3 = row0 + srcImage.width * 3;
+        size_t rowPitch = srcImage.rowPitch;
 
-#ifdef _DEBUG
-        memset(row0, 0xCD, sizeof(XMVECTOR)*srcImage.width);
-        memset(row1, 0xDD, sizeof(XMVECTOR)*srcImage.width);
-        memset(row2, 0xED, sizeof(XMVECTOR)*srcImage.width);
-        memset(row3, 0xFD, sizeof(XMVECTOR)*srcImage.width);
-#endif
+        std::atomic<bool> outOfMemory(false);
+        auto resizeRows = [&](size_t begin, size_t end) -> bool
+        {
+            // Allocate temporary space (5 scanlines)
+            ScopedAlignedArrayXMVECTOR scanline(static_cast<XMVECTOR*>(_aligned_malloc(
+                (sizeof(XMVECTOR) * (srcImage.width * 4 + destImage.width)), 16)));
+            if (!scanline)
+            {
+                outOfMemory = true;
+                return false;
+            }
 
-        const uint8_t* pSrc = srcImage.pixels;
-        uint8_t* pDest = destImage.pixels;
+            XMVECTOR* target = scanline.get();
 
-        size_t rowPitch = srcImage.rowPitch;
+            XMVECTOR* row0 = target + destImage.width;
+            XMVECTOR* row1 = row0 + srcImage.width;
+            XMVECTOR* row2 = row0 + srcImage.width * 2;
+            XMVECTOR* row3 = row0 + srcImage.width * 3;
+
+#ifdef _DEBUG
+            memset(row0, 0xCD, sizeof(XMVECTOR)*srcImage.width);
+            memset(row1, 0xDD, sizeof(XMVECTOR)*srcImage.width);
+            memset(row2, 0xED, sizeof(XMVECTOR)*srcImage.width);
+            memset(row3, 0xFD, sizeof(XMVECTOR)*srcImage.width);
+#endif
 
-        size_t u0 = size_t(-1);
-        size_t u1 = size_t(-1);
-        size_t u2 = size_t(-1);
-        size_t u3 = size_t(-1);
+            uint8_t* pDest = destImage.pixels + destImage.rowPitch * begin;
 
-        for (size_t y = 0; y < destImage.height; ++y)
-        {
-            auto& toY = cfY[y];
+            size_t u0 = size_t(-1);
+            size_t u1 = size_t(-1);
+            size_t u2 = size_t(-1);
+            size_t u3 = size_t(-1);
 
-            // Scanline 1
-            if (toY.u0 != u0)
+            for (size_t y = begin; y < end; ++y)
             {
-                if (toY.u0 != u1 && toY.u0 != u2 && toY.u0 != u3)
-                {
-                    u0 = toY.u0;
+                auto& toY = cfY[y];
 
-                    if (!_LoadScanlineLinear(row0, srcImage.width, pSrc + (rowPitch * u0), rowPitch, srcImage.format, filter))
-                        return E_FAIL;
-                }
-                else if (toY.u0 == u1)
+                // Scanline 1
+                if (toY.u0 != u0)
                 {
-                    u0 = u1;
-                    u1 = size_t(-1);
+                    if (toY.u0 != u1 && toY.u0 != u2 && toY.u0 != u3)
+                    {
+                        u0 = toY.u0;
 
-                    std::swap(row0, row1);
-                }
-                else if (toY.u0 == u2)
-                {
-                    u0 = u2;
-                    u2 = size_t(-1);
+                        if (!_LoadScanlineLinear(row0, srcImage.width, pSrc + (rowPitch * u0), rowPitch, srcImage.format, filter))
+                            return false;
+                    }
+                    else if (toY.u0 == u1)
+                    {
+                        u0 = u1;
+                        u1 = size_t(-1);
 
-                    std::swap(row0, row2);
-                }
-                else if (toY.u0 == u3)
-                {
-                    u0 = u3;
-                    u3 = size_t(-1);
+                        std::swap(row0, row1);
+                    }
+                    else if (toY.u0 == u2)
+                    {
+                        u0 = u2;
+                        u2 = size_t(-1);
+
+                        std::swap(row0, row2);
+                    }
+                    else if (toY.u0 == u3)
+                    {
+                        u0 = u3;
+                        u3 = size_t(-1);
 
-                    std::swap(row0, row3);
+                        std::swap(row0, row3);
+                    }
                 }
-            }
 
-            // Scanline 2
-            if (toY.u1 != u1)
-            {
-                if (toY.u1 != u2 && toY.u1 != u3)
+                // Scanline 2
+                if (toY.u1 != u1)
                 {
-                    u1 = toY.u1;
+                    if (toY.u1 != u2 && toY.u1 != u3)
+                    {
+                        u1 = toY.u1;
 
-                    if (!_LoadScanlineLinear(row1, srcImage.width, pSrc + (rowPitch * u1), rowPitch, srcImage.format, filter))
-                        return E_FAIL;
-                }
-                else if (toY.u1 == u2)
-                {
-                    u1 = u2;
-                    u2 = size_t(-1);
+                        if (!_LoadScanlineLinear(row1, srcImage.width, pSrc + (rowPitch * u1), rowPitch, srcImage.format, filter))
+                            return false;
+                    }
+                    else if (toY.u1 == u2)
+                    {
+                        u1 = u2;
+                        u2 = size_t(-1);
 
-                    std::swap(row1, row2);
-                }
-                else if (toY.u1 == u3)
-                {
-                    u1 = u3;
-                    u3 = size_t(-1);
+                        std::swap(row1, row2);
+                    }
+                    else if (toY.u1 == u3)
+                    {
+                        u1 = u3;
+                        u3 = size_t(-1);
 
-                    std::swap(row1, row3);
+                        std::swap(row1, row3);
+                    }
                 }
-            }
 
-            // Scanline 3
-            if (toY.u2 != u2)
-            {
-                if (toY.u2 != u3)
+                // Scanline 3
+                if (toY.u2 != u2)
                 {
-                    u2 = toY.u2;
+                    if (toY.u2 != u3)
+                    {
+                        u2 = toY.u2;
 
-                    if (!_LoadScanlineLinear(row2, srcImage.width, pSrc + (rowPitch * u2), rowPitch, srcImage.format, filter))
-                        return E_FAIL;
+                        if (!_LoadScanlineLinear(row2, srcImage.width, pSrc + (rowPitch * u2), rowPitch, srcImage.format, filter))
+                            return false;
+                    }
+                    else
+                    {
+                        u2 = u3;
+                        u3 = size_t(-1);
+
+                        std::swap(row2, row3);
+                    }
                 }
-                else
+
+                // Scanline 4
+                if (toY.u3 != u3)
                 {
-                    u2 = u3;
-                    u3 = size_t(-1);
+                    u3 = toY.u3;
 
-                    std::swap(row2, row3);
+                    if (!_LoadScanlineLinear(row3, srcImage.width, pSrc + (rowPitch * u3), rowPitch, srcImage.format, filter))
+                        return false;
                 }
-            }
-
-            // Scanline 4
-            if (toY.u3 != u3)
-            {
-                u3 = toY.u3;
 
-                if (!_LoadScanlineLinear(row3, srcImage.width, pSrc + (rowPitch * u3), rowPitch, srcImage.format, filter))
-                    return E_FAIL;
-            }
+                for (size_t x = 0; x < destImage.width; ++x)
+                {
+                    auto& toX = cfX[x];
 
-            for (size_t x = 0; x < destImage.width; ++x)
-            {
-                auto& toX = cfX[x];
+                    XMVECTOR C0, C1, C2, C3;
 
-                XMVECTOR C0, C1, C2, C3;
+                    CUBIC_INTERPOLATE(C0, toX.x, row0[toX.u0], row0[toX.u1], row0[toX.u2], row0[toX.u3])
+                    CUBIC_INTERPOLATE(C1, toX.x, row1[toX.u0], row1[toX.u1], row1[toX.u2], row1[toX.u3])
+                    CUBIC_INTERPOLATE(C2, toX.x, row2[toX.u0], row2[toX.u1], row2[toX.u2], row2[toX.u3])
+                    CUBIC_INTERPOLATE(C3, toX.x, row3[toX.u0], row3[toX.u1], row3[toX.u2], row3[toX.u3])
 
-                CUBIC_INTERPOLATE(C0, toX.x, row0[toX.u0], row0[toX.u1], row0[toX.u2], row0[toX.u3])
-                CUBIC_INTERPOLATE(C1, toX.x, row1[toX.u0], row1[toX.u1], row1[toX.u2], row1[toX.u3])
-                CUBIC_INTERPOLATE(C2, toX.x, row2[toX.u0], row2[toX.u1], row2[toX.u2], row2[toX.u3])
-                CUBIC_INTERPOLATE(C3, toX.x, row3[toX.u0], row3[toX.u1], row3[toX.u2], row3[toX.u3])
+                    CUBIC_INTERPOLATE(target[x], toY.x, C0, C1, C2, C3)
+                }
 
-                CUBIC_INTERPOLATE(target[x], toY.x, C0, C1, C2, C3)
+                if (!_StoreScanlineLinear(pDest, destImage.rowPitch, destImage.format, target, destImage.width, filter))
+                    return false;
+                pDest += destImage.rowPitch;
             }
 
-            if (!_StoreScanlineLinear(pDest, destImage.rowPitch, destImage.format, target, destImage.width, filter))
-                return E_FAIL;
-            pDest += destImage.rowPitch;
-        }
+            return true;
+        };
 
-        return S_OK;
+        return ForEachRowTile(destImage, filter, outOfMemory, resizeRows);
     }
 
 
@@ -808,7 +865,7 @@ namespace
         switch (filter_select)
         {
         case TEX_FILTER_POINT:
-            return ResizePointFilter(srcImage, destImage);
+            return ResizePointFilter(srcImage, filter, destImage);
 
         case TEX_FILTER_BOX:
             return ResizeBoxFilter(srcImage, filter, destImage);
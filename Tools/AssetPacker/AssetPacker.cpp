@@ -0,0 +1,105 @@
+#include <algorithm>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "AssetFileSystem.h"
+#include "PakFile.h"
+
+namespace fs = std::filesystem;
+
+// Entries from the access order come first, in the order they were read, the rest follow by name.
+static std::vector<PakFile::Source> OrderSources(std::vector<PakFile::Source> sources, const std::vector<std::string>& order, const std::string& prefix)
+{
+    std::sort(sources.begin(), sources.end(), [](const PakFile::Source& a, const PakFile::Source& b) { return a.name < b.name; });
+
+    std::unordered_map<std::string, uint32_t> indices;
+    for (uint32_t i = 0; i < sources.size(); i++)
+        indices[sources[i].name] = i;
+
+    std::vector<PakFile::Source> ordered;
+    std::vector<bool> bTaken(sources.size(), false);
+    for (const auto& path : order)
+    {
+        if (path.compare(0, prefix.size(), prefix) != 0)
+            continue;
+
+        auto it = indices.find(path.substr(prefix.size()));
+        if (it == indices.end() || bTaken[it->second])
+            continue;
+
+        bTaken[it->second] = true;
+        ordered.push_back(sources[it->second]);
+    }
+
+    std::cout << ordered.size() << " of " << sources.size() << " entries in access order" << std::endl;
+
+    for (uint32_t i = 0; i < sources.size(); i++)
+    {
+        if (!bTaken[i])
+            ordered.push_back(sources[i]);
+    }
+
+    return ordered;
+}
+
+int main(int argc, char* argv[])
+{
+    bool bCompress = false;
+    std::string orderPath;
+    std::string prefix = "Asset/";
+    std::vector<std::string> arguments;
+    for (int i = 1; i < argc; i++)
+    {
+        std::string argument = argv[i];
+        if (argument == "--lz4")
+            bCompress = true;
+        else if (argument == "--order" && i + 1 < argc)
+            orderPath = argv[++i];
+        else if (argument == "--prefix" && i + 1 < argc)
+            prefix = AssetFileSystem::Normalize(argv[++i]);
+        else
+            arguments.push_back(argument);
+    }
+
+    if (arguments.size() != 2)
+    {
+        std::cerr << "usage: AssetPacker [--lz4] [--order <access order>] [--prefix <mount prefix>] <asset directory> <archive>" << std::endl;
+        return 1;
+    }
+
+    fs::path input = arguments[0];
+    std::string output = arguments[1];
+
+    std::error_code error;
+    if (!fs::is_directory(input, error))
+    {
+        std::cerr << input.string() << " is not a directory" << std::endl;
+        return 1;
+    }
+
+    std::vector<PakFile::Source> sources;
+    for (const auto& entry : fs::recursive_directory_iterator(input, error))
+    {
+        if (entry.is_regular_file())
+            sources.push_back(PakFile::Source { entry.path().lexically_relative(input).generic_string(), entry.path().string() });
+    }
+
+    // A missing order file only means no startup run has been recorded yet.
+    std::vector<std::string> order;
+    if (!orderPath.empty())
+        order = AssetFileSystem::LoadAccessOrder(orderPath);
+
+    sources = OrderSources(sources, order, prefix);
+
+    if (!PakFile::Write(output, sources, bCompress))
+    {
+        std::cerr << "failed to write " << output << std::endl;
+        return 1;
+    }
+
+    std::cout << output << ": " << sources.size() << " entries" << std::endl;
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,70 @@
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "EnvironmentBaker.h"
+#include "Global.h"
+#include "MappedFile.h"
+
+using namespace Engine;
+
+namespace fs = std::filesystem;
+
+// Bakes every Radiance HDR under a directory into the derived data cache. This only prewarms the
+// cache: a later EnvironmentBaker::Bake of the same image and settings returns the cached files
+// instead of baking again. Nothing in the renderer reads the results yet.
+int main(int argc, char* argv[])
+{
+    EnvironmentBaker::Desc desc;
+    std::vector<std::string> arguments;
+    for (int i = 1; i < argc; i++)
+    {
+        std::string argument = argv[i];
+        if (argument == "--face-size" && i + 1 < argc)
+            desc.faceSize = (uint32_t)std::stoul(argv[++i]);
+        else if (argument == "--samples" && i + 1 < argc)
+            desc.sampleCount = (uint32_t)std::stoul(argv[++i]);
+        else
+            arguments.push_back(argument);
+    }
+
+    if (arguments.size() != 1)
+    {
+        std::cerr << "usage: IBLBaker [--face-size <pixels>] [--samples <count>] <environment directory>" << std::endl;
+        return 1;
+    }
+
+    if (gpGlobal == nullptr)
+        gpGlobal = new Global();
+
+    fs::path input = arguments[0];
+
+    std::error_code error;
+    if (!fs::is_directory(input, error))
+    {
+        std::cerr << input.string() << " is not a directory" << std::endl;
+        return 1;
+    }
+
+    uint32_t failedCount = 0;
+    for (const auto& entry : fs::recursive_directory_iterator(input, error))
+    {
+        if (!entry.is_regular_file() || entry.path().extension().string() != ".hdr")
+            continue;
+
+        auto pFile = MappedFile::Open(entry.path().string());
+        EnvironmentBaker::Result result;
+        if (pFile == nullptr || !EnvironmentBaker::Bake(pFile->GetView(0).get(), (uint32_t)pFile->GetSize(), desc, result))
+        {
+            std::cerr << entry.path().string() << ": failed to bake" << std::endl;
+            failedCount++;
+            continue;
+        }
+
+        const auto& dc = result.irradiance.coefficients[0];
+        std::cout << entry.path().string() << ": " << result.specularPath << ", irradiance DC " << dc[0] << " " << dc[1] << " " << dc[2] << std::endl;
+    }
+
+    return failedCount == 0 ? 0 : 1;
+}
\ No newline at end of file
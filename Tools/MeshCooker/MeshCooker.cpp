@@ -0,0 +1,103 @@
+#include <exception>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "Global.h"
+#include "GLTF2Loader.h"
+#include "MeshFile.h"
+
+using namespace Engine;
+
+namespace fs = std::filesystem;
+
+static bool IsScene(const fs::path& path)
+{
+    auto extension = path.extension().string();
+    return extension == ".gltf" || extension == ".glb";
+}
+
+// Every primitive of a scene becomes <stem>_<primitive>.ntmesh next to where the scene would be in the output tree.
+static uint32_t CookScene(const fs::path& scene, const fs::path& outputDirectory, bool bCompress)
+{
+    GLTF2Loader loader;
+    loader.Load(scene.string());
+
+    fs::create_directories(outputDirectory);
+
+    uint32_t cookedCount = 0;
+    for (uint32_t i = 0; i < loader.GetMeshCount(); i++)
+    {
+        auto pMesh = loader.GetMesh(i);
+        auto path = outputDirectory / (scene.stem().string() + "_" + std::to_string(i) + ".ntmesh");
+
+        if (pMesh != nullptr && MeshFile::Save(*pMesh, path.string(), bCompress))
+            cookedCount++;
+        else
+            std::cerr << "failed to write " << path.string() << std::endl;
+
+        const auto& statistics = loader.GetCacheStatistics(i);
+        if (statistics.bOptimized)
+        {
+            std::cout << "  " << path.filename().string() << ": ACMR " << statistics.before.acmr << " -> " << statistics.after.acmr
+                      << ", ATVR " << statistics.before.atvr << " -> " << statistics.after.atvr << std::endl;
+        }
+    }
+
+    return cookedCount;
+}
+
+int main(int argc, char* argv[])
+{
+    bool bCompress = false;
+    std::vector<std::string> arguments;
+    for (int i = 1; i < argc; i++)
+    {
+        std::string argument = argv[i];
+        if (argument == "--lz4")
+            bCompress = true;
+        else
+            arguments.push_back(argument);
+    }
+
+    if (arguments.size() != 2)
+    {
+        std::cerr << "usage: MeshCooker [--lz4] <scene directory> <output directory>" << std::endl;
+        return 1;
+    }
+
+    if (gpGlobal == nullptr)
+        gpGlobal = new Global();
+
+    fs::path input = arguments[0];
+    fs::path output = arguments[1];
+
+    std::error_code error;
+    if (!fs::is_directory(input, error))
+    {
+        std::cerr << input.string() << " is not a directory" << std::endl;
+        return 1;
+    }
+
+    uint32_t failedCount = 0;
+    for (const auto& entry : fs::recursive_directory_iterator(input, error))
+    {
+        if (!entry.is_regular_file() || !IsScene(entry.path()))
+            continue;
+
+        auto relative = entry.path().parent_path().lexically_relative(input);
+        try
+        {
+            uint32_t count = CookScene(entry.path(), output / relative, bCompress);
+            std::cout << entry.path().string() << ": " << count << " meshes" << std::endl;
+        }
+        catch (const std::exception& e)
+        {
+            std::cerr << entry.path().string() << ": " << e.what() << std::endl;
+            failedCount++;
+        }
+    }
+
+    return failedCount == 0 ? 0 : 1;
+}
\ No newline at end of file
@@ -0,0 +1,181 @@
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <string.h>
+
+#include <DirectXTex.h>
+
+#include "Global.h"
+#include "MipGenerator.h"
+
+using namespace Engine;
+
+constexpr static uint32_t RUN_COUNT = 3;
+
+// Smooth gradients under noise with a cut out alpha, roughly what foliage albedo looks like.
+static void FillImage(const DirectX::Image& image)
+{
+    uint32_t state = 0x9E3779B9u;
+    for (size_t y = 0; y < image.height; y++)
+    {
+        uint8_t* pRow = image.pixels + y * image.rowPitch;
+        for (size_t x = 0; x < image.width; x++)
+        {
+            state = state * 1664525u + 1013904223u;
+            uint32_t noise = state >> 28;
+            pRow[x * 4 + 0] = (uint8_t)((x * 255 / image.width + noise) & 0xFF);
+            pRow[x * 4 + 1] = (uint8_t)((y * 255 / image.height + noise) & 0xFF);
+            pRow[x * 4 + 2] = (uint8_t)(((x + y) * 127 / image.width) & 0xFF);
+            pRow[x * 4 + 3] = ((x / 16 + y / 16) % 3 == 0) ? 0 : 255;
+        }
+    }
+}
+
+// Best of RUN_COUNT runs in milliseconds.
+static double Time(const std::function<void()>& run)
+{
+    double best = 0.0;
+    for (uint32_t i = 0; i < RUN_COUNT; i++)
+    {
+        auto start = std::chrono::steady_clock::now();
+        run();
+        double elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        best = i == 0 ? elapsed : std::min(best, elapsed);
+    }
+
+    return best;
+}
+
+static void Report(const std::string& name, uint32_t size, double milliseconds)
+{
+    std::cout << std::setw(8) << (std::to_string(size) + "^2") << "  " << std::setw(48) << std::left << name << std::right
+        << std::setw(10) << std::fixed << std::setprecision(1) << milliseconds << " ms" << std::endl;
+}
+
+// Each operation on one thread as DirectXTex picks the path, then in row tiles on all cores.
+static void BenchmarkConvertAndResize(const DirectX::ScratchImage& image, uint32_t size)
+{
+    const DirectX::Image& source = *image.GetImage(0, 0, 0);
+
+    DirectX::ScratchImage linear;
+    DirectX::Convert(source, DXGI_FORMAT_R32G32B32A32_FLOAT, DirectX::TEX_FILTER_DEFAULT, DirectX::TEX_THRESHOLD_DEFAULT, linear);
+
+    struct Operation
+    {
+        const char* name;
+        std::function<void(DWORD)> run;
+    };
+
+    const Operation operations[] = {
+        { "Convert sRGB RGBA8 to RGBA32F", [&](DWORD filter) {
+            DirectX::ScratchImage result;
+            DirectX::Convert(source, DXGI_FORMAT_R32G32B32A32_FLOAT, filter, DirectX::TEX_THRESHOLD_DEFAULT, result);
+        } },
+        { "Convert RGBA32F to sRGB RGBA8", [&](DWORD filter) {
+            DirectX::ScratchImage result;
+            DirectX::Convert(*linear.GetImage(0, 0, 0), DXGI_FORMAT_R8G8B8A8_UNORM_SRGB, filter, DirectX::TEX_THRESHOLD_DEFAULT, result);
+        } },
+        { "Convert RGBA32F to RGBA16F", [&](DWORD filter) {
+            DirectX::ScratchImage result;
+            DirectX::Convert(*linear.GetImage(0, 0, 0), DXGI_FORMAT_R16G16B16A16_FLOAT, filter, DirectX::TEX_THRESHOLD_DEFAULT, result);
+        } },
+        { "Resize sRGB RGBA8 to half, linear", [&](DWORD filter) {
+            DirectX::ScratchImage result;
+            DirectX::Resize(source, size / 2, size / 2, filter | DirectX::TEX_FILTER_LINEAR, result);
+        } },
+        { "Resize RGBA32F to half, cubic", [&](DWORD filter) {
+            DirectX::ScratchImage result;
+            DirectX::Resize(*linear.GetImage(0, 0, 0), size / 2, size / 2, filter | DirectX::TEX_FILTER_CUBIC, result);
+        } },
+    };
+
+    for (const auto& operation : operations)
+    {
+        Report(operation.name, size, Time([&]() { operation.run(DirectX::TEX_FILTER_DEFAULT); }));
+        Report(std::string(operation.name) + ", parallel", size, Time([&]() { operation.run(DirectX::TEX_FILTER_PARALLEL); }));
+    }
+}
+
+static void Benchmark(uint32_t size)
+{
+    DirectX::ScratchImage image;
+    if (FAILED(image.Initialize2D(DXGI_FORMAT_R8G8B8A8_UNORM_SRGB, size, size, 1, 1)))
+    {
+        std::cerr << "out of memory for " << size << "^2" << std::endl;
+        return;
+    }
+
+    FillImage(*image.GetImage(0, 0, 0));
+
+    const auto& metadata = image.GetMetadata();
+    auto generateMipMaps = [&](DWORD filter) {
+        return Time([&]() {
+            DirectX::ScratchImage mipChain;
+            DirectX::GenerateMipMaps(image.GetImages(), image.GetImageCount(), metadata, filter | DirectX::TEX_FILTER_SRGB, 0, mipChain);
+        });
+    };
+
+    Report("GenerateMipMaps default", size, generateMipMaps(DirectX::TEX_FILTER_DEFAULT));
+    Report("GenerateMipMaps box", size, generateMipMaps(DirectX::TEX_FILTER_BOX | DirectX::TEX_FILTER_FORCE_NON_WIC));
+    Report("GenerateMipMaps cubic", size, generateMipMaps(DirectX::TEX_FILTER_CUBIC | DirectX::TEX_FILTER_FORCE_NON_WIC));
+
+    // The chain is allocated once, as the cooker allocates it before generating.
+    uint32_t levelCount = MipGenerator::GetLevelCount(size, size);
+    DirectX::ScratchImage mipChain;
+    mipChain.Initialize2D(metadata.format, size, size, 1, levelCount);
+
+    std::vector<MipGenerator::Level> levels(levelCount);
+    for (uint32_t i = 0; i < levelCount; i++)
+    {
+        const DirectX::Image* pImage = mipChain.GetImage(i, 0, 0);
+        levels[i] = MipGenerator::Level { (uint32_t)pImage->width, (uint32_t)pImage->height, pImage->rowPitch, pImage->pixels };
+    }
+    memcpy(levels[0].pTexels, image.GetPixels(), image.GetPixelsSize());
+
+    auto generate = [&](MipGenerator::EFilter filter, float alphaCutoff) {
+        MipGenerator::Desc desc;
+        desc.filter = filter;
+        desc.bSRGB = true;
+        desc.alphaCutoff = alphaCutoff;
+        return Time([&]() { MipGenerator::Generate(levels.data(), levelCount, desc); });
+    };
+
+    Report("MipGenerator box", size, generate(MipGenerator::eFilter_Box, -1.0f));
+    Report("MipGenerator Kaiser", size, generate(MipGenerator::eFilter_Kaiser, -1.0f));
+    Report("MipGenerator Kaiser, alpha coverage", size, generate(MipGenerator::eFilter_Kaiser, 0.5f));
+
+    BenchmarkConvertAndResize(image, size);
+}
+
+int main(int argc, char* argv[])
+{
+    std::vector<uint32_t> sizes;
+    for (int i = 1; i < argc; i++)
+        sizes.push_back((uint32_t)std::stoul(argv[i]));
+
+    if (sizes.empty())
+        sizes = { 4096, 8192 };
+
+    if (gpGlobal == nullptr)
+        gpGlobal = new Global();
+
+    // The WIC filters need COM.
+    HRESULT hrCom = CoInitializeEx(nullptr, COINIT_MULTITHREADED);
+
+    std::cout << gpGlobal->GetJobSystem().WorkerCount() + 1 << " threads, sRGB RGBA8, best of " << RUN_COUNT << std::endl;
+    for (auto size : sizes)
+        Benchmark(size);
+
+    if (SUCCEEDED(hrCom))
+        CoUninitialize();
+
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,14 @@
+#ifndef _BASIC_H_
+#define _BASIC_H_
+
+struct Basic_Input
+{
+    float3 Position : POSITION;
+};
+
+struct Basic_VertexAttr
+{
+    float4 position : SV_Position;
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,10 @@
+#ifndef _RECT_H_
+#define _RECT_H_
+
+struct Rect_VertexAttr
+{
+    float4 position : SV_Position;
+    float2 uv : TexCoord;
+};
+
+#endif
\ No newline at end of file
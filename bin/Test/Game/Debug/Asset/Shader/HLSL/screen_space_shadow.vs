@@ -0,0 +1,38 @@
+#include "screen_space_shadow.h"
+#include "vertex_packing.h"
+
+cbuffer TransformCB : register(b0)
+{
+    row_major float4x4 gWorldMatrix : WORLD;
+    row_major float4x4 gViewMatrix : VIEW;
+    row_major float4x4 gProjectionView : PROJECTION;
+    float3 gPositionScale : POSITION_SCALE;
+    float3 gPositionOffset : POSITION_OFFSET;
+};
+
+cbuffer TransformLight : register(b1)
+{
+    row_major float4x4 gLightViewMatrix : LIGHT_VIEW;
+    row_major float4x4 gLightProjMatrix : LIGHT_PROJ;
+};
+
+ScreenSpaceShadow_VertexAttr ScreenSpaceShadow_VS(ScreenSpaceShadow_Input input)
+{
+    ScreenSpaceShadow_VertexAttr output = (ScreenSpaceShadow_VertexAttr)0;
+
+    output.position.xyz = DecodePosition(input.Position.xyz, gPositionScale, gPositionOffset);
+    output.position.w = 1.0f;
+    output.position = mul(output.position, gWorldMatrix);
+    output.position = mul(output.position, gViewMatrix);
+    output.position = mul(output.position, gProjectionView);
+
+    output.normal = normalize(mul(DecodeOctahedral(input.Normal), (float3x3)gWorldMatrix));
+
+    output.lightViewPosition.xyz = DecodePosition(input.Position.xyz, gPositionScale, gPositionOffset);
+    output.lightViewPosition.w = 1.0f;
+    output.lightViewPosition = mul(output.lightViewPosition, gWorldMatrix);
+    output.lightViewPosition = mul(output.lightViewPosition, gLightViewMatrix);
+    output.lightViewPosition = mul(output.lightViewPosition, gLightProjMatrix);
+
+    return output;
+}
\ No newline at end of file
@@ -0,0 +1,19 @@
+#ifndef _VERTEX_PACKING_H_
+#define _VERTEX_PACKING_H_
+
+// Decoders for the packed vertex streams, see Engine/Math/VertexPacking.h.
+
+float3 DecodePosition(float3 packed, float3 scale, float3 offset)
+{
+    return packed * scale + offset;
+}
+
+float3 DecodeOctahedral(float2 packed)
+{
+    float3 n = float3(packed.xy, 1.0f - abs(packed.x) - abs(packed.y));
+    float t = saturate(-n.z);
+    n.xy += n.xy >= 0.0f ? -t : t;
+    return normalize(n);
+}
+
+#endif
\ No newline at end of file